@@ -20,8 +20,12 @@
 #ifndef BESSEL_BASICS_DECAYINGSAMPLE_H_INCLUDED
 #define BESSEL_BASICS_DECAYINGSAMPLE_H_INCLUDED
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 
 namespace bessel {
 
@@ -103,6 +107,114 @@ private:
 
 //------------------------------------------------------------------------------
 
+/** A DecayingSample that may be shared between threads without a lock.
+
+    The value and the second it was last aged are packed into a single
+    64-bit word, and add() updates them with compare-and-swap. Samples
+    must be non-negative; the accumulated value saturates instead of
+    wrapping. Decay is applied in whole seconds of the clock's epoch,
+    which matches DecayingSample when driven by a seconds clock.
+    @tparam The number of seconds in the decay window.
+*/
+template <int Window, typename Clock>
+class AtomicDecayingSample
+{
+public:
+    typedef std::int32_t value_type;
+    typedef typename Clock::time_point time_point;
+
+    AtomicDecayingSample () = delete;
+    AtomicDecayingSample (AtomicDecayingSample const&) = delete;
+    AtomicDecayingSample& operator= (AtomicDecayingSample const&) = delete;
+
+    /**
+        @param now Start time of AtomicDecayingSample.
+    */
+    explicit AtomicDecayingSample (time_point now)
+        : m_state (pack (0, seconds (now)))
+    {
+    }
+
+    /** Add a new sample.
+        The value is first aged according to the specified time.
+    */
+    value_type add (value_type value, time_point now)
+    {
+        std::uint32_t const when (seconds (now));
+        std::uint64_t state (m_state.load (std::memory_order_relaxed));
+        std::uint32_t next;
+
+        do
+        {
+            std::uint64_t const sum (
+                std::uint64_t (decay (state, when)) + std::max (value, 0));
+            next = static_cast <std::uint32_t> (std::min <std::uint64_t> (
+                sum, std::numeric_limits <value_type>::max ()));
+        }
+        while (! m_state.compare_exchange_weak (state,
+            pack (next, std::max (when, timeOf (state))),
+                std::memory_order_relaxed));
+
+        return value_type (next) / Window;
+    }
+
+    /** Retrieve the current value in normalized units.
+        The stored value is left alone; aging is applied to the copy.
+    */
+    value_type value (time_point now) const
+    {
+        return value_type (decay (
+            m_state.load (std::memory_order_relaxed), seconds (now))) / Window;
+    }
+
+private:
+    static std::uint32_t seconds (time_point now)
+    {
+        return static_cast <std::uint32_t> (std::chrono::duration_cast <
+            std::chrono::seconds> (now.time_since_epoch ()).count ());
+    }
+
+    static std::uint64_t pack (std::uint32_t value, std::uint32_t when)
+    {
+        return (std::uint64_t (when) << 32) | value;
+    }
+
+    static std::uint32_t timeOf (std::uint64_t state)
+    {
+        return static_cast <std::uint32_t> (state >> 32);
+    }
+
+    // Returns the stored value aged up to `when`
+    static std::uint32_t decay (std::uint64_t state, std::uint32_t when)
+    {
+        std::uint32_t value (static_cast <std::uint32_t> (state));
+        std::uint32_t const last (timeOf (state));
+
+        // Another thread may already have aged the sample past `when`
+        if (value == 0 || when <= last)
+            return value;
+
+        std::uint32_t elapsed (when - last);
+
+        // A span larger than four times the window decays the
+        // value to an insignificant amount so just reset it.
+        //
+        if (elapsed > 4 * Window)
+            return 0;
+
+        while (elapsed--)
+            value -= (value + Window - 1) / Window;
+
+        return value;
+    }
+
+    // Value in exponential units (low half) and the time in
+    // seconds it was last aged (high half)
+    std::atomic <std::uint64_t> m_state;
+};
+
+//------------------------------------------------------------------------------
+
 /** Sampling function using exponential decay to provide a continuous value.
     @tparam HalfLife The half life of a sample, in seconds.
 */
@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 
 namespace bessel {
 
@@ -95,6 +96,13 @@ operator== (Slice const& lhs, Slice const& rhs) noexcept
             lhs.data(), rhs.data(), lhs.size()) == 0;
 }
 
+inline
+bool
+operator!= (Slice const& lhs, Slice const& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
 inline
 bool
 operator< (Slice const& lhs, Slice const& rhs) noexcept
@@ -26,6 +26,7 @@
 
 #include <common/base/ByteOrder.h>
 #include <common/base/Blob.h>
+#include <common/base/Slice.h>
 #include <common/base/strHex.h>
 
 namespace bessel {
@@ -41,6 +42,11 @@ inline std::string strHex (Blob const& vucData)
     return strHex (vucData.begin (), vucData.size ());
 }
 
+inline std::string strHex (Slice const& slice)
+{
+    return strHex (slice.data (), slice.size ());
+}
+
 inline std::string strHex (const std::uint64_t uiHost)
 {
     uint64_t    uBig    = htobe64 (uiHost);
@@ -148,6 +148,18 @@ public:
         return m_hits * (100.0f / std::max (1.0f, total));
     }
 
+    std::uint64_t getHits ()
+    {
+        lock_guard lock (m_mutex);
+        return m_hits;
+    }
+
+    std::uint64_t getMisses ()
+    {
+        lock_guard lock (m_mutex);
+        return m_misses;
+    }
+
     void clearStats ()
     {
         lock_guard lock (m_mutex);
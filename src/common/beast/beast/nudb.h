@@ -25,6 +25,7 @@
 #include <beast/nudb/common.h>
 #include <beast/nudb/file.h>
 #include <beast/nudb/recover.h>
+#include <beast/nudb/rekey.h>
 #include <beast/nudb/store.h>
 #include <beast/nudb/verify.h>
 #include <beast/nudb/visit.h>
@@ -24,6 +24,7 @@
 #include <beast/nudb/identity.h>
 #include <beast/nudb/store.h>
 #include <beast/nudb/recover.h>
+#include <beast/nudb/rekey.h>
 #include <beast/nudb/verify.h>
 #include <beast/nudb/visit.h>
 #include <cstdint>
@@ -92,6 +93,40 @@ struct api
             dat_path, key_path, BufferSize);
     }
     
+    template <class Progress, class... Args>
+    static
+    bool
+    rekey (
+        path_type const& dat_path,
+        path_type const& key_path,
+        path_type const& log_path,
+        std::size_t block_size,
+        float load_factor,
+        std::size_t item_count,
+        std::size_t threads,
+        Progress&& progress,
+        Args&&... args)
+    {
+        return nudb::rekey<Hasher, File>(
+            dat_path, key_path, log_path, block_size,
+                load_factor, item_count, BufferSize,
+                    threads, progress, args...);
+    }
+
+    template <class Progress>
+    static
+    verify_info
+    verify_parallel (
+        path_type const& dat_path,
+        path_type const& key_path,
+        std::size_t threads,
+        Progress&& progress)
+    {
+        return nudb::verify_parallel<Hasher>(
+            dat_path, key_path, BufferSize,
+                threads, progress);
+    }
+
     template <class Function>
     static
     bool
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_NUDB_DETAIL_PARALLEL_H_INCLUDED
+#define BEAST_NUDB_DETAIL_PARALLEL_H_INCLUDED
+
+#include <beast/nudb/detail/format.h>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace beast {
+namespace nudb {
+namespace detail {
+
+// Invokes f(i) for each i in [0, threads), using one
+// thread per index. The calling thread runs index zero.
+// If any invocation throws, the first exception is
+// rethrown after all threads have joined.
+//
+template <class Function>
+void
+parallel_for (std::size_t threads, Function const& f)
+{
+    if (threads <= 1)
+    {
+        f(0);
+        return;
+    }
+    std::mutex m;
+    std::exception_ptr ep;
+    auto const run =
+        [&](std::size_t i)
+        {
+            try
+            {
+                f(i);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if (! ep)
+                    ep = std::current_exception();
+            }
+        };
+    std::vector<std::thread> v;
+    v.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i)
+        v.emplace_back(run, i);
+    run(0);
+    for (auto& t : v)
+        t.join();
+    if (ep)
+        std::rethrow_exception(ep);
+}
+
+// Returns the first index of the i-th of n
+// nearly equal parts of the range [first, last)
+//
+inline
+std::size_t
+split_range (std::size_t first, std::size_t last,
+    std::size_t n, std::size_t i)
+{
+    return first + (last - first) * i / n;
+}
+
+// A run of data records read sequentially from the
+// data file, with their hashes computed in parallel.
+//
+struct record_batch
+{
+    std::size_t key_size;
+    std::vector<std::size_t> offset;
+    std::vector<std::size_t> size;
+    std::vector<std::size_t> hash;
+    std::vector<std::uint8_t> keys;
+
+    explicit
+    record_batch (std::size_t key_size_)
+        : key_size (key_size_)
+    {
+    }
+
+    std::size_t
+    count() const
+    {
+        return offset.size();
+    }
+
+    void
+    clear()
+    {
+        offset.clear();
+        size.clear();
+        keys.clear();
+    }
+
+    void
+    add (std::size_t offset_, std::size_t size_,
+        void const* key)
+    {
+        offset.push_back(offset_);
+        size.push_back(size_);
+        auto const p = static_cast<
+            std::uint8_t const*>(key);
+        keys.insert(keys.end(), p, p + key_size);
+    }
+
+    // Compute hashes for every record
+    template <class Hasher>
+    void
+    hash_all (std::size_t salt, std::size_t threads)
+    {
+        hash.resize(count());
+        parallel_for(threads,
+            [&](std::size_t t)
+            {
+                auto const i1 = split_range(
+                    0, count(), threads, t + 1);
+                for (auto i = split_range(
+                    0, count(), threads, t); i < i1; ++i)
+                    hash[i] = detail::hash<Hasher>(
+                        keys.data() + i * key_size,
+                            key_size, salt);
+            });
+    }
+};
+
+} // detail
+} // nudb
+} // beast
+
+#endif
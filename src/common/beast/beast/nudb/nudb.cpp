@@ -19,6 +19,7 @@
 
 #include <beast/nudb/tests/callgrind_test.cpp>
 #include <beast/nudb/tests/recover_test.cpp>
+#include <beast/nudb/tests/rekey_test.cpp>
 #include <beast/nudb/tests/store_test.cpp>
 #include <beast/nudb/tests/varint_test.cpp>
 #include <beast/nudb/tests/verify_test.cpp>
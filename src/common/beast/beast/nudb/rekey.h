@@ -0,0 +1,321 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_NUDB_REKEY_H_INCLUDED
+#define BEAST_NUDB_REKEY_H_INCLUDED
+
+#include <beast/nudb/common.h>
+#include <beast/nudb/create.h>
+#include <beast/nudb/file.h>
+#include <beast/nudb/detail/bucket.h>
+#include <beast/nudb/detail/bulkio.h>
+#include <beast/nudb/detail/format.h>
+#include <beast/nudb/detail/parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace beast {
+namespace nudb {
+
+/** Build a new key file from an existing data file.
+
+    The data file is streamed sequentially and every data
+    record is inserted into a freshly sized key file using
+    the given block size and load factor. The bucket count
+    is chosen so that `item_count` records fill buckets to
+    `load_factor` on average; if `item_count` is zero the
+    data file is scanned once to count the records first.
+
+    Memory use is bounded by `buffer_size`: the key file is
+    built in contiguous runs of buckets which fit in the
+    buffer, with one pass over the data file per run. Within
+    a pass, hashing and bucket insertion are divided among
+    `threads` threads. Buckets that overflow are written as
+    spill records appended to the data file, exactly as the
+    store does during a commit. Spill records belonging to
+    the previous key file are skipped and left in place.
+
+    Preconditions:
+        The key file and log file must not exist.
+        No store may have the data file open.
+
+    Effects:
+        Creates the key file and a log file recording the
+        original data file size. If the process is interrupted,
+        `recover` rolls the data file back and empties the key
+        file, which must then be erased before trying again.
+        On success the log file is erased.
+
+    @param progress A function called with (work, total)
+    @param args Arguments passed to File constructors
+    @return `false` if the data file could not be opened or
+            the key or log file already exists.
+*/
+template <
+    class Hasher,
+    class File = native_file,
+    class Progress,
+    class... Args
+>
+bool
+rekey (
+    path_type const& dat_path,
+    path_type const& key_path,
+    path_type const& log_path,
+    std::size_t block_size,
+    float load_factor,
+    std::size_t item_count,
+    std::size_t buffer_size,
+    std::size_t threads,
+    Progress&& progress,
+    Args&&... args)
+{
+    using namespace detail;
+    if (block_size > field<std::uint16_t>::max)
+        throw std::domain_error(
+            "nudb: block size too large");
+    if (load_factor <= 0.f)
+        throw std::domain_error(
+            "nudb: load factor too small");
+    if (load_factor >= 1.f)
+        throw std::domain_error(
+            "nudb: load factor too large");
+    auto const capacity =
+        bucket_capacity(block_size);
+    if (capacity < 1)
+        throw std::domain_error(
+            "nudb: block size too small");
+    threads = std::max<std::size_t>(threads, 1);
+
+    File df(args...);
+    File kf(args...);
+    File lf(args...);
+    if (! df.open (file_mode::append, dat_path))
+        return false;
+    dat_file_header dh;
+    try
+    {
+        read (df, dh);
+    }
+    catch (file_short_read_error const&)
+    {
+        throw store_corrupt_error(
+            "short data file header");
+    }
+    verify(dh);
+    if (! kf.create (file_mode::write, key_path))
+        return false;
+    if (! lf.create (file_mode::append, log_path))
+    {
+        kf.close();
+        File::erase (key_path);
+        return false;
+    }
+    auto const df_size = df.actual_size();
+
+    // Data records are read in batches of this size
+    std::size_t const read_size =
+        std::min<std::size_t>(buffer_size,
+            16 * 1024 * 1024);
+    std::size_t const batch_size = 64 * 1024;
+
+    // Count the data records if necessary
+    std::size_t work = 0;
+    if (item_count == 0)
+    {
+        bulk_reader<File> r(df,
+            dat_file_header::size, df_size, read_size);
+        while (! r.eof())
+        {
+            progress(r.offset(), 2 * df_size);
+            auto is = r.prepare(
+                field<uint48_t>::size); // Size
+            std::size_t size;
+            read<uint48_t>(is, size);
+            if (size > 0)
+            {
+                // Data Record
+                r.prepare(dh.key_size + size);
+                ++item_count;
+            }
+            else
+            {
+                // Spill Record
+                is = r.prepare(
+                    field<std::uint16_t>::size);
+                read<std::uint16_t>(is, size);
+                r.prepare(size);
+            }
+        }
+        work = df_size;
+    }
+
+    key_file_header kh;
+    kh.version = currentVersion;
+    kh.uid = dh.uid;
+    kh.appnum = dh.appnum;
+    kh.key_size = dh.key_size;
+    kh.salt = make_salt();
+    kh.pepper = pepper<Hasher>(kh.salt);
+    kh.block_size = block_size;
+    kh.load_factor = std::min<std::size_t>(
+        65536.0 * load_factor, 65535);
+    kh.capacity = capacity;
+    kh.bucket_size = bucket_size(capacity);
+    kh.buckets = std::max<std::size_t>(1,
+        static_cast<std::size_t>(std::ceil(
+            item_count / (capacity * load_factor))));
+    kh.modulus = ceil_pow2(kh.buckets);
+
+    // Write the header and empty buckets first so
+    // the key file always has its final size.
+    auto const nbuckets = std::max<std::size_t>(1,
+        buffer_size / block_size);
+    buffer buf(nbuckets * block_size);
+    std::memset(buf.get(), 0, nbuckets * block_size);
+    write (kf, kh);
+    for (std::size_t b0 = 0; b0 < kh.buckets;
+        b0 += nbuckets)
+    {
+        auto const bn = std::min(
+            nbuckets, kh.buckets - b0);
+        kf.write((b0 + 1) * block_size,
+            buf.get(), bn * block_size);
+    }
+    kf.sync();
+
+    // Spill records are appended to the data file,
+    // the log lets recovery remove them.
+    log_file_header lh;
+    lh.version = currentVersion;
+    lh.uid = kh.uid;
+    lh.appnum = kh.appnum;
+    lh.key_size = kh.key_size;
+    lh.salt = kh.salt;
+    lh.pepper = kh.pepper;
+    lh.block_size = kh.block_size;
+    lh.key_file_size = 0;
+    lh.dat_file_size = df_size;
+    write (lf, lh);
+    lf.sync();
+
+    std::size_t const passes =
+        (kh.buckets + nbuckets - 1) / nbuckets;
+    std::size_t const total = work + passes * df_size;
+    std::mutex m;
+    bulk_writer<File> w(df, df_size, read_size);
+    record_batch batch(kh.key_size);
+    for (std::size_t b0 = 0; b0 < kh.buckets;
+        b0 += nbuckets)
+    {
+        auto const b1 = std::min(
+            b0 + nbuckets, kh.buckets);
+        // Buffered range is [b0, b1)
+        auto const bn = b1 - b0;
+        std::memset(buf.get(), 0, bn * block_size);
+        auto const insert_all =
+            [&]()
+            {
+                batch.hash_all<Hasher>(kh.salt, threads);
+                // Each thread owns a sub-range of the buckets
+                parallel_for(threads,
+                    [&](std::size_t t)
+                    {
+                        auto const t0 = split_range(
+                            b0, b1, threads, t);
+                        auto const t1 = split_range(
+                            b0, b1, threads, t + 1);
+                        for (std::size_t i = 0;
+                            i < batch.count(); ++i)
+                        {
+                            auto const n = bucket_index(
+                                batch.hash[i], kh.buckets,
+                                    kh.modulus);
+                            if (n < t0 || n >= t1)
+                                continue;
+                            bucket b (block_size, buf.get() +
+                                (n - b0) * block_size);
+                            if (b.full())
+                            {
+                                std::lock_guard<
+                                    std::mutex> lock(m);
+                                maybe_spill(b, w);
+                            }
+                            b.insert (batch.offset[i],
+                                batch.size[i], batch.hash[i]);
+                        }
+                    });
+                batch.clear();
+            };
+        bulk_reader<File> r(df,
+            dat_file_header::size, df_size, read_size);
+        while (! r.eof())
+        {
+            auto const offset = r.offset();
+            progress(work + offset, total);
+            // Data Record or Spill Record
+            auto is = r.prepare(
+                field<uint48_t>::size); // Size
+            std::size_t size;
+            read<uint48_t>(is, size);
+            if (size > 0)
+            {
+                // Data Record
+                is = r.prepare(
+                    kh.key_size +       // Key
+                    size);              // Data
+                batch.add(offset, size,
+                    is.data(kh.key_size));
+                if (batch.count() >= batch_size)
+                    insert_all();
+            }
+            else
+            {
+                // Spill Record
+                is = r.prepare(
+                    field<std::uint16_t>::size);
+                read<std::uint16_t>(is, size);  // Size
+                r.prepare(size);                // Bucket
+            }
+        }
+        insert_all();
+        w.flush();
+        kf.write((b0 + 1) * block_size,
+            buf.get(), bn * block_size);
+        work += df_size;
+    }
+    progress(total, total);
+    df.sync();
+    kf.sync();
+    lf.trunc(0);
+    lf.sync();
+    lf.close();
+    File::erase (log_path);
+    return true;
+}
+
+} // nudb
+} // beast
+
+#endif
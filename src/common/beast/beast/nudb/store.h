@@ -51,6 +51,7 @@
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #if DOXYGEN
 #include <beast/nudb/README.md>
@@ -253,6 +254,29 @@ public:
     bool
     fetch (void const* key, Handler&& handler);
 
+    /** Fetch several values.
+
+        Keys still in the insert pools or in cached buckets are
+        looked up first. The rest are grouped by bucket so that each
+        bucket is read from the key file once, and the groups are
+        handed to the launcher, which may run them concurrently:
+            `(void)()(std::size_t groups, F&& f)`
+        must call `f(i)` once for each i in [0, groups) and return
+        when all calls have returned, rethrowing any exception.
+
+        For each key found, Handler will be called as:
+            `(void)()(std::size_t index,
+                void const* data, std::size_t size)`
+        where index is the position of the key in keys. Calls may
+        come from the launcher's threads, concurrently.
+
+        @return The number of keys found.
+    */
+    template <class Handler, class Launcher>
+    std::size_t
+    fetch_batch (std::size_t count, void const* const* keys,
+        Handler&& handler, Launcher&& launch);
+
     /** Insert a value.
 
         Returns:
@@ -459,6 +483,103 @@ next:
     return fetch(h, key, b, handler);
 }
 
+template <class Hasher, class Codec, class File>
+template <class Handler, class Launcher>
+std::size_t
+store<Hasher, Codec, File>::fetch_batch (
+    std::size_t count, void const* const* keys,
+        Handler&& handler, Launcher&& launch)
+{
+    using namespace detail;
+    rethrow();
+    struct pending
+    {
+        std::size_t bucket;
+        std::size_t hash;
+        std::size_t index;
+    };
+    std::vector<pending> todo;
+    todo.reserve(count);
+    std::atomic<std::size_t> found (0);
+    shared_lock_type m (m_);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto const key = keys[i];
+        auto const h = hash<Hasher>(
+            key, s_->kh.key_size, s_->kh.salt);
+        bool pooled = true;
+        auto iter = s_->p1.find(key);
+        if (iter == s_->p1.end())
+        {
+            iter = s_->p0.find(key);
+            pooled = iter != s_->p0.end();
+        }
+        if (pooled)
+        {
+            buffer buf;
+            auto const result =
+                s_->codec.decompress(
+                    iter->first.data,
+                        iter->first.size, buf);
+            handler(i, result.first, result.second);
+            ++found;
+            continue;
+        }
+        auto const n = bucket_index(
+            h, buckets_, modulus_);
+        auto const citer = s_->c1.find(n);
+        if (citer != s_->c1.end())
+        {
+            if (fetch(h, key, citer->second,
+                [&](void const* data, std::size_t size)
+                {
+                    handler(i, data, size);
+                }))
+                ++found;
+            continue;
+        }
+        todo.push_back(pending{n, h, i});
+    }
+    if (todo.empty())
+        return found;
+    //  Audit for concurrency
+    genlock <gentex> g (g_);
+    m.unlock();
+    // Keys sharing a bucket share one key file read
+    std::sort(todo.begin(), todo.end(),
+        [](pending const& lhs, pending const& rhs)
+        {
+            return lhs.bucket < rhs.bucket;
+        });
+    std::vector<std::size_t> groups;
+    for (std::size_t i = 0; i < todo.size(); ++i)
+        if (i == 0 || todo[i].bucket != todo[i - 1].bucket)
+            groups.push_back(i);
+    groups.push_back(todo.size());
+    launch(groups.size() - 1,
+        [&](std::size_t group)
+        {
+            auto const first = groups[group];
+            auto const last = groups[group + 1];
+            buffer buf (s_->kh.block_size);
+            bucket b (s_->kh.block_size,
+                buf.get());
+            b.read (s_->kf,
+                (todo[first].bucket + 1) * b.block_size());
+            for (auto i = first; i < last; ++i)
+            {
+                auto const index = todo[i].index;
+                if (fetch(todo[i].hash, keys[index], b,
+                    [&](void const* data, std::size_t size)
+                    {
+                        handler(index, data, size);
+                    }))
+                    ++found;
+            }
+        });
+    return found;
+}
+
 template <class Hasher, class Codec, class File>
 bool
 store<Hasher, Codec, File>::insert (
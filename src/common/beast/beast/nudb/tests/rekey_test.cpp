@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <beast/nudb/tests/common.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/module/core/files/File.h>
+#include <beast/unit_test/suite.h>
+#include <cstring>
+#include <string>
+
+namespace beast {
+namespace nudb {
+namespace test {
+
+// Builds a store, discards its key file, then rebuilds
+// the key file from the data file with rekey and checks
+// that every value is still reachable. Load factor is
+// set high to ensure that spill records are created.
+//
+class rekey_test : public unit_test::suite
+{
+public:
+    void
+    do_test (std::size_t N, std::size_t block_size,
+        std::size_t new_block_size, float load_factor,
+            std::size_t item_count, std::size_t threads)
+    {
+        testcase (abort_on_fail) << "rekey " <<
+            N << " items, " << threads << " threads";
+        std::string const path =
+            beast::UnitTestUtilities::TempDirectory(
+                "test_db").getFullPathName().toStdString();
+        auto const dp = path + ".dat";
+        auto const kp = path + ".key";
+        auto const lp = path + ".log";
+        Sequence seq;
+        test_api::store db;
+        auto const no_progress =
+            [](std::size_t, std::size_t)
+            {
+            };
+        try
+        {
+            expect (test_api::create (dp, kp, lp, appnum,
+                salt, sizeof(key_type), block_size,
+                    load_factor), "create");
+            expect (db.open(dp, kp, lp,
+                arena_alloc_size), "open");
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                auto const v = seq[i];
+                expect (db.insert(
+                    &v.key, v.data, v.size), "insert");
+            }
+            db.close();
+            expect (test_api::file_type::erase(kp));
+            // A small buffer forces several passes
+            expect (rekey<test_api::hash_type,
+                test_api::file_type>(dp, kp, lp,
+                    new_block_size, load_factor, item_count,
+                        16 * new_block_size, threads,
+                            no_progress), "rekey");
+            expect (! test_api::file_type::erase(lp),
+                "log file remains");
+            auto const stats = verify<test_api::hash_type>(
+                dp, kp, 1 * 1024 * 1024);
+            expect (stats.value_count == N, "value count");
+            expect (stats.key_count == N, "key count");
+            auto const pstats = verify_parallel<
+                test_api::hash_type>(dp, kp,
+                    1 * 1024 * 1024, threads, no_progress);
+            expect (pstats.value_count == stats.value_count &&
+                pstats.key_count == stats.key_count &&
+                pstats.spill_count == stats.spill_count &&
+                pstats.spill_bytes == stats.spill_bytes &&
+                pstats.hist == stats.hist,
+                    "verify_parallel mismatch");
+            expect (db.open(dp, kp, lp,
+                arena_alloc_size), "reopen");
+            Storage s;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                auto const v = seq[i];
+                bool const found = db.fetch (&v.key, s);
+                expect (found, "not found");
+                expect (s.size() == v.size &&
+                    std::memcmp(s.get(), v.data,
+                        v.size) == 0, "wrong data");
+            }
+            for (std::size_t i = N; i < 2 * N; ++i)
+            {
+                auto const v = seq[i];
+                expect (db.insert(
+                    &v.key, v.data, v.size), "insert after");
+            }
+            db.close();
+            verify<test_api::hash_type>(
+                dp, kp, 1 * 1024 * 1024);
+        }
+        catch (nudb::store_error const& e)
+        {
+            fail (e.what());
+        }
+        catch (std::exception const& e)
+        {
+            fail (e.what());
+        }
+        expect (test_api::file_type::erase(dp));
+        expect (test_api::file_type::erase(kp));
+        expect (! test_api::file_type::erase(lp));
+    }
+
+    void
+    run() override
+    {
+        enum
+        {
+        #ifndef NDEBUG
+            N =             5000 // debug
+        #else
+            N =             50000
+        #endif
+            ,block_size =   256
+        };
+
+        do_test (N, block_size, block_size, 0.95f, 0, 1);
+        // Old spill records no longer match the bucket size
+        do_test (N, block_size, 2 * block_size, 0.5f, N, 4);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(rekey,nudb,beast);
+
+} // test
+} // nudb
+} // beast
@@ -24,10 +24,13 @@
 #include <beast/random/xor_shift_engine.h>
 #include <beast/unit_test/suite.h>
 #include <cmath>
+#include <functional>
 #include <iomanip>
 #include <memory>
 #include <random>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace beast {
 namespace nudb {
@@ -99,6 +102,47 @@ public:
                 expect (db.insert(&v.key, v.data, v.size),
                     "insert 2");
             }
+            // fetch_batch, including keys never inserted
+            {
+                std::vector<key_type> keys;
+                for (std::size_t i = 0; i < 3 * N; ++i)
+                    keys.push_back(seq[i].key);
+                std::vector<void const*> pkeys;
+                for (auto const& key : keys)
+                    pkeys.push_back(&key);
+                std::vector<std::string> values (keys.size());
+                std::vector<bool> found (keys.size());
+                auto const count = db.fetch_batch (
+                    pkeys.size(), pkeys.data(),
+                    [&](std::size_t i,
+                        void const* data, std::size_t size)
+                    {
+                        found[i] = true;
+                        values[i].assign (
+                            static_cast<char const*>(data), size);
+                    },
+                    [](std::size_t groups,
+                        std::function<void(std::size_t)> const& f)
+                    {
+                        for (std::size_t i = 0; i < groups; ++i)
+                            f(i);
+                    });
+                expect (count == 2 * N, "fetch_batch count");
+                for (std::size_t i = 0; i < 3 * N; ++i)
+                {
+                    auto const v = seq[i];
+                    if (i >= 2 * N)
+                    {
+                        expect (! found[i], "fetch_batch phantom");
+                        continue;
+                    }
+                    expect (found[i], "fetch_batch missing");
+                    expect (values[i].size() == v.size &&
+                        std::memcmp(values[i].data(),
+                            v.data, v.size) == 0,
+                                "fetch_batch wrong data");
+                }
+            }
             db.close();
             //auto const stats = test_api::verify(dp, kp);
             auto const stats = verify<test_api::hash_type>(
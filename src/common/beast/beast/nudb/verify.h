@@ -25,9 +25,11 @@
 #include <beast/nudb/detail/bucket.h>
 #include <beast/nudb/detail/bulkio.h>
 #include <beast/nudb/detail/format.h>
+#include <beast/nudb/detail/parallel.h>
 #include <algorithm>
 #include <cstddef>
 #include <string>
+#include <vector>
 
 namespace beast {
 namespace nudb {
@@ -210,8 +212,17 @@ verify (
                     field<std::uint16_t>::size);
                 read<std::uint16_t>(is, size);  // Size
                 if (size != kh.bucket_size)
-                    throw store_corrupt_error(
-                        "bad spill size");
+                {
+                    // Left by a rekey to a different
+                    // block size, never referenced.
+                    r.prepare(size);
+                    ++info.spill_count_tot;
+                    info.spill_bytes_tot +=
+                        field<uint48_t>::size +     // Zero
+                        field<uint16_t>::size +     // Size
+                        size;                       // Bucket
+                    continue;
+                }
                 b.read(r);                      // Bucket
                 ++info.spill_count_tot;
                 info.spill_bytes_tot +=
@@ -482,8 +493,20 @@ verify_fast (
                     field<std::uint16_t>::size);
                 read<std::uint16_t>(is, size);      // Size
                 if (size != kh.bucket_size)
-                    throw store_corrupt_error(
-                        "bad spill size");
+                {
+                    // Left by a rekey to a different
+                    // block size, never referenced.
+                    r.prepare(size);
+                    if (b0 == 0)
+                    {
+                        ++info.spill_count_tot;
+                        info.spill_bytes_tot +=
+                            field<uint48_t>::size +     // Zero
+                            field<uint16_t>::size +     // Size
+                            size;                       // Bucket
+                    }
+                    continue;
+                }
                 tmp.read(r);                        // Bucket
                 if (b0 == 0)
                 {
@@ -526,6 +549,300 @@ verify_fast (
     return info;
 }
 
+
+/** Verify consistency of the key and data files.
+    Effects:
+        Opens the key and data files in read-only mode.
+        Throws file_error if a file can't be opened.
+        Iterates the key and data files, throws store_corrupt_error
+            on broken invariants.
+    This performs the same checks as verify, but divides the
+    random reads among `threads` threads: the data file is
+    still scanned sequentially, while the bucket lookups for
+    each batch of data records and the walk of each range of
+    the key file are done in parallel.
+*/
+template <class Hasher, class Progress>
+verify_info
+verify_parallel (
+    path_type const& dat_path,
+    path_type const& key_path,
+    std::size_t read_size,
+    std::size_t threads,
+    Progress&& progress)
+{
+    using namespace detail;
+    using File = native_file;
+    File df;
+    File kf;
+    if (! df.open (file_mode::scan, dat_path))
+        throw store_corrupt_error(
+            "no data file");
+    if (! kf.open (file_mode::read, key_path))
+        throw store_corrupt_error(
+            "no key file");
+    key_file_header kh;
+    dat_file_header dh;
+    read (df, dh);
+    read (kf, kh);
+    verify(dh);
+    verify<Hasher>(dh, kh);
+    threads = std::max<std::size_t>(threads, 1);
+
+    verify_info info;
+    info.version = dh.version;
+    info.uid = dh.uid;
+    info.appnum = dh.appnum;
+    info.key_size = dh.key_size;
+    info.salt = kh.salt;
+    info.pepper = kh.pepper;
+    info.block_size = kh.block_size;
+    info.load_factor = kh.load_factor / 65536.f;
+    info.capacity = kh.capacity;
+    info.buckets = kh.buckets;
+    info.bucket_size = kh.bucket_size;
+    info.key_file_size = kf.actual_size();
+    info.dat_file_size = df.actual_size();
+
+    // Data Record
+    auto const dh_len =
+        field<uint48_t>::size + // Size
+        kh.key_size;            // Key
+
+    // Per-thread results, merged at the end
+    std::vector<verify_info> parts(threads);
+    std::vector<std::size_t> fetches(threads);
+
+    auto const df_size = info.dat_file_size;
+    std::size_t const work = df_size + kh.buckets;
+
+    // Iterate Data File
+    {
+        record_batch batch(kh.key_size);
+        auto const check_all =
+            [&]()
+            {
+                batch.hash_all<Hasher>(kh.salt, threads);
+                parallel_for(threads,
+                    [&](std::size_t t)
+                    {
+                        auto& part = parts[t];
+                        buffer buf (kh.block_size);
+                        bucket b (kh.block_size, buf.get());
+                        auto const i1 = split_range(
+                            0, batch.count(), threads, t + 1);
+                        for (auto i = split_range(0,
+                            batch.count(), threads, t); i < i1; ++i)
+                        {
+                            auto const h = batch.hash[i];
+                            auto const offset = batch.offset[i];
+                            // Check bucket and spills
+                            try
+                            {
+                                auto const n = bucket_index(
+                                    h, kh.buckets, kh.modulus);
+                                b.read (kf, (n + 1) * kh.block_size);
+                                ++fetches[t];
+                            }
+                            catch (file_short_read_error const&)
+                            {
+                                throw store_corrupt_error(
+                                    "short bucket");
+                            }
+                            for (;;)
+                            {
+                                for (auto j = b.lower_bound(h);
+                                    j < b.size(); ++j)
+                                {
+                                    auto const item = b[j];
+                                    if (item.hash != h)
+                                        break;
+                                    if (item.offset == offset)
+                                        goto found;
+                                    ++fetches[t];
+                                }
+                                auto const spill = b.spill();
+                                if (! spill)
+                                    throw store_corrupt_error(
+                                        "orphaned value");
+                                try
+                                {
+                                    b.read (df, spill);
+                                    ++fetches[t];
+                                }
+                                catch (file_short_read_error const&)
+                                {
+                                    throw store_corrupt_error(
+                                        "short spill");
+                                }
+                            }
+                        found:
+                            // Update
+                            ++part.value_count;
+                            part.value_bytes += batch.size[i];
+                        }
+                    });
+                batch.clear();
+            };
+        buffer buf (kh.block_size);
+        bucket b (kh.block_size, buf.get());
+        bulk_reader<File> r(df,
+            dat_file_header::size, df_size, read_size);
+        while (! r.eof())
+        {
+            auto const offset = r.offset();
+            progress(offset, work);
+            // Data Record or Spill Record
+            auto is = r.prepare(
+                field<uint48_t>::size); // Size
+            std::size_t size;
+            read<uint48_t>(is, size);
+            if (size > 0)
+            {
+                // Data Record
+                is = r.prepare(
+                    kh.key_size +           // Key
+                    size);                  // Data
+                batch.add(offset, size,
+                    is.data(kh.key_size));
+                if (batch.count() >= 64 * 1024)
+                    check_all();
+            }
+            else
+            {
+                // Spill Record
+                is = r.prepare(
+                    field<std::uint16_t>::size);
+                read<std::uint16_t>(is, size);  // Size
+                if (size != kh.bucket_size)
+                {
+                    // Left by a rekey to a different
+                    // block size, never referenced.
+                    r.prepare(size);
+                    ++info.spill_count_tot;
+                    info.spill_bytes_tot +=
+                        field<uint48_t>::size +     // Zero
+                        field<uint16_t>::size +     // Size
+                        size;                       // Bucket
+                    continue;
+                }
+                b.read(r);                      // Bucket
+                ++info.spill_count_tot;
+                info.spill_bytes_tot +=
+                    field<uint48_t>::size +     // Zero
+                    field<uint16_t>::size +     // Size
+                    b.compact_size();           // Bucket
+            }
+        }
+        check_all();
+    }
+
+    // Iterate Key File
+    std::size_t const chunk = threads * 4096;
+    for (std::size_t b0 = 0; b0 < kh.buckets; b0 += chunk)
+    {
+        progress(df_size + b0, work);
+        auto const b1 = std::min(b0 + chunk, kh.buckets);
+        parallel_for(threads,
+            [&](std::size_t t)
+            {
+                auto& part = parts[t];
+                buffer buf (kh.block_size + dh_len);
+                bucket b (kh.block_size, buf.get());
+                std::uint8_t* pd = buf.get() + kh.block_size;
+                auto const n1 = split_range(b0, b1, threads, t + 1);
+                for (auto n = split_range(
+                    b0, b1, threads, t); n < n1; ++n)
+                {
+                    std::size_t nspill = 0;
+                    b.read (kf, (n + 1) * kh.block_size);
+                    for(;;)
+                    {
+                        part.key_count += b.size();
+                        for (std::size_t i = 0; i < b.size(); ++i)
+                        {
+                            auto const e = b[i];
+                            try
+                            {
+                                df.read (e.offset, pd, dh_len);
+                            }
+                            catch (file_short_read_error const&)
+                            {
+                                throw store_corrupt_error(
+                                    "missing value");
+                            }
+                            // Data Record
+                            istream is(pd, dh_len);
+                            std::size_t size;
+                            read<uint48_t>(is, size);   // Size
+                            void const* key =
+                                is.data(kh.key_size);   // Key
+                            if (size != e.size)
+                                throw store_corrupt_error(
+                                    "wrong size");
+                            auto const h = hash<Hasher>(key,
+                                kh.key_size, kh.salt);
+                            if (h != e.hash)
+                                throw store_corrupt_error(
+                                    "wrong hash");
+                        }
+                        if (! b.spill())
+                            break;
+                        try
+                        {
+                            b.read (df, b.spill());
+                            ++nspill;
+                            ++part.spill_count;
+                            part.spill_bytes +=
+                                field<uint48_t>::size + // Zero
+                                field<uint16_t>::size + // Size
+                                b.compact_size();       // SpillBucket
+                        }
+                        catch (file_short_read_error const&)
+                        {
+                            throw store_corrupt_error(
+                                "missing spill");
+                        }
+                    }
+                    if (nspill >= part.hist.size())
+                        nspill = part.hist.size() - 1;
+                    ++part.hist[nspill];
+                }
+            });
+    }
+    progress(work, work);
+
+    std::size_t nfetches = 0;
+    for (std::size_t t = 0; t < threads; ++t)
+    {
+        auto const& part = parts[t];
+        nfetches += fetches[t];
+        info.value_count += part.value_count;
+        info.value_bytes += part.value_bytes;
+        info.key_count += part.key_count;
+        info.spill_count += part.spill_count;
+        info.spill_bytes += part.spill_bytes;
+        for (std::size_t i = 0; i < info.hist.size(); ++i)
+            info.hist[i] += part.hist[i];
+    }
+
+    info.avg_fetch = float(nfetches) / info.value_count;
+    info.waste = (info.spill_bytes_tot - info.spill_bytes) /
+        float(info.dat_file_size);
+    info.overhead =
+        float(info.key_file_size + info.dat_file_size) /
+        (
+            info.value_bytes +
+            info.key_count *
+                (info.key_size +
+                // Data Record
+                 field<uint48_t>::size) // Size
+                    ) - 1;
+    info.actual_load = info.key_count / float(
+        info.capacity * info.buckets);
+    return info;
+}
+
 } // nudb
 } // beast
 
@@ -178,6 +178,7 @@ public:
         NORMAL,
         LOAD,
         LOAD_FILE,
+        LOAD_SNAPSHOT,
         REPLAY,
         NETWORK
     };
@@ -72,6 +72,7 @@ struct ConfigSection
 #define SECTION_VALIDATORS              "validators"
 #define SECTION_VALIDATORS_SITE         "validators_site"
 #define SECTION_MYSQL_CONFIG            "mysql_config"
+#define SECTION_TX_INDEX                "tx_index"
 
 } // bessel
 
@@ -44,14 +44,18 @@ enum JobType
     jtLEDGER_REQ,    // Peer request ledger/txnset data
     jtPROPOSAL_ut,   // A proposal from an untrusted source
     jtLEDGER_DATA,   // Received data for a ledger we're acquiring
+    jtLEDGER_DECODE, // Decode and hash received ledger nodes
+    jtLEDGER_SNAPSHOT, // Decode and build a ledger from a snapshot
     jtCLIENT,        // A websocket command from the client
     jtRPC,           // A websocket command from the client
     jtUPDATE_PF,     // Update pathfinding requests
+    jtPATH_EVAL,     // Evaluate the paths of a payment pass
     jtTRANSACTION,   // A transaction received from the network
     jtUNL,           // A Score or Fetch of the UNL (DEPRECATED)
     jtADVANCE,       // Advance validated/acquired ledgers
     jtPUBLEDGER,     // Publish a fully-accepted ledger
     jtTXN_DATA,      // Fetch a proposed set
+    jtTXN_PREFLIGHT, // Check an acquired transaction set ahead of accept
     jtWAL,           // Write-ahead logging
     jtVALIDATION_t,  // A validation from a trusted source
     jtWRITE,         // Write out hashed objects
@@ -66,6 +66,14 @@ public:
         add (jtLEDGER_DATA,   "ledgerData",
             2,        true,   false, 0,     0);
 
+        // Decode and hash nodes received for a ledger we're acquiring
+        add (jtLEDGER_DECODE, "decodeLedgerData",
+            maxLimit, true,   false, 0,     0);
+
+        // Decode chunks and build maps while loading a ledger snapshot
+        add (jtLEDGER_SNAPSHOT, "ledgerSnapshot",
+            maxLimit, true,   false, 0,     0);
+
         // A websocket command from the client
         add (jtCLIENT,        "clientCommand",
             maxLimit, true,   false, 2000,  5000);
@@ -78,6 +86,10 @@ public:
         add (jtUPDATE_PF,     "updatePaths",
             maxLimit, true,   false, 0,     0);
 
+        // Evaluate the paths of a payment pass concurrently
+        add (jtPATH_EVAL,     "evaluatePaths",
+            maxLimit, true,   false, 0,     0);
+
         // A transaction received from the network
         add (jtTRANSACTION,   "transaction",
             maxLimit, true,   false, 250,   1000);
@@ -98,6 +110,10 @@ public:
         add (jtTXN_DATA,      "fetchTxnData",
             1,        true,   false, 0,     0);
 
+        // Check signatures and fees of an acquired transaction set
+        add (jtTXN_PREFLIGHT, "preflightTxnSet",
+            maxLimit, true,   false, 0,     0);
+
         // Write-ahead logging
         add (jtWAL,           "writeAhead",
             maxLimit, false,  false, 1000,  2500);
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_CORE_PARALLELFOR_H_INCLUDED
+#define BESSEL_CORE_PARALLELFOR_H_INCLUDED
+
+#include <common/core/JobQueue.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace bessel {
+
+/** Invoke a function for every index in [0, count) using the JobQueue.
+
+    Up to 'helpers' jobs of the given type are queued to share the work. The
+    calling thread participates as well and does not return until every index
+    has been processed, so the call completes even if no helper job ever gets
+    a thread (for example while the queue is stopping or saturated). Helper
+    jobs that start after all indexes were claimed return immediately.
+
+    The function must be safe to call concurrently for distinct indexes and
+    must not throw.
+*/
+template <class Function>
+void
+parallelFor (JobQueue& jobQueue, JobType type, std::string const& name,
+    std::size_t count, std::size_t helpers, Function&& func)
+{
+    if (count == 0)
+        return;
+
+    struct State
+    {
+        std::function <void (std::size_t)> func;
+        std::size_t count;
+        std::atomic <std::size_t> next;
+        std::size_t finished;
+        std::mutex mutex;
+        std::condition_variable cond;
+
+        State (std::function <void (std::size_t)> f, std::size_t n)
+            : func (std::move (f)), count (n), next (0), finished (0)
+        {
+        }
+
+        void run ()
+        {
+            std::size_t done = 0;
+            for (std::size_t i = next++; i < count; i = next++)
+            {
+                func (i);
+                ++done;
+            }
+
+            if (done != 0)
+            {
+                std::lock_guard <std::mutex> lock (mutex);
+                finished += done;
+                if (finished == count)
+                    cond.notify_all ();
+            }
+        }
+    };
+
+    auto state = std::make_shared <State> (
+        std::forward <Function> (func), count);
+
+    helpers = std::min (helpers, count - 1);
+    for (std::size_t i = 0; i < helpers; ++i)
+    {
+        jobQueue.addJob (type, name,
+            [state] (Job&) { state->run (); });
+    }
+
+    state->run ();
+
+    std::unique_lock <std::mutex> lock (state->mutex);
+    state->cond.wait (lock, [&state] { return state->finished == state->count; });
+}
+
+} // bessel
+
+#endif
@@ -0,0 +1,257 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_JSON_FASTREADER_H_INCLUDED
+#define BESSEL_JSON_FASTREADER_H_INCLUDED
+
+#include <common/json/json_value.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Json {
+
+class FastReader;
+
+/** A read-only view of one value inside a FastReader tape.
+
+    The accessors mirror the const interface of Json::Value, including its
+    conversions and the exceptions they throw, so code written against
+    Json::Value can be instantiated on a TapeValue and behave identically.
+    A default-constructed TapeValue is null. Views are only valid while the
+    FastReader that produced them is alive and unchanged.
+*/
+class TapeValue
+{
+public:
+    TapeValue () = default;
+
+    ValueType type () const;
+
+    bool isNull () const
+    {
+        return type () == nullValue;
+    }
+
+    bool isBool () const
+    {
+        return type () == booleanValue;
+    }
+
+    bool isInt () const
+    {
+        return type () == intValue;
+    }
+
+    bool isUInt () const
+    {
+        return type () == uintValue;
+    }
+
+    bool isDouble () const
+    {
+        return type () == realValue;
+    }
+
+    bool isString () const
+    {
+        return type () == stringValue;
+    }
+
+    bool isArray () const
+    {
+        return type () == arrayValue;
+    }
+
+    bool isObject () const
+    {
+        return type () == objectValue;
+    }
+
+    std::string asString () const;
+    Int asInt () const;
+    UInt asUInt () const;
+    double asDouble () const;
+    bool asBool () const;
+
+    /** Number of elements or members, zero for everything else. */
+    UInt size () const;
+
+    bool empty () const
+    {
+        return isNull () || ((isArray () || isObject ()) && size () == 0);
+    }
+
+    bool isValidIndex (UInt index) const
+    {
+        return index < size ();
+    }
+
+    /** Array element, or null if out of range or not an array. */
+    TapeValue operator[] (UInt index) const;
+
+    TapeValue operator[] (int index) const
+    {
+        return (*this)[UInt (index)];
+    }
+
+    /** Object member, or null if absent or not an object. */
+    TapeValue operator[] (char const* key) const;
+    TapeValue operator[] (std::string const& key) const;
+    TapeValue operator[] (StaticString const& key) const;
+
+    bool isMember (char const* key) const;
+    bool isMember (std::string const& key) const;
+    bool isMember (StaticString const& key) const;
+
+    /** Member names in key order, as Json::Value would iterate them. */
+    std::vector <std::string> getMemberNames () const;
+
+    /** Build an equivalent Json::Value. */
+    Value toValue () const;
+
+private:
+    friend class FastReader;
+
+    TapeValue (FastReader const* reader, std::size_t index)
+        : reader_ (reader)
+        , index_ (index)
+    {
+    }
+
+    TapeValue find (char const* key, std::size_t size) const;
+
+    FastReader const* reader_ = nullptr;
+    std::size_t index_ = 0;
+};
+
+//------------------------------------------------------------------------------
+
+/** Parses a JSON document into a flat tape instead of a tree of Values.
+
+    The structural scan skips whitespace and finds string terminators
+    sixteen bytes at a time with SSE2 where available. Strings without
+    escapes are referenced in place, numbers are decoded once, and every
+    array and object records the tape position of its children so indexing
+    is constant time. Object members are sorted by key once, when the
+    object closes, so member lookup is a binary search. The whole document
+    costs a few vector growths rather than one allocation per value.
+
+    The reader is deliberately stricter than Json::Reader: it rejects
+    comments, trailing content, duplicate keys and anything outside the
+    JSON grammar. Callers should fall back to Json::Reader when parse()
+    fails, so the set of accepted documents and the errors reported for
+    bad ones are unchanged.
+*/
+class FastReader
+{
+public:
+    FastReader () = default;
+    FastReader (FastReader const&) = delete;
+    FastReader& operator= (FastReader const&) = delete;
+
+    /** Parse a document, which must be an object or an array.
+        The text is kept by the reader; strings refer into it.
+        @return `true` on success.
+    */
+    bool parse (std::string document);
+
+    /** The root of the last successful parse. */
+    TapeValue root () const
+    {
+        return TapeValue (this, 0);
+    }
+
+    /** Number of tape entries, for diagnostics. */
+    std::size_t tapeSize () const
+    {
+        return tape_.size ();
+    }
+
+private:
+    friend class TapeValue;
+
+    struct Node
+    {
+        ValueType type;
+
+        // Strings: length. Arrays and objects: number of children.
+        std::uint32_t count;
+
+        // Tape position one past the end of this value.
+        std::uint32_t next;
+
+        union
+        {
+            Int int_;
+            UInt uint_;
+            double real_;
+            bool bool_;
+            char const* string_;
+
+            // Arrays and objects: offset of the first entry in children_.
+            std::uint32_t children_;
+        } value;
+    };
+
+    char const* parseString (char const* p, char const* end);
+    char const* parseNumber (char const* p, char const* end);
+    char const* parseLiteral (char const* p, char const* end);
+    bool close (std::size_t index);
+
+    static bool keyLess (Node const& key, char const* other, std::size_t size);
+
+    std::string text_;
+    std::vector <Node> tape_;
+
+    // Tape positions of the children of each array, and of the keys of
+    // each object in key order (the value follows its key).
+    std::vector <std::uint32_t> children_;
+
+    // Strings which contained escapes, decoded.
+    std::deque <std::string> decoded_;
+
+    // Scratch space for parsing.
+    std::vector <std::uint32_t> stack_;
+};
+
+//------------------------------------------------------------------------------
+
+/** Parse a document, building a FastReader tape only when it is wanted.
+
+    @a root always receives the document, with the accepted input and the
+    errors for bad input unchanged from Json::Reader.
+
+    Only documents that contain @a key as a quoted string are parsed with
+    @a reader, and @a root is then built from the tape, which @a tape
+    views. Everything else, and any document the fast reader declines,
+    goes through Json::Reader alone and leaves @a tape null, so requests
+    that never read from a tape pay nothing for one.
+
+    @return `true` if the document was parsed.
+*/
+bool parse (FastReader& reader, std::string const& document,
+    Value& root, TapeValue& tape, StaticString const& key);
+
+} // Json
+
+#endif
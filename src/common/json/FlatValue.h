@@ -0,0 +1,282 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_JSON_FLATVALUE_H_INCLUDED
+#define BESSEL_JSON_FLATVALUE_H_INCLUDED
+
+#include <common/json/json_value.h>
+#include <boost/utility/string_ref.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Json {
+
+/** A bump allocator for building one response.
+
+    Memory is taken from large blocks and is only released when the Arena is
+    destroyed, so building a document costs a handful of heap allocations
+    instead of one per member, key and string.
+*/
+class Arena
+{
+public:
+    static std::size_t const defaultBlockSize = 64 * 1024;
+
+    explicit Arena (std::size_t blockSize = defaultBlockSize);
+    Arena (Arena const&) = delete;
+    Arena& operator= (Arena const&) = delete;
+
+    void* allocate (std::size_t size, std::size_t align);
+
+    /** Copy a string into the arena and terminate it. */
+    char const* copy (char const* s, std::size_t size);
+
+    /** Number of blocks taken from the heap. */
+    std::size_t blocks () const
+    {
+        return blocks_.size ();
+    }
+
+    /** Number of bytes handed out, including alignment padding. */
+    std::size_t used () const
+    {
+        return used_;
+    }
+
+private:
+    std::size_t const blockSize_;
+    std::vector <std::unique_ptr <char[]>> blocks_;
+    char* current_ = nullptr;
+    std::size_t remaining_ = 0;
+    std::size_t used_ = 0;
+};
+
+/** A standard allocator drawing from an Arena. Deallocation is a no-op. */
+template <class T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator (Arena& arena) noexcept
+        : arena_ (&arena)
+    {
+    }
+
+    template <class U>
+    ArenaAllocator (ArenaAllocator <U> const& other) noexcept
+        : arena_ (other.arena ())
+    {
+    }
+
+    T* allocate (std::size_t n)
+    {
+        return static_cast <T*> (arena_->allocate (n * sizeof (T), alignof (T)));
+    }
+
+    void deallocate (T*, std::size_t) noexcept
+    {
+    }
+
+    Arena* arena () const noexcept
+    {
+        return arena_;
+    }
+
+private:
+    Arena* arena_;
+};
+
+template <class T, class U>
+bool operator== (ArenaAllocator <T> const& a, ArenaAllocator <U> const& b)
+{
+    return a.arena () == b.arena ();
+}
+
+template <class T, class U>
+bool operator!= (ArenaAllocator <T> const& a, ArenaAllocator <U> const& b)
+{
+    return !(a == b);
+}
+
+//------------------------------------------------------------------------------
+
+/** A JSON value whose storage lives entirely in an Arena.
+
+    Objects are flat vectors of members kept sorted by key, so they iterate
+    and serialize in the same order as Json::Value. Keys given as
+    Json::StaticString, which includes every field in JsonFields.h, are
+    stored by pointer and never copied; other keys and strings are copied
+    into the arena.
+
+    Members and elements are allocated individually, so references to them
+    stay valid while their parent grows, as with Json::Value. Nothing is
+    freed before the arena is destroyed: replacing or removing a value
+    simply abandons its storage.
+
+    FlatValue interoperates with the streaming API: it can be passed to
+    Writer::output, Object::set and Array::append, and the generic accessors
+    in Object.h (setArray, addObject, appendArray, appendObject, copyFrom)
+    accept it.
+*/
+class FlatValue
+{
+public:
+    using UInt = Json::UInt;
+    using Int = Json::Int;
+
+    struct Member
+    {
+        char const* key;
+        FlatValue* value;
+    };
+
+    using Members = std::vector <Member, ArenaAllocator <Member>>;
+    using Elements = std::vector <FlatValue*, ArenaAllocator <FlatValue*>>;
+
+    explicit FlatValue (Arena& arena, ValueType type = nullValue);
+    FlatValue (FlatValue const&) = delete;
+
+    /** Replace the contents with a deep copy of another value. */
+    FlatValue& operator= (FlatValue const& other);
+    FlatValue& operator= (Json::Value const& other);
+
+    FlatValue& operator= (ValueType type);
+    FlatValue& operator= (Int value);
+    FlatValue& operator= (UInt value);
+    FlatValue& operator= (double value);
+    FlatValue& operator= (bool value);
+    FlatValue& operator= (char const* value);
+    FlatValue& operator= (std::string const& value);
+    FlatValue& operator= (StaticString const& value);
+
+    Arena& arena () const
+    {
+        return *arena_;
+    }
+
+    ValueType type () const
+    {
+        return type_;
+    }
+
+    bool isNull () const     { return type_ == nullValue; }
+    bool isArray () const    { return type_ == arrayValue; }
+    bool isObject () const   { return type_ == objectValue; }
+    bool isString () const   { return type_ == stringValue; }
+
+    Int asInt () const;
+    UInt asUInt () const;
+    double asDouble () const;
+    bool asBool () const;
+    char const* asCString () const;
+    std::string asString () const;
+
+    /** The string with its length. Unlike asCString, this keeps any
+        embedded NULs.
+    */
+    boost::string_ref asStringRef () const;
+
+    /** Number of members or elements. */
+    UInt size () const;
+
+    /** Access a member, creating it if needed. A null value becomes an
+        object. The key is not copied.
+    */
+    FlatValue& operator[] (StaticString const& key);
+
+    /** Access a member, creating it if needed. A null value becomes an
+        object. The key is copied into the arena.
+    */
+    FlatValue& operator[] (std::string const& key);
+    FlatValue& operator[] (char const* key);
+
+    /** Return the member, or nullptr if there is none. */
+    FlatValue const* find (char const* key) const;
+
+    bool isMember (char const* key) const
+    {
+        return find (key) != nullptr;
+    }
+
+    bool isMember (std::string const& key) const
+    {
+        return find (key.c_str ()) != nullptr;
+    }
+
+    /** Append a null element and return it. A null value becomes an array. */
+    FlatValue& append ();
+
+    template <class T>
+    FlatValue& append (T const& value)
+    {
+        FlatValue& v = append ();
+        v = value;
+        return v;
+    }
+
+    /** Access an array element. */
+    FlatValue const& operator[] (UInt index) const;
+
+    /** Members in key order. */
+    Members const& members () const;
+
+    Elements const& elements () const;
+
+    /** Build an equivalent Json::Value. */
+    Json::Value toValue () const;
+
+private:
+    Members& makeObject ();
+    Elements& makeArray ();
+    FlatValue& resolve (char const* key, bool isStatic);
+    void assignString (char const* s, std::size_t size);
+
+    struct String
+    {
+        char const* data;
+        std::size_t size;
+    };
+
+    union Holder
+    {
+        Int int_;
+        UInt uint_;
+        double real_;
+        bool bool_;
+        String string_;
+        Members* members_;
+        Elements* elements_;
+    };
+
+    Arena* arena_;
+    Holder value_;
+    ValueType type_;
+};
+
+/** Stream compact JSON for a FlatValue to the specified function. */
+void stream (FlatValue const& value, write_t write);
+
+} // Json
+
+#endif
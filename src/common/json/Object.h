@@ -20,6 +20,7 @@
 #ifndef BESSEL_JSON_OBJECT_H_INCLUDED
 #define BESSEL_JSON_OBJECT_H_INCLUDED
 
+#include <common/json/FlatValue.h>
 #include <common/json/Writer.h>
 #include <common/misc/Utility.h>
 
@@ -197,6 +198,8 @@ public:
 
     void set (std::string const& key, Json::Value const&);
 
+    void set (std::string const& key, Json::FlatValue const&);
+
     // Detail class and method used to implement operator[].
     class Proxy;
 
@@ -249,6 +252,11 @@ public:
      */
     void append (Json::Value const&);
 
+    /** Appends a Json::FlatValue to an array.
+        Throws an exception if this Array was disabled.
+     */
+    void append (Json::FlatValue const&);
+
     /** Append a new Object and return it.
 
         This Array is disabled until that sub-object is destroyed.
@@ -279,6 +287,9 @@ Json::Value& setArray (Json::Value&, Json::StaticString const& key);
 /** Add a new subarray at a named key in a Json object. */
 Array setArray (Object&, Json::StaticString const& key);
 
+/** Add a new subarray at a named key in a Json object. */
+Json::FlatValue& setArray (Json::FlatValue&, Json::StaticString const& key);
+
 
 /** Add a new subobject at a named key in a Json object. */
 Json::Value& addObject (Json::Value&, Json::StaticString const& key);
@@ -286,6 +297,9 @@ Json::Value& addObject (Json::Value&, Json::StaticString const& key);
 /** Add a new subobject at a named key in a Json object. */
 Object addObject (Object&, Json::StaticString const& key);
 
+/** Add a new subobject at a named key in a Json object. */
+Json::FlatValue& addObject (Json::FlatValue&, Json::StaticString const& key);
+
 
 /** Append a new subarray to a Json array. */
 Json::Value& appendArray (Json::Value&);
@@ -293,6 +307,9 @@ Json::Value& appendArray (Json::Value&);
 /** Append a new subarray to a Json array. */
 Array appendArray (Array&);
 
+/** Append a new subarray to a Json array. */
+Json::FlatValue& appendArray (Json::FlatValue&);
+
 
 /** Append a new subobject to a Json object. */
 Json::Value& appendObject (Json::Value&);
@@ -300,6 +317,9 @@ Json::Value& appendObject (Json::Value&);
 /** Append a new subobject to a Json object. */
 Object appendObject (Array&);
 
+/** Append a new subobject to a Json object. */
+Json::FlatValue& appendObject (Json::FlatValue&);
+
 
 /** Copy all the keys and values from one object into another. */
 void copyFrom (Json::Value& to, Json::Value const& from);
@@ -307,6 +327,9 @@ void copyFrom (Json::Value& to, Json::Value const& from);
 /** Copy all the keys and values from one object into another. */
 void copyFrom (Object& to, Json::Value const& from);
 
+/** Copy all the keys and values from one object into another. */
+void copyFrom (Json::FlatValue& to, Json::Value const& from);
+
 
 /** An Object that contains its own Writer. */
 class WriterObject
@@ -401,6 +424,12 @@ Array setArray (Object& json, Json::StaticString const& key)
     return json.setArray (std::string (key));
 }
 
+inline
+Json::FlatValue& setArray (Json::FlatValue& json, Json::StaticString const& key)
+{
+    return (json[key] = Json::arrayValue);
+}
+
 inline
 Json::Value& addObject (Json::Value& json, Json::StaticString const& key)
 {
@@ -413,6 +442,12 @@ Object addObject (Object& object, Json::StaticString const& key)
     return object.setObject (std::string (key));
 }
 
+inline
+Json::FlatValue& addObject (Json::FlatValue& json, Json::StaticString const& key)
+{
+    return (json[key] = Json::objectValue);
+}
+
 inline
 Json::Value& appendArray (Json::Value& json)
 {
@@ -425,6 +460,12 @@ Array appendArray (Array& json)
     return json.appendArray ();
 }
 
+inline
+Json::FlatValue& appendArray (Json::FlatValue& json)
+{
+    return json.append (Json::arrayValue);
+}
+
 inline
 Json::Value& appendObject (Json::Value& json)
 {
@@ -437,6 +478,12 @@ Object appendObject (Array& json)
     return json.appendObject ();
 }
 
+inline
+Json::FlatValue& appendObject (Json::FlatValue& json)
+{
+    return json.append (Json::objectValue);
+}
+
 } // Json
 
 #endif
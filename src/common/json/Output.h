@@ -26,6 +26,7 @@
 namespace Json {
 
 class Value;
+class FlatValue;
 
 using Output = std::function <void (boost::string_ref const&)>;
 
@@ -42,6 +43,9 @@ Output stringOutput (std::string& s)
  */
 void outputJson (Json::Value const&, Output const&);
 
+/** Writes a minimal representation of a Json::FlatValue to an Output. */
+void outputJson (Json::FlatValue const&, Output const&);
+
 /** Return the minimal string representation of a Json::Value in O(n) time.
 
     This requires a memory allocation for the full size of the output.
@@ -49,6 +53,9 @@ void outputJson (Json::Value const&, Output const&);
  */
 std::string jsonAsString (Json::Value const&);
 
+/** Return the minimal string representation of a Json::FlatValue. */
+std::string jsonAsString (Json::FlatValue const&);
+
 } // Json
 
 #endif
@@ -28,6 +28,8 @@
 
 namespace Json {
 
+class FlatValue;
+
 /**
  *  Writer implements an O(1)-space, O(1)-granular output JSON writer.
  *
@@ -197,9 +199,15 @@ public:
     /*** Output a literal constant or C string. */
     void output (char const*);
 
+    /*** Output a string of known length, which may contain NULs. */
+    void output (boost::string_ref const&);
+
     /*** Output a Json::Value. */
     void output (Json::Value const&);
 
+    /*** Output a Json::FlatValue. */
+    void output (Json::FlatValue const&);
+
     /** Output a null. */
     void output (std::nullptr_t);
 
@@ -0,0 +1,364 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+/*  JSON response building benchmark.
+
+    Builds and serializes synthetic payloads shaped like the responses of
+    the ledger (with expanded transactions), account_tx and book_offers
+    commands, once with Json::Value and once with an arena backed
+    Json::FlatValue, and reports build and serialize throughput and the
+    number of heap allocations each representation needs.
+
+    It is a program of its own because allocations are counted by
+    replacing the global operator new, which must not happen in skywelld.
+
+    Usage: jsonbench [iterations]
+
+    Exits with EXIT_SUCCESS if both representations serialized identically.
+*/
+
+#include <BeastConfig.h>
+#include <common/json/FlatValue.h>
+#include <common/json/Output.h>
+#include <protocol/JsonFields.h>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace bessel {
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+// Heap allocations are counted by the operator new below while enabled.
+std::atomic <bool> countingAllocations (false);
+std::atomic <std::size_t> allocations (0);
+
+std::string const sampleHash =
+    "4E3C5AF2E0C8B6D9A1F7E2B3C4D5E6F708192A3B4C5D6E7F8091A2B3C4D5E6F7";
+std::string const sampleAccount = "bHb9CJAWyB4bj91VRWn96DkukG4bwdtyTh";
+std::string const samplePubKey =
+    "0330E7FC9D56BB25D6893BA3F317AE5BCF33B3291BD63DB32654A313222F7FD020";
+std::string const sampleSignature =
+    "3045022100D184EB4AE5956FF600E7536EE459345C7BBCF097A84CC61A93B9AF7197"
+    "EDB98702201CEA8009B7BEEBAA2AACC0359B41C427C1C5B550A4CA4B80CF2174AF2D6D5DCE";
+
+// Serialized fields are keyed by their SField names, which are not static
+// strings, while RPC fields come from JsonFields.h.
+
+template <class JsonValue>
+void
+fillAmount (JsonValue& json, int i)
+{
+    json[jss::currency] = "USD";
+    json[jss::issuer] = sampleAccount;
+    json[jss::value] = std::to_string (1000 + i) + ".25";
+}
+
+template <class JsonValue>
+void
+fillTransaction (JsonValue& tx, int i)
+{
+    tx[jss::Account] = sampleAccount;
+    fillAmount (tx[jss::Amount], i);
+    tx[jss::Destination] = sampleAccount;
+    tx[jss::Fee] = "10";
+    tx[jss::Flags] = Json::UInt (2147483648u);
+    tx[jss::Sequence] = Json::UInt (i);
+    tx[std::string ("SigningPubKey")] = samplePubKey;
+    tx[jss::TransactionType] = "Payment";
+    tx[std::string ("TxnSignature")] = sampleSignature;
+    tx[jss::hash] = sampleHash;
+}
+
+template <class JsonValue>
+void
+fillMeta (JsonValue& meta, int i)
+{
+    auto& nodes = meta[std::string ("AffectedNodes")] = Json::arrayValue;
+    for (int n = 0; n < 3; ++n)
+    {
+        auto& modified = nodes.append (Json::objectValue)[
+            std::string ("ModifiedNode")] = Json::objectValue;
+        auto& fields = modified[std::string ("FinalFields")] = Json::objectValue;
+        fields[jss::Account] = sampleAccount;
+        fields[std::string ("Balance")] = std::to_string (99999000 - i);
+        fields[jss::Flags] = Json::UInt (0);
+        fields[std::string ("OwnerCount")] = Json::UInt (n);
+        fields[jss::Sequence] = Json::UInt (i + 1);
+        modified[std::string ("LedgerEntryType")] = "AccountRoot";
+        modified[std::string ("LedgerIndex")] = sampleHash;
+        modified[std::string ("PreviousTxnID")] = sampleHash;
+        modified[std::string ("PreviousTxnLgrSeq")] = Json::UInt (1000 + i);
+    }
+    meta[std::string ("TransactionIndex")] = Json::UInt (i);
+    meta[std::string ("TransactionResult")] = "tesSUCCESS";
+}
+
+template <class JsonValue>
+void
+buildLedger (JsonValue& result)
+{
+    auto& ledger = result[jss::ledger] = Json::objectValue;
+    ledger[jss::accepted] = true;
+    ledger[jss::account_hash] = sampleHash;
+    ledger[jss::close_time] = Json::UInt (500000000);
+    ledger[jss::closed] = true;
+    ledger[jss::ledger_hash] = sampleHash;
+    ledger[jss::ledger_index] = "1000";
+    ledger[jss::parent_hash] = sampleHash;
+    ledger[jss::total_coins] = "100000000000000000";
+    ledger[jss::transaction_hash] = sampleHash;
+
+    auto& txns = ledger[jss::transactions] = Json::arrayValue;
+    for (int i = 0; i < 400; ++i)
+    {
+        auto& tx = txns.append (Json::objectValue);
+        fillTransaction (tx, i);
+        fillMeta (tx[jss::metaData], i);
+    }
+}
+
+template <class JsonValue>
+void
+buildAccountTx (JsonValue& result)
+{
+    result[jss::account] = sampleAccount;
+    result[jss::limit] = Json::UInt (200);
+    auto& txns = result[jss::transactions] = Json::arrayValue;
+    for (int i = 0; i < 200; ++i)
+    {
+        auto& entry = txns.append (Json::objectValue);
+        fillMeta (entry[jss::meta], i);
+        fillTransaction (entry[jss::tx], i);
+        entry[jss::validated] = true;
+    }
+}
+
+template <class JsonValue>
+void
+buildBookOffers (JsonValue& result)
+{
+    result[jss::ledger_index] = Json::UInt (1000);
+    auto& offers = result[jss::offers] = Json::arrayValue;
+    for (int i = 0; i < 300; ++i)
+    {
+        auto& offer = offers.append (Json::objectValue);
+        offer[jss::Account] = sampleAccount;
+        offer[std::string ("BookDirectory")] = sampleHash;
+        offer[std::string ("BookNode")] = "0000000000000000";
+        offer[jss::Flags] = Json::UInt (0);
+        offer[std::string ("LedgerEntryType")] = "Offer";
+        offer[std::string ("OwnerNode")] = "0000000000000000";
+        offer[std::string ("PreviousTxnID")] = sampleHash;
+        offer[std::string ("PreviousTxnLgrSeq")] = Json::UInt (900 + i);
+        offer[jss::Sequence] = Json::UInt (i);
+        offer[jss::TakerGets] = std::to_string (1000000 + i);
+        fillAmount (offer[jss::TakerPays], i);
+        offer[jss::index] = sampleHash;
+        offer[jss::owner_funds] = "2500000000";
+        offer[jss::quality] = "0.000000001";
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Returns the number of heap allocations made by f
+template <class Function>
+std::size_t
+countAllocations (Function f)
+{
+    allocations = 0;
+    countingAllocations = true;
+    f ();
+    countingAllocations = false;
+    return allocations;
+}
+
+struct Result
+{
+    clock_type::duration build = clock_type::duration::zero ();
+    clock_type::duration write = clock_type::duration::zero ();
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+    std::string output;
+};
+
+double
+seconds (clock_type::duration d)
+{
+    return std::chrono::duration_cast<std::chrono::duration<double>> (d).count ();
+}
+
+bool
+runPayload (char const* name, void (*buildValue) (Json::Value&),
+    void (*buildFlat) (Json::FlatValue&), int iterations, std::ostream& out)
+{
+    Result classic, flat;
+
+    classic.allocations = countAllocations ([buildValue] ()
+    {
+        Json::Value value (Json::objectValue);
+        buildValue (value);
+    });
+
+    flat.allocations = countAllocations ([buildFlat] ()
+    {
+        Json::Arena arena;
+        Json::FlatValue value (arena, Json::objectValue);
+        buildFlat (value);
+    });
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        auto start = clock_type::now ();
+        Json::Value value (Json::objectValue);
+        buildValue (value);
+        auto built = clock_type::now ();
+        std::string s;
+        Json::outputJson (value, Json::stringOutput (s));
+        auto written = clock_type::now ();
+
+        classic.build += built - start;
+        classic.write += written - built;
+        classic.bytes = s.size ();
+        if (i == 0)
+            classic.output = std::move (s);
+    }
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        auto start = clock_type::now ();
+        Json::Arena arena;
+        Json::FlatValue value (arena, Json::objectValue);
+        buildFlat (value);
+        auto built = clock_type::now ();
+        std::string s;
+        Json::outputJson (value, Json::stringOutput (s));
+        auto written = clock_type::now ();
+
+        flat.build += built - start;
+        flat.write += written - built;
+        flat.bytes = s.size ();
+        if (i == 0)
+            flat.output = std::move (s);
+    }
+
+    auto report = [&] (char const* kind, Result const& r)
+    {
+        double const mb = double (r.bytes) * iterations / (1024 * 1024);
+        out << boost::format ("%-12s %-10s %10u %12.1f %12.1f %10.1f\n")
+            % name % kind % r.allocations
+            % (iterations / seconds (r.build))
+            % (mb / seconds (r.write))
+            % (r.bytes / 1024.0);
+    };
+
+    report ("Value", classic);
+    report ("FlatValue", flat);
+
+    if (classic.output != flat.output)
+    {
+        out << name << ": FlatValue output differs from Json::Value\n";
+        return false;
+    }
+
+    return true;
+}
+
+int
+runJsonBenchmark (int iterations, std::ostream& out)
+{
+
+    out << boost::format ("%-12s %-10s %10s %12s %12s %10s\n")
+        % "payload" % "type" % "allocs" % "builds/s" % "write MB/s" % "size KB";
+
+    bool ok = true;
+
+    ok = runPayload ("ledger", &buildLedger<Json::Value>,
+        &buildLedger<Json::FlatValue>, iterations, out) && ok;
+    ok = runPayload ("account_tx", &buildAccountTx<Json::Value>,
+        &buildAccountTx<Json::FlatValue>, iterations, out) && ok;
+    ok = runPayload ("book_offers", &buildBookOffers<Json::Value>,
+        &buildBookOffers<Json::FlatValue>, iterations, out) && ok;
+
+    out << "\nallocs counts the heap allocations made building the "
+        "document once, arena blocks included.\n";
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace
+
+} // bessel
+
+//------------------------------------------------------------------------------
+
+int
+main (int argc, char** argv)
+{
+    int iterations = 100;
+
+    if (argc > 1)
+        iterations = std::max (1, std::atoi (argv[1]));
+
+    return bessel::runJsonBenchmark (iterations, std::cout);
+}
+
+//------------------------------------------------------------------------------
+
+void*
+operator new (std::size_t size)
+{
+    if (bessel::countingAllocations.load (std::memory_order_relaxed))
+        ++bessel::allocations;
+
+    if (size == 0)
+        size = 1;
+
+    for (;;)
+    {
+        if (void* p = std::malloc (size))
+            return p;
+
+        auto const handler = std::get_new_handler ();
+        if (!handler)
+            throw std::bad_alloc ();
+        handler ();
+    }
+}
+
+void
+operator delete (void* p) noexcept
+{
+    std::free (p);
+}
+
+void
+operator delete (void* p, std::size_t) noexcept
+{
+    std::free (p);
+}
@@ -0,0 +1,927 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <common/json/FastReader.h>
+#include <common/json/json_reader.h>
+#include <common/json/impl/json_assert.h>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Json {
+
+namespace {
+
+inline bool isSpace (char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool isDigit (char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Whitespace between tokens is usually absent or a single space, so the
+// scalar test comes first; the vector loop pays off on indented documents.
+inline char const* skipSpaces (char const* p, char const* end)
+{
+    if (p != end && !isSpace (*p))
+        return p;
+
+#if defined(__SSE2__)
+    __m128i const space = _mm_set1_epi8 (' ');
+    __m128i const tab = _mm_set1_epi8 ('\t');
+    __m128i const lf = _mm_set1_epi8 ('\n');
+    __m128i const cr = _mm_set1_epi8 ('\r');
+
+    while (end - p >= 16)
+    {
+        __m128i const chunk =
+            _mm_loadu_si128 (reinterpret_cast <__m128i const*> (p));
+        __m128i const ws = _mm_or_si128 (
+            _mm_or_si128 (_mm_cmpeq_epi8 (chunk, space),
+                _mm_cmpeq_epi8 (chunk, tab)),
+            _mm_or_si128 (_mm_cmpeq_epi8 (chunk, lf),
+                _mm_cmpeq_epi8 (chunk, cr)));
+        int const other = ~_mm_movemask_epi8 (ws) & 0xffff;
+
+        if (other != 0)
+            return p + __builtin_ctz (other);
+
+        p += 16;
+    }
+#endif
+
+    while (p != end && isSpace (*p))
+        ++p;
+
+    return p;
+}
+
+// Returns the first quote, backslash or NUL at or after p, or end.
+inline char const* findStringSpecial (char const* p, char const* end)
+{
+#if defined(__SSE2__)
+    __m128i const quote = _mm_set1_epi8 ('"');
+    __m128i const backslash = _mm_set1_epi8 ('\\');
+    __m128i const zero = _mm_setzero_si128 ();
+
+    while (end - p >= 16)
+    {
+        __m128i const chunk =
+            _mm_loadu_si128 (reinterpret_cast <__m128i const*> (p));
+        int const special = _mm_movemask_epi8 (_mm_or_si128 (
+            _mm_or_si128 (_mm_cmpeq_epi8 (chunk, quote),
+                _mm_cmpeq_epi8 (chunk, backslash)),
+            _mm_cmpeq_epi8 (chunk, zero)));
+
+        if (special != 0)
+            return p + __builtin_ctz (special);
+
+        p += 16;
+    }
+#endif
+
+    while (p != end && *p != '"' && *p != '\\' && *p != 0)
+        ++p;
+
+    return p;
+}
+
+bool decodeHex4 (char const*& p, char const* end, unsigned int& unicode)
+{
+    if (end - p < 4)
+        return false;
+
+    unicode = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        char const c = *p++;
+        unicode *= 16;
+
+        if (c >= '0' && c <= '9')
+            unicode += c - '0';
+        else if (c >= 'a' && c <= 'f')
+            unicode += c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            unicode += c - 'A' + 10;
+        else
+            return false;
+    }
+
+    return true;
+}
+
+// Same encoding as Json::Reader, including lone low surrogates.
+void appendUTF8 (std::string& s, unsigned int cp)
+{
+    if (cp <= 0x7f)
+    {
+        s += static_cast <char> (cp);
+    }
+    else if (cp <= 0x7FF)
+    {
+        s += static_cast <char> (0xC0 | (0x1f & (cp >> 6)));
+        s += static_cast <char> (0x80 | (0x3f & cp));
+    }
+    else if (cp <= 0xFFFF)
+    {
+        s += static_cast <char> (0xE0 | (0xf & (cp >> 12)));
+        s += static_cast <char> (0x80 | (0x3f & (cp >> 6)));
+        s += static_cast <char> (0x80 | (0x3f & cp));
+    }
+    else
+    {
+        s += static_cast <char> (0xF0 | (0x7 & (cp >> 18)));
+        s += static_cast <char> (0x80 | (0x3f & (cp >> 12)));
+        s += static_cast <char> (0x80 | (0x3f & (cp >> 6)));
+        s += static_cast <char> (0x80 | (0x3f & cp));
+    }
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+bool FastReader::parse (std::string document)
+{
+    text_ = std::move (document);
+    tape_.clear ();
+    children_.clear ();
+    decoded_.clear ();
+    stack_.clear ();
+
+    if (text_.size () >= std::numeric_limits <std::uint32_t>::max ())
+        return false;
+
+    char const* p = text_.data ();
+    char const* const end = p + text_.size ();
+
+    p = skipSpaces (p, end);
+
+    if (p == end || (*p != '{' && *p != '['))
+        return false;
+
+    // Each pass either opens a container or reads a leaf, then consumes
+    // separators and closing brackets until another value is expected.
+    for (;;)
+    {
+        p = skipSpaces (p, end);
+
+        if (p == end)
+            return false;
+
+        bool inObject = !stack_.empty () &&
+            tape_[stack_.back ()].type == objectValue;
+
+        if (*p == '{' || *p == '[')
+        {
+            Node node;
+            node.type = (*p == '{') ? objectValue : arrayValue;
+            node.count = 0;
+            node.next = 0;
+            node.value.children_ = 0;
+            stack_.push_back (static_cast <std::uint32_t> (tape_.size ()));
+            tape_.push_back (node);
+            inObject = node.type == objectValue;
+
+            p = skipSpaces (p + 1, end);
+
+            if (p == end)
+                return false;
+
+            if (*p == (inObject ? '}' : ']'))
+            {
+                if (! close (stack_.back ()))
+                    return false;
+                stack_.pop_back ();
+                ++p;
+            }
+            else if (inObject)
+            {
+                if (*p != '"' || ! (p = parseString (p + 1, end)))
+                    return false;
+
+                p = skipSpaces (p, end);
+
+                if (p == end || *p != ':')
+                    return false;
+
+                ++p;
+                continue;
+            }
+            else
+            {
+                continue;
+            }
+        }
+        else if (*p == '"')
+        {
+            p = parseString (p + 1, end);
+        }
+        else if (*p == '-' || isDigit (*p))
+        {
+            p = parseNumber (p, end);
+        }
+        else
+        {
+            p = parseLiteral (p, end);
+        }
+
+        if (! p)
+            return false;
+
+        // A value is complete.
+        for (;;)
+        {
+            if (stack_.empty ())
+                return skipSpaces (p, end) == end;
+
+            inObject = tape_[stack_.back ()].type == objectValue;
+            p = skipSpaces (p, end);
+
+            if (p == end)
+                return false;
+
+            if (*p == ',')
+            {
+                p = skipSpaces (p + 1, end);
+
+                if (inObject)
+                {
+                    if (p == end || *p != '"' ||
+                            ! (p = parseString (p + 1, end)))
+                        return false;
+
+                    p = skipSpaces (p, end);
+
+                    if (p == end || *p != ':')
+                        return false;
+
+                    ++p;
+                }
+                break;
+            }
+
+            if (*p != (inObject ? '}' : ']'))
+                return false;
+
+            if (! close (stack_.back ()))
+                return false;
+
+            stack_.pop_back ();
+            ++p;
+        }
+    }
+}
+
+// Keys never contain NUL, so comparing bytes and then lengths gives the
+// same order as strcmp.
+bool FastReader::keyLess (Node const& key, char const* other, std::size_t size)
+{
+    int const c = std::memcmp (key.value.string_, other,
+        std::min <std::size_t> (key.count, size));
+    return c < 0 || (c == 0 && key.count < size);
+}
+
+bool FastReader::close (std::size_t index)
+{
+    auto const next = static_cast <std::uint32_t> (tape_.size ());
+    bool const object = tape_[index].type == objectValue;
+    auto const first = static_cast <std::uint32_t> (children_.size ());
+    std::uint32_t count = 0;
+
+    for (std::uint32_t pos = static_cast <std::uint32_t> (index + 1);
+        pos < next; pos = tape_[pos].next)
+    {
+        children_.push_back (pos);
+        ++count;
+
+        if (object)
+            pos = tape_[pos].next;
+    }
+
+    tape_[index].count = count;
+    tape_[index].next = next;
+    tape_[index].value.children_ = first;
+
+    if (object && count > 1)
+    {
+        // Members are kept in key order, the order Json::Value iterates
+        // them in, so lookups are a binary search and duplicates are
+        // adjacent. Json::Value keeps the last of duplicate keys; rather
+        // than reproduce that, leave such documents to Json::Reader.
+        std::sort (children_.begin () + first, children_.end (),
+            [this](std::uint32_t a, std::uint32_t b)
+            {
+                return keyLess (tape_[a], tape_[b].value.string_, tape_[b].count);
+            });
+
+        for (std::uint32_t i = first + 1; i < first + count; ++i)
+        {
+            Node const& a = tape_[children_[i - 1]];
+            Node const& b = tape_[children_[i]];
+
+            if (a.count == b.count &&
+                    std::memcmp (a.value.string_, b.value.string_, a.count) == 0)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+char const* FastReader::parseString (char const* p, char const* end)
+{
+    char const* q = findStringSpecial (p, end);
+
+    if (q == end || *q == 0)
+        return nullptr;
+
+    Node node;
+    node.type = stringValue;
+    node.next = static_cast <std::uint32_t> (tape_.size () + 1);
+
+    if (*q == '"')
+    {
+        node.count = static_cast <std::uint32_t> (q - p);
+        node.value.string_ = p;
+        tape_.push_back (node);
+        return q + 1;
+    }
+
+    decoded_.emplace_back (p, q);
+    std::string& s = decoded_.back ();
+
+    for (;;)
+    {
+        if (q == end || *q == 0)
+            return nullptr;
+
+        if (*q == '"')
+            break;
+
+        // *q is a backslash
+        if (++q == end)
+            return nullptr;
+
+        switch (*q++)
+        {
+        case '"':  s += '"'; break;
+        case '/':  s += '/'; break;
+        case '\\': s += '\\'; break;
+        case 'b':  s += '\b'; break;
+        case 'f':  s += '\f'; break;
+        case 'n':  s += '\n'; break;
+        case 'r':  s += '\r'; break;
+        case 't':  s += '\t'; break;
+
+        case 'u':
+        {
+            unsigned int unicode;
+
+            if (! decodeHex4 (q, end, unicode))
+                return nullptr;
+
+            if (unicode >= 0xD800 && unicode <= 0xDBFF)
+            {
+                unsigned int surrogate;
+
+                if (end - q < 6 || q[0] != '\\' || q[1] != 'u')
+                    return nullptr;
+
+                q += 2;
+
+                if (! decodeHex4 (q, end, surrogate))
+                    return nullptr;
+
+                unicode = 0x10000 + ((unicode & 0x3FF) << 10) +
+                    (surrogate & 0x3FF);
+            }
+
+            // Json::Value stores C strings and would truncate here.
+            if (unicode == 0)
+                return nullptr;
+
+            appendUTF8 (s, unicode);
+            break;
+        }
+
+        default:
+            return nullptr;
+        }
+
+        char const* const run = findStringSpecial (q, end);
+        s.append (q, run);
+        q = run;
+    }
+
+    node.count = static_cast <std::uint32_t> (s.size ());
+    node.value.string_ = s.data ();
+    tape_.push_back (node);
+    return q + 1;
+}
+
+char const* FastReader::parseNumber (char const* p, char const* end)
+{
+    char const* const start = p;
+    bool const negative = *p == '-';
+
+    if (negative)
+        ++p;
+
+    char const* const digits = p;
+
+    while (p != end && isDigit (*p))
+        ++p;
+
+    if (p == digits)
+        return nullptr;
+
+    bool integral = true;
+
+    if (p != end && *p == '.')
+    {
+        integral = false;
+        char const* const fraction = ++p;
+
+        while (p != end && isDigit (*p))
+            ++p;
+
+        if (p == fraction)
+            return nullptr;
+    }
+
+    if (p != end && (*p == 'e' || *p == 'E'))
+    {
+        integral = false;
+        ++p;
+
+        if (p != end && (*p == '+' || *p == '-'))
+            ++p;
+
+        char const* const exponent = p;
+
+        while (p != end && isDigit (*p))
+            ++p;
+
+        if (p == exponent)
+            return nullptr;
+    }
+
+    Node node;
+    node.count = 0;
+    node.next = static_cast <std::uint32_t> (tape_.size () + 1);
+
+    if (integral)
+    {
+        // Same ranges and representation as Json::Reader::decodeNumber.
+        std::int64_t value = 0;
+
+        for (char const* d = digits; d != p; ++d)
+        {
+            value = (value * 10) + (*d - '0');
+
+            if (value > Value::maxUInt)
+                return nullptr;
+        }
+
+        if (negative)
+        {
+            value = -value;
+
+            if (value < Value::minInt)
+                return nullptr;
+
+            node.type = intValue;
+            node.value.int_ = static_cast <Int> (value);
+        }
+        else if (value <= Value::maxInt)
+        {
+            node.type = intValue;
+            node.value.int_ = static_cast <Int> (value);
+        }
+        else
+        {
+            node.type = uintValue;
+            node.value.uint_ = static_cast <UInt> (value);
+        }
+    }
+    else
+    {
+        std::string const token (start, p);
+        double value = 0;
+
+        if (std::sscanf (token.c_str (), "%lf", &value) != 1)
+            return nullptr;
+
+        node.type = realValue;
+        node.value.real_ = value;
+    }
+
+    tape_.push_back (node);
+    return p;
+}
+
+char const* FastReader::parseLiteral (char const* p, char const* end)
+{
+    Node node;
+    node.count = 0;
+    node.next = static_cast <std::uint32_t> (tape_.size () + 1);
+
+    auto const match = [&](char const* word, std::size_t size)
+    {
+        return static_cast <std::size_t> (end - p) >= size &&
+            std::memcmp (p, word, size) == 0;
+    };
+
+    if (match ("true", 4))
+    {
+        node.type = booleanValue;
+        node.value.bool_ = true;
+        p += 4;
+    }
+    else if (match ("false", 5))
+    {
+        node.type = booleanValue;
+        node.value.bool_ = false;
+        p += 5;
+    }
+    else if (match ("null", 4))
+    {
+        node.type = nullValue;
+        node.value.int_ = 0;
+        p += 4;
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    tape_.push_back (node);
+    return p;
+}
+
+//------------------------------------------------------------------------------
+
+ValueType TapeValue::type () const
+{
+    if (! reader_)
+        return nullValue;
+
+    return reader_->tape_[index_].type;
+}
+
+std::string TapeValue::asString () const
+{
+    switch (type ())
+    {
+    case nullValue:
+        return "";
+
+    case stringValue:
+    {
+        auto const& node = reader_->tape_[index_];
+        return std::string (node.value.string_, node.count);
+    }
+
+    case booleanValue:
+        return reader_->tape_[index_].value.bool_ ? "true" : "false";
+
+    case intValue:
+        return boost::lexical_cast <std::string> (
+            reader_->tape_[index_].value.int_);
+
+    default:
+        JSON_ASSERT_MESSAGE (false, "Type is not convertible to string");
+    }
+
+    return "";
+}
+
+Int TapeValue::asInt () const
+{
+    switch (type ())
+    {
+    case nullValue:
+        return 0;
+
+    case intValue:
+        return reader_->tape_[index_].value.int_;
+
+    case uintValue:
+    {
+        UInt const v = reader_->tape_[index_].value.uint_;
+        JSON_ASSERT_MESSAGE (v < (unsigned)Value::maxInt,
+            "integer out of signed integer range");
+        return v;
+    }
+
+    case realValue:
+    {
+        double const v = reader_->tape_[index_].value.real_;
+        JSON_ASSERT_MESSAGE (v >= Value::minInt && v <= Value::maxInt,
+            "Real out of signed integer range");
+        return Int (v);
+    }
+
+    case booleanValue:
+        return reader_->tape_[index_].value.bool_ ? 1 : 0;
+
+    case stringValue:
+        return boost::lexical_cast <int> (asString ());
+
+    default:
+        JSON_ASSERT_MESSAGE (false, "Type is not convertible to int");
+    }
+
+    return 0;
+}
+
+UInt TapeValue::asUInt () const
+{
+    switch (type ())
+    {
+    case nullValue:
+        return 0;
+
+    case intValue:
+    {
+        Int const v = reader_->tape_[index_].value.int_;
+        JSON_ASSERT_MESSAGE (v >= 0,
+            "Negative integer can not be converted to unsigned integer");
+        return v;
+    }
+
+    case uintValue:
+        return reader_->tape_[index_].value.uint_;
+
+    case realValue:
+    {
+        double const v = reader_->tape_[index_].value.real_;
+        JSON_ASSERT_MESSAGE (v >= 0 && v <= Value::maxUInt,
+            "Real out of unsigned integer range");
+        return UInt (v);
+    }
+
+    case booleanValue:
+        return reader_->tape_[index_].value.bool_ ? 1 : 0;
+
+    case stringValue:
+        return boost::lexical_cast <unsigned int> (asString ());
+
+    default:
+        JSON_ASSERT_MESSAGE (false, "Type is not convertible to uint");
+    }
+
+    return 0;
+}
+
+double TapeValue::asDouble () const
+{
+    switch (type ())
+    {
+    case nullValue:
+        return 0.0;
+
+    case intValue:
+        return reader_->tape_[index_].value.int_;
+
+    case uintValue:
+        return reader_->tape_[index_].value.uint_;
+
+    case realValue:
+        return reader_->tape_[index_].value.real_;
+
+    case booleanValue:
+        return reader_->tape_[index_].value.bool_ ? 1.0 : 0.0;
+
+    default:
+        JSON_ASSERT_MESSAGE (false, "Type is not convertible to double");
+    }
+
+    return 0.0;
+}
+
+bool TapeValue::asBool () const
+{
+    switch (type ())
+    {
+    case nullValue:
+        return false;
+
+    case intValue:
+        return reader_->tape_[index_].value.int_ != 0;
+
+    case uintValue:
+        return reader_->tape_[index_].value.uint_ != 0;
+
+    case realValue:
+        return reader_->tape_[index_].value.real_ != 0.0;
+
+    case booleanValue:
+        return reader_->tape_[index_].value.bool_;
+
+    case stringValue:
+        return reader_->tape_[index_].count != 0;
+
+    default:
+        return size () != 0;
+    }
+}
+
+UInt TapeValue::size () const
+{
+    if (! isArray () && ! isObject ())
+        return 0;
+
+    return reader_->tape_[index_].count;
+}
+
+TapeValue TapeValue::operator[] (UInt index) const
+{
+    if (! isArray () || index >= size ())
+        return TapeValue ();
+
+    auto const& node = reader_->tape_[index_];
+    return TapeValue (reader_,
+        reader_->children_[node.value.children_ + index]);
+}
+
+TapeValue TapeValue::find (char const* key, std::size_t size) const
+{
+    if (! isObject ())
+        return TapeValue ();
+
+    auto const& node = reader_->tape_[index_];
+    auto const& tape = reader_->tape_;
+    auto const first = reader_->children_.begin () + node.value.children_;
+    auto const last = first + node.count;
+
+    auto const it = std::lower_bound (first, last, key,
+        [&tape, size](std::uint32_t pos, char const* k)
+        {
+            return FastReader::keyLess (tape[pos], k, size);
+        });
+
+    if (it == last || tape[*it].count != size ||
+            std::memcmp (tape[*it].value.string_, key, size) != 0)
+        return TapeValue ();
+
+    return TapeValue (reader_, *it + 1);
+}
+
+TapeValue TapeValue::operator[] (char const* key) const
+{
+    return find (key, std::strlen (key));
+}
+
+TapeValue TapeValue::operator[] (std::string const& key) const
+{
+    return find (key.data (), key.size ());
+}
+
+TapeValue TapeValue::operator[] (StaticString const& key) const
+{
+    return (*this)[key.c_str ()];
+}
+
+// A member whose value is null is still a member, as with Json::Value.
+bool TapeValue::isMember (char const* key) const
+{
+    return find (key, std::strlen (key)).reader_ != nullptr;
+}
+
+bool TapeValue::isMember (std::string const& key) const
+{
+    return find (key.data (), key.size ()).reader_ != nullptr;
+}
+
+bool TapeValue::isMember (StaticString const& key) const
+{
+    return isMember (key.c_str ());
+}
+
+std::vector <std::string> TapeValue::getMemberNames () const
+{
+    std::vector <std::string> names;
+
+    if (! isObject ())
+        return names;
+
+    auto const& node = reader_->tape_[index_];
+    names.reserve (node.count);
+
+    for (std::uint32_t i = 0; i < node.count; ++i)
+    {
+        auto const& name =
+            reader_->tape_[reader_->children_[node.value.children_ + i]];
+        names.emplace_back (name.value.string_, name.count);
+    }
+
+    return names;
+}
+
+Value TapeValue::toValue () const
+{
+    switch (type ())
+    {
+    case intValue:
+        return Value (reader_->tape_[index_].value.int_);
+
+    case uintValue:
+        return Value (reader_->tape_[index_].value.uint_);
+
+    case realValue:
+        return Value (reader_->tape_[index_].value.real_);
+
+    case booleanValue:
+        return Value (reader_->tape_[index_].value.bool_);
+
+    case stringValue:
+        return Value (asString ());
+
+    case arrayValue:
+    {
+        Value result (Json::arrayValue);
+        UInt const count = size ();
+
+        if (count != 0)
+            result.resize (count);
+
+        for (UInt i = 0; i < count; ++i)
+            result[i] = (*this)[i].toValue ();
+
+        return result;
+    }
+
+    case objectValue:
+    {
+        Value result (Json::objectValue);
+        auto const& node = reader_->tape_[index_];
+
+        for (std::uint32_t i = 0; i < node.count; ++i)
+        {
+            auto const pos =
+                reader_->children_[node.value.children_ + i];
+            auto const& name = reader_->tape_[pos];
+            result[std::string (name.value.string_, name.count)] =
+                TapeValue (reader_, pos + 1).toValue ();
+        }
+
+        return result;
+    }
+
+    default:
+        return Value ();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool parse (FastReader& reader, std::string const& document,
+    Value& root, TapeValue& tape, StaticString const& key)
+{
+    tape = TapeValue ();
+
+    // A cheap test; a false positive only costs the conversion below
+    std::string const quoted = std::string ("\"") + key.c_str () + "\"";
+
+    if (document.find (quoted) != std::string::npos && reader.parse (document))
+    {
+        tape = reader.root ();
+        root = tape.toValue ();
+        return true;
+    }
+
+    return Reader ().parse (document, root);
+}
+
+} // Json
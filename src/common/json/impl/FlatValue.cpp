@@ -0,0 +1,624 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <common/json/FlatValue.h>
+#include <common/json/json_writer.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace Json {
+
+Arena::Arena (std::size_t blockSize)
+    : blockSize_ (blockSize)
+{
+}
+
+void*
+Arena::allocate (std::size_t size, std::size_t align)
+{
+    auto const address = reinterpret_cast <std::uintptr_t> (current_);
+    std::size_t const padding = (align - (address % align)) % align;
+
+    if (current_ == nullptr || padding + size > remaining_)
+    {
+        // Oversized requests get a block of their own
+        std::size_t const n = std::max (blockSize_, size + align);
+        blocks_.emplace_back (new char[n]);
+        current_ = blocks_.back ().get ();
+        remaining_ = n;
+        return allocate (size, align);
+    }
+
+    char* const p = current_ + padding;
+    current_ = p + size;
+    remaining_ -= padding + size;
+    used_ += padding + size;
+    return p;
+}
+
+char const*
+Arena::copy (char const* s, std::size_t size)
+{
+    char* const p = static_cast <char*> (allocate (size + 1, 1));
+    std::memcpy (p, s, size);
+    p[size] = 0;
+    return p;
+}
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+bool
+keyLess (FlatValue::Member const& member, char const* key)
+{
+    return std::strcmp (member.key, key) < 0;
+}
+
+} // namespace
+
+FlatValue::FlatValue (Arena& arena, ValueType type)
+    : arena_ (&arena)
+    , type_ (nullValue)
+{
+    value_.uint_ = 0;
+    *this = type;
+}
+
+FlatValue&
+FlatValue::operator= (ValueType type)
+{
+    type_ = type;
+
+    switch (type)
+    {
+    case nullValue:     value_.uint_ = 0; break;
+    case intValue:      value_.int_ = 0; break;
+    case uintValue:     value_.uint_ = 0; break;
+    case realValue:     value_.real_ = 0.0; break;
+    case booleanValue:  value_.bool_ = false; break;
+    case stringValue:   value_.string_ = { "", 0 }; break;
+
+    case arrayValue:
+        value_.elements_ = new (arena_->allocate (sizeof (Elements),
+            alignof (Elements))) Elements (ArenaAllocator <FlatValue*> (*arena_));
+        break;
+
+    case objectValue:
+        value_.members_ = new (arena_->allocate (sizeof (Members),
+            alignof (Members))) Members (ArenaAllocator <Member> (*arena_));
+        break;
+    }
+
+    return *this;
+}
+
+FlatValue&
+FlatValue::operator= (Int value)
+{
+    type_ = intValue;
+    value_.int_ = value;
+    return *this;
+}
+
+FlatValue&
+FlatValue::operator= (UInt value)
+{
+    type_ = uintValue;
+    value_.uint_ = value;
+    return *this;
+}
+
+FlatValue&
+FlatValue::operator= (double value)
+{
+    type_ = realValue;
+    value_.real_ = value;
+    return *this;
+}
+
+FlatValue&
+FlatValue::operator= (bool value)
+{
+    type_ = booleanValue;
+    value_.bool_ = value;
+    return *this;
+}
+
+void
+FlatValue::assignString (char const* s, std::size_t size)
+{
+    type_ = stringValue;
+    value_.string_ = { arena_->copy (s, size), size };
+}
+
+FlatValue&
+FlatValue::operator= (char const* value)
+{
+    assignString (value, std::strlen (value));
+    return *this;
+}
+
+FlatValue&
+FlatValue::operator= (std::string const& value)
+{
+    assignString (value.data (), value.size ());
+    return *this;
+}
+
+FlatValue&
+FlatValue::operator= (StaticString const& value)
+{
+    type_ = stringValue;
+    value_.string_ = { value.c_str (), std::strlen (value.c_str ()) };
+    return *this;
+}
+
+FlatValue&
+FlatValue::operator= (FlatValue const& other)
+{
+    if (&other == this)
+        return *this;
+
+    switch (other.type_)
+    {
+    case stringValue:
+        // Strings from the same arena, including static ones, can be shared
+        if (other.arena_ == arena_)
+        {
+            type_ = stringValue;
+            value_.string_ = other.value_.string_;
+        }
+        else
+        {
+            assignString (other.value_.string_.data,
+                other.value_.string_.size);
+        }
+        break;
+
+    case arrayValue:
+    {
+        auto& elements = makeArray ();
+        elements.clear ();
+        elements.reserve (other.value_.elements_->size ());
+        for (auto const e : *other.value_.elements_)
+            append (*e);
+        break;
+    }
+
+    case objectValue:
+    {
+        auto& members = makeObject ();
+        members.clear ();
+        members.reserve (other.value_.members_->size ());
+        for (auto const& m : *other.value_.members_)
+        {
+            char const* key = (other.arena_ == arena_) ? m.key :
+                arena_->copy (m.key, std::strlen (m.key));
+            auto v = new (arena_->allocate (sizeof (FlatValue),
+                alignof (FlatValue))) FlatValue (*arena_);
+            *v = *m.value;
+            // Source members are already sorted
+            members.push_back ({ key, v });
+        }
+        break;
+    }
+
+    default:
+        type_ = other.type_;
+        value_ = other.value_;
+        break;
+    }
+
+    return *this;
+}
+
+FlatValue&
+FlatValue::operator= (Json::Value const& other)
+{
+    switch (other.type ())
+    {
+    case nullValue:     return *this = nullValue;
+    case intValue:      return *this = other.asInt ();
+    case uintValue:     return *this = other.asUInt ();
+    case realValue:     return *this = other.asDouble ();
+    case booleanValue:  return *this = other.asBool ();
+    case stringValue:   return *this = other.asString ();
+
+    case arrayValue:
+    {
+        auto& elements = makeArray ();
+        elements.clear ();
+        elements.reserve (other.size ());
+        for (auto const& e : other)
+            append (e);
+        return *this;
+    }
+
+    case objectValue:
+    {
+        makeObject ().clear ();
+        for (auto it = other.begin (); it != other.end (); ++it)
+            (*this)[std::string (it.memberName ())] = *it;
+        return *this;
+    }
+    }
+
+    assert (false);
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+
+FlatValue::Int
+FlatValue::asInt () const
+{
+    switch (type_)
+    {
+    case intValue:      return value_.int_;
+    case booleanValue:  return value_.bool_ ? 1 : 0;
+    case nullValue:     return 0;
+
+    case uintValue:
+        if (value_.uint_ > static_cast <UInt> (Value::maxInt))
+            throw std::runtime_error ("integer out of signed integer range");
+        return static_cast <Int> (value_.uint_);
+
+    case realValue:
+        if (!(value_.real_ >= Value::minInt && value_.real_ <= Value::maxInt))
+            throw std::runtime_error ("Real out of signed integer range");
+        return static_cast <Int> (value_.real_);
+
+    default:
+        throw std::runtime_error ("FlatValue is not convertible to Int");
+    }
+}
+
+FlatValue::UInt
+FlatValue::asUInt () const
+{
+    switch (type_)
+    {
+    case uintValue:     return value_.uint_;
+    case booleanValue:  return value_.bool_ ? 1 : 0;
+    case nullValue:     return 0;
+
+    case intValue:
+        if (value_.int_ < 0)
+            throw std::runtime_error (
+                "Negative integer can not be converted to unsigned integer");
+        return static_cast <UInt> (value_.int_);
+
+    case realValue:
+        if (!(value_.real_ >= 0 && value_.real_ <= Value::maxUInt))
+            throw std::runtime_error ("Real out of unsigned integer range");
+        return static_cast <UInt> (value_.real_);
+
+    default:
+        throw std::runtime_error ("FlatValue is not convertible to UInt");
+    }
+}
+
+double
+FlatValue::asDouble () const
+{
+    switch (type_)
+    {
+    case intValue:      return value_.int_;
+    case uintValue:     return value_.uint_;
+    case realValue:     return value_.real_;
+    case booleanValue:  return value_.bool_ ? 1.0 : 0.0;
+    case nullValue:     return 0.0;
+    default:
+        throw std::runtime_error ("FlatValue is not convertible to double");
+    }
+}
+
+bool
+FlatValue::asBool () const
+{
+    switch (type_)
+    {
+    case intValue:      return value_.int_ != 0;
+    case uintValue:     return value_.uint_ != 0;
+    case realValue:     return value_.real_ != 0.0;
+    case booleanValue:  return value_.bool_;
+    case stringValue:   return value_.string_.size != 0;
+    case arrayValue:    return !value_.elements_->empty ();
+    case objectValue:   return !value_.members_->empty ();
+    default:            return false;
+    }
+}
+
+char const*
+FlatValue::asCString () const
+{
+    assert (type_ == stringValue);
+    return value_.string_.data;
+}
+
+boost::string_ref
+FlatValue::asStringRef () const
+{
+    assert (type_ == stringValue);
+    return { value_.string_.data, value_.string_.size };
+}
+
+std::string
+FlatValue::asString () const
+{
+    switch (type_)
+    {
+    case nullValue:     return "";
+    case stringValue:
+        return std::string (value_.string_.data, value_.string_.size);
+    case booleanValue:  return value_.bool_ ? "true" : "false";
+    case intValue:      return valueToString (value_.int_);
+    case uintValue:     return valueToString (value_.uint_);
+    case realValue:     return valueToString (value_.real_);
+    default:
+        throw std::runtime_error ("FlatValue is not convertible to string");
+    }
+}
+
+FlatValue::UInt
+FlatValue::size () const
+{
+    switch (type_)
+    {
+    case arrayValue:    return value_.elements_->size ();
+    case objectValue:   return value_.members_->size ();
+    default:            return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+FlatValue::Members&
+FlatValue::makeObject ()
+{
+    if (type_ != objectValue)
+        *this = objectValue;
+    return *value_.members_;
+}
+
+FlatValue::Elements&
+FlatValue::makeArray ()
+{
+    if (type_ != arrayValue)
+        *this = arrayValue;
+    return *value_.elements_;
+}
+
+FlatValue&
+FlatValue::resolve (char const* key, bool isStatic)
+{
+    if (type_ != nullValue && type_ != objectValue)
+        throw std::logic_error ("FlatValue::operator[]: not an object");
+
+    auto& members = makeObject ();
+
+    // Members usually arrive in order, so check the end first
+    auto it = members.end ();
+    if (members.empty () || !keyLess (members.back (), key))
+    {
+        it = std::lower_bound (members.begin (), members.end (), key, keyLess);
+        if (it != members.end () &&
+            (it->key == key || std::strcmp (it->key, key) == 0))
+            return *it->value;
+    }
+
+    auto v = new (arena_->allocate (sizeof (FlatValue),
+        alignof (FlatValue))) FlatValue (*arena_);
+    members.insert (it, { isStatic ? key :
+        arena_->copy (key, std::strlen (key)), v });
+    return *v;
+}
+
+FlatValue&
+FlatValue::operator[] (StaticString const& key)
+{
+    return resolve (key.c_str (), true);
+}
+
+FlatValue&
+FlatValue::operator[] (std::string const& key)
+{
+    return resolve (key.c_str (), false);
+}
+
+FlatValue&
+FlatValue::operator[] (char const* key)
+{
+    return resolve (key, false);
+}
+
+FlatValue const*
+FlatValue::find (char const* key) const
+{
+    if (type_ != objectValue)
+        return nullptr;
+
+    auto const& members = *value_.members_;
+    auto it = std::lower_bound (members.begin (), members.end (), key, keyLess);
+    if (it != members.end () && std::strcmp (it->key, key) == 0)
+        return it->value;
+    return nullptr;
+}
+
+FlatValue&
+FlatValue::append ()
+{
+    if (type_ != nullValue && type_ != arrayValue)
+        throw std::logic_error ("FlatValue::append: not an array");
+
+    auto v = new (arena_->allocate (sizeof (FlatValue),
+        alignof (FlatValue))) FlatValue (*arena_);
+    makeArray ().push_back (v);
+    return *v;
+}
+
+FlatValue const&
+FlatValue::operator[] (UInt index) const
+{
+    assert (type_ == arrayValue && index < value_.elements_->size ());
+    return *(*value_.elements_)[index];
+}
+
+FlatValue::Members const&
+FlatValue::members () const
+{
+    assert (type_ == objectValue);
+    return *value_.members_;
+}
+
+FlatValue::Elements const&
+FlatValue::elements () const
+{
+    assert (type_ == arrayValue);
+    return *value_.elements_;
+}
+
+Json::Value
+FlatValue::toValue () const
+{
+    switch (type_)
+    {
+    case nullValue:     return Json::Value ();
+    case intValue:      return Json::Value (value_.int_);
+    case uintValue:     return Json::Value (value_.uint_);
+    case realValue:     return Json::Value (value_.real_);
+    case booleanValue:  return Json::Value (value_.bool_);
+    case stringValue:
+        return Json::Value (value_.string_.data,
+            value_.string_.data + value_.string_.size);
+
+    case arrayValue:
+    {
+        Json::Value result (Json::arrayValue);
+        for (auto const e : *value_.elements_)
+            result.append (e->toValue ());
+        return result;
+    }
+
+    case objectValue:
+    {
+        Json::Value result (Json::objectValue);
+        for (auto const& m : *value_.members_)
+            result[m.key] = m.value->toValue ();
+        return result;
+    }
+    }
+
+    assert (false);
+    return Json::Value ();
+}
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+void
+writeString (write_t const& write, std::string const& s)
+{
+    write (s.data (), s.size ());
+}
+
+void
+writeFlat (write_t const& write, FlatValue const& value)
+{
+    switch (value.type ())
+    {
+    case nullValue:
+        write ("null", 4);
+        break;
+
+    case intValue:
+        writeString (write, valueToString (value.asInt ()));
+        break;
+
+    case uintValue:
+        writeString (write, valueToString (value.asUInt ()));
+        break;
+
+    case realValue:
+        writeString (write, valueToString (value.asDouble ()));
+        break;
+
+    case stringValue:
+    {
+        auto const string = value.asStringRef ();
+        writeString (write, valueToQuotedString (
+            string.data (), string.size ()));
+        break;
+    }
+
+    case booleanValue:
+        writeString (write, valueToString (value.asBool ()));
+        break;
+
+    case arrayValue:
+    {
+        write ("[", 1);
+        bool first = true;
+        for (auto const e : value.elements ())
+        {
+            if (!first)
+                write (",", 1);
+            first = false;
+            writeFlat (write, *e);
+        }
+        write ("]", 1);
+        break;
+    }
+
+    case objectValue:
+    {
+        write ("{", 1);
+        bool first = true;
+        for (auto const& m : value.members ())
+        {
+            if (!first)
+                write (",", 1);
+            first = false;
+            writeString (write, valueToQuotedString (m.key));
+            write (":", 1);
+            writeFlat (write, *m.value);
+        }
+        write ("}", 1);
+        break;
+    }
+    }
+}
+
+} // namespace
+
+void
+stream (FlatValue const& value, write_t write)
+{
+    writeFlat (write, value);
+    write ("\n", 1);
+}
+
+} // Json
@@ -187,6 +187,26 @@ void Object::set (std::string const& k, Json::Value const& v)
     assert (false);  // Can't get here.
 }
 
+void Array::append (Json::FlatValue const& v)
+{
+    checkWritable ("append");
+    if (writer_)
+    {
+        writer_->rawAppend ();
+        writer_->output (v);
+    }
+}
+
+void Object::set (std::string const& k, Json::FlatValue const& v)
+{
+    checkWritable ("set");
+    if (writer_)
+    {
+        writer_->rawSet (k);
+        writer_->output (v);
+    }
+}
+
 //------------------------------------------------------------------------------
 
 namespace {
@@ -215,6 +235,11 @@ void copyFrom (Object& to, Json::Value const& from)
     doCopyFrom (to, from);
 }
 
+void copyFrom (Json::FlatValue& to, Json::Value const& from)
+{
+    doCopyFrom (to, from);
+}
+
 WriterObject stringWriterObject (std::string& s)
 {
     return WriterObject (stringOutput (s));
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <common/json/FlatValue.h>
 #include <common/json/Output.h>
 #include <common/json/Writer.h>
 
@@ -92,6 +93,56 @@ void outputJson (Json::Value const& value, Writer& writer)
     } // switch
 }
 
+void outputJson (Json::FlatValue const& value, Writer& writer)
+{
+    switch (value.type())
+    {
+    case Json::nullValue:
+        writer.output (nullptr);
+        break;
+
+    case Json::intValue:
+        writer.output (value.asInt());
+        break;
+
+    case Json::uintValue:
+        writer.output (value.asUInt());
+        break;
+
+    case Json::realValue:
+        writer.output (value.asDouble());
+        break;
+
+    case Json::stringValue:
+        writer.output (value.asStringRef());
+        break;
+
+    case Json::booleanValue:
+        writer.output (value.asBool());
+        break;
+
+    case Json::arrayValue:
+        writer.startRoot (Writer::array);
+        for (auto const element: value.elements())
+        {
+            writer.rawAppend();
+            outputJson (*element, writer);
+        }
+        writer.finish();
+        break;
+
+    case Json::objectValue:
+        writer.startRoot (Writer::object);
+        for (auto const& member: value.members())
+        {
+            writer.rawSet (member.key);
+            outputJson (*member.value, writer);
+        }
+        writer.finish();
+        break;
+    } // switch
+}
+
 } // namespace
 
 void outputJson (Json::Value const& value, Output const& out)
@@ -100,6 +151,20 @@ void outputJson (Json::Value const& value, Output const& out)
     outputJson (value, writer);
 }
 
+void outputJson (Json::FlatValue const& value, Output const& out)
+{
+    Writer writer (out);
+    outputJson (value, writer);
+}
+
+std::string jsonAsString (Json::FlatValue const& value)
+{
+    std::string s;
+    Writer writer (stringOutput (s));
+    outputJson (value, writer);
+    return s;
+}
+
 std::string jsonAsString (Json::Value const& value)
 {
     std::string s;
@@ -116,7 +116,21 @@ public:
                 }
                 output_ ({i->second, jsonEscapeLength});
                 writtenUntil = position + 1;
-            };
+            }
+            else if (static_cast <unsigned char> (data[position]) < 0x20)
+            {
+                // Other control characters, including NUL, need \u escapes
+                if (writtenUntil < position)
+                {
+                    output_ ({data + writtenUntil, position - writtenUntil});
+                }
+                char const* const hex = "0123456789ABCDEF";
+                auto const c = static_cast <unsigned char> (data[position]);
+                char const escape[] = {'\\', 'u', '0', '0',
+                    hex[c >> 4], hex[c & 0xf]};
+                output_ ({escape, sizeof (escape)});
+                writtenUntil = position + 1;
+            }
         }
         if (writtenUntil < position)
             output_ ({data + writtenUntil, position - writtenUntil});
@@ -241,12 +255,23 @@ void Writer::output (std::string const& s)
     impl_->stringOutput (s);
 }
 
+void Writer::output (boost::string_ref const& s)
+{
+    impl_->stringOutput (s);
+}
+
 void Writer::output (Json::Value const& value)
 {
     impl_->markStarted();
     outputJson (value, impl_->getOutput());
 }
 
+void Writer::output (Json::FlatValue const& value)
+{
+    impl_->markStarted();
+    outputJson (value, impl_->getOutput());
+}
+
 void Writer::output (float f)
 {
     auto s = bessel::to_string (f);
@@ -29,18 +29,7 @@ namespace Json
 
 static bool isControlCharacter (char ch)
 {
-    return ch > 0 && ch <= 0x1F;
-}
-
-static bool containsControlCharacter ( const char* str )
-{
-    while ( *str )
-    {
-        if ( isControlCharacter ( * (str++) ) )
-            return true;
-    }
-
-    return false;
+    return ch >= 0 && ch <= 0x1F;
 }
 static void uintToString ( unsigned int value,
                            char*& current )
@@ -105,20 +94,30 @@ std::string valueToString ( bool value )
 }
 
 std::string valueToQuotedString ( const char* value )
+{
+    return valueToQuotedString ( value, strlen (value) );
+}
+
+std::string valueToQuotedString ( const char* value, std::size_t size )
 {
     // Not sure how to handle unicode...
-    if (strpbrk (value, "\"\\\b\f\n\r\t") == nullptr && !containsControlCharacter ( value ))
-        return std::string ("\"") + value + "\"";
+    const char* const end = value + size;
+    bool plain = true;
+    for (const char* c = value; plain && c != end; ++c)
+        plain = !isControlCharacter ( *c ) && strchr ("\"\\", *c) == nullptr;
+
+    if (plain)
+        return "\"" + std::string (value, size) + "\"";
 
     // We have to walk value and escape any special characters.
     // Appending to std::string is not efficient, but this should be rare.
     // (Note: forward slashes are *not* rare, but I am not escaping them.)
-    unsigned maxsize = strlen (value) * 2 + 3; // allescaped+quotes+NULL
+    std::size_t maxsize = size * 2 + 3; // allescaped+quotes+NULL
     std::string result;
     result.reserve (maxsize); // to avoid lots of mallocs
     result += "\"";
 
-    for (const char* c = value; *c != 0; ++c)
+    for (const char* c = value; c != value + size; ++c)
     {
         switch (*c)
         {
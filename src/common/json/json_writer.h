@@ -170,6 +170,7 @@ std::string valueToString ( UInt value );
 std::string valueToString ( double value );
 std::string valueToString ( bool value );
 std::string valueToQuotedString ( const char* value );
+std::string valueToQuotedString ( const char* value, std::size_t size );
 
 /// \brief Output using the StyledStreamWriter.
 /// \see Json::operator>>()
@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <common/json/FastReader.h>
+#include <common/json/json_reader.h>
+#include <common/json/to_string.h>
+#include <beast/unit_test/suite.h>
+#include <string>
+
+namespace Json {
+
+class FastReader_test : public beast::unit_test::suite
+{
+public:
+    // Checks that the tape and Json::Reader agree on a document
+    void
+    checkSame (std::string const& document)
+    {
+        FastReader reader;
+        Value value;
+
+        expect (reader.parse (document), document);
+        expect (Reader ().parse (document, value), document);
+
+        TapeValue const root = reader.root ();
+        expect (to_string (root.toValue ()) == to_string (value), document);
+        expect (root.getMemberNames () == value.getMemberNames (), document);
+
+        for (auto const& name : value.getMemberNames ())
+        {
+            expect (root.isMember (name), name);
+            expect (to_string (root[name].toValue ()) ==
+                to_string (value[name]), name);
+        }
+
+        expect (! root.isMember ("absent"));
+        expect (root["absent"].isNull ());
+    }
+
+    void
+    testMembers ()
+    {
+        testcase ("members");
+
+        checkSame ("{\"b\":1,\"a\":2,\"ab\":3,\"\":4,\"aa\":[true,false]}");
+
+        // Wider than a linear scan is worth, and nested
+        std::string wide = "{";
+        for (int i = 40; i > 0; --i)
+            wide += "\"k" + std::to_string (i) + "\":" + std::to_string (i) + ",";
+        wide += "\"nested\":{\"z\":1,\"y\":[{\"q\":1,\"p\":2}]}}";
+        checkSame (wide);
+
+        FastReader reader;
+        expect (reader.parse (wide));
+        expect (reader.root ()["nested"]["y"][0u]["p"].asInt () == 2);
+        expect (reader.root ()["k17"].asInt () == 17);
+    }
+
+    void
+    testNullMember ()
+    {
+        testcase ("null member");
+
+        std::string const document = "{\"Fee\":null,\"Sequence\":1}";
+        checkSame (document);
+
+        FastReader reader;
+        Value value;
+        expect (reader.parse (document));
+        expect (Reader ().parse (document, value));
+
+        // Present with a null value is still a member
+        expect (value.isMember ("Fee"));
+        expect (reader.root ().isMember ("Fee"));
+        expect (reader.root ().isMember (std::string ("Fee")));
+        expect (reader.root ()["Fee"].isNull ());
+    }
+
+    void
+    testDeclined ()
+    {
+        testcase ("declined");
+
+        char const* const documents[] = {
+            "{\"a\":1,\"b\":2,\"a\":3}",
+            "[{\"x\":1,\"x\":1}]",
+            "// comment\n{}",
+            "{\"a\":1} trailing",
+            "[\"\\u0000\"]",
+        };
+
+        for (auto const document : documents)
+        {
+            FastReader reader;
+            expect (! reader.parse (document), document);
+        }
+
+        // The helper falls back to Json::Reader and leaves no tape
+        static StaticString const key ("a");
+        FastReader reader;
+        Value value;
+        TapeValue tape;
+        expect (parse (reader, "// comment\n{\"a\":1}", value, tape, key));
+        expect (tape.isNull ());
+        expect (value["a"].asInt () == 1);
+
+        expect (parse (reader, "{\"a\":[1,2]}", value, tape, key));
+        expect (tape.isObject ());
+        expect (tape["a"][1u].asInt () == 2);
+        expect (value["a"][1u].asInt () == 2);
+
+        // Documents without the key are left to Json::Reader
+        expect (parse (reader, "{\"b\":[1,2]}", value, tape, key));
+        expect (tape.isNull ());
+        expect (value["b"][1u].asInt () == 2);
+    }
+
+    void
+    run ()
+    {
+        testMembers ();
+        testNullMember ();
+        testDeclined ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FastReader,json,bessel);
+
+} // Json
@@ -0,0 +1,217 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <common/json/FlatValue.h>
+#include <common/json/Output.h>
+#include <common/json/to_string.h>
+#include <beast/unit_test/suite.h>
+#include <stdexcept>
+#include <string>
+
+namespace Json {
+
+class FlatValue_test : public beast::unit_test::suite
+{
+public:
+    static std::string
+    output (Value const& value)
+    {
+        std::string s;
+        outputJson (value, stringOutput (s));
+        return s;
+    }
+
+    static std::string
+    output (FlatValue const& value)
+    {
+        std::string s;
+        outputJson (value, stringOutput (s));
+        return s;
+    }
+
+    // Fills either representation the same way, with members out of order
+    template <class JsonValue>
+    static void
+    fill (JsonValue& json)
+    {
+        static StaticString const account ("Account");
+
+        json["zeta"] = "last";
+        json[account] = "bHb9CJAWyB4bj91VRWn96DkukG4bwdtyTh";
+        json[std::string ("count")] = UInt (7);
+        json["negative"] = Int (-3);
+        json["ratio"] = 0.5;
+        json["flag"] = true;
+        json["none"] = nullValue;
+
+        auto& list = json["list"] = arrayValue;
+        list.append (UInt (1));
+        list.append ("two");
+        list.append (objectValue)["inner"] = false;
+    }
+
+    void
+    testBuild ()
+    {
+        testcase ("build");
+
+        Value value (objectValue);
+        fill (value);
+
+        Arena arena;
+        FlatValue flat (arena, objectValue);
+        fill (flat);
+
+        expect (flat.size () == value.size ());
+        expect (output (flat) == output (value), output (flat));
+        expect (to_string (flat.toValue ()) == to_string (value));
+
+        // Members are kept in key order
+        auto const& members = flat.members ();
+        for (std::size_t i = 1; i < members.size (); ++i)
+            expect (std::string (members[i - 1].key) < members[i].key);
+
+        expect (flat.isMember ("list"));
+        expect (flat.isMember (std::string ("Account")));
+        expect (! flat.isMember ("absent"));
+        expect (flat.find ("absent") == nullptr);
+        expect (flat.find ("count")->asUInt () == 7);
+        expect (flat["list"][1u].asString () == "two");
+
+        // Assigning to an existing member replaces it in place
+        flat["count"] = UInt (8);
+        expect (flat.size () == value.size ());
+        expect (flat.find ("count")->asUInt () == 8);
+    }
+
+    void
+    testCopy ()
+    {
+        testcase ("copy");
+
+        Value value (objectValue);
+        fill (value);
+
+        Arena arena;
+        FlatValue flat (arena);
+        flat = value;
+        expect (output (flat) == output (value));
+
+        // A copy into another arena does not share its strings
+        Arena other;
+        FlatValue copy (other);
+        copy = flat;
+        flat["zeta"] = "changed";
+        expect (output (copy) == output (value));
+        expect (copy["zeta"].asString () == "last");
+    }
+
+    void
+    testEmbeddedNul ()
+    {
+        testcase ("embedded NUL");
+
+        std::string const s ("ab\0cd", 5);
+
+        Arena arena;
+        FlatValue flat (arena, objectValue);
+        flat["s"] = s;
+
+        FlatValue const& member = *flat.find ("s");
+        expect (member.asString () == s);
+        expect (member.asStringRef ().size () == 5);
+        expect (output (flat) == "{\"s\":\"ab\\u0000cd\"}", output (flat));
+
+        // A copy keeps the whole string as well
+        Arena other;
+        FlatValue copy (other);
+        copy = flat;
+        expect (copy.find ("s")->asString () == s);
+    }
+
+    template <class Function>
+    void
+    expectThrow (Function f, std::string const& message)
+    {
+        try
+        {
+            f ();
+            fail (message);
+        }
+        catch (std::runtime_error const& e)
+        {
+            expect (e.what () == message, e.what ());
+        }
+    }
+
+    void
+    testConversions ()
+    {
+        testcase ("conversions");
+
+        Arena arena;
+        FlatValue v (arena);
+
+        expect (v.asInt () == 0);
+        expect (v.asUInt () == 0);
+        expect (! v.asBool ());
+
+        v = true;
+        expect (v.asInt () == 1);
+
+        v = Int (-5);
+        expect (v.asInt () == -5);
+        expect (v.asDouble () == -5.0);
+        expectThrow ([&] { v.asUInt (); },
+            "Negative integer can not be converted to unsigned integer");
+
+        v = UInt (Value::maxInt);
+        expect (v.asInt () == Value::maxInt);
+        v = UInt (Value::maxInt) + 1;
+        expectThrow ([&] { v.asInt (); },
+            "integer out of signed integer range");
+
+        v = 1e20;
+        expectThrow ([&] { v.asInt (); },
+            "Real out of signed integer range");
+        expectThrow ([&] { v.asUInt (); },
+            "Real out of unsigned integer range");
+
+        v = -1.0;
+        expectThrow ([&] { v.asUInt (); },
+            "Real out of unsigned integer range");
+
+        v = 42.0;
+        expect (v.asUInt () == 42);
+    }
+
+    void
+    run ()
+    {
+        testBuild ();
+        testCopy ();
+        testEmbeddedNul ();
+        testConversions ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FlatValue,json,bessel);
+
+} // Json
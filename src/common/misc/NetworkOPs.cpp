@@ -32,6 +32,7 @@
 #include <ledger/LedgerTiming.h>
 #include <ledger/LedgerToJson.h>
 #include <ledger/OrderBookDB.h>
+#include <main/CollectorManager.h>
 #include <main/LoadManager.h>
 #include <main/LocalCredentials.h>
 #include <transaction/book/Quality.h>
@@ -61,6 +62,7 @@
 #include <protocol/BuildInfo.h>
 #include <protocol/HashPrefix.h>
 #include <protocol/Indexes.h>
+#include <services/websocket/Deflate.h>
 #include <common/misc/Utility.h>
 #include <boost/lexical_cast.hpp>
 
@@ -87,7 +89,7 @@ public:
     NetworkOPsImp (
             clock_type& clock, bool standalone, std::size_t network_quorum,
             JobQueue& job_queue, LedgerMaster& ledgerMaster, Stoppable& parent,
-            beast::Journal journal)
+            CollectorManager& collectorManager, beast::Journal journal)
         : NetworkOPs (parent)
         , m_clock (clock)
         , m_journal (journal)
@@ -115,6 +117,7 @@ public:
         , m_job_queue (job_queue)
         , m_standalone (standalone)
         , m_network_quorum (network_quorum)
+        , m_deflateStats (collectorManager.group ("ws_deflate"))
     {
     }
 
@@ -533,6 +536,9 @@ private:
     std::string getHostId (bool forAdmin);
 
 private:
+    // Outbound queues of subscribers that have fallen behind
+    Json::Value getSendQueues ();
+
     clock_type& m_clock;
 
     typedef hash_map <Account, SubMapType> SubInfoMapType;
@@ -608,6 +614,9 @@ private:
 
     // The number of nodes that we need to consider ourselves connected
     std::size_t const m_network_quorum;
+
+    // Compression of the objects published to websocket subscribers
+    websocket::DeflateStats m_deflateStats;
 };
 
 //------------------------------------------------------------------------------
@@ -900,7 +909,7 @@ void NetworkOPsImp::submitTransaction (
     }
 
     // this is an asynchronous interface
-    Serializer s;
+    PooledSerializer s;
     iTrans->add (s);
 
     SerialIter sit (s);
@@ -963,11 +972,11 @@ Transaction::pointer NetworkOPsImp::submitTransactionSync (
     Transaction::ref tpTrans,
     bool bAdmin, bool bLocal, bool bFailHard, bool bSubmit)
 {
-    Serializer s;
+    PooledSerializer s;
     tpTrans->getSTransaction ()->add (s);
 	
     auto tpTransNew = Transaction::sharedTransaction (
-        s.getData (), Validate::YES);
+        s.peekData (), Validate::YES);
 
     if (!tpTransNew)
     {
@@ -1109,9 +1118,9 @@ Transaction::pointer NetworkOPsImp::processTransactionCb (
                     trans->getID (), peers, SF_RELAYED))
             {
                 protocol::TMTransaction tx;
-                Serializer s;
+                PooledSerializer s;
                 trans->getSTransaction ()->add (s);
-                tx.set_rawtransaction (&s.getData ().front (), s.getLength ());
+                tx.set_rawtransaction (s.data (), s.size ());
                 tx.set_status (protocol::tsCURRENT);
                 tx.set_receivetimestamp (getNetworkTimeNC ());
                 // FIXME: This should be when we received it
@@ -1717,8 +1726,7 @@ void NetworkOPsImp::pubServer ()
         jvObj [jss::load_factor]   =
                 (mLastLoadFactor = getApp().getFeeTrack ().getLoadFactor ());
 
-        std::string sObj = to_string (jvObj);
-
+        websocket::Broadcast const broadcast (jvObj, m_deflateStats);
 
         for (auto i = mSubServer.begin (); i != mSubServer.end (); )
         {
@@ -1729,7 +1737,7 @@ void NetworkOPsImp::pubServer ()
             //             sending of JSON data.
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                p->send (broadcast);
                 ++i;
             }
             else
@@ -2138,8 +2146,14 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     //      info[jss::consensus] = mConsensus->getJson();
 
     if (admin)
+    {
         info[jss::load] = m_job_queue.getJson ();
 
+        Json::Value queues = getSendQueues ();
+        if (queues.size () != 0)
+            info["send_queues"] = queues;
+    }
+
     if (!human)
     {
         info[jss::load_base] = getApp().getFeeTrack ().getLoadBase ();
@@ -2251,6 +2265,43 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     return info;
 }
 
+Json::Value NetworkOPsImp::getSendQueues ()
+{
+    std::map <std::uint64_t, InfoSub::pointer> listeners;
+
+    auto collect = [&listeners](SubMapType const& subMap)
+    {
+        for (auto const& sub : subMap)
+            if (auto p = sub.second.lock ())
+                listeners.emplace (sub.first, std::move (p));
+    };
+
+    {
+        ScopedLockType sl (mSubLock);
+
+        collect (mSubLedger);
+        collect (mSubServer);
+        collect (mSubTransactions);
+        collect (mSubRTTransactions);
+
+        for (auto const& account : mSubAccount)
+            collect (account.second);
+        for (auto const& account : mSubRTAccount)
+            collect (account.second);
+    }
+
+    Json::Value ret (Json::arrayValue);
+
+    for (auto const& listener : listeners)
+    {
+        Json::Value queue = listener.second->getSendQueue ();
+        if (!queue.isNull ())
+            ret.append (queue);
+    }
+
+    return ret;
+}
+
 void NetworkOPsImp::clearLedgerFetch ()
 {
     getApp().getInboundLedgers().clearFailures();
@@ -2285,6 +2336,7 @@ void NetworkOPsImp::pubProposedTransaction (
     Ledger::ref lpCurrent, STTx::ref stTxn, TER terResult)
 {
     Json::Value jvObj   = transJson (*stTxn, terResult, false, lpCurrent);
+    websocket::Broadcast const broadcast (jvObj, m_deflateStats);
 
     {
         ScopedLockType sl (mSubLock);
@@ -2296,7 +2348,7 @@ void NetworkOPsImp::pubProposedTransaction (
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (broadcast);
                 ++it;
             }
             else
@@ -2345,13 +2397,15 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
                         = getApp().getLedgerMaster ().getCompleteLedgers ();
             }
 
+            websocket::Broadcast const broadcast (jvObj, m_deflateStats);
+
             auto it = mSubLedger.begin ();
             while (it != mSubLedger.end ())
             {
                 InfoSub::pointer p = it->second.lock ();
                 if (p)
                 {
-                    p->send (jvObj, true);
+                    p->send (broadcast);
                     ++it;
                 }
                 else
@@ -2440,7 +2494,7 @@ void NetworkOPsImp::pubValidatedTransaction (
         *alTx.getTxn (), alTx.getResult (), true, alAccepted);
     jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
-    std::string sObj = to_string (jvObj);
+    websocket::Broadcast const broadcast (jvObj, m_deflateStats);
 
     {
         ScopedLockType sl (mSubLock);
@@ -2452,7 +2506,7 @@ void NetworkOPsImp::pubValidatedTransaction (
 
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                p->send (broadcast);
                 ++it;
             }
             else
@@ -2467,7 +2521,7 @@ void NetworkOPsImp::pubValidatedTransaction (
 
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                p->send (broadcast);
                 ++it;
             }
             else
@@ -2552,11 +2606,11 @@ void NetworkOPsImp::pubAccountTransaction (
         if (alTx.isApplied ())
             jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
-        std::string sObj = to_string (jvObj);
+        websocket::Broadcast const broadcast (jvObj, m_deflateStats);
 
         for (InfoSub::ref isrListener : notify)
         {
-            isrListener->send (jvObj, sObj, true);
+            isrListener->send (broadcast);
         }
     }
 }
@@ -3426,10 +3480,11 @@ NetworkOPs::~NetworkOPs ()
 std::unique_ptr<NetworkOPs>
 make_NetworkOPs (NetworkOPs::clock_type& clock, bool standalone,
     std::size_t network_quorum, JobQueue& job_queue, LedgerMaster& ledgerMaster,
-    beast::Stoppable& parent, beast::Journal journal)
+    beast::Stoppable& parent, CollectorManager& collectorManager,
+    beast::Journal journal)
 {
     return std::make_unique<NetworkOPsImp> (clock, standalone, network_quorum,
-        job_queue, ledgerMaster, parent, journal);
+        job_queue, ledgerMaster, parent, collectorManager, journal);
 }
 
 } // bessel
@@ -37,6 +37,7 @@ namespace bessel {
 // Operations that clients may wish to perform against the network
 // Master operational handler, server sequencer, network tracker
 
+class CollectorManager;
 class Peer;
 class LedgerConsensus;
 class LedgerMaster;
@@ -325,7 +326,8 @@ public:
 std::unique_ptr<NetworkOPs>
 make_NetworkOPs (NetworkOPs::clock_type& clock, bool standalone,
     std::size_t network_quorum, JobQueue& job_queue, LedgerMaster& ledgerMaster,
-    beast::Stoppable& parent, beast::Journal journal);
+    beast::Stoppable& parent, CollectorManager& collectorManager,
+    beast::Journal journal);
 
 } // bessel
 
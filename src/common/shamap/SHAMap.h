@@ -89,10 +89,16 @@ private:
     bool                            backed_ = true; // Map is backed by the database
 
 public:
-    using DeltaItem = std::pair<std::shared_ptr<SHAMapItem>,
-                                std::shared_ptr<SHAMapItem>>;
+    using DeltaItem = std::pair<boost::intrusive_ptr<SHAMapItem const>,
+                                boost::intrusive_ptr<SHAMapItem const>>;
     using Delta     = std::map<uint256, DeltaItem>;
 
+    /** Invokes a function once for each of the 16 root branches.
+        The calls may run concurrently.
+    */
+    using ForEachBranch =
+        std::function<void (std::function<void (int)> const&)>;
+
     ~SHAMap ();
     SHAMap(SHAMap const&) = delete;
     SHAMap& operator=(SHAMap const&) = delete;
@@ -120,13 +126,23 @@ public:
     // normal hash access functions
     bool hasItem (uint256 const& id) const;
     bool delItem (uint256 const& id);
-    bool addItem (SHAMapItem const& i, bool isTransaction, bool hasMeta);
-    bool addItem (SHAMapItem&& i, bool isTransaction, bool hasMeta);
     uint256 getHash () const;
 
+    /** Build the contents of an empty map from leaves sorted by key.
+
+        Each root branch is built and hashed independently through forEach.
+        When the map is backed, every node is written to the node store in
+        batches as it is built, so the map is left clean as if flushed.
+
+        Throws if the items are not strictly ascending.
+    */
+    void addSortedItems (std::vector<boost::intrusive_ptr<SHAMapItem const>> const& items,
+                         SHAMapTreeNode::TNType type, NodeObjectType t,
+                         ForEachBranch const& forEach);
+
     // save a copy if you have a temporary anyway
-    bool updateGiveItem (std::shared_ptr<SHAMapItem> const&, bool isTransaction, bool hasMeta);
-    bool addGiveItem (std::shared_ptr<SHAMapItem> const&, bool isTransaction, bool hasMeta);
+    bool updateGiveItem (boost::intrusive_ptr<SHAMapItem const> const&, bool isTransaction, bool hasMeta);
+    bool addGiveItem (boost::intrusive_ptr<SHAMapItem const> const&, bool isTransaction, bool hasMeta);
 
     /** Fetch an item given its key.
         This retrieves the item whose key matches.
@@ -135,26 +151,24 @@ public:
             Can throw SHAMapMissingNode
         @note This can cause NodeStore reads
     */
-    //  NOTE This should return `const&` when SHAMapTreeNode
-    //             stores std::shared_ptr<SHAMapItem const>
-    std::shared_ptr<SHAMapItem const> fetch (uint256 const& key) const;
+    boost::intrusive_ptr<SHAMapItem const> const& fetch (uint256 const& key) const;
 
     //  NOTE Is "save a copy" the in imperative or indicative mood?
     // save a copy if you only need a temporary
-    std::shared_ptr<SHAMapItem> peekItem (uint256 const& id) const;
-    std::shared_ptr<SHAMapItem> peekItem (uint256 const& id, uint256 & hash) const;
-    std::shared_ptr<SHAMapItem> peekItem (uint256 const& id, SHAMapTreeNode::TNType & type) const;
+    boost::intrusive_ptr<SHAMapItem const> peekItem (uint256 const& id) const;
+    boost::intrusive_ptr<SHAMapItem const> peekItem (uint256 const& id, uint256 & hash) const;
+    boost::intrusive_ptr<SHAMapItem const> peekItem (uint256 const& id, SHAMapTreeNode::TNType & type) const;
 
     // traverse functions
-    std::shared_ptr<SHAMapItem> peekFirstItem () const;
-    std::shared_ptr<SHAMapItem> peekFirstItem (SHAMapTreeNode::TNType & type) const;
-    std::shared_ptr<SHAMapItem> peekLastItem () const;
-    std::shared_ptr<SHAMapItem> peekNextItem (uint256 const& ) const;
-    std::shared_ptr<SHAMapItem> peekNextItem (uint256 const& , SHAMapTreeNode::TNType & type) const;
-    std::shared_ptr<SHAMapItem> peekPrevItem (uint256 const& ) const;
+    boost::intrusive_ptr<SHAMapItem const> peekFirstItem () const;
+    boost::intrusive_ptr<SHAMapItem const> peekFirstItem (SHAMapTreeNode::TNType & type) const;
+    boost::intrusive_ptr<SHAMapItem const> peekLastItem () const;
+    boost::intrusive_ptr<SHAMapItem const> peekNextItem (uint256 const& ) const;
+    boost::intrusive_ptr<SHAMapItem const> peekNextItem (uint256 const& , SHAMapTreeNode::TNType & type) const;
+    boost::intrusive_ptr<SHAMapItem const> peekPrevItem (uint256 const& ) const;
 
     void visitNodes (std::function<bool (SHAMapTreeNode&)> const&) const;
-    void visitLeaves(std::function<void (std::shared_ptr<SHAMapItem> const&)> const&) const;
+    void visitLeaves(std::function<void (boost::intrusive_ptr<SHAMapItem const> const&)> const&) const;
 
     // comparison/sync functions
     void getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<uint256>& hashes, int max,
@@ -174,6 +188,13 @@ public:
     SHAMapAddNode addKnownNode (SHAMapNodeID const& nodeID, Blob const& rawNode,
                                 SHAMapSyncFilter * filter);
 
+    /** Attach a node that was already decoded and hashed from wire format.
+        This lets callers do the expensive decoding outside of any lock.
+    */
+    SHAMapAddNode addKnownNode (SHAMapNodeID const& nodeID,
+                                std::shared_ptr<SHAMapTreeNode> const& newNode,
+                                SHAMapSyncFilter * filter);
+
     // status functions
     void setImmutable ();
     bool isSynching () const;
@@ -204,8 +225,8 @@ public:
 private:
     using SharedPtrNodeStack =
         std::stack<std::pair<std::shared_ptr<SHAMapTreeNode>, SHAMapNodeID>>;
-    using DeltaRef = std::pair<std::shared_ptr<SHAMapItem> const&,
-                               std::shared_ptr<SHAMapItem> const&> ;
+    using DeltaRef = std::pair<boost::intrusive_ptr<SHAMapItem const> const&,
+                               boost::intrusive_ptr<SHAMapItem const> const&> ;
 
     int unshare ();
 
@@ -233,7 +254,7 @@ private:
         getStack (uint256 const& id, bool include_nonmatching_leaf) const;
 
     /** Walk to the specified index, returning the node */
-    SHAMapTreeNode* walkToPointer (uint256 const& id) const;
+    SHAMapLeafNode* walkToPointer (uint256 const& id) const;
 
     /** Unshare the node, allowing it to be modified */
     void unshareNode (std::shared_ptr<SHAMapTreeNode>&, SHAMapNodeID const& nodeID);
@@ -245,36 +266,50 @@ private:
     void writeNode (NodeObjectType t, std::uint32_t seq,
         std::shared_ptr<SHAMapTreeNode>& node) const;
 
-    SHAMapTreeNode* firstBelow (SHAMapTreeNode*) const;
-    SHAMapTreeNode* lastBelow (SHAMapTreeNode*) const;
+    SHAMapLeafNode* firstBelow (SHAMapTreeNode*) const;
+    SHAMapLeafNode* lastBelow (SHAMapTreeNode*) const;
 
     // Simple descent
     // Get a child of the specified node
-    SHAMapTreeNode* descend (SHAMapTreeNode*, int branch) const;
-    SHAMapTreeNode* descendThrow (SHAMapTreeNode*, int branch) const;
-    std::shared_ptr<SHAMapTreeNode> descend (std::shared_ptr<SHAMapTreeNode> const&, int branch) const;
-    std::shared_ptr<SHAMapTreeNode> descendThrow (std::shared_ptr<SHAMapTreeNode> const&, int branch) const;
+    SHAMapTreeNode* descend (SHAMapInnerNode*, int branch) const;
+    SHAMapTreeNode* descendThrow (SHAMapInnerNode*, int branch) const;
+    std::shared_ptr<SHAMapTreeNode> descend (std::shared_ptr<SHAMapInnerNode> const&, int branch) const;
+    std::shared_ptr<SHAMapTreeNode> descendThrow (std::shared_ptr<SHAMapInnerNode> const&, int branch) const;
 
     // Descend with filter
-    SHAMapTreeNode* descendAsync (SHAMapTreeNode* parent, int branch,
+    SHAMapTreeNode* descendAsync (SHAMapInnerNode* parent, int branch,
         SHAMapNodeID const& childID, SHAMapSyncFilter* filter, bool& pending) const;
 
     std::pair <SHAMapTreeNode*, SHAMapNodeID>
-        descend (SHAMapTreeNode* parent, SHAMapNodeID const& parentID,
+        descend (SHAMapInnerNode* parent, SHAMapNodeID const& parentID,
         int branch, SHAMapSyncFilter* filter) const;
 
     // Non-storing
     // Does not hook the returned node to its parent
-    std::shared_ptr<SHAMapTreeNode> descendNoStore (std::shared_ptr<SHAMapTreeNode> const&, int branch) const;
+    std::shared_ptr<SHAMapTreeNode> descendNoStore (std::shared_ptr<SHAMapInnerNode> const&, int branch) const;
 
     /** If there is only one leaf below this node, get its contents */
-    std::shared_ptr<SHAMapItem> onlyBelow (SHAMapTreeNode*) const;
+    boost::intrusive_ptr<SHAMapItem const> onlyBelow (SHAMapTreeNode*) const;
+
+    // Find where a received node hooks into the tree and attach it.
+    // The node is only built (by calling makeNode) once a hook is found.
+    template <class MakeNode>
+    SHAMapAddNode addKnownNodeImpl (SHAMapNodeID const& nodeID,
+        MakeNode makeNode, SHAMapSyncFilter* filter);
 
     bool hasInnerNode (SHAMapNodeID const& nodeID, uint256 const& hash) const;
     bool hasLeafNode (uint256 const& tag, uint256 const& hash) const;
 
+    using ItemIterator =
+        std::vector<boost::intrusive_ptr<SHAMapItem const>>::const_iterator;
+
+    std::shared_ptr<SHAMapTreeNode> buildSubtree (ItemIterator first,
+        ItemIterator last, SHAMapNodeID const& nodeID,
+        SHAMapTreeNode::TNType type, NodeObjectType t,
+        NodeStore::Batch& batch) const;
+
     bool walkBranch (SHAMapTreeNode* node,
-                     std::shared_ptr<SHAMapItem> const& otherMapItem, bool isFirstMap,
+                     boost::intrusive_ptr<SHAMapItem const> const& otherMapItem, bool isFirstMap,
                      Delta & differences, int & maxCount) const;
     int walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq);
 };
@@ -17,92 +17,134 @@
 */
 //==============================================================================
 
+
 #ifndef BESSEL_SHAMAP_SHAMAPITEM_H_INCLUDED
 #define BESSEL_SHAMAP_SHAMAPITEM_H_INCLUDED
 
+#include <atomic>
 #include <cstddef>
-#include <beast/utility/Journal.h>
-#include <protocol/Serializer.h>
+#include <cstdint>
+#include <common/base/Blob.h>
+#include <common/base/Slice.h>
 #include <common/base/base_uint.h>
-
+#include <boost/intrusive_ptr.hpp>
 
 namespace bessel {
 
-// an item stored in a SHAMap
+/** An item stored in a SHAMap.
+
+    The tag, the payload size, the reference count and the payload itself
+    share one allocation, so an item costs a single heap block instead of
+    a control block, an object and a vector buffer. Items are immutable
+    once made and are held through boost::intrusive_ptr.
+
+    Use make_shamapitem to create one.
+*/
 class SHAMapItem
 {
 private:
-    uint256 mTag;
-    Serializer mData;
+    uint256 const                       mTag;
+    std::uint32_t const                 mSize;
+    mutable std::atomic<std::uint32_t>  mRefCount;
+
+    // The payload follows the object in the same allocation
+    SHAMapItem (uint256 const& tag, std::uint32_t size);
+    ~SHAMapItem () = default;
+
+    friend
+    boost::intrusive_ptr<SHAMapItem const>
+    make_shamapitem (uint256 const& tag, void const* data, std::size_t size);
+
+    friend void intrusive_ptr_add_ref (SHAMapItem const* item);
+    friend void intrusive_ptr_release (SHAMapItem const* item);
 
 public:
-    explicit SHAMapItem (uint256 const& tag);
-    SHAMapItem (uint256 const& tag, Blob const & data);
-    SHAMapItem (uint256 const& tag, Serializer const& s);
-    SHAMapItem (uint256 const& tag, Serializer&& s);
-    uint256 const& getTag() const;
-    Blob const& peekData() const;
-    Serializer& peekSerializer();
+    SHAMapItem (SHAMapItem const&) = delete;
+    SHAMapItem& operator= (SHAMapItem const&) = delete;
 
-public:  // public only to SHAMapTreeNode
-    std::size_t size() const;
+    uint256 const& getTag () const;
+    std::size_t size () const;
+    void const* data () const;
 
-private:
-    explicit SHAMapItem (Blob const& data);
+    /** The payload. Items stored in a SHAMap are never empty. */
+    Slice slice () const;
 
-    void const* data() const;
-    void addRaw (Blob& s) const;
-    void dump (beast::Journal journal);
+    /** A copy of the payload. */
+    Blob getData () const;
 };
 
+boost::intrusive_ptr<SHAMapItem const>
+make_shamapitem (uint256 const& tag, void const* data, std::size_t size);
+
 inline
-SHAMapItem::SHAMapItem (uint256 const& tag)
-    : mTag (tag)
+boost::intrusive_ptr<SHAMapItem const>
+make_shamapitem (uint256 const& tag, Blob const& data)
 {
+    return make_shamapitem (tag, data.data (), data.size ());
 }
 
 inline
-std::size_t
-SHAMapItem::size() const
+boost::intrusive_ptr<SHAMapItem const>
+make_shamapitem (uint256 const& tag, Slice const& data)
 {
-    return mData.peekData().size();
+    return make_shamapitem (tag, data.data (), data.size ());
 }
 
+//------------------------------------------------------------------------------
+
 inline
-void const*
-SHAMapItem::data() const
+SHAMapItem::SHAMapItem (uint256 const& tag, std::uint32_t size)
+    : mTag (tag)
+    , mSize (size)
+    , mRefCount (1)
 {
-    return mData.peekData().data();
 }
 
 inline
 uint256 const&
-SHAMapItem::getTag() const
+SHAMapItem::getTag () const
 {
     return mTag;
 }
 
 inline
-Blob const&
-SHAMapItem::peekData() const
+std::size_t
+SHAMapItem::size () const
 {
-    return mData.peekData();
+    return mSize;
 }
 
 inline
-Serializer& 
-SHAMapItem::peekSerializer()
+void const*
+SHAMapItem::data () const
 {
-    return mData;
+    return this + 1;
+}
+
+inline
+Slice
+SHAMapItem::slice () const
+{
+    return Slice (data (), size ());
+}
+
+inline
+Blob
+SHAMapItem::getData () const
+{
+    auto const p = static_cast<std::uint8_t const*> (data ());
+    return Blob (p, p + size ());
 }
 
 inline
 void
-SHAMapItem::addRaw (Blob& s) const
+intrusive_ptr_add_ref (SHAMapItem const* item)
 {
-    s.insert (s.end (), mData.begin (), mData.end ());
+    item->mRefCount.fetch_add (1, std::memory_order_relaxed);
 }
 
+void intrusive_ptr_release (SHAMapItem const* item);
+
 } // bessel
 
 #endif
@@ -20,9 +20,9 @@
 #ifndef BESSEL_SHAMAP_SHAMAPTREENODE_H_INCLUDED
 #define BESSEL_SHAMAP_SHAMAPTREENODE_H_INCLUDED
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
-#include <mutex>
 #include <string>
 
 #include <beast/utility/Journal.h>
@@ -39,6 +39,14 @@ enum SHANodeFormat
     snfHASH     = 3, // just the hash
 };
 
+/** A node in a SHAMap.
+
+    Inner nodes and leaves have nothing in common beyond their hash, sequence
+    and type, so they are separate classes: SHAMapInnerNode holds only the
+    branches that are populated, and SHAMapLeafNode holds only its item.
+    Code holding a SHAMapTreeNode checks isInner() or isLeaf() before
+    converting it to the derived type.
+*/
 class SHAMapTreeNode
 {
 public:
@@ -51,34 +59,30 @@ public:
         tnACCOUNT_STATE     = 4
     };
 
-private:
+protected:
     uint256                         mHash;
-    uint256                         mHashes[16];
-    std::shared_ptr<SHAMapTreeNode> mChildren[16];
-    std::shared_ptr<SHAMapItem>     mItem;
     std::uint32_t                   mSeq;
     TNType                          mType;
-    int                             mIsBranch;
-    std::uint32_t                   mFullBelowGen;
 
-    static std::mutex               childLock;
+    SHAMapTreeNode (std::uint32_t seq, TNType type);
 
 public:
     SHAMapTreeNode (const SHAMapTreeNode&) = delete;
     SHAMapTreeNode& operator= (const SHAMapTreeNode&) = delete;
+    virtual ~SHAMapTreeNode () = default;
 
-    SHAMapTreeNode (std::uint32_t seq); // empty node
-    SHAMapTreeNode (const SHAMapTreeNode & node, std::uint32_t seq); // copy node from older tree
-    SHAMapTreeNode (std::shared_ptr<SHAMapItem> const& item, TNType type, std::uint32_t seq);
-    SHAMapTreeNode (Blob const & data, std::uint32_t seq,
-                    SHANodeFormat format, uint256 const& hash, bool hashValid);
+    /** Decode a node from its wire or prefix format.
+        Throws if the data is not a valid node.
+    */
+    static std::shared_ptr<SHAMapTreeNode> make (Blob const& rawNode,
+        std::uint32_t seq, SHANodeFormat format, uint256 const& hash,
+        bool hashValid);
 
-    void addRaw (Serializer&, SHANodeFormat format);
-    uint256 const& getNodeHash () const;
+    /** Copy this node for modification in a newer tree. */
+    virtual std::shared_ptr<SHAMapTreeNode> clone (std::uint32_t seq) const = 0;
 
-public:  // public only to SHAMap
-    void setChild (int m, std::shared_ptr<SHAMapTreeNode> const& child);
-    void shareChild (int m, std::shared_ptr<SHAMapTreeNode> const& child);
+    virtual void addRaw (Serializer&, SHANodeFormat format) const = 0;
+    uint256 const& getNodeHash () const;
 
     // node functions
     std::uint32_t getSeq () const;
@@ -91,19 +95,70 @@ public:  // public only to SHAMap
     bool isInBounds (SHAMapNodeID const &id) const;
     bool isValid () const;
 
-    // inner node functions
-    bool isInnerNode () const;
+    // debugging
+#ifdef BEAST_DEBUG
+    void dump (SHAMapNodeID const&, beast::Journal journal);
+#endif
+    virtual std::string getString (SHAMapNodeID const&) const;
+    virtual bool updateHash () = 0;
+};
+
+//------------------------------------------------------------------------------
+
+/** An inner node.
+
+    Only populated branches are stored: one slot per bit set in mIsBranch,
+    in branch order, each holding the child's hash and, once it has been
+    loaded, the child itself. A node with two children costs two slots
+    rather than sixteen.
+
+    Nodes shared between maps are read by many threads at once, and the
+    only change made to them is hooking up a child that was just loaded.
+    That is done without a lock: the first thread to set the branch's bit
+    in mClaimed stores the child and then sets the bit in mPublished.
+    Readers check mPublished, and a published child never changes while
+    the node is shared. Adding or removing branches is only done to nodes
+    that are not shared.
+*/
+class SHAMapInnerNode final : public SHAMapTreeNode
+{
+private:
+    struct Branch
+    {
+        uint256                         hash;
+        std::shared_ptr<SHAMapTreeNode> child;
+    };
+
+    std::unique_ptr<Branch[]>       mBranches;
+    std::atomic<std::uint32_t>      mFullBelowGen;
+    std::uint16_t                   mIsBranch;
+    std::atomic<std::uint16_t>      mClaimed;
+    std::atomic<std::uint16_t>      mPublished;
+
+    int slot (int m) const;
+    void publish (int m);
+
+public:
+    explicit SHAMapInnerNode (std::uint32_t seq); // empty node
+
+    /** Build a node from the sixteen child hashes; zero means empty. */
+    SHAMapInnerNode (uint256 const (&hashes)[16], std::uint32_t seq);
+
+    std::shared_ptr<SHAMapTreeNode> clone (std::uint32_t seq) const override;
+    void addRaw (Serializer&, SHANodeFormat format) const override;
+    std::string getString (SHAMapNodeID const&) const override;
+    bool updateHash () override;
+    void updateHashDeep ();
+
+public:  // public only to SHAMap
+    void setChild (int m, std::shared_ptr<SHAMapTreeNode> const& child);
+    void shareChild (int m, std::shared_ptr<SHAMapTreeNode> const& child);
+
     bool isEmptyBranch (int m) const;
     bool isEmpty () const;
     int getBranchCount () const;
-    void makeInner ();
     uint256 const& getChildHash (int m) const;
 
-    // item node function
-    bool hasItem () const;
-    std::shared_ptr<SHAMapItem> const& peekItem () const;
-    bool setItem (std::shared_ptr<SHAMapItem> const& i, TNType type);
-
     // sync functions
     bool isFullBelow (std::uint32_t generation) const;
     void setFullBelowGen (std::uint32_t gen);
@@ -111,21 +166,34 @@ public:  // public only to SHAMap
     SHAMapTreeNode* getChildPointer (int branch);
     std::shared_ptr<SHAMapTreeNode> getChild (int branch);
     void canonicalizeChild (int branch, std::shared_ptr<SHAMapTreeNode>& node);
+};
 
-    // debugging
-#ifdef BEAST_DEBUG
-    void dump (SHAMapNodeID const&, beast::Journal journal);
-#endif
-    std::string getString (SHAMapNodeID const&) const;
-    bool updateHash ();
-    void updateHashDeep();
+//------------------------------------------------------------------------------
 
+/** A leaf node holding one item. */
+class SHAMapLeafNode final : public SHAMapTreeNode
+{
 private:
-    bool isTransaction () const;
-    bool hasMetaData () const;
-    bool isAccountState () const;
+    boost::intrusive_ptr<SHAMapItem const>     mItem;
+
+public:
+    SHAMapLeafNode (boost::intrusive_ptr<SHAMapItem const> const& item, TNType type, std::uint32_t seq);
+
+    /** Construct with a hash already known to be correct. */
+    SHAMapLeafNode (boost::intrusive_ptr<SHAMapItem const> const& item, TNType type,
+                    std::uint32_t seq, uint256 const& hash);
+
+    std::shared_ptr<SHAMapTreeNode> clone (std::uint32_t seq) const override;
+    void addRaw (Serializer&, SHANodeFormat format) const override;
+    std::string getString (SHAMapNodeID const&) const override;
+    bool updateHash () override;
+
+    boost::intrusive_ptr<SHAMapItem const> const& peekItem () const;
+    bool setItem (boost::intrusive_ptr<SHAMapItem const> const& i, TNType type);
 };
 
+//------------------------------------------------------------------------------
+
 inline
 std::uint32_t
 SHAMapTreeNode::getSeq () const
@@ -186,75 +254,39 @@ SHAMapTreeNode::isValid () const
 
 inline
 bool
-SHAMapTreeNode::isTransaction () const
-{
-    return (mType == tnTRANSACTION_NM) || (mType == tnTRANSACTION_MD);
-}
-
-inline
-bool
-SHAMapTreeNode::hasMetaData () const
-{
-    return mType == tnTRANSACTION_MD;
-}
-
-inline
-bool
-SHAMapTreeNode::isAccountState () const
+SHAMapInnerNode::isEmptyBranch (int m) const
 {
-    return mType == tnACCOUNT_STATE;
+    return (mIsBranch & (1 << m)) == 0;
 }
 
 inline
 bool
-SHAMapTreeNode::isInnerNode () const
+SHAMapInnerNode::isEmpty () const
 {
-    return !mItem;
+    return mIsBranch == 0;
 }
 
 inline
 bool
-SHAMapTreeNode::isEmptyBranch (int m) const
-{
-    return (mIsBranch & (1 << m)) == 0;
-}
-
-inline
-uint256 const&
-SHAMapTreeNode::getChildHash (int m) const
+SHAMapInnerNode::isFullBelow (std::uint32_t generation) const
 {
-    assert ((m >= 0) && (m < 16) && (mType == tnINNER));
-    return mHashes[m];
+    return mFullBelowGen.load (std::memory_order_relaxed) == generation;
 }
 
 inline
-bool
-SHAMapTreeNode::hasItem () const
+void
+SHAMapInnerNode::setFullBelowGen (std::uint32_t gen)
 {
-    return bool(mItem);
+    mFullBelowGen.store (gen, std::memory_order_relaxed);
 }
 
 inline
-std::shared_ptr<SHAMapItem> const&
-SHAMapTreeNode::peekItem () const
+boost::intrusive_ptr<SHAMapItem const> const&
+SHAMapLeafNode::peekItem () const
 {
     return mItem;
 }
 
-inline
-bool
-SHAMapTreeNode::isFullBelow (std::uint32_t generation) const
-{
-    return mFullBelowGen == generation;
-}
-
-inline
-void
-SHAMapTreeNode::setFullBelowGen (std::uint32_t gen)
-{
-    mFullBelowGen = gen;
-}
-
 } // bessel
 
 #endif
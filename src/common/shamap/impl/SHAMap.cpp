@@ -19,6 +19,8 @@
 
 #include <BeastConfig.h>
 #include <common/shamap/SHAMap.h>
+#include <algorithm>
+#include <array>
 
 namespace bessel {
 
@@ -36,8 +38,7 @@ SHAMap::SHAMap (
 {
     assert (seq_ != 0);
 
-    root_ = std::make_shared<SHAMapTreeNode> (seq_);
-    root_->makeInner ();
+    root_ = std::make_shared<SHAMapInnerNode> (seq_);
 }
 
 SHAMap::SHAMap (
@@ -52,8 +53,7 @@ SHAMap::SHAMap (
     , state_ (SHAMapState::Synching)
     , type_ (t)
 {
-    root_ = std::make_shared<SHAMapTreeNode> (seq_);
-    root_->makeInner ();
+    root_ = std::make_shared<SHAMapInnerNode> (seq_);
 }
 
 SHAMap::~SHAMap ()
@@ -99,14 +99,16 @@ SHAMap::getStack (uint256 const& id, bool include_nonmatching_leaf) const
         int branch = nodeID.selectBranch (id);
         assert (branch >= 0);
 
-        if (node->isEmptyBranch (branch))
+        auto inner = std::static_pointer_cast<SHAMapInnerNode> (node);
+        if (inner->isEmptyBranch (branch))
             return stack;
 
-        node = descendThrow (node, branch);
+        node = descendThrow (inner, branch);
         nodeID = nodeID.getChildNodeID (branch);
     }
 
-    if (include_nonmatching_leaf || (node->peekItem ()->getTag () == id))
+    if (include_nonmatching_leaf ||
+            (static_cast<SHAMapLeafNode*> (node.get ())->peekItem ()->getTag () == id))
         stack.push ({node, nodeID});
 
     return stack;
@@ -129,13 +131,13 @@ SHAMap::dirtyUp (SharedPtrNodeStack& stack,
         std::shared_ptr<SHAMapTreeNode> node = stack.top ().first;
         SHAMapNodeID nodeID = stack.top ().second;
         stack.pop ();
-        assert (node->isInnerNode ());
+        assert (node->isInner ());
 
         int branch = nodeID.selectBranch (target);
         assert (branch >= 0);
 
         unshareNode (node, nodeID);
-        node->setChild (branch, child);
+        static_cast<SHAMapInnerNode*> (node.get ())->setChild (branch, child);
 
     #ifdef ST_DEBUG
         if (journal_.trace) journal_.trace <<
@@ -145,24 +147,25 @@ SHAMap::dirtyUp (SharedPtrNodeStack& stack,
     }
 }
 
-SHAMapTreeNode* SHAMap::walkToPointer (uint256 const& id) const
+SHAMapLeafNode* SHAMap::walkToPointer (uint256 const& id) const
 {
     SHAMapTreeNode* inNode = root_.get ();
     SHAMapNodeID nodeID;
-    uint256 nodeHash;
 
     while (inNode->isInner ())
     {
         int branch = nodeID.selectBranch (id);
+        auto inner = static_cast<SHAMapInnerNode*> (inNode);
 
-        if (inNode->isEmptyBranch (branch))
+        if (inner->isEmptyBranch (branch))
             return nullptr;
 
-        inNode = descendThrow (inNode, branch);
+        inNode = descendThrow (inner, branch);
         nodeID = nodeID.getChildNodeID (branch);
     }
 
-    return (inNode->peekItem()->getTag () == id) ? inNode : nullptr;
+    auto leaf = static_cast<SHAMapLeafNode*> (inNode);
+    return (leaf->peekItem()->getTag () == id) ? leaf : nullptr;
 }
 
 std::shared_ptr<SHAMapTreeNode>
@@ -177,7 +180,7 @@ SHAMap::fetchNodeFromDB (uint256 const& hash) const
         {
             try
             {
-                node = std::make_shared <SHAMapTreeNode> (obj->getData(),
+                node = SHAMapTreeNode::make (obj->getData(),
                     0, snfPREFIX, hash, true);
                 canonicalize (hash, node);
             }
@@ -209,7 +212,7 @@ std::shared_ptr<SHAMapTreeNode> SHAMap::checkFilter (
 
     if (filter->haveNode (id, hash, nodeData))
     {
-        node = std::make_shared <SHAMapTreeNode> (
+        node = SHAMapTreeNode::make (
             nodeData, 0, snfPREFIX, hash, true);
 
        filter->gotNode (true, id, hash, nodeData, node->getType ());
@@ -269,7 +272,7 @@ std::shared_ptr<SHAMapTreeNode> SHAMap::fetchNode (uint256 const& hash) const
     return node;
 }
 
-SHAMapTreeNode* SHAMap::descendThrow (SHAMapTreeNode* parent, int branch) const
+SHAMapTreeNode* SHAMap::descendThrow (SHAMapInnerNode* parent, int branch) const
 {
     SHAMapTreeNode* ret = descend (parent, branch);
 
@@ -280,7 +283,7 @@ SHAMapTreeNode* SHAMap::descendThrow (SHAMapTreeNode* parent, int branch) const
 }
 
 std::shared_ptr<SHAMapTreeNode>
-SHAMap::descendThrow (std::shared_ptr<SHAMapTreeNode> const& parent, int branch) const
+SHAMap::descendThrow (std::shared_ptr<SHAMapInnerNode> const& parent, int branch) const
 {
     std::shared_ptr<SHAMapTreeNode> ret = descend (parent, branch);
 
@@ -290,7 +293,7 @@ SHAMap::descendThrow (std::shared_ptr<SHAMapTreeNode> const& parent, int branch)
     return ret;
 }
 
-SHAMapTreeNode* SHAMap::descend (SHAMapTreeNode* parent, int branch) const
+SHAMapTreeNode* SHAMap::descend (SHAMapInnerNode* parent, int branch) const
 {
     SHAMapTreeNode* ret = parent->getChildPointer (branch);
     if (ret || !backed_)
@@ -305,7 +308,7 @@ SHAMapTreeNode* SHAMap::descend (SHAMapTreeNode* parent, int branch) const
 }
 
 std::shared_ptr<SHAMapTreeNode>
-SHAMap::descend (std::shared_ptr<SHAMapTreeNode> const& parent, int branch) const
+SHAMap::descend (std::shared_ptr<SHAMapInnerNode> const& parent, int branch) const
 {
     std::shared_ptr<SHAMapTreeNode> node = parent->getChild (branch);
     if (node || !backed_)
@@ -322,7 +325,7 @@ SHAMap::descend (std::shared_ptr<SHAMapTreeNode> const& parent, int branch) cons
 // Gets the node that would be hooked to this branch,
 // but doesn't hook it up.
 std::shared_ptr<SHAMapTreeNode>
-SHAMap::descendNoStore (std::shared_ptr<SHAMapTreeNode> const& parent, int branch) const
+SHAMap::descendNoStore (std::shared_ptr<SHAMapInnerNode> const& parent, int branch) const
 {
     std::shared_ptr<SHAMapTreeNode> ret = parent->getChild (branch);
     if (!ret && backed_)
@@ -331,10 +334,9 @@ SHAMap::descendNoStore (std::shared_ptr<SHAMapTreeNode> const& parent, int branc
 }
 
 std::pair <SHAMapTreeNode*, SHAMapNodeID>
-SHAMap::descend (SHAMapTreeNode * parent, SHAMapNodeID const& parentID,
+SHAMap::descend (SHAMapInnerNode * parent, SHAMapNodeID const& parentID,
     int branch, SHAMapSyncFilter * filter) const
 {
-    assert (parent->isInner ());
     assert ((branch >= 0) && (branch < 16));
     assert (!parent->isEmptyBranch (branch));
 
@@ -356,7 +358,7 @@ SHAMap::descend (SHAMapTreeNode * parent, SHAMapNodeID const& parentID,
     return std::make_pair (child, childID);
 }
 
-SHAMapTreeNode* SHAMap::descendAsync (SHAMapTreeNode* parent, int branch,
+SHAMapTreeNode* SHAMap::descendAsync (SHAMapInnerNode* parent, int branch,
     SHAMapNodeID const& childID, SHAMapSyncFilter * filter, bool & pending) const
 {
     pending = false;
@@ -384,7 +386,7 @@ SHAMapTreeNode* SHAMap::descendAsync (SHAMapTreeNode* parent, int branch,
             if (!obj)
                 return nullptr;
 
-            ptr = std::make_shared <SHAMapTreeNode> (obj->getData(), 0, snfPREFIX, hash, true);
+            ptr = SHAMapTreeNode::make (obj->getData(), 0, snfPREFIX, hash, true);
 
             if (backed_)
                 canonicalize (hash, ptr);
@@ -409,7 +411,7 @@ SHAMap::unshareNode (std::shared_ptr<SHAMapTreeNode>& node, SHAMapNodeID const&
         // have a CoW
         assert (state_ != SHAMapState::Immutable);
 
-        node = std::make_shared<SHAMapTreeNode> (*node, seq_); // here's to the new node, same as the old node
+        node = node->clone (seq_); // here's to the new node, same as the old node
         assert (node->isValid ());
 
         if (nodeID.isRoot ())
@@ -417,7 +419,7 @@ SHAMap::unshareNode (std::shared_ptr<SHAMapTreeNode>& node, SHAMapNodeID const&
     }
 }
 
-SHAMapTreeNode*
+SHAMapLeafNode*
 SHAMap::firstBelow (SHAMapTreeNode* node) const
 {
     // Return the first item below this node
@@ -425,16 +427,17 @@ SHAMap::firstBelow (SHAMapTreeNode* node) const
     {
         assert(node != nullptr);
 
-        if (node->hasItem ())
-            return node;
+        if (node->isLeaf ())
+            return static_cast<SHAMapLeafNode*> (node);
 
         // Walk down the tree
+        auto inner = static_cast<SHAMapInnerNode*> (node);
         bool foundNode = false;
         for (int i = 0; i < 16; ++i)
         {
-            if (!node->isEmptyBranch (i))
+            if (!inner->isEmptyBranch (i))
             {
-                node = descendThrow (node, i);
+                node = descendThrow (inner, i);
                 foundNode = true;
                 break;
             }
@@ -445,21 +448,22 @@ SHAMap::firstBelow (SHAMapTreeNode* node) const
     while (true);
 }
 
-SHAMapTreeNode*
+SHAMapLeafNode*
 SHAMap::lastBelow (SHAMapTreeNode* node) const
 {
     do
     {
-        if (node->hasItem ())
-            return node;
+        if (node->isLeaf ())
+            return static_cast<SHAMapLeafNode*> (node);
 
         // Walk down the tree
+        auto inner = static_cast<SHAMapInnerNode*> (node);
         bool foundNode = false;
         for (int i = 15; i >= 0; --i)
         {
-            if (!node->isEmptyBranch (i))
+            if (!inner->isEmptyBranch (i))
             {
-                node = descendThrow (node, i);
+                node = descendThrow (inner, i);
                 foundNode = true;
                 break;
             }
@@ -470,57 +474,54 @@ SHAMap::lastBelow (SHAMapTreeNode* node) const
     while (true);
 }
 
-std::shared_ptr<SHAMapItem>
+boost::intrusive_ptr<SHAMapItem const>
 SHAMap::onlyBelow (SHAMapTreeNode* node) const
 {
     // If there is only one item below this node, return it
 
     while (!node->isLeaf ())
     {
+        auto inner = static_cast<SHAMapInnerNode*> (node);
         SHAMapTreeNode* nextNode = nullptr;
         for (int i = 0; i < 16; ++i)
         {
-            if (!node->isEmptyBranch (i))
+            if (!inner->isEmptyBranch (i))
             {
                 if (nextNode)
-                    return std::shared_ptr<SHAMapItem> ();
+                    return boost::intrusive_ptr<SHAMapItem const> ();
 
-                nextNode = descendThrow (node, i);
+                nextNode = descendThrow (inner, i);
             }
         }
 
         if (!nextNode)
         {
             assert (false);
-            return std::shared_ptr<SHAMapItem> ();
+            return boost::intrusive_ptr<SHAMapItem const> ();
         }
 
         node = nextNode;
     }
 
-    // An inner node must have at least one leaf
-    // below it, unless it's the root_
-    assert (node->hasItem () || (node == root_.get ()));
-
-    return node->peekItem ();
+    return static_cast<SHAMapLeafNode*> (node)->peekItem ();
 }
 
-static std::shared_ptr<SHAMapItem const> const nullConstSHAMapItem;
+static boost::intrusive_ptr<SHAMapItem const> const nullConstSHAMapItem;
 
-std::shared_ptr<SHAMapItem const> SHAMap::fetch (uint256 const& key) const
+boost::intrusive_ptr<SHAMapItem const> const& SHAMap::fetch (uint256 const& key) const
 {
-    SHAMapTreeNode const* const leaf =
+    SHAMapLeafNode const* const leaf =
         walkToPointer(key);
     if (! leaf)
         return nullConstSHAMapItem;
     return leaf->peekItem();
 }
 
-static const std::shared_ptr<SHAMapItem> no_item;
+static const boost::intrusive_ptr<SHAMapItem const> no_item;
 
-std::shared_ptr<SHAMapItem> SHAMap::peekFirstItem () const
+boost::intrusive_ptr<SHAMapItem const> SHAMap::peekFirstItem () const
 {
-    SHAMapTreeNode* node = firstBelow (root_.get ());
+    SHAMapLeafNode* node = firstBelow (root_.get ());
 
     if (!node)
         return no_item;
@@ -528,9 +529,9 @@ std::shared_ptr<SHAMapItem> SHAMap::peekFirstItem () const
     return node->peekItem ();
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekFirstItem (SHAMapTreeNode::TNType& type) const
+boost::intrusive_ptr<SHAMapItem const> SHAMap::peekFirstItem (SHAMapTreeNode::TNType& type) const
 {
-    SHAMapTreeNode* node = firstBelow (root_.get ());
+    SHAMapLeafNode* node = firstBelow (root_.get ());
 
     if (!node)
         return no_item;
@@ -539,9 +540,9 @@ std::shared_ptr<SHAMapItem> SHAMap::peekFirstItem (SHAMapTreeNode::TNType& type)
     return node->peekItem ();
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekLastItem () const
+boost::intrusive_ptr<SHAMapItem const> SHAMap::peekLastItem () const
 {
-    SHAMapTreeNode* node = lastBelow (root_.get ());
+    SHAMapLeafNode* node = lastBelow (root_.get ());
 
     if (!node)
         return no_item;
@@ -549,13 +550,13 @@ std::shared_ptr<SHAMapItem> SHAMap::peekLastItem () const
     return node->peekItem ();
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekNextItem (uint256 const& id) const
+boost::intrusive_ptr<SHAMapItem const> SHAMap::peekNextItem (uint256 const& id) const
 {
     SHAMapTreeNode::TNType type;
     return peekNextItem (id, type);
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekNextItem (uint256 const& id, SHAMapTreeNode::TNType& type) const
+boost::intrusive_ptr<SHAMapItem const> SHAMap::peekNextItem (uint256 const& id, SHAMapTreeNode::TNType& type) const
 {
     // Get a pointer to the next item in the tree after a given item - item need not be in tree
 
@@ -569,26 +570,27 @@ std::shared_ptr<SHAMapItem> SHAMap::peekNextItem (uint256 const& id, SHAMapTreeN
 
         if (node->isLeaf ())
         {
-            if (node->peekItem ()->getTag () > id)
+            auto leaf = static_cast<SHAMapLeafNode*> (node);
+            if (leaf->peekItem ()->getTag () > id)
             {
-                type = node->getType ();
-                return node->peekItem ();
+                type = leaf->getType ();
+                return leaf->peekItem ();
             }
         }
         else
         {
             // breadth-first
+            auto inner = static_cast<SHAMapInnerNode*> (node);
             for (int i = nodeID.selectBranch (id) + 1; i < 16; ++i)
-                if (!node->isEmptyBranch (i))
+                if (!inner->isEmptyBranch (i))
                 {
-                    node = descendThrow (node, i);
-                    node = firstBelow (node);
+                    SHAMapLeafNode* leaf = firstBelow (descendThrow (inner, i));
 
-                    if (!node || node->isInner ())
+                    if (!leaf)
                         throw (std::runtime_error ("missing/corrupt node"));
 
-                    type = node->getType ();
-                    return node->peekItem ();
+                    type = leaf->getType ();
+                    return leaf->peekItem ();
                 }
         }
     }
@@ -598,7 +600,7 @@ std::shared_ptr<SHAMapItem> SHAMap::peekNextItem (uint256 const& id, SHAMapTreeN
 }
 
 // Get a pointer to the previous item in the tree after a given item - item need not be in tree
-std::shared_ptr<SHAMapItem> SHAMap::peekPrevItem (uint256 const& id) const
+boost::intrusive_ptr<SHAMapItem const> SHAMap::peekPrevItem (uint256 const& id) const
 {
     auto stack = getStack (id, true);
 
@@ -610,18 +612,23 @@ std::shared_ptr<SHAMapItem> SHAMap::peekPrevItem (uint256 const& id) const
 
         if (node->isLeaf ())
         {
-            if (node->peekItem ()->getTag () < id)
-                return node->peekItem ();
+            auto leaf = static_cast<SHAMapLeafNode*> (node);
+            if (leaf->peekItem ()->getTag () < id)
+                return leaf->peekItem ();
         }
         else
         {
+            auto inner = static_cast<SHAMapInnerNode*> (node);
             for (int i = nodeID.selectBranch (id) - 1; i >= 0; --i)
             {
-                if (!node->isEmptyBranch (i))
+                if (!inner->isEmptyBranch (i))
                 {
-                    node = descendThrow (node, i);
-                    node = lastBelow (node);
-                    return node->peekItem ();
+                    SHAMapLeafNode* leaf = lastBelow (descendThrow (inner, i));
+
+                    if (!leaf)
+                        throw (std::runtime_error ("missing/corrupt node"));
+
+                    return leaf->peekItem ();
                 }
             }
         }
@@ -631,9 +638,9 @@ std::shared_ptr<SHAMapItem> SHAMap::peekPrevItem (uint256 const& id) const
     return no_item;
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id) const
+boost::intrusive_ptr<SHAMapItem const> SHAMap::peekItem (uint256 const& id) const
 {
-    SHAMapTreeNode* leaf = walkToPointer (id);
+    SHAMapLeafNode* leaf = walkToPointer (id);
 
     if (!leaf)
         return no_item;
@@ -641,9 +648,9 @@ std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id) const
     return leaf->peekItem ();
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id, SHAMapTreeNode::TNType& type) const
+boost::intrusive_ptr<SHAMapItem const> SHAMap::peekItem (uint256 const& id, SHAMapTreeNode::TNType& type) const
 {
-    SHAMapTreeNode* leaf = walkToPointer (id);
+    SHAMapLeafNode* leaf = walkToPointer (id);
 
     if (!leaf)
         return no_item;
@@ -652,9 +659,9 @@ std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id, SHAMapTreeNode:
     return leaf->peekItem ();
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id, uint256& hash) const
+boost::intrusive_ptr<SHAMapItem const> SHAMap::peekItem (uint256 const& id, uint256& hash) const
 {
-    SHAMapTreeNode* leaf = walkToPointer (id);
+    SHAMapLeafNode* leaf = walkToPointer (id);
 
     if (!leaf)
         return no_item;
@@ -667,7 +674,7 @@ std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id, uint256& hash)
 bool SHAMap::hasItem (uint256 const& id) const
 {
     // does the tree have an item with this ID
-    SHAMapTreeNode* leaf = walkToPointer (id);
+    SHAMapLeafNode* leaf = walkToPointer (id);
     return (leaf != nullptr);
 }
 
@@ -684,7 +691,8 @@ bool SHAMap::delItem (uint256 const& id)
     std::shared_ptr<SHAMapTreeNode> leaf = stack.top ().first;
     stack.pop ();
 
-    if (!leaf || !leaf->hasItem () || (leaf->peekItem ()->getTag () != id))
+    if (!leaf || !leaf->isLeaf () ||
+            (static_cast<SHAMapLeafNode*> (leaf.get ())->peekItem ()->getTag () != id))
         return false;
 
     SHAMapTreeNode::TNType type = leaf->getType ();
@@ -703,13 +711,14 @@ bool SHAMap::delItem (uint256 const& id)
         assert (node->isInner ());
 
         unshareNode (node, nodeID);
-        node->setChild (nodeID.selectBranch (id), prevNode);
+        auto inner = static_cast<SHAMapInnerNode*> (node.get ());
+        inner->setChild (nodeID.selectBranch (id), prevNode);
 
         if (!nodeID.isRoot ())
         {
             // we may have made this a node with 1 or 0 children
             // And, if so, we need to remove this branch
-            int bc = node->getBranchCount ();
+            int bc = inner->getBranchCount ();
 
             if (bc == 0)
             {
@@ -720,20 +729,10 @@ bool SHAMap::delItem (uint256 const& id)
             else if (bc == 1)
             {
                 // If there's only one item, pull up on the thread
-                std::shared_ptr<SHAMapItem> item = onlyBelow (node.get ());
+                boost::intrusive_ptr<SHAMapItem const> item = onlyBelow (node.get ());
 
                 if (item)
-                {
-                    for (int i = 0; i < 16; ++i)
-                    {
-                        if (!node->isEmptyBranch (i))
-                        {
-                            node->setChild (i, nullptr);
-                            break;
-                        }
-                    }
-                    node->setItem (item, type);
-                }
+                    node = std::make_shared<SHAMapLeafNode> (item, type, seq_);
 
                 prevHash = node->getNodeHash ();
                 prevNode = std::move (node);
@@ -751,7 +750,7 @@ bool SHAMap::delItem (uint256 const& id)
 }
 
 bool
-SHAMap::addGiveItem (std::shared_ptr<SHAMapItem> const& item,
+SHAMap::addGiveItem (boost::intrusive_ptr<SHAMapItem const> const& item,
                      bool isTransaction, bool hasMeta)
 {
     // add the specified item, does not update
@@ -770,66 +769,182 @@ SHAMap::addGiveItem (std::shared_ptr<SHAMapItem> const& item,
     SHAMapNodeID nodeID = stack.top ().second;
     stack.pop ();
 
-    if (node->isLeaf () && (node->peekItem ()->getTag () == tag))
+    if (node->isLeaf () &&
+            (static_cast<SHAMapLeafNode*> (node.get ())->peekItem ()->getTag () == tag))
         return false;
 
-    unshareNode (node, nodeID);
     if (node->isInner ())
     {
         // easy case, we end on an inner node
+        unshareNode (node, nodeID);
+        auto inner = static_cast<SHAMapInnerNode*> (node.get ());
         int branch = nodeID.selectBranch (tag);
-        assert (node->isEmptyBranch (branch));
-        auto newNode = std::make_shared<SHAMapTreeNode> (item, type, seq_);
-        node->setChild (branch, newNode);
+        assert (inner->isEmptyBranch (branch));
+        auto newNode = std::make_shared<SHAMapLeafNode> (item, type, seq_);
+        inner->setChild (branch, newNode);
     }
     else
     {
-        // this is a leaf node that has to be made an inner node holding two items
-        std::shared_ptr<SHAMapItem> otherItem = node->peekItem ();
+        // this is a leaf node that has to be replaced by an inner node holding two items
+        boost::intrusive_ptr<SHAMapItem const> otherItem =
+            static_cast<SHAMapLeafNode*> (node.get ())->peekItem ();
         assert (otherItem && (tag != otherItem->getTag ()));
 
-        node->makeInner ();
+        auto inner = std::make_shared<SHAMapInnerNode> (seq_);
+
+        if (nodeID.isRoot ())
+            root_ = inner;
 
         int b1, b2;
 
         while ((b1 = nodeID.selectBranch (tag)) ==
                (b2 = nodeID.selectBranch (otherItem->getTag ())))
         {
-            stack.push ({node, nodeID});
+            stack.push ({inner, nodeID});
 
             // we need a new inner node, since both go on same branch at this level
             nodeID = nodeID.getChildNodeID (b1);
-            node = std::make_shared<SHAMapTreeNode> (seq_);
-            node->makeInner ();
+            inner = std::make_shared<SHAMapInnerNode> (seq_);
         }
 
         // we can add the two leaf nodes here
-        assert (node->isInner ());
-
         std::shared_ptr<SHAMapTreeNode> newNode =
-            std::make_shared<SHAMapTreeNode> (item, type, seq_);
+            std::make_shared<SHAMapLeafNode> (item, type, seq_);
         assert (newNode->isValid () && newNode->isLeaf ());
-        node->setChild (b1, newNode);
+        inner->setChild (b1, newNode);
 
-        newNode = std::make_shared<SHAMapTreeNode> (otherItem, type, seq_);
+        newNode = std::make_shared<SHAMapLeafNode> (otherItem, type, seq_);
         assert (newNode->isValid () && newNode->isLeaf ());
-        node->setChild (b2, newNode);
+        inner->setChild (b2, newNode);
+
+        node = std::move (inner);
     }
 
     dirtyUp (stack, tag, node);
     return true;
 }
 
-bool SHAMap::addItem (const SHAMapItem& i, bool isTransaction, bool hasMetaData)
+// Nodes are handed to the node store in batches of this size
+static std::size_t const buildBatchSize = 4096;
+
+std::shared_ptr<SHAMapTreeNode>
+SHAMap::buildSubtree (ItemIterator first, ItemIterator last,
+                      SHAMapNodeID const& nodeID, SHAMapTreeNode::TNType type,
+                      NodeObjectType t, NodeStore::Batch& batch) const
 {
-    return addGiveItem (std::make_shared<SHAMapItem> (i), isTransaction, hasMetaData);
+    std::shared_ptr<SHAMapTreeNode> node;
+
+    if (std::next (first) == last)
+    {
+        node = std::make_shared<SHAMapLeafNode> (*first, type, seq_);
+    }
+    else
+    {
+        auto inner = std::make_shared<SHAMapInnerNode> (seq_);
+
+        // Items are sorted, so each branch is a contiguous run
+        while (first != last)
+        {
+            int const branch = nodeID.selectBranch ((*first)->getTag ());
+            auto end = std::next (first);
+            while (end != last && nodeID.selectBranch ((*end)->getTag ()) == branch)
+                ++end;
+
+            inner->setChild (branch, buildSubtree (first, end,
+                nodeID.getChildNodeID (branch), type, t, batch));
+            first = end;
+        }
+
+        inner->updateHashDeep ();
+        node = std::move (inner);
+    }
+
+    // The node is complete and can be shared
+    node->setSeq (0);
+
+    if (backed_)
+    {
+        Serializer s;
+        node->addRaw (s, snfPREFIX);
+        batch.push_back (NodeObject::createObject (t,
+            std::move (s.modData ()), node->getNodeHash ()));
+
+        if (batch.size () >= buildBatchSize)
+        {
+            f_.db ().storeBatch (batch);
+            batch.clear ();
+        }
+    }
+
+    return node;
 }
 
-bool
-SHAMap::addItem(SHAMapItem&& i, bool isTransaction, bool hasMetaData)
+void
+SHAMap::addSortedItems (std::vector<boost::intrusive_ptr<SHAMapItem const>> const& items,
+                        SHAMapTreeNode::TNType type, NodeObjectType t,
+                        ForEachBranch const& forEach)
 {
-    return addGiveItem(std::make_shared<SHAMapItem>(std::move(i)),
-                                                          isTransaction, hasMetaData);
+    assert (state_ == SHAMapState::Modifying);
+    assert (root_->isInner () &&
+        static_cast<SHAMapInnerNode*> (root_.get ())->isEmpty ());
+
+    // Equal keys would never separate, so check the order up front
+    for (std::size_t i = 1; i < items.size (); ++i)
+    {
+        if (!(items[i - 1]->getTag () < items[i]->getTag ()))
+            throw std::runtime_error ("items not strictly ascending");
+    }
+
+    if (items.empty ())
+        return;
+
+    SHAMapNodeID const rootID;
+    std::array<ItemIterator, 17> bounds;
+    bounds[0] = items.begin ();
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        bounds[branch + 1] = std::find_if (bounds[branch], items.end (),
+            [&rootID, branch] (boost::intrusive_ptr<SHAMapItem const> const& item)
+            {
+                return rootID.selectBranch (item->getTag ()) > branch;
+            });
+    }
+
+    std::array<std::shared_ptr<SHAMapTreeNode>, 16> children;
+
+    forEach ([&] (int branch)
+    {
+        if (bounds[branch] == bounds[branch + 1])
+            return;
+
+        NodeStore::Batch batch;
+        batch.reserve (buildBatchSize);
+
+        children[branch] = buildSubtree (bounds[branch], bounds[branch + 1],
+            rootID.getChildNodeID (branch), type, t, batch);
+
+        if (!batch.empty ())
+            f_.db ().storeBatch (batch);
+    });
+
+    auto root = std::make_shared<SHAMapInnerNode> (seq_);
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        if (children[branch])
+            root->setChild (branch, children[branch]);
+    }
+    root->updateHashDeep ();
+    root->setSeq (0);
+
+    if (backed_)
+    {
+        Serializer s;
+        root->addRaw (s, snfPREFIX);
+        f_.db ().storeBatch ({NodeObject::createObject (t,
+            std::move (s.modData ()), root->getNodeHash ())});
+    }
+
+    root_ = std::move (root);
 }
 
 uint256
@@ -845,7 +960,7 @@ SHAMap::getHash () const
 }
 
 bool
-SHAMap::updateGiveItem (std::shared_ptr<SHAMapItem> const& item,
+SHAMap::updateGiveItem (boost::intrusive_ptr<SHAMapItem const> const& item,
                         bool isTransaction, bool hasMeta)
 {
     // can't change the tag but can change the hash
@@ -862,7 +977,8 @@ SHAMap::updateGiveItem (std::shared_ptr<SHAMapItem> const& item,
     SHAMapNodeID nodeID = stack.top ().second;
     stack.pop ();
 
-    if (!node->isLeaf () || (node->peekItem ()->getTag () != tag))
+    if (!node->isLeaf () ||
+            (static_cast<SHAMapLeafNode*> (node.get ())->peekItem ()->getTag () != tag))
     {
         assert (false);
         return false;
@@ -870,7 +986,7 @@ SHAMap::updateGiveItem (std::shared_ptr<SHAMapItem> const& item,
 
     unshareNode (node, nodeID);
 
-    if (!node->setItem (item, !isTransaction ? SHAMapTreeNode::tnACCOUNT_STATE :
+    if (!static_cast<SHAMapLeafNode*> (node.get ())->setItem (item, !isTransaction ? SHAMapTreeNode::tnACCOUNT_STATE :
                         (hasMeta ? SHAMapTreeNode::tnTRANSACTION_MD : SHAMapTreeNode::tnTRANSACTION_NM)))
     {
         journal_.trace <<
@@ -937,7 +1053,9 @@ void SHAMap::writeNode (
 
     canonicalize (node->getNodeHash(), node);
 
-    Serializer s;
+    // The buffer is handed to the node store, so size it exactly
+    Serializer s (node->isInner () ? (4 + 16 * 32) : (4 + 32 +
+        static_cast<SHAMapLeafNode*> (node.get ())->peekItem ()->size ()));
     node->addRaw (s, snfPREFIX);
     f_.db().store (t,
         std::move (s.modData ()), node->getNodeHash ());
@@ -956,7 +1074,7 @@ void SHAMap::preFlushNode (std::shared_ptr<SHAMapTreeNode>& node) const
     {
         // Node is not uniquely ours, so unshare it before
         // possibly modifying it
-        node = std::make_shared <SHAMapTreeNode> (*node, seq_);
+        node = node->clone (seq_);
     }
 }
 
@@ -976,9 +1094,8 @@ int
 SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
 {
     int flushed = 0;
-    Serializer s;
 
-    if (!root_ || (root_->getSeq() == 0) || root_->isEmpty ())
+    if (!root_ || (root_->getSeq() == 0))
         return flushed;
 
     if (root_->isLeaf())
@@ -989,13 +1106,17 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
         return 1;
     }
 
+    if (static_cast<SHAMapInnerNode*> (root_.get ())->isEmpty ())
+        return flushed;
+
     // Stack of {parent,index,child} pointers representing
     // inner nodes we are in the process of flushing
-    using StackEntry = std::pair <std::shared_ptr<SHAMapTreeNode>, int>;
+    using StackEntry = std::pair <std::shared_ptr<SHAMapInnerNode>, int>;
     std::stack <StackEntry, std::vector<StackEntry>> stack;
 
-    std::shared_ptr<SHAMapTreeNode> node = root_;
-    preFlushNode (node);
+    std::shared_ptr<SHAMapTreeNode> root = root_;
+    preFlushNode (root);
+    auto node = std::static_pointer_cast<SHAMapInnerNode> (root);
 
     int pos = 0;
 
@@ -1026,7 +1147,7 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
 
                         stack.emplace (std::move (node), branch);
 
-                        node = std::move (child);
+                        node = std::static_pointer_cast<SHAMapInnerNode> (child);
                         pos = 0;
                     }
                     else
@@ -1053,14 +1174,18 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
 
         // This inner node can now be shared
         if (doWrite && backed_)
-            writeNode (t, seq, node);
+        {
+            std::shared_ptr<SHAMapTreeNode> written = node;
+            writeNode (t, seq, written);
+            node = std::static_pointer_cast<SHAMapInnerNode> (written);
+        }
 
         ++flushed;
 
         if (stack.empty ())
            break;
 
-        std::shared_ptr<SHAMapTreeNode> parent = std::move (stack.top().first);
+        std::shared_ptr<SHAMapInnerNode> parent = std::move (stack.top().first);
         pos = stack.top().second;
         stack.pop();
 
@@ -1102,14 +1227,15 @@ void SHAMap::dump (bool hash) const
 
         if (node->isInner ())
         {
+            auto inner = static_cast<SHAMapInnerNode*> (node);
             for (int i = 0; i < 16; ++i)
             {
-                if (!node->isEmptyBranch (i))
+                if (!inner->isEmptyBranch (i))
                 {
-                    SHAMapTreeNode* child = node->getChildPointer (i);
+                    SHAMapTreeNode* child = inner->getChildPointer (i);
                     if (child)
                     {
-                        assert (child->getNodeHash() == node->getChildHash (i));
+                        assert (child->getNodeHash() == inner->getChildHash (i));
                         stack.push ({child, nodeID.getChildNodeID (i)});
                      }
                 }
@@ -31,7 +31,7 @@ namespace bessel {
 // synchronizing matching branches too.)
 
 bool SHAMap::walkBranch (SHAMapTreeNode* node,
-                         std::shared_ptr<SHAMapItem> const& otherMapItem, bool isFirstMap,
+                         boost::intrusive_ptr<SHAMapItem const> const& otherMapItem, bool isFirstMap,
                          Delta& differences, int& maxCount) const
 {
     // Walk a branch of a SHAMap that's matched by an empty branch or single item in the other map
@@ -48,29 +48,31 @@ bool SHAMap::walkBranch (SHAMapTreeNode* node,
         if (node->isInner ())
         {
             // This is an inner node, add all non-empty branches
+            auto inner = static_cast<SHAMapInnerNode*> (node);
             for (int i = 0; i < 16; ++i)
-                if (!node->isEmptyBranch (i))
-                    nodeStack.push ({descendThrow (node, i)});
+                if (!inner->isEmptyBranch (i))
+                    nodeStack.push ({descendThrow (inner, i)});
         }
         else
         {
             // This is a leaf node, process its item
-            std::shared_ptr<SHAMapItem> item = node->peekItem ();
+            boost::intrusive_ptr<SHAMapItem const> item =
+                static_cast<SHAMapLeafNode*> (node)->peekItem ();
 
             if (emptyBranch || (item->getTag () != otherMapItem->getTag ()))
             {
                 // unmatched
                 if (isFirstMap)
                     differences.insert (std::make_pair (item->getTag (),
-                                      DeltaRef (item, std::shared_ptr<SHAMapItem> ())));
+                                      DeltaRef (item, boost::intrusive_ptr<SHAMapItem const> ())));
                 else
                     differences.insert (std::make_pair (item->getTag (),
-                                      DeltaRef (std::shared_ptr<SHAMapItem> (), item)));
+                                      DeltaRef (boost::intrusive_ptr<SHAMapItem const> (), item)));
 
                 if (--maxCount <= 0)
                     return false;
             }
-            else if (item->peekData () != otherMapItem->peekData ())
+            else if (item->slice () != otherMapItem->slice ())
             {
                 // non-matching items with same tag
                 if (isFirstMap)
@@ -98,12 +100,12 @@ bool SHAMap::walkBranch (SHAMapTreeNode* node,
         // otherMapItem was unmatched, must add
         if (isFirstMap) // this is first map, so other item is from second
             differences.insert (std::make_pair (otherMapItem->getTag (),
-                                                DeltaRef (std::shared_ptr<SHAMapItem>(),
+                                                DeltaRef (boost::intrusive_ptr<SHAMapItem const>(),
                                                           otherMapItem)));
         else
             differences.insert (std::make_pair (otherMapItem->getTag (),
                                                 DeltaRef (otherMapItem,
-                                                      std::shared_ptr<SHAMapItem> ())));
+                                                      boost::intrusive_ptr<SHAMapItem const> ())));
 
         if (--maxCount <= 0)
             return false;
@@ -145,71 +147,76 @@ SHAMap::compare (std::shared_ptr<SHAMap> const& otherMap,
         if (ourNode->isLeaf () && otherNode->isLeaf ())
         {
             // two leaves
-            if (ourNode->peekItem()->getTag () == otherNode->peekItem()->getTag ())
+            auto const& ours = static_cast<SHAMapLeafNode*> (ourNode)->peekItem ();
+            auto const& other = static_cast<SHAMapLeafNode*> (otherNode)->peekItem ();
+            if (ours->getTag () == other->getTag ())
             {
-                if (ourNode->peekItem()->peekData () != otherNode->peekItem()->peekData ())
+                if (ours->slice () != other->slice ())
                 {
-                    differences.insert (std::make_pair (ourNode->peekItem()->getTag (),
-                                                 DeltaRef (ourNode->peekItem (),
-                                                 otherNode->peekItem ())));
+                    differences.insert (std::make_pair (ours->getTag (),
+                                                 DeltaRef (ours, other)));
                     if (--maxCount <= 0)
                         return false;
                 }
             }
             else
             {
-                differences.insert (std::make_pair(ourNode->peekItem()->getTag (),
-                                                   DeltaRef(ourNode->peekItem(),
-                                                   std::shared_ptr<SHAMapItem> ())));
+                differences.insert (std::make_pair(ours->getTag (),
+                                                   DeltaRef(ours,
+                                                   boost::intrusive_ptr<SHAMapItem const> ())));
                 if (--maxCount <= 0)
                     return false;
 
-                differences.insert(std::make_pair(otherNode->peekItem()->getTag (),
-                                                  DeltaRef(std::shared_ptr<SHAMapItem>(),
-                                                  otherNode->peekItem ())));
+                differences.insert(std::make_pair(other->getTag (),
+                                                  DeltaRef(boost::intrusive_ptr<SHAMapItem const>(),
+                                                  other)));
                 if (--maxCount <= 0)
                     return false;
             }
         }
         else if (ourNode->isInner () && otherNode->isLeaf ())
         {
-            if (!walkBranch (ourNode, otherNode->peekItem (),
+            if (!walkBranch (ourNode,
+                    static_cast<SHAMapLeafNode*> (otherNode)->peekItem (),
                     true, differences, maxCount))
                 return false;
         }
         else if (ourNode->isLeaf () && otherNode->isInner ())
         {
-            if (!otherMap->walkBranch (otherNode, ourNode->peekItem (),
-                                       false, differences, maxCount))
+            if (!otherMap->walkBranch (otherNode,
+                    static_cast<SHAMapLeafNode*> (ourNode)->peekItem (),
+                    false, differences, maxCount))
                 return false;
         }
         else if (ourNode->isInner () && otherNode->isInner ())
         {
+            auto ourInner = static_cast<SHAMapInnerNode*> (ourNode);
+            auto otherInner = static_cast<SHAMapInnerNode*> (otherNode);
             for (int i = 0; i < 16; ++i)
-                if (ourNode->getChildHash (i) != otherNode->getChildHash (i))
+                if (ourInner->getChildHash (i) != otherInner->getChildHash (i))
                 {
-                    if (otherNode->isEmptyBranch (i))
+                    if (otherInner->isEmptyBranch (i))
                     {
                         // We have a branch, the other tree does not
-                        SHAMapTreeNode* iNode = descendThrow (ourNode, i);
+                        SHAMapTreeNode* iNode = descendThrow (ourInner, i);
                         if (!walkBranch (iNode,
-                                         std::shared_ptr<SHAMapItem> (), true,
+                                         boost::intrusive_ptr<SHAMapItem const> (), true,
                                          differences, maxCount))
                             return false;
                     }
-                    else if (ourNode->isEmptyBranch (i))
+                    else if (ourInner->isEmptyBranch (i))
                     {
                         // The other tree has a branch, we do not
                         SHAMapTreeNode* iNode =
-                            otherMap->descendThrow(otherNode, i);
+                            otherMap->descendThrow(otherInner, i);
                         if (!otherMap->walkBranch (iNode,
-                                                   std::shared_ptr<SHAMapItem>(),
+                                                   boost::intrusive_ptr<SHAMapItem const>(),
                                                    false, differences, maxCount))
                             return false;
                     }
                     else // The two trees have different non-empty branches
-                        nodeStack.push ({descendThrow (ourNode, i),
-                                        otherMap->descendThrow (otherNode, i)});
+                        nodeStack.push ({descendThrow (ourInner, i),
+                                        otherMap->descendThrow (otherInner, i)});
                 }
         }
         else
@@ -221,17 +228,17 @@ SHAMap::compare (std::shared_ptr<SHAMap> const& otherMap,
 
 void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const
 {
-    std::stack <std::shared_ptr<SHAMapTreeNode>,
-        std::vector <std::shared_ptr<SHAMapTreeNode>>> nodeStack;
+    std::stack <std::shared_ptr<SHAMapInnerNode>,
+        std::vector <std::shared_ptr<SHAMapInnerNode>>> nodeStack;
 
     if (!root_->isInner ())  // root_ is only node, and we have it
         return;
 
-    nodeStack.push (root_);
+    nodeStack.push (std::static_pointer_cast<SHAMapInnerNode> (root_));
 
     while (!nodeStack.empty ())
     {
-        std::shared_ptr<SHAMapTreeNode> node = std::move (nodeStack.top());
+        std::shared_ptr<SHAMapInnerNode> node = std::move (nodeStack.top());
         nodeStack.pop ();
 
         for (int i = 0; i < 16; ++i)
@@ -243,7 +250,7 @@ void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissi
                 if (nextNode)
                 {
                     if (nextNode->isInner ())
-                        nodeStack.push (std::move (nextNode));
+                        nodeStack.push (std::static_pointer_cast<SHAMapInnerNode> (nextNode));
                 }
                 else
                 {
@@ -17,36 +17,42 @@
 */
 //==============================================================================
 
+
 #include <BeastConfig.h>
 #include <common/shamap/SHAMapItem.h>
-    
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
 namespace bessel {
 
-class SHAMap;
+static_assert (sizeof (SHAMapItem) % alignof (SHAMapItem) == 0,
+    "the payload must start right after the item");
 
-SHAMapItem::SHAMapItem (uint256 const& tag, Blob const& data)
-    : mTag (tag)
-    , mData (data)
+boost::intrusive_ptr<SHAMapItem const>
+make_shamapitem (uint256 const& tag, void const* data, std::size_t size)
 {
-}
+    if (size > 0xffffffffu)
+        throw std::length_error ("SHAMapItem payload too large");
 
-SHAMapItem::SHAMapItem (uint256 const& tag, const Serializer& data)
-    : mTag (tag)
-    , mData (data.peekData ())
-{
-}
+    void* raw = ::operator new (sizeof (SHAMapItem) + size);
+    auto item = new (raw) SHAMapItem (tag, static_cast<std::uint32_t> (size));
 
-SHAMapItem::SHAMapItem (uint256 const& tag, Serializer&& data)
-    : mTag (tag)
-    , mData (std::move(data.modData()))
-{
+    if (size != 0)
+        std::memcpy (item + 1, data, size);
+
+    // The item starts with one reference, which the pointer adopts
+    return boost::intrusive_ptr<SHAMapItem const> (item, false);
 }
 
-//  This function appears not to be called
-void SHAMapItem::dump (beast::Journal journal)
+void
+intrusive_ptr_release (SHAMapItem const* item)
 {
-    if (journal.info) journal.info <<
-        "SHAMapItem(" << mTag << ") " << mData.size () << "bytes";
+    if (item->mRefCount.fetch_sub (1, std::memory_order_acq_rel) == 1)
+    {
+        item->~SHAMapItem ();
+        ::operator delete (const_cast<SHAMapItem*> (item));
+    }
 }
 
 } // bessel
@@ -28,17 +28,17 @@ namespace bessel {
 static const uint256 uZero;
 
 static bool visitLeavesHelper (
-    std::function <void (std::shared_ptr<SHAMapItem> const&)> const& function,
+    std::function <void (boost::intrusive_ptr<SHAMapItem const> const&)> const& function,
     SHAMapTreeNode& node)
 {
     // Adapt visitNodes to visitLeaves
-    if (!node.isInner ())
-        function (node.peekItem ());
+    if (node.isLeaf ())
+        function (static_cast<SHAMapLeafNode&> (node).peekItem ());
 
     return false;
 }
 
-void SHAMap::visitLeaves (std::function<void (std::shared_ptr<SHAMapItem> const& item)> const& leafFunction) const
+void SHAMap::visitLeaves (std::function<void (boost::intrusive_ptr<SHAMapItem const> const& item)> const& leafFunction) const
 {
     visitNodes (std::bind (visitLeavesHelper,
             std::cref (leafFunction), std::placeholders::_1));
@@ -49,18 +49,23 @@ void SHAMap::visitNodes(std::function<bool (SHAMapTreeNode&)> const& function) c
     // Visit every node in a SHAMap
     assert (root_->isValid ());
 
-    if (!root_ || root_->isEmpty ())
+    if (!root_)
         return;
 
-    function (*root_);
+    if (root_->isLeaf ())
+    {
+        function (*root_);
+        return;
+    }
 
-    if (!root_->isInner ())
+    auto node = std::static_pointer_cast<SHAMapInnerNode> (root_);
+
+    if (node->isEmpty () || function (*node))
         return;
 
-    using StackEntry = std::pair <int, std::shared_ptr<SHAMapTreeNode>>;
+    using StackEntry = std::pair <int, std::shared_ptr<SHAMapInnerNode>>;
     std::stack <StackEntry, std::vector <StackEntry>> stack;
 
-    std::shared_ptr<SHAMapTreeNode> node = root_;
     int pos = 0;
 
     while (1)
@@ -89,7 +94,7 @@ void SHAMap::visitNodes(std::function<bool (SHAMapTreeNode&)> const& function) c
                     }
 
                     // descend to the child's first position
-                    node = child;
+                    node = std::static_pointer_cast<SHAMapInnerNode> (child);
                     pos = 0;
                 }
             }
@@ -117,17 +122,17 @@ void SHAMap::getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<ui
     assert (root_->isValid ());
     assert (root_->getNodeHash().isNonZero ());
 
-    std::uint32_t generation = f_.fullbelow().getGeneration();
-    if (root_->isFullBelow (generation))
+    if (!root_->isInner ())
     {
-        clearSynching ();
+        if (journal_.warning) journal_.warning <<
+            "synching empty tree";
         return;
     }
 
-    if (!root_->isInner ())
+    std::uint32_t generation = f_.fullbelow().getGeneration();
+    if (static_cast<SHAMapInnerNode*> (root_.get ())->isFullBelow (generation))
     {
-        if (journal_.warning) journal_.warning <<
-            "synching empty tree";
+        clearSynching ();
         return;
     }
 
@@ -139,15 +144,15 @@ void SHAMap::getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<ui
 
     while (1)
     {
-        std::vector <std::tuple <SHAMapTreeNode*, int, SHAMapNodeID>> deferredReads;
+        std::vector <std::tuple <SHAMapInnerNode*, int, SHAMapNodeID>> deferredReads;
         deferredReads.reserve (maxDefer + 16);
 
-        using StackEntry = std::tuple<SHAMapTreeNode*, SHAMapNodeID, int, int, bool>;
+        using StackEntry = std::tuple<SHAMapInnerNode*, SHAMapNodeID, int, int, bool>;
         std::stack <StackEntry, std::vector<StackEntry>> stack;
 
         // Traverse the map without blocking
 
-        SHAMapTreeNode *node = root_.get ();
+        auto node = static_cast<SHAMapInnerNode*> (root_.get ());
         SHAMapNodeID nodeID;
 
         // The firstChild value is selected randomly so if multiple threads
@@ -196,13 +201,14 @@ void SHAMap::getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<ui
 
                             fullBelow = false; // This node is not known full below
                         }
-                        else if (d->isInner () && !d->isFullBelow (generation))
+                        else if (d->isInner () &&
+                            !static_cast<SHAMapInnerNode*> (d)->isFullBelow (generation))
                         {
                             stack.push (std::make_tuple (node, nodeID,
                                           firstChild, currentChild, fullBelow));
 
                             // Switch to processing the child node
-                            node = d;
+                            node = static_cast<SHAMapInnerNode*> (d);
                             nodeID = childID;
                             firstChild = rand() % 256;
                             currentChild = 0;
@@ -315,11 +321,12 @@ bool SHAMap::getNodeFat (SHAMapNodeID wanted,
     while (node && node->isInner () && (nodeID.getDepth() < wanted.getDepth()))
     {
         int branch = nodeID.selectBranch (wanted.getNodeID());
+        auto inner = static_cast<SHAMapInnerNode*> (node);
 
-        if (node->isEmptyBranch (branch))
+        if (inner->isEmptyBranch (branch))
             return false;
 
-        node = descendThrow (node, branch);
+        node = descendThrow (inner, branch);
         nodeID = nodeID.getChildNodeID (branch);
     }
 
@@ -330,7 +337,7 @@ bool SHAMap::getNodeFat (SHAMapNodeID wanted,
         return false;
     }
 
-    if (node->isInner () && node->isEmpty ())
+    if (node->isInner () && static_cast<SHAMapInnerNode*> (node)->isEmpty ())
     {
         if (journal_.warning) journal_.warning <<
             "peer requests empty node";
@@ -355,16 +362,17 @@ bool SHAMap::getNodeFat (SHAMapNodeID wanted,
         {
             // We descend inner nodes with only a single child
             // without decrementing the depth
-            int bc = node->getBranchCount();
+            auto inner = static_cast<SHAMapInnerNode*> (node);
+            int bc = inner->getBranchCount();
             if ((depth > 0) || (bc == 1))
             {
                 // We need to process this node's children
                 for (int i = 0; i < 16; ++i)
                 {
-                    if (! node->isEmptyBranch (i))
+                    if (! inner->isEmptyBranch (i))
                     {
                         SHAMapNodeID childID = nodeID.getChildNodeID (i);
-                        SHAMapTreeNode* childNode = descendThrow (node, i);
+                        SHAMapTreeNode* childNode = descendThrow (inner, i);
 
                         if (childNode->isInner () &&
                             ((depth > 1) || (bc == 1)))
@@ -409,8 +417,8 @@ SHAMapAddNode SHAMap::addRootNode (Blob const& rootNode,
     }
 
     assert (seq_ >= 1);
-    auto node = std::make_shared<SHAMapTreeNode> (rootNode, 0,
-                                                  format, uZero, false);
+    auto node = SHAMapTreeNode::make (rootNode, 0,
+                                      format, uZero, false);
 
     if (!node)
         return SHAMapAddNode::invalid ();
@@ -452,8 +460,8 @@ SHAMapAddNode SHAMap::addRootNode (uint256 const& hash, Blob const& rootNode, SH
 
     assert (seq_ >= 1);
     std::shared_ptr<SHAMapTreeNode> node =
-        std::make_shared<SHAMapTreeNode> (rootNode, 0,
-                                          format, uZero, false);
+        SHAMapTreeNode::make (rootNode, 0,
+                              format, uZero, false);
 
     if (!node || node->getNodeHash () != hash)
         return SHAMapAddNode::invalid ();
@@ -477,9 +485,10 @@ SHAMapAddNode SHAMap::addRootNode (uint256 const& hash, Blob const& rootNode, SH
     return SHAMapAddNode::useful ();
 }
 
+template <class MakeNode>
 SHAMapAddNode
-SHAMap::addKnownNode (const SHAMapNodeID& node, Blob const& rawNode,
-                      SHAMapSyncFilter* filter)
+SHAMap::addKnownNodeImpl (const SHAMapNodeID& node, MakeNode makeNode,
+                          SHAMapSyncFilter* filter)
 {
     // return value: true=okay, false=error
     assert (!node.isRoot ());
@@ -495,25 +504,26 @@ SHAMap::addKnownNode (const SHAMapNodeID& node, Blob const& rawNode,
     SHAMapNodeID iNodeID;
     SHAMapTreeNode* iNode = root_.get ();
 
-    while (iNode->isInner () && !iNode->isFullBelow (generation) &&
+    while (iNode->isInner () &&
+           !static_cast<SHAMapInnerNode*> (iNode)->isFullBelow (generation) &&
            (iNodeID.getDepth () < node.getDepth ()))
     {
         int branch = iNodeID.selectBranch (node.getNodeID ());
         assert (branch >= 0);
 
-        if (iNode->isEmptyBranch (branch))
+        auto prevNode = static_cast<SHAMapInnerNode*> (iNode);
+        if (prevNode->isEmptyBranch (branch))
         {
             if (journal_.warning) journal_.warning <<
                 "Add known node for empty branch" << node;
             return SHAMapAddNode::invalid ();
         }
 
-        uint256 childHash = iNode->getChildHash (branch);
+        uint256 childHash = prevNode->getChildHash (branch);
         if (f_.fullbelow().touch_if_exists (childHash))
             return SHAMapAddNode::duplicate ();
 
-        SHAMapTreeNode* prevNode = iNode;
-        std::tie (iNode, iNodeID) = descend (iNode, iNodeID, branch, filter);
+        std::tie (iNode, iNodeID) = descend (prevNode, iNodeID, branch, filter);
 
         if (!iNode)
         {
@@ -530,8 +540,14 @@ SHAMap::addKnownNode (const SHAMapNodeID& node, Blob const& rawNode,
                 return SHAMapAddNode::invalid ();
             }
 
-            auto newNode = std::make_shared<SHAMapTreeNode>(rawNode, 0, snfWIRE,
-                                                            uZero, false);
+            std::shared_ptr<SHAMapTreeNode> newNode = makeNode ();
+
+            if (!newNode || !newNode->isValid ())
+            {
+                if (journal_.warning) journal_.warning <<
+                    "Undecodable node received";
+                return SHAMapAddNode::invalid ();
+            }
 
             if (!newNode->isInBounds (iNodeID))
             {
@@ -569,6 +585,30 @@ SHAMap::addKnownNode (const SHAMapNodeID& node, Blob const& rawNode,
     return SHAMapAddNode::duplicate ();
 }
 
+SHAMapAddNode
+SHAMap::addKnownNode (const SHAMapNodeID& node, Blob const& rawNode,
+                      SHAMapSyncFilter* filter)
+{
+    return addKnownNodeImpl (node,
+        [&rawNode] ()
+        {
+            return SHAMapTreeNode::make (rawNode, 0, snfWIRE,
+                                         uZero, false);
+        }, filter);
+}
+
+SHAMapAddNode
+SHAMap::addKnownNode (const SHAMapNodeID& node,
+                      std::shared_ptr<SHAMapTreeNode> const& newNode,
+                      SHAMapSyncFilter* filter)
+{
+    return addKnownNodeImpl (node,
+        [&newNode] ()
+        {
+            return newNode;
+        }, filter);
+}
+
 bool SHAMap::deepCompare (SHAMap& other) const
 {
     // Intended for debug/test only
@@ -599,11 +639,11 @@ bool SHAMap::deepCompare (SHAMap& other) const
         {
             if (!otherNode->isLeaf ())
                  return false;
-            auto nodePeek = node->peekItem();
-            auto otherNodePeek = otherNode->peekItem();
+            auto nodePeek = static_cast<SHAMapLeafNode*> (node)->peekItem();
+            auto otherNodePeek = static_cast<SHAMapLeafNode*> (otherNode)->peekItem();
             if (nodePeek->getTag() != otherNodePeek->getTag())
                 return false;
-            if (nodePeek->peekData() != otherNodePeek->peekData())
+            if (nodePeek->slice() != otherNodePeek->slice())
                 return false;
         }
         else if (node->isInner ())
@@ -611,20 +651,22 @@ bool SHAMap::deepCompare (SHAMap& other) const
             if (!otherNode->isInner ())
                 return false;
 
+            auto inner = static_cast<SHAMapInnerNode*> (node);
+            auto otherInner = static_cast<SHAMapInnerNode*> (otherNode);
             for (int i = 0; i < 16; ++i)
             {
-                if (node->isEmptyBranch (i))
+                if (inner->isEmptyBranch (i))
                 {
-                    if (!otherNode->isEmptyBranch (i))
+                    if (!otherInner->isEmptyBranch (i))
                         return false;
                 }
                 else
                 {
-                    if (otherNode->isEmptyBranch (i))
+                    if (otherInner->isEmptyBranch (i))
                        return false;
 
-                    SHAMapTreeNode *next = descend (node, i);
-                    SHAMapTreeNode *otherNext = other.descend (otherNode, i);
+                    SHAMapTreeNode *next = descend (inner, i);
+                    SHAMapTreeNode *otherNext = other.descend (otherInner, i);
                     if (!next || !otherNext)
                     {
                         if (journal_.warning) journal_.warning <<
@@ -652,11 +694,12 @@ SHAMap::hasInnerNode (SHAMapNodeID const& targetNodeID,
     while (node->isInner () && (nodeID.getDepth () < targetNodeID.getDepth ()))
     {
         int branch = nodeID.selectBranch (targetNodeID.getNodeID ());
+        auto inner = static_cast<SHAMapInnerNode*> (node);
 
-        if (node->isEmptyBranch (branch))
+        if (inner->isEmptyBranch (branch))
             return false;
 
-        node = descendThrow (node, branch);
+        node = descendThrow (inner, branch);
         nodeID = nodeID.getChildNodeID (branch);
     }
 
@@ -677,14 +720,15 @@ SHAMap::hasLeafNode (uint256 const& tag, uint256 const& targetNodeHash) const
     do
     {
         int branch = nodeID.selectBranch (tag);
+        auto inner = static_cast<SHAMapInnerNode*> (node);
 
-        if (node->isEmptyBranch (branch))
+        if (inner->isEmptyBranch (branch))
             return false;   // Dead end, node must not be here
 
-        if (node->getChildHash (branch) == targetNodeHash) // Matching leaf, no need to retrieve it
+        if (inner->getChildHash (branch) == targetNodeHash) // Matching leaf, no need to retrieve it
             return true;
 
-        node = descendThrow (node, branch);
+        node = descendThrow (inner, branch);
         nodeID = nodeID.getChildNodeID (branch);
     }
     while (node->isInner());
@@ -733,20 +777,21 @@ void SHAMap::visitDifferences (SHAMap* have, std::function <bool (SHAMapTreeNode
 
     if (root_->isLeaf ())
     {
-        if (! have || ! have->hasLeafNode (root_->peekItem()->getTag (), root_->getNodeHash ()))
+        auto leaf = static_cast<SHAMapLeafNode*> (root_.get ());
+        if (! have || ! have->hasLeafNode (leaf->peekItem()->getTag (), root_->getNodeHash ()))
             func (*root_);
 
         return;
     }
     // contains unexplored non-matching inner node entries
-    using StackEntry = std::pair <SHAMapTreeNode*, SHAMapNodeID>;
+    using StackEntry = std::pair <SHAMapInnerNode*, SHAMapNodeID>;
     std::stack <StackEntry, std::vector<StackEntry>> stack;
 
-    stack.push ({root_.get(), SHAMapNodeID{}});
+    stack.push ({static_cast<SHAMapInnerNode*> (root_.get()), SHAMapNodeID{}});
 
     while (!stack.empty())
     {
-        SHAMapTreeNode* node;
+        SHAMapInnerNode* node;
         SHAMapNodeID nodeID;
         std::tie (node, nodeID) = stack.top ();
         stack.pop ();
@@ -767,9 +812,10 @@ void SHAMap::visitDifferences (SHAMap* have, std::function <bool (SHAMapTreeNode
                 if (next->isInner ())
                 {
                     if (! have || ! have->hasInnerNode (childID, childHash))
-                        stack.push ({next, childID});
+                        stack.push ({static_cast<SHAMapInnerNode*> (next), childID});
                 }
-                else if (! have || ! have->hasLeafNode (next->peekItem()->getTag(), childHash))
+                else if (! have || ! have->hasLeafNode (
+                    static_cast<SHAMapLeafNode*> (next)->peekItem()->getTag(), childHash))
                 {
                     if (! func (*next))
                         return;
@@ -18,65 +18,132 @@
 //==============================================================================
 
 #include <BeastConfig.h>
-#include <mutex>
 #include <common/shamap/SHAMapTreeNode.h>
 #include <common/base/Log.h>
 #include <common/base/StringUtilities.h>
 #include <protocol/HashPrefix.h>
 #include <boost/lexical_cast.hpp>
+#include <thread>
 
 namespace bessel {
 
-std::mutex SHAMapTreeNode::childLock;
+static uint256 const zeroHash;
 
-SHAMapTreeNode::SHAMapTreeNode (std::uint32_t seq)
+SHAMapTreeNode::SHAMapTreeNode (std::uint32_t seq, TNType type)
     : mSeq (seq)
-    , mType (tnERROR)
-    , mIsBranch (0)
+    , mType (type)
+{
+}
+
+SHAMapInnerNode::SHAMapInnerNode (std::uint32_t seq)
+    : SHAMapTreeNode (seq, tnINNER)
     , mFullBelowGen (0)
+    , mIsBranch (0)
+    , mClaimed (0)
+    , mPublished (0)
 {
 }
 
-SHAMapTreeNode::SHAMapTreeNode (const SHAMapTreeNode& node, std::uint32_t seq)
-    : mHash (node.mHash)
-    , mSeq (seq)
-    , mType (node.mType)
-    , mIsBranch (node.mIsBranch)
+SHAMapInnerNode::SHAMapInnerNode (uint256 const (&hashes)[16], std::uint32_t seq)
+    : SHAMapTreeNode (seq, tnINNER)
     , mFullBelowGen (0)
+    , mIsBranch (0)
+    , mClaimed (0)
+    , mPublished (0)
 {
-    if (node.mItem)
-        mItem = node.mItem;
-    else
+    for (int i = 0; i < 16; ++i)
     {
-        memcpy (mHashes, node.mHashes, sizeof (mHashes));
+        if (hashes[i].isNonZero ())
+            mIsBranch |= (1 << i);
+    }
 
-        std::unique_lock <std::mutex> lock (childLock);
+    if (mIsBranch != 0)
+    {
+        mBranches.reset (new Branch[getBranchCount ()]);
 
+        int n = 0;
         for (int i = 0; i < 16; ++i)
-            mChildren[i] = node.mChildren[i];
+        {
+            if (!isEmptyBranch (i))
+                mBranches[n++].hash = hashes[i];
+        }
     }
 }
 
-SHAMapTreeNode::SHAMapTreeNode (std::shared_ptr<SHAMapItem> const& item,
+SHAMapLeafNode::SHAMapLeafNode (boost::intrusive_ptr<SHAMapItem const> const& item,
                                 TNType type, std::uint32_t seq)
-    : mItem (item)
-    , mSeq (seq)
-    , mType (type)
-    , mIsBranch (0)
-    , mFullBelowGen (0)
+    : SHAMapTreeNode (seq, type)
+    , mItem (item)
 {
-    assert (item->peekData ().size () >= 12);
+    assert (isLeaf ());
+    assert (item->size () >= 12);
     updateHash ();
 }
 
-SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
-                                std::uint32_t seq, SHANodeFormat format,
-                                uint256 const& hash, bool hashValid)
-    : mSeq (seq)
-    , mType (tnERROR)
-    , mIsBranch (0)
-    , mFullBelowGen (0)
+SHAMapLeafNode::SHAMapLeafNode (boost::intrusive_ptr<SHAMapItem const> const& item,
+                                TNType type, std::uint32_t seq,
+                                uint256 const& hash)
+    : SHAMapTreeNode (seq, type)
+    , mItem (item)
 {
+    assert (isLeaf ());
+    mHash = hash;
+#if BESSEL_VERIFY_NODEOBJECT_KEYS
+    updateHash ();
+    assert (mHash == hash);
+#endif
+}
+
+std::shared_ptr<SHAMapTreeNode>
+SHAMapInnerNode::clone (std::uint32_t seq) const
+{
+    auto node = std::make_shared<SHAMapInnerNode> (seq);
+    node->mHash = mHash;
+    node->mIsBranch = mIsBranch;
+
+    if (mIsBranch != 0)
+    {
+        int const count = getBranchCount ();
+        node->mBranches.reset (new Branch[count]);
+
+        // Only children that have been published are safe to copy
+        std::uint16_t const published =
+            mPublished.load (std::memory_order_acquire);
+
+        for (int i = 0, n = 0; i < 16; ++i)
+        {
+            if (isEmptyBranch (i))
+                continue;
+
+            node->mBranches[n].hash = mBranches[n].hash;
+            if (published & (1 << i))
+                node->mBranches[n].child = mBranches[n].child;
+            ++n;
+        }
+
+        node->mClaimed.store (published, std::memory_order_relaxed);
+        node->mPublished.store (published, std::memory_order_relaxed);
+    }
+
+    return node;
+}
+
+std::shared_ptr<SHAMapTreeNode>
+SHAMapLeafNode::clone (std::uint32_t seq) const
+{
+    return std::make_shared<SHAMapLeafNode> (mItem, mType, seq, mHash);
+}
+
+std::shared_ptr<SHAMapTreeNode>
+SHAMapTreeNode::make (Blob const& rawNode,
+                      std::uint32_t seq, SHANodeFormat format,
+                      uint256 const& hash, bool hashValid)
+{
+    // A leaf's item and type, or an inner node's child hashes
+    boost::intrusive_ptr<SHAMapItem const> item;
+    TNType type = tnINNER;
+    uint256 hashes[16];
+
     if (format == snfWIRE)
     {
         if (rawNode.empty ())
@@ -90,10 +157,10 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
         }
 
         Serializer s (rawNode.begin (), rawNode.end () - 1);
-        int type = rawNode.back ();
+        int wireType = rawNode.back ();
         int len = s.getLength ();
 
-        if ((type < 0) || (type > 4))
+        if ((wireType < 0) || (wireType > 4))
         {
 #ifdef BEAST_DEBUG
             deprecatedLogs().journal("SHAMapTreeNode").fatal <<
@@ -103,13 +170,13 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             throw std::runtime_error ("invalid node AW type");
         }
 
-        if (type == 0)
+        if (wireType == 0)
         {
             // transaction
-            mItem = std::make_shared<SHAMapItem> (s.getPrefixHash (HashPrefix::transactionID), s.peekData ());
-            mType = tnTRANSACTION_NM;
+            item = make_shamapitem (s.getPrefixHash (HashPrefix::transactionID), s.peekData ());
+            type = tnTRANSACTION_NM;
         }
-        else if (type == 1)
+        else if (wireType == 1)
         {
             // account state
             if (len < (256 / 8))
@@ -121,26 +188,19 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
 
             if (u.isZero ()) throw std::runtime_error ("invalid AS node");
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
-            mType = tnACCOUNT_STATE;
+            item = make_shamapitem (u, s.peekData ());
+            type = tnACCOUNT_STATE;
         }
-        else if (type == 2)
+        else if (wireType == 2)
         {
             // full inner
             if (len != 512)
                 throw std::runtime_error ("invalid FI node");
 
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (mHashes[i], i * 32);
-
-                if (mHashes[i].isNonZero ())
-                    mIsBranch |= (1 << i);
-            }
-
-            mType = tnINNER;
+                s.get256 (hashes[i], i * 32);
         }
-        else if (type == 3)
+        else if (wireType == 3)
         {
             // compressed inner
             for (int i = 0; i < (len / 33); ++i)
@@ -150,15 +210,10 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
                     throw std::runtime_error ("short CI node");
                 if ((pos < 0) || (pos >= 16))
                     throw std::runtime_error ("invalid CI node");                
-                s.get256 (mHashes[pos], i * 33);
-
-                if (mHashes[pos].isNonZero ())
-                    mIsBranch |= (1 << pos);
+                s.get256 (hashes[pos], i * 33);
             }
-
-            mType = tnINNER;
         }
-        else if (type == 4)
+        else if (wireType == 4)
         {
             // transaction with metadata
             if (len < (256 / 8))
@@ -171,8 +226,8 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             if (u.isZero ())
                 throw std::runtime_error ("invalid TM node");
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
-            mType = tnTRANSACTION_MD;
+            item = make_shamapitem (u, s.peekData ());
+            type = tnTRANSACTION_MD;
         }
     }
 
@@ -191,21 +246,21 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
         prefix |= rawNode[2];
         prefix <<= 8;
         prefix |= rawNode[3];
-        Serializer s (rawNode.begin () + 4, rawNode.end ());
+        // Parse in place; only the item's own copy of the data is made
+        Slice const body (rawNode.data () + 4, rawNode.size () - 4);
 
         if (prefix == HashPrefix::transactionID)
         {
-            mItem = std::make_shared<SHAMapItem> (getSHA512Half (rawNode), s.peekData ());
-            mType = tnTRANSACTION_NM;
+            item = make_shamapitem (getSHA512Half (rawNode),
+                body.data (), body.size ());
+            type = tnTRANSACTION_NM;
         }
         else if (prefix == HashPrefix::leafNode)
         {
-            if (s.getLength () < 32)
+            if (body.size () < 32)
                 throw std::runtime_error ("short PLN node");
 
-            uint256 u;
-            s.get256 (u, s.getLength () - 32);
-            s.chop (32);
+            auto const u = uint256::fromVoid (body.data () + body.size () - 32);
 
             if (u.isZero ())
             {
@@ -213,35 +268,26 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
                 throw std::runtime_error ("invalid PLN node");
             }
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
-            mType = tnACCOUNT_STATE;
+            item = make_shamapitem (u, body.data (), body.size () - 32);
+            type = tnACCOUNT_STATE;
         }
         else if (prefix == HashPrefix::innerNode)
         {
-            if (s.getLength () != 512)
+            if (body.size () != 512)
                 throw std::runtime_error ("invalid PIN node");
 
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (mHashes[i], i * 32);
-
-                if (mHashes[i].isNonZero ())
-                    mIsBranch |= (1 << i);
-            }
-
-            mType = tnINNER;
+                hashes[i] = uint256::fromVoid (body.data () + i * 32);
         }
         else if (prefix == HashPrefix::txNode)
         {
             // transaction with metadata
-            if (s.getLength () < 32)
+            if (body.size () < 32)
                 throw std::runtime_error ("short TXN node");
 
-            uint256 txID;
-            s.get256 (txID, s.getLength () - 32);
-            s.chop (32);
-            mItem = std::make_shared<SHAMapItem> (txID, s.peekData ());
-            mType = tnTRANSACTION_MD;
+            auto const txID = uint256::fromVoid (body.data () + body.size () - 32);
+            item = make_shamapitem (txID, body.data (), body.size () - 32);
+            type = tnTRANSACTION_MD;
         }
         else
         {
@@ -256,59 +302,83 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
         throw std::runtime_error ("Unknown format");
     }
 
-    if (hashValid)
+    if (type == tnINNER)
     {
-        mHash = hash;
+        auto inner = std::make_shared<SHAMapInnerNode> (hashes, seq);
+
+        if (hashValid)
+        {
+            inner->mHash = hash;
 #if BESSEL_VERIFY_NODEOBJECT_KEYS
-        updateHash ();
-        assert (mHash == hash);
+            inner->updateHash ();
+            assert (inner->mHash == hash);
 #endif
+        }
+        else
+            inner->updateHash ();
+
+        return inner;
     }
-    else
-        updateHash ();
+
+    if (hashValid)
+        return std::make_shared<SHAMapLeafNode> (item, type, seq, hash);
+
+    return std::make_shared<SHAMapLeafNode> (item, type, seq);
 }
 
-bool SHAMapTreeNode::updateHash ()
+bool SHAMapInnerNode::updateHash ()
 {
     uint256 nh;
 
-    if (mType == tnINNER)
+    if (mIsBranch != 0)
     {
-        if (mIsBranch != 0)
+        uint256 hashes[16];
+
+        for (int i = 0, n = 0; i < 16; ++i)
         {
-            nh = Serializer::getPrefixHash (HashPrefix::innerNode, reinterpret_cast<unsigned char*> (mHashes), sizeof (mHashes));
+            if (!isEmptyBranch (i))
+                hashes[i] = mBranches[n++].hash;
+        }
+
+        nh = Serializer::getPrefixHash (HashPrefix::innerNode, reinterpret_cast<unsigned char*> (hashes), sizeof (hashes));
 #if BESSEL_VERIFY_NODEOBJECT_KEYS
-            Serializer s;
-            s.add32 (HashPrefix::innerNode);
+        Serializer s;
+        s.add32 (HashPrefix::innerNode);
 
-            for (int i = 0; i < 16; ++i)
-                s.add256 (mHashes[i]);
+        for (int i = 0; i < 16; ++i)
+            s.add256 (hashes[i]);
 
-            assert (nh == s.getSHA512Half ());
+        assert (nh == s.getSHA512Half ());
 #endif
-        }
-        else
-            nh.zero ();
     }
-    else if (mType == tnTRANSACTION_NM)
+    else
+        nh.zero ();
+
+    if (nh == mHash)
+        return false;
+
+    mHash = nh;
+    return true;
+}
+
+bool SHAMapLeafNode::updateHash ()
+{
+    uint256 nh;
+
+    if (mType == tnTRANSACTION_NM)
     {
-        nh = Serializer::getPrefixHash (HashPrefix::transactionID, mItem->peekData ());
+        nh = Serializer::getPrefixHash (HashPrefix::transactionID,
+            mItem->slice ().data (), mItem->size ());
     }
     else if (mType == tnACCOUNT_STATE)
     {
-        Serializer s (mItem->size() + (256 + 32) / 8);
-        s.add32 (HashPrefix::leafNode);
-        s.addRaw (mItem->peekData ());
-        s.add256 (mItem->getTag ());
-        nh = s.getSHA512Half ();
+        nh = Serializer::getPrefixHash (HashPrefix::leafNode,
+            mItem->slice (), mItem->getTag ());
     }
     else if (mType == tnTRANSACTION_MD)
     {
-        Serializer s (mItem->size() + (256 + 32) / 8);
-        s.add32 (HashPrefix::txNode);
-        s.addRaw (mItem->peekData ());
-        s.add256 (mItem->getTag ());
-        nh = s.getSHA512Half ();
+        nh = Serializer::getPrefixHash (HashPrefix::txNode,
+            mItem->slice (), mItem->getTag ());
     }
     else
         assert (false);
@@ -321,72 +391,83 @@ bool SHAMapTreeNode::updateHash ()
 }
 
 void
-SHAMapTreeNode::updateHashDeep()
+SHAMapInnerNode::updateHashDeep()
 {
-    for (auto pos = 0; pos < 16; ++pos)
+    int const count = getBranchCount ();
+
+    for (int i = 0; i < count; ++i)
     {
-        if (mChildren[pos] != nullptr)
-            mHashes[pos] = mChildren[pos]->mHash;
+        if (mBranches[i].child != nullptr)
+            mBranches[i].hash = mBranches[i].child->getNodeHash ();
     }
     updateHash();
 }
 
-void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
+void SHAMapInnerNode::addRaw (Serializer& s, SHANodeFormat format) const
 {
     assert ((format == snfPREFIX) || (format == snfWIRE) || (format == snfHASH));
 
-    if (mType == tnERROR)
-        throw std::runtime_error ("invalid I node type");
-
     if (format == snfHASH)
     {
         s.add256 (getNodeHash ());
+        return;
     }
-    else if (mType == tnINNER)
+
+    assert (!isEmpty ());
+
+    if (format == snfPREFIX)
     {
-        assert (!isEmpty ());
+        s.add32 (HashPrefix::innerNode);
 
-        if (format == snfPREFIX)
+        for (int i = 0; i < 16; ++i)
+            s.add256 (getChildHash (i));
+    }
+    else
+    {
+        if (getBranchCount () < 12)
         {
-            s.add32 (HashPrefix::innerNode);
-
+            // compressed node
             for (int i = 0; i < 16; ++i)
-                s.add256 (mHashes[i]);
+                if (!isEmptyBranch (i))
+                {
+                    s.add256 (getChildHash (i));
+                    s.add8 (i);
+                }
+
+            s.add8 (3);
         }
         else
         {
-            if (getBranchCount () < 12)
-            {
-                // compressed node
-                for (int i = 0; i < 16; ++i)
-                    if (!isEmptyBranch (i))
-                    {
-                        s.add256 (mHashes[i]);
-                        s.add8 (i);
-                    }
-
-                s.add8 (3);
-            }
-            else
-            {
-                for (int i = 0; i < 16; ++i)
-                    s.add256 (mHashes[i]);
+            for (int i = 0; i < 16; ++i)
+                s.add256 (getChildHash (i));
 
-                s.add8 (2);
-            }
+            s.add8 (2);
         }
     }
+}
+
+void SHAMapLeafNode::addRaw (Serializer& s, SHANodeFormat format) const
+{
+    assert ((format == snfPREFIX) || (format == snfWIRE) || (format == snfHASH));
+
+    if (mType == tnERROR)
+        throw std::runtime_error ("invalid I node type");
+
+    if (format == snfHASH)
+    {
+        s.add256 (getNodeHash ());
+    }
     else if (mType == tnACCOUNT_STATE)
     {
         if (format == snfPREFIX)
         {
             s.add32 (HashPrefix::leafNode);
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->slice ());
             s.add256 (mItem->getTag ());
         }
         else
         {
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->slice ());
             s.add256 (mItem->getTag ());
             s.add8 (1);
         }
@@ -396,11 +477,11 @@ void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
         if (format == snfPREFIX)
         {
             s.add32 (HashPrefix::transactionID);
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->slice ());
         }
         else
         {
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->slice ());
             s.add8 (0);
         }
     }
@@ -409,12 +490,12 @@ void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
         if (format == snfPREFIX)
         {
             s.add32 (HashPrefix::txNode);
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->slice ());
             s.add256 (mItem->getTag ());
         }
         else
         {
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->slice ());
             s.add256 (mItem->getTag ());
             s.add8 (4);
         }
@@ -423,7 +504,7 @@ void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
         assert (false);
 }
 
-bool SHAMapTreeNode::setItem (std::shared_ptr<SHAMapItem> const& i, TNType type)
+bool SHAMapLeafNode::setItem (boost::intrusive_ptr<SHAMapItem const> const& i, TNType type)
 {
     mType = type;
     mItem = i;
@@ -432,14 +513,8 @@ bool SHAMapTreeNode::setItem (std::shared_ptr<SHAMapItem> const& i, TNType type)
     return updateHash ();
 }
 
-bool SHAMapTreeNode::isEmpty () const
+int SHAMapInnerNode::getBranchCount () const
 {
-    return mIsBranch == 0;
-}
-
-int SHAMapTreeNode::getBranchCount () const
-{
-    assert (isInner ());
     int count = 0;
 
     for (int i = 0; i < 16; ++i)
@@ -449,13 +524,26 @@ int SHAMapTreeNode::getBranchCount () const
     return count;
 }
 
-void SHAMapTreeNode::makeInner ()
+// Position of branch m among the populated branches
+int SHAMapInnerNode::slot (int m) const
+{
+    int n = 0;
+
+    for (int i = 0; i < m; ++i)
+        if (!isEmptyBranch (i))
+            ++n;
+
+    return n;
+}
+
+uint256 const& SHAMapInnerNode::getChildHash (int m) const
 {
-    mItem.reset ();
-    mIsBranch = 0;
-    memset (mHashes, 0, sizeof (mHashes));
-    mType = tnINNER;
-    mHash.zero ();
+    assert ((m >= 0) && (m < 16));
+
+    if (isEmptyBranch (m))
+        return zeroHash;
+
+    return mBranches[slot (m)].hash;
 }
 
 #ifdef BEAST_DEBUG
@@ -475,106 +563,167 @@ std::string SHAMapTreeNode::getString (const SHAMapNodeID & id) const
     ret += ",";
     ret += to_string (id.getNodeID ());
     ret += ")";
+    return ret;
+}
 
-    if (isInner ())
-    {
-        for (int i = 0; i < 16; ++i)
-            if (!isEmptyBranch (i))
-            {
-                ret += "\nb";
-                ret += boost::lexical_cast<std::string> (i);
-                ret += " = ";
-                ret += to_string (mHashes[i]);
-            }
-    }
+std::string SHAMapInnerNode::getString (const SHAMapNodeID & id) const
+{
+    std::string ret = SHAMapTreeNode::getString (id);
 
-    if (isLeaf ())
-    {
-        if (mType == tnTRANSACTION_NM)
-            ret += ",txn\n";
-        else if (mType == tnTRANSACTION_MD)
-            ret += ",txn+md\n";
-        else if (mType == tnACCOUNT_STATE)
-            ret += ",as\n";
-        else
-            ret += ",leaf\n";
-
-        ret += "  Tag=";
-        ret += to_string (peekItem()->getTag ());
-        ret += "\n  Hash=";
-        ret += to_string (mHash);
-        ret += "/";
-        ret += boost::lexical_cast<std::string> (mItem->size());
-    }
+    for (int i = 0; i < 16; ++i)
+        if (!isEmptyBranch (i))
+        {
+            ret += "\nb";
+            ret += boost::lexical_cast<std::string> (i);
+            ret += " = ";
+            ret += to_string (getChildHash (i));
+        }
+
+    return ret;
+}
+
+std::string SHAMapLeafNode::getString (const SHAMapNodeID & id) const
+{
+    std::string ret = SHAMapTreeNode::getString (id);
+
+    if (mType == tnTRANSACTION_NM)
+        ret += ",txn\n";
+    else if (mType == tnTRANSACTION_MD)
+        ret += ",txn+md\n";
+    else if (mType == tnACCOUNT_STATE)
+        ret += ",as\n";
+    else
+        ret += ",leaf\n";
+
+    ret += "  Tag=";
+    ret += to_string (mItem->getTag ());
+    ret += "\n  Hash=";
+    ret += to_string (mHash);
+    ret += "/";
+    ret += boost::lexical_cast<std::string> (mItem->size());
 
     return ret;
 }
 
 // We are modifying an inner node
 void
-SHAMapTreeNode::setChild (int m, std::shared_ptr<SHAMapTreeNode> const& child)
+SHAMapInnerNode::setChild (int m, std::shared_ptr<SHAMapTreeNode> const& child)
 {
     assert ((m >= 0) && (m < 16));
-    assert (mType == tnINNER);
     assert (mSeq != 0);
     assert (child.get() != this);
-    mHashes[m].zero();
     mHash.zero();
-    if (child)
-        mIsBranch |= (1 << m);
-    else
+
+    int const n = slot (m);
+    int const count = getBranchCount ();
+
+    if (!isEmptyBranch (m))
+    {
+        if (child)
+        {
+            mBranches[n].hash.zero ();
+            mBranches[n].child = child;
+            publish (m);
+            return;
+        }
+
+        // Drop the slot for this branch
+        std::unique_ptr<Branch[]> branches;
+        if (count > 1)
+        {
+            branches.reset (new Branch[count - 1]);
+            for (int i = 0, j = 0; i < count; ++i)
+                if (i != n)
+                    branches[j++] = std::move (mBranches[i]);
+        }
+
+        mBranches = std::move (branches);
         mIsBranch &= ~ (1 << m);
-    mChildren[m] = child;
+        mClaimed.fetch_and (~ (1 << m), std::memory_order_relaxed);
+        mPublished.fetch_and (~ (1 << m), std::memory_order_relaxed);
+    }
+    else if (child)
+    {
+        // Open a slot for this branch
+        std::unique_ptr<Branch[]> branches (new Branch[count + 1]);
+        for (int i = 0, j = 0; i <= count; ++i)
+        {
+            if (i == n)
+                branches[i].child = child;
+            else
+                branches[i] = std::move (mBranches[j++]);
+        }
+
+        mBranches = std::move (branches);
+        mIsBranch |= (1 << m);
+        publish (m);
+    }
+}
+
+// The node is not shared, so there is no one to race with
+void
+SHAMapInnerNode::publish (int m)
+{
+    mClaimed.fetch_or (1 << m, std::memory_order_relaxed);
+    mPublished.fetch_or (1 << m, std::memory_order_release);
 }
 
 // finished modifying, now make shareable
-void SHAMapTreeNode::shareChild (int m, std::shared_ptr<SHAMapTreeNode> const& child)
+void SHAMapInnerNode::shareChild (int m, std::shared_ptr<SHAMapTreeNode> const& child)
 {
     assert ((m >= 0) && (m < 16));
-    assert (mType == tnINNER);
     assert (mSeq != 0);
     assert (child);
     assert (child.get() != this);
+    assert (!isEmptyBranch (m));
 
-    mChildren[m] = child;
+    mBranches[slot (m)].child = child;
+    publish (m);
 }
 
-SHAMapTreeNode* SHAMapTreeNode::getChildPointer (int branch)
+SHAMapTreeNode* SHAMapInnerNode::getChildPointer (int branch)
 {
     assert (branch >= 0 && branch < 16);
-    assert (isInnerNode ());
 
-    std::unique_lock <std::mutex> lock (childLock);
-    return mChildren[branch].get ();
+    if ((mPublished.load (std::memory_order_acquire) & (1 << branch)) == 0)
+        return nullptr;
+
+    return mBranches[slot (branch)].child.get ();
 }
 
-std::shared_ptr<SHAMapTreeNode> SHAMapTreeNode::getChild (int branch)
+std::shared_ptr<SHAMapTreeNode> SHAMapInnerNode::getChild (int branch)
 {
     assert (branch >= 0 && branch < 16);
-    assert (isInnerNode ());
 
-    std::unique_lock <std::mutex> lock (childLock);
-    return mChildren[branch];
+    if ((mPublished.load (std::memory_order_acquire) & (1 << branch)) == 0)
+        return std::shared_ptr<SHAMapTreeNode> ();
+
+    return mBranches[slot (branch)].child;
 }
 
-void SHAMapTreeNode::canonicalizeChild (int branch, std::shared_ptr<SHAMapTreeNode>& node)
+void SHAMapInnerNode::canonicalizeChild (int branch, std::shared_ptr<SHAMapTreeNode>& node)
 {
     assert (branch >= 0 && branch < 16);
-    assert (isInnerNode ());
     assert (node);
-    assert (node->getNodeHash() == mHashes[branch]);
+    assert (!isEmptyBranch (branch));
+    assert (node->getNodeHash() == getChildHash (branch));
 
-    std::unique_lock <std::mutex> lock (childLock);
-    if (mChildren[branch])
-    {
-        // There is already a node hooked up, return it
-        node = mChildren[branch];
-    }
-    else
+    std::uint16_t const bit = 1 << branch;
+    auto& child = mBranches[slot (branch)].child;
+
+    if ((mClaimed.fetch_or (bit, std::memory_order_acq_rel) & bit) == 0)
     {
         // Hook this node up
-        mChildren[branch] = node;
+        child = node;
+        mPublished.fetch_or (bit, std::memory_order_release);
+        return;
     }
+
+    // There is already a node hooked up, or about to be; return it
+    while ((mPublished.load (std::memory_order_acquire) & bit) == 0)
+        std::this_thread::yield ();
+
+    node = child;
 }
 
 
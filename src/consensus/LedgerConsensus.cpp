@@ -36,8 +36,10 @@
 #include <common/base/Log.h>
 #include <common/core/Config.h>
 #include <common/core/JobQueue.h>
+#include <common/core/ParallelFor.h>
 #include <common/core/LoadFeeTrack.h>
 #include <common/json/to_string.h>
+#include <data/nodestore/Database.h>
 #include <transaction/tx/TransactionAcquire.h>
 #include <transaction/tx/InboundTransactions.h>
 #include <network/overlay/Overlay.h>
@@ -405,6 +407,15 @@ public:
 
         mAcquired[hash] = map;
 
+        // Check the set's signatures and fees while consensus proceeds,
+        // so accepting it only has ledger-dependent work left to do.
+        auto const snapshot = map->snapShot (false);
+        getApp().getJobQueue ().addJob (jtTXN_PREFLIGHT, "preflightTxnSet",
+            [snapshot] (Job&)
+            {
+                preflightTransactions (snapshot);
+            });
+
         // Adjust tracking for each peer that takes this position
         std::vector<NodeID> peers;
         for (auto& it : mPeerPositions)
@@ -963,6 +974,9 @@ private:
 
         WriteLog (lsDEBUG, LedgerConsensus) << "Flushed " << asf << " account and " << tmf << "transaction nodes";
 
+        // Backends that queue writes in memory persist them now
+        getApp().getNodeStore ().flush ();
+
         // Accept ledger
         newLCL->setAccepted (closeTime, mCloseResolution, closeTimeCorrect);
 
@@ -1154,14 +1168,14 @@ private:
                 // transaction is only in first map
                 assert (!pos.second.second);
 
-                addDisputedTransaction (pos.first , pos.second.first->peekData ());
+                addDisputedTransaction (pos.first , pos.second.first->getData ());
             }
             else if (pos.second.second)
             {
                 // transaction is only in second map
                 assert (!pos.second.first);
 
-                addDisputedTransaction (pos.first, pos.second.second->peekData ());
+                addDisputedTransaction (pos.first, pos.second.second->getData ());
             }
             else // No other disagreement over a transaction should be possible
             {
@@ -1499,7 +1513,7 @@ private:
 
                 if (it.second->getOurVote ()) // now a yes
                 {
-                    ourPosition->addItem (SHAMapItem (it.first, it.second->peekTransaction ()), true, false);
+                    ourPosition->addGiveItem (make_shamapitem (it.first, it.second->peekTransaction ().peekData ()), true, false);
                     //              addedTx.push_back(it.first);
                 }
                 else // now a no
@@ -1847,6 +1861,120 @@ make_LedgerConsensus (LocalTxs& localtx,
     return std::make_shared <LedgerConsensusImp> (localtx, prevLCLHash, previousLedger, closeTime, feeVote);
 }
 
+/** Run the checks that do not depend on a ledger over a transaction set
+
+  Signatures and fee formats are the same in every ledger, so they can be
+  checked as soon as a set is acquired, in parallel, and off the path from
+  consensus to validation. Transactions that pass are marked SF_SIGGOOD in
+  the HashRouter and those that can never apply are marked SF_BAD, the
+  flag PeerImp and NetworkOPs already use, so nothing is checked twice.
+  Local policy checks are not applied here because other servers may
+  legitimately include such transactions.
+
+  @param set The transaction set, which must not change while this runs.
+*/
+void preflightTransactions (std::shared_ptr<SHAMap> const& set)
+{
+    // Ed25519 signatures are verified in batches of up to this many
+    std::size_t const chunkSize = 64;
+
+    // Most helper jobs to use, so a large set does not take every thread
+    // of the job queue away from consensus
+    std::size_t const helpersMax = 4;
+
+    auto& router = getApp().getHashRouter ();
+
+    std::vector<boost::intrusive_ptr<SHAMapItem const>> items;
+
+    set->visitLeaves (
+        [&] (boost::intrusive_ptr<SHAMapItem const> const& item)
+        {
+            if ((router.getFlags (item->getTag ()) & (SF_SIGGOOD | SF_BAD)) == 0)
+                items.push_back (item);
+        });
+
+    if (items.empty ())
+        return;
+
+    auto const chunks = (items.size () + chunkSize - 1) / chunkSize;
+
+    parallelFor (getApp().getJobQueue (), jtTXN_PREFLIGHT, "preflightTxnSet",
+        chunks, helpersMax,
+        [&] (std::size_t chunk)
+        {
+            auto const first = chunk * chunkSize;
+            auto const last = std::min (first + chunkSize, items.size ());
+
+            std::vector<STTx::pointer> txns;
+            txns.reserve (last - first);
+
+            for (auto i = first; i != last; ++i)
+            {
+                try
+                {
+                    SerialIter sit (items[i]->slice ());
+                    auto txn = std::make_shared<STTx> (sit);
+
+                    STAmount const fee = txn->getTransactionFee ();
+
+                    // The same tests Transactor::payFee fails with tem codes
+                    if (!isLegalNet (fee) || fee < zero || !fee.isNative ())
+                        router.setFlag (txn->getTransactionID (), SF_BAD);
+                    else
+                        txns.push_back (std::move (txn));
+                }
+                catch (...)
+                {
+                    // applyTransactions skips what it cannot parse
+                }
+            }
+
+            STTx::checkSigns (txns);
+
+            for (auto const& txn : txns)
+            {
+                router.setFlag (txn->getTransactionID (),
+                    txn->isKnownGood () ? SF_SIGGOOD : SF_BAD);
+            }
+        });
+
+    WriteLog (lsDEBUG, LedgerConsensus) << "Preflighted " << items.size ()
+                                        << " transactions of set "
+                                        << set->getHash ();
+}
+
+/** Verify the signatures of a set of candidate transactions in one pass
+
+  Transactions the HashRouter already knows to be good are skipped. The
+  rest are checked together, so Ed25519 signatures are verified as a
+  batch, and the good ones are marked so applyTransaction can skip the
+  check.
+
+  @param txns The transactions about to be applied.
+*/
+static
+void checkSignatures (std::vector<STTx::pointer> const& txns)
+{
+    auto& router = getApp().getHashRouter ();
+
+    std::vector<STTx::pointer> unchecked;
+    unchecked.reserve (txns.size ());
+
+    for (auto const& txn : txns)
+    {
+        if ((router.getFlags (txn->getTransactionID ()) & (SF_SIGGOOD | SF_BAD)) == 0)
+            unchecked.push_back (txn);
+    }
+
+    STTx::checkSigns (unchecked);
+
+    for (auto const& txn : unchecked)
+    {
+        if (txn->isKnownGood ())
+            router.setFlag (txn->getTransactionID (), SF_SIGGOOD);
+    }
+}
+
 /** Apply a transaction to a ledger
 
   @param engine       The transaction engine containing the ledger.
@@ -1869,7 +1997,12 @@ int applyTransaction (TransactionEngine& engine,
         parms = static_cast<TransactionEngineParams> (parms | tapRETRY);
     }
 
-    if ((getApp().getHashRouter ().getFlags (txn->getTransactionID ()) & SF_SIGGOOD) == SF_SIGGOOD)
+    int const flags = getApp().getHashRouter ().getFlags (txn->getTransactionID ());
+
+    // SF_BAD is also set for local policy failures on submission, so a
+    // transaction carrying it still goes through the engine, with its
+    // signature checked, rather than being dropped here.
+    if ((flags & (SF_SIGGOOD | SF_BAD)) == SF_SIGGOOD)
     {
         parms = static_cast<TransactionEngineParams>(parms | tapNO_CHECK_SIGN);
     }
@@ -1939,7 +2072,9 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
 
     if (set)
     {
-        for (std::shared_ptr<SHAMapItem> item = set->peekFirstItem (); 
+        std::vector<STTx::pointer> candidates;
+
+        for (boost::intrusive_ptr<SHAMapItem const> item = set->peekFirstItem (); 
             !!item;
             item = set->peekNextItem (item->getTag ()))
         {
@@ -1951,14 +2086,8 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
 
                 try
                 {
-                    SerialIter    sit (item->peekSerializer ());
-                    STTx::pointer txn = std::make_shared<STTx>(sit);
-                    if (applyTransaction (engine, txn, openLgr, true) == LedgerConsensusImp::resultRetry)
-                    {
-                        // On failure, stash the failed transaction for
-                        // later retry.
-                        retriableTransactions.push_back (txn);
-                    }
+                    SerialIter sit (item->slice ());
+                    candidates.push_back (std::make_shared<STTx>(sit));
                 }
                 catch (...)
                 {
@@ -1966,6 +2095,25 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
                 }
             }
         }
+
+        checkSignatures (candidates);
+
+        for (auto const& txn : candidates)
+        {
+            try
+            {
+                if (applyTransaction (engine, txn, openLgr, true) == LedgerConsensusImp::resultRetry)
+                {
+                    // On failure, stash the failed transaction for
+                    // later retry.
+                    retriableTransactions.push_back (txn);
+                }
+            }
+            catch (...)
+            {
+                WriteLog (lsWARNING, LedgerConsensus) << "  Throws";
+            }
+        }
     }
 
     int changes;
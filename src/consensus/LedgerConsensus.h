@@ -81,6 +81,9 @@ make_LedgerConsensus (LocalTxs& localtx,
                       std::uint32_t closeTime, 
                       FeeVote& feeVote);
 
+void
+preflightTransactions (std::shared_ptr<SHAMap> const& set);
+
 void
 applyTransactions(std::shared_ptr<SHAMap> const& set, 
                   Ledger::ref applyLedger,
@@ -22,6 +22,7 @@
 
 #include <common/base/base_uint.h>
 #include <common/base/Blob.h>
+#include <cstdint>
 
 namespace bessel {
 
@@ -32,6 +33,16 @@ bool ECDSAVerify (uint256 const& hash,
                   std::uint8_t const* key_data,
                   std::size_t key_size);
 
+/** Counters for the decoded public key cache used by ECDSAVerify. */
+struct ECDSAKeyCacheStats
+{
+    std::uint64_t hits;
+    std::uint64_t misses;
+    std::size_t size;
+};
+
+ECDSAKeyCacheStats getECDSAKeyCacheStats ();
+
 } // bessel
 
 #endif
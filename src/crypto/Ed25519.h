@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_CRYPTO_ED25519_H_INCLUDED
+#define BESSEL_CRYPTO_ED25519_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bessel {
+
+/** Returns true if the S half of an Ed25519 signature is below the group order. */
+bool isCanonicalEd25519Signature (std::uint8_t const* signature);
+
+/** Returns true if a 32 byte Ed25519 point encoding is canonical and the
+    point lies in the prime order subgroup.
+
+    This costs a scalar multiplication.
+*/
+bool isCanonicalTorsionFreeEd25519Point (std::uint8_t const* point);
+
+/** Verifies a group of Ed25519 signatures together.
+
+    ed25519_sign_open_batch checks up to 64 signatures with a single
+    multi-scalar multiplication, which is several times cheaper per
+    signature than calling ed25519_sign_open for each. When a batch does
+    not check out, the library falls back to verifying its members one by
+    one, so a single bad signature is still pinned to its own entry.
+
+    The batch equation uses random coefficients and does not compare the
+    encoding of R, so it only agrees with ed25519_sign_open when every key
+    and R value is canonical and torsion free (see
+    isCanonicalTorsionFreeEd25519Point). Anything else must be checked on
+    its own.
+
+    The verifier does not copy its inputs: the message, key and signature
+    buffers handed to add() must stay alive until verify() returns.
+*/
+class Ed25519BatchVerifier
+{
+public:
+    Ed25519BatchVerifier () = default;
+    Ed25519BatchVerifier (Ed25519BatchVerifier const&) = delete;
+    Ed25519BatchVerifier& operator= (Ed25519BatchVerifier const&) = delete;
+
+    /** Queue a signature for verification.
+
+        @param publicKey 32 byte Ed25519 key, without the 0xED type prefix.
+        @param signature 64 byte signature.
+        @return The index of the entry, to be passed to valid().
+    */
+    std::size_t add (void const* message, std::size_t size,
+        std::uint8_t const* publicKey, std::uint8_t const* signature);
+
+    std::size_t size () const
+    {
+        return keys_.size ();
+    }
+
+    /** Check every queued signature.
+
+        @return true if all of them are good.
+    */
+    bool verify ();
+
+    /** Returns the result of entry `index` after verify(). */
+    bool valid (std::size_t index) const
+    {
+        return valid_[index] != 0;
+    }
+
+private:
+    std::vector <unsigned char const*> messages_;
+    std::vector <std::size_t> sizes_;
+    std::vector <unsigned char const*> keys_;
+    std::vector <unsigned char const*> signatures_;
+    std::vector <int> valid_;
+};
+
+} // bessel
+
+#endif
@@ -117,6 +117,56 @@ ED25519_FN(ed25519_sign_open) (const unsigned char *m, size_t mlen, const ed2551
 
 #include "ed25519-donna-batchverify.h"
 
+/*
+	Returns 1 if p is the canonical encoding of a point in the prime order
+	subgroup. A batch made only of such keys and R values reaches the same
+	verdict as ed25519_sign_open: with no small order components there is
+	nothing for the random batch coefficients to cancel.
+*/
+
+int
+ED25519_FN(ed25519_point_is_canonical_torsion_free) (const unsigned char p[32]) {
+	/* l - 1, little endian */
+	static const unsigned char order_minus_one[32] = {
+		0xec,0xd3,0xf5,0x5c,0x1a,0x63,0x12,0x58,0xd6,0x9c,0xf7,0xa2,0xde,0xf9,0xde,0x14,
+		0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x10
+	};
+	static const unsigned char zero[32] = {0};
+	bignum256modm s, none = {0};
+	ge25519 ALIGN(16) P, Q;
+	bignum25519 t;
+	unsigned char check[32];
+
+	/* P = -A */
+	if (!ge25519_unpack_negative_vartime(&P, p))
+		return 0;
+
+	/* A must encode back to the same bytes: y below 2^255 - 19, and no sign bit when x is 0 */
+	Q = P;
+	curve25519_neg(Q.x, P.x);
+	curve25519_neg(Q.t, P.t);
+	ge25519_pack(check, &Q);
+	if (memcmp(check, p, 32) != 0)
+		return 0;
+
+	/* Q = [l-1]P, which is -P = A exactly when [l]P is the neutral point */
+	expand256_modm(s, order_minus_one, 32);
+	ge25519_double_scalarmult_vartime(&Q, &P, s, none);
+
+	/* Q.x / Q.z == -P.x */
+	curve25519_mul(t, P.x, Q.z);
+	curve25519_add_reduce(t, t, Q.x);
+	curve25519_contract(check, t);
+	if (memcmp(check, zero, 32) != 0)
+		return 0;
+
+	/* Q.y / Q.z == P.y */
+	curve25519_mul(t, P.y, Q.z);
+	curve25519_sub_reduce(t, Q.y, t);
+	curve25519_contract(check, t);
+	return (memcmp(check, zero, 32) == 0) ? 1 : 0;
+}
+
 /*
 	Fast Curve25519 basepoint scalar multiplication
 */
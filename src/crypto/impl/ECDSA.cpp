@@ -30,7 +30,13 @@
 #include <openssl/ec.h>
 #include <openssl/ecdsa.h>
 #include <openssl/hmac.h>
+#include <common/base/UnorderedContainers.h>
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
 
 namespace bessel  {
 
@@ -69,9 +75,167 @@ static bool ECDSAVerify (uint256 const& hash, std::uint8_t const* sig, size_t si
     return ECDSA_verify (0, hash.begin(), hash.size(), sig, sigLen, key) > 0;
 }
 
-static bool ECDSAVerify (uint256 const& hash, Blob const& sig, const openssl::ec_key& key)
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+/** Decoded secp256k1 public keys, keyed by their compressed encoding.
+
+    Decoding a public key (o2i_ECPublicKey) decompresses the point, which
+    costs about as much as the signature check itself. The same few
+    hundred validators and busy accounts sign almost everything we see,
+    so the decoded EC_KEY objects are kept here and shared between
+    verifying threads.
+
+    The cache is split into shards with their own locks. Each shard keeps
+    two generations: when the current one fills up it becomes the old one
+    and the previous old generation is dropped. A hit in the old
+    generation moves the key forward, so keys in steady use stay resident
+    and the memory held is bounded.
+*/
+class ECDSAKeyCache
 {
-    return ECDSAVerify (hash, sig.data(), sig.size(), (EC_KEY*) key.get());
+public:
+    using key_type = std::array <std::uint8_t, 33>;
+    using value_type = std::shared_ptr <EC_KEY>;
+
+private:
+    static std::size_t const shardCount = 16;
+    static std::size_t const generationSize = 512;
+
+    using map_type = hardened_hash_map <key_type, value_type>;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        map_type current;
+        map_type old;
+    };
+
+    std::array <Shard, shardCount> shards_;
+    std::atomic <std::uint64_t> hits_;
+    std::atomic <std::uint64_t> misses_;
+
+    Shard&
+    shard (key_type const& key)
+    {
+        // The leading byte is the parity tag, the rest is the x coordinate
+        return shards_[key[key.size() - 1] % shardCount];
+    }
+
+    static
+    value_type
+    decode (std::uint8_t const* data, std::size_t size)
+    {
+        openssl::ec_key key = ECDSAPublicKey (data, size);
+
+        if (! key.valid ())
+            return value_type ();
+
+        return value_type ((EC_KEY*) key.release (), &EC_KEY_free);
+    }
+
+public:
+    ECDSAKeyCache ()
+        : hits_ (0)
+        , misses_ (0)
+    {
+    }
+
+    value_type
+    get (std::uint8_t const* data, std::size_t size)
+    {
+        if (size != std::tuple_size <key_type>::value)
+            return decode (data, size);
+
+        key_type key;
+        std::memcpy (key.data (), data, key.size ());
+
+        Shard& s = shard (key);
+
+        {
+            std::lock_guard <std::mutex> lock (s.mutex);
+
+            auto iter = s.current.find (key);
+
+            if (iter != s.current.end ())
+            {
+                ++hits_;
+                return iter->second;
+            }
+
+            iter = s.old.find (key);
+
+            if (iter != s.old.end ())
+            {
+                ++hits_;
+                value_type result = iter->second;
+                s.old.erase (iter);
+                insert (s, key, result);
+                return result;
+            }
+        }
+
+        ++misses_;
+
+        // Decode outside the lock; if two threads race on the same key
+        // the second insert simply replaces an equivalent entry.
+        value_type result = decode (data, size);
+
+        if (result)
+        {
+            std::lock_guard <std::mutex> lock (s.mutex);
+            insert (s, key, result);
+        }
+
+        return result;
+    }
+
+    ECDSAKeyCacheStats
+    stats ()
+    {
+        ECDSAKeyCacheStats result;
+        result.hits = hits_.load ();
+        result.misses = misses_.load ();
+        result.size = 0;
+
+        for (auto& s : shards_)
+        {
+            std::lock_guard <std::mutex> lock (s.mutex);
+            result.size += s.current.size () + s.old.size ();
+        }
+
+        return result;
+    }
+
+private:
+    static
+    void
+    insert (Shard& s, key_type const& key, value_type const& value)
+    {
+        if (s.current.size () >= generationSize)
+        {
+            s.old.clear ();
+            std::swap (s.current, s.old);
+        }
+
+        s.current[key] = value;
+    }
+};
+
+static
+ECDSAKeyCache&
+keyCache ()
+{
+    static ECDSAKeyCache cache;
+    return cache;
+}
+
+} // detail
+
+ECDSAKeyCacheStats getECDSAKeyCacheStats ()
+{
+    return detail::keyCache ().stats ();
 }
 
 bool ECDSAVerify (uint256 const& hash,
@@ -79,7 +243,12 @@ bool ECDSAVerify (uint256 const& hash,
                   std::uint8_t const* key_data,
                   std::size_t key_size)
 {
-    return ECDSAVerify (hash, sig, ECDSAPublicKey (key_data, key_size));
+    auto const key = detail::keyCache ().get (key_data, key_size);
+
+    if (! key)
+        return false;
+
+    return ECDSAVerify (hash, sig.data(), sig.size(), key.get());
 }
 
 } // bessel
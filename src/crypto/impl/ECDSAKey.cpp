@@ -79,6 +79,7 @@ ec_key ECDSAPublicKey (std::uint8_t const* data, std::size_t size)
     else
     {
         EC_KEY_free (key);
+        key = nullptr;
     }
 
     return ec_key::acquire ((ec_key::pointer_t) key);
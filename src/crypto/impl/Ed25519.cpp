@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <crypto/Ed25519.h>
+#include <crypto/ed25519-donna/ed25519.h>
+#include <algorithm>
+
+namespace bessel {
+
+bool isCanonicalEd25519Signature (std::uint8_t const* signature)
+{
+    using std::uint8_t;
+
+    // Big-endian `l`, the Ed25519 subgroup order
+    char const* const order = "\x10\x00\x00\x00\x00\x00\x00\x00"
+                              "\x00\x00\x00\x00\x00\x00\x00\x00"
+                              "\x14\xDE\xF9\xDE\xA2\xF7\x9C\xD6"
+                              "\x58\x12\x63\x1A\x5C\xF5\xD3\xED";
+
+    uint8_t const* const l = reinterpret_cast<uint8_t const*> (order);
+
+    // Take the second half of signature and byte-reverse it to big-endian.
+    uint8_t const* S_le = signature + 32;
+    uint8_t S[32];
+    std::reverse_copy (S_le, S_le + 32, S);
+
+    return std::lexicographical_compare (S, S + 32, l, l + 32);
+}
+
+bool isCanonicalTorsionFreeEd25519Point (std::uint8_t const* point)
+{
+    return ed25519_point_is_canonical_torsion_free (point) != 0;
+}
+
+//------------------------------------------------------------------------------
+
+std::size_t Ed25519BatchVerifier::add (void const* message, std::size_t size,
+    std::uint8_t const* publicKey, std::uint8_t const* signature)
+{
+    messages_.push_back (static_cast <unsigned char const*> (message));
+    sizes_.push_back (size);
+    keys_.push_back (publicKey);
+    signatures_.push_back (signature);
+    return keys_.size () - 1;
+}
+
+bool Ed25519BatchVerifier::verify ()
+{
+    valid_.assign (keys_.size (), 0);
+
+    if (keys_.empty ())
+        return true;
+
+    // Returns 0 when every signature in the batch is good
+    return ed25519_sign_open_batch (messages_.data (), sizes_.data (),
+        keys_.data (), signatures_.data (), keys_.size (),
+        valid_.data ()) == 0;
+}
+
+} // bessel
@@ -35,6 +35,7 @@ DatabaseCon::DatabaseCon (
         = setup.standAlone &&
           setup.startUp != Config::LOAD &&
           setup.startUp != Config::LOAD_FILE &&
+          setup.startUp != Config::LOAD_SNAPSHOT &&
           setup.startUp != Config::REPLAY;
 
     boost::filesystem::path pPath = useTempFiles ? "" : (setup.dataDir / strName);
@@ -100,6 +100,12 @@ public:
     /** Estimate the number of write operations pending. */
     virtual int getWriteLoad () = 0;
 
+    /** Make the objects stored so far durable.
+        This is called after each ledger is accepted. Backends which
+        make every write durable as it happens do nothing.
+    */
+    virtual void flush () = 0;
+
     /** Remove contents on disk upon destruction. */
     virtual void setDeletePath() = 0;
 
@@ -109,6 +109,14 @@ public:
                         Blob&& data,
                         uint256 const& hash) = 0;
 
+    /** Store a group of objects with a single backend write.
+
+        This bypasses the backend's write queue and does not populate the
+        positive cache, so it suits bulk loads such as snapshot imports.
+        The objects are written before this returns.
+    */
+    virtual void storeBatch (Batch const& batch) = 0;
+
     /** Visit every object in the database
         This is usually called during import.
 
@@ -126,6 +134,11 @@ public:
     */
     virtual std::int32_t getWriteLoad() const = 0;
 
+    /** Make the objects stored so far durable.
+        Called once a ledger has been accepted and its nodes stored.
+    */
+    virtual void flush () = 0;
+
     /** Get the positive cache hits to total attempts ratio. */
     virtual float getCacheHitRate () = 0;
 
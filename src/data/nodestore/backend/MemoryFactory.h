@@ -170,6 +170,11 @@ public:
         return 0;
     }
 
+    void
+    flush() override
+    {
+    }
+
     void
     setDeletePath() override
     {
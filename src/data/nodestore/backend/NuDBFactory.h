@@ -24,6 +24,7 @@
 #include <beast/nudb.h>
 #include <beast/hash/xxhasher.h>
 #include <boost/filesystem.hpp>
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstdio>
@@ -36,6 +37,7 @@
 #include <data/nodestore/impl/codec.h>
 #include <data/nodestore/impl/DecodedBlob.h>
 #include <data/nodestore/impl/EncodedBlob.h>
+#include <data/nodestore/impl/ReadPool.h>
 
 namespace bessel {
 namespace NodeStore {
@@ -50,6 +52,10 @@ public:
         // distribution of data sizes.
         arena_alloc_size = 16 * 1024 * 1024,
 
+        // Threads issuing reads for fetchBatch, besides the caller,
+        // started by the first fetchBatch
+        defaultFetchThreads = 4,
+
         currentType = 1
     };
 
@@ -62,6 +68,7 @@ public:
     api::store db_;
     std::atomic <bool> deletePath_;
     Scheduler& scheduler_;
+    ReadPool readPool_;
 
     NuDBBackend (int keyBytes, Section const& keyValues,
         Scheduler& scheduler, beast::Journal journal)
@@ -70,6 +77,8 @@ public:
         , name_ (get<std::string>(keyValues, "path"))
         , deletePath_(false)
         , scheduler_ (scheduler)
+        , readPool_ (std::max (0, get<int>(keyValues,
+            "fetch_threads", defaultFetchThreads)))
     {
         if (name_.empty())
             throw std::runtime_error (
@@ -152,14 +161,27 @@ public:
     bool
     canFetchBatch() override
     {
-        return false;
+        return true;
     }
 
+    // Objects not found, or which fail to decode, are returned as null
     std::vector<std::shared_ptr<NodeObject>>
     fetchBatch (std::size_t n, void const* const* keys) override
     {
-        throw std::runtime_error("pure virtual called");
-        return {};
+        std::vector<std::shared_ptr<NodeObject>> results (n);
+        db_.fetch_batch (n, keys,
+            [keys, &results](std::size_t i,
+                void const* data, std::size_t size)
+            {
+                DecodedBlob decoded (keys[i], data, size);
+                if (decoded.wasOk ())
+                    results[i] = decoded.createObject();
+            },
+            [this](std::size_t groups, ReadPool::Task const& task)
+            {
+                readPool_.run (groups, task);
+            });
+        return results;
     }
 
     void
@@ -230,6 +252,11 @@ public:
         return 0;
     }
 
+    void
+    flush() override
+    {
+    }
+
     void
     setDeletePath() override
     {
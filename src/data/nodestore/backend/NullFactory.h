@@ -90,6 +90,11 @@ public:
         return 0;
     }
 
+    void
+    flush() override
+    {
+    }
+
     void
     setDeletePath() override
     {
@@ -125,6 +125,10 @@ public:
     std::string m_name;
     std::unique_ptr <rocksdb::DB> m_db;
 
+    // Write straight to the memtable, without the write-ahead log or the
+    // BatchWriter queue, and flush the memtable after each ledger instead
+    bool m_directWrites = false;
+
     RocksDBBackend (int keyBytes, Section const& keyValues,
         Scheduler& scheduler, beast::Journal journal, RocksDBEnv* env)
         : m_deletePath (false)
@@ -150,16 +154,34 @@ public:
             table_options.block_cache = rocksdb::NewLRUCache (get<int>(keyValues, "cache_mb") * 1024L * 1024L);
         }
 
+        // Full filters cover a whole file rather than each block
+        bool const fullFilter = get<int>(keyValues, "filter_full") != 0;
+
         if (!keyValues.exists ("filter_bits"))
         {
             if (getConfig ().NODE_SIZE >= 2)
-                table_options.filter_policy.reset (rocksdb::NewBloomFilterPolicy (10));
+                table_options.filter_policy.reset (
+                    rocksdb::NewBloomFilterPolicy (10, !fullFilter));
         }
         else if (auto const v = get<int>(keyValues, "filter_bits"))
         {
-            table_options.filter_policy.reset (rocksdb::NewBloomFilterPolicy (v));
+            table_options.filter_policy.reset (
+                rocksdb::NewBloomFilterPolicy (v, !fullFilter));
         }
 
+        // Node keys are hashes and never read in order, so a hash index
+        // finds a key within a block without a binary search
+        if (get<int>(keyValues, "hash_index") != 0)
+        {
+            options.prefix_extractor.reset (rocksdb::NewNoopTransform ());
+            table_options.index_type =
+                rocksdb::BlockBasedTableOptions::kHashSearch;
+            options.memtable_factory.reset (
+                rocksdb::NewHashSkipListRepFactory ());
+        }
+
+        m_directWrites = get<int>(keyValues, "direct_writes") != 0;
+
         get_if_exists (keyValues, "open_files", options.max_open_files);
 
         if (keyValues.exists ("file_size_mb"))
@@ -298,20 +320,49 @@ public:
     bool
     canFetchBatch() override
     {
-        return false;
+        return true;
     }
 
+    // Objects not found, or which fail to decode, are returned as null
     std::vector<std::shared_ptr<NodeObject>>
     fetchBatch (std::size_t n, void const* const* keys) override
     {
-        throw std::runtime_error("pure virtual called");
-        return {};
+        std::vector <rocksdb::Slice> slices;
+        slices.reserve (n);
+        for (std::size_t i = 0; i < n; ++i)
+            slices.emplace_back (static_cast <char const*> (keys[i]), m_keyBytes);
+
+        std::vector <std::string> values;
+        auto const statuses = m_db->MultiGet (
+            rocksdb::ReadOptions (), slices, &values);
+
+        std::vector<std::shared_ptr<NodeObject>> results (n);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (statuses[i].ok ())
+            {
+                DecodedBlob decoded (keys[i], values[i].data (), values[i].size ());
+
+                if (decoded.wasOk ())
+                    results[i] = decoded.createObject ();
+            }
+            else if (!statuses[i].IsNotFound ())
+            {
+                m_journal.error << statuses[i].ToString ();
+            }
+        }
+
+        return results;
     }
 
     void
     store (NodeObject::ref object)
     {
-        m_batch.store (object);
+        if (m_directWrites)
+            storeBatch (Batch {object});
+        else
+            m_batch.store (object);
     }
 
     void
@@ -332,7 +383,10 @@ public:
                     encoded.getData ()), encoded.getSize ()));
         }
 
-        rocksdb::WriteOptions const options;
+        rocksdb::WriteOptions options;
+
+        // flush() makes these durable once the ledger is accepted
+        options.disableWAL = m_directWrites;
 
         auto ret = m_db->Write (options, &wb);
 
@@ -382,6 +436,22 @@ public:
         return m_batch.getWriteLoad ();
     }
 
+    void
+    flush() override
+    {
+        if (!m_directWrites)
+            return;
+
+        // Start writing the memtable out, but don't wait for it
+        rocksdb::FlushOptions options;
+        options.wait = false;
+
+        auto const ret = m_db->Flush (options);
+
+        if (!ret.ok ())
+            m_journal.error << "flush failed: " << ret.ToString ();
+    }
+
     void
     setDeletePath() override
     {
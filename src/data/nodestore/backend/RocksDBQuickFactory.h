@@ -100,6 +100,10 @@ public:
     std::string m_name;
     std::unique_ptr <rocksdb::DB> m_db;
 
+    // Flush the memtable after each ledger, since writes skip the
+    // write-ahead log
+    bool m_directWrites = false;
+
     RocksDBQuickBackend (int keyBytes, Section const& keyValues,
         Scheduler& scheduler, beast::Journal journal, RocksDBQuickEnv* env)
         : m_deletePath (false)
@@ -163,6 +167,8 @@ public:
         // options.memtable_factory.reset(
         //     rocksdb::NewHashCuckooRepFactory(options.write_buffer_size));
 
+        m_directWrites = get<int>(keyValues, "direct_writes") != 0;
+
         get_if_exists (keyValues, "open_files", options.max_open_files);
 
         if (keyValues.exists ("compression") &&
@@ -345,6 +351,22 @@ public:
         return 0;
     }
 
+    void
+    flush() override
+    {
+        if (!m_directWrites)
+            return;
+
+        // Writes skip the write-ahead log; start writing the memtable out
+        rocksdb::FlushOptions options;
+        options.wait = false;
+
+        auto const ret = m_db->Flush (options);
+
+        if (!ret.ok ())
+            m_journal.error << "flush failed: " << ret.ToString ();
+    }
+
     void
     setDeletePath() override
     {
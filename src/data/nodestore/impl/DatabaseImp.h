@@ -342,6 +342,32 @@ public:
         }
     }
 
+    void storeBatch (Batch const& batch) override
+    {
+        storeBatchInternal (batch, *m_backend.get());
+    }
+
+    void storeBatchInternal (Batch const& batch, Backend& backend)
+    {
+        if (batch.empty ())
+            return;
+
+        backend.storeBatch (batch);
+
+        for (auto const& object : batch)
+        {
+            ++m_storeCount;
+            m_storeSize += object->getData().size();
+            m_negCache.erase (object->getHash ());
+        }
+
+        if (m_fastBackend)
+        {
+            m_fastBackend->storeBatch (batch);
+            m_storeCount += batch.size ();
+        }
+    }
+
     //------------------------------------------------------------------------------
 
     float getCacheHitRate ()
@@ -368,6 +394,14 @@ public:
         return m_backend->getWriteLoad();
     }
 
+    void flush () override
+    {
+        m_backend->flush ();
+
+        if (m_fastBackend)
+            m_fastBackend->flush ();
+    }
+
     //------------------------------------------------------------------------------
 
     // Entry point for async read threads
@@ -97,6 +97,11 @@ public:
         return getWritableBackend()->getWriteLoad();
     }
 
+    void flush () override
+    {
+        getWritableBackend()->flush ();
+    }
+
     void for_each (std::function <void(NodeObject::Ptr)> f) override
     {
         Backends b = getBackends();
@@ -117,6 +122,11 @@ public:
                 *getWritableBackend());
     }
 
+    void storeBatch (Batch const& batch) override
+    {
+        storeBatchInternal (batch, *getWritableBackend());
+    }
+
     NodeObject::Ptr fetchNode (uint256 const& hash) override
     {
         return fetchFrom (hash);
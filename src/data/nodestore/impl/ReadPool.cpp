@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <data/nodestore/impl/ReadPool.h>
+#include <algorithm>
+
+namespace bessel {
+namespace NodeStore {
+
+ReadPool::ReadPool (std::size_t threads)
+    : size_ (threads)
+{
+}
+
+ReadPool::~ReadPool ()
+{
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all ();
+
+    for (auto& t : threads_)
+        t.join ();
+}
+
+void
+ReadPool::run (std::size_t count, Task const& task)
+{
+    if (count == 0)
+        return;
+
+    if (count == 1 || size_ == 0)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            task (i);
+        return;
+    }
+
+    Work work;
+    work.task = &task;
+    work.count = count;
+
+    std::unique_lock <std::mutex> lock (mutex_);
+
+    // Most backends are never asked for a batch, so start no
+    // threads until one is.
+    if (threads_.empty ())
+    {
+        threads_.reserve (size_);
+        for (std::size_t i = 0; i < size_; ++i)
+            threads_.emplace_back (&ReadPool::work, this);
+    }
+
+    queue_.push_back (&work);
+    wake_.notify_all ();
+
+    while (work.next < work.count)
+        perform (work, work.next++, lock);
+
+    // Pool threads only reach the work through the queue
+    auto const iter = std::find (queue_.begin (), queue_.end (), &work);
+    if (iter != queue_.end ())
+        queue_.erase (iter);
+
+    finished_.wait (lock, [&work] { return work.done == work.count; });
+    lock.unlock ();
+
+    if (work.error)
+        std::rethrow_exception (work.error);
+}
+
+void
+ReadPool::perform (Work& work, std::size_t index,
+    std::unique_lock <std::mutex>& lock)
+{
+    lock.unlock ();
+
+    std::exception_ptr error;
+    try
+    {
+        (*work.task) (index);
+    }
+    catch (...)
+    {
+        error = std::current_exception ();
+    }
+
+    lock.lock ();
+
+    if (error && !work.error)
+        work.error = error;
+
+    if (++work.done == work.count)
+        finished_.notify_all ();
+}
+
+void
+ReadPool::work ()
+{
+    std::unique_lock <std::mutex> lock (mutex_);
+
+    for (;;)
+    {
+        wake_.wait (lock, [this] { return stop_ || !queue_.empty (); });
+
+        if (stop_)
+            return;
+
+        auto& work = *queue_.front ();
+
+        if (work.next == work.count)
+        {
+            queue_.pop_front ();
+            continue;
+        }
+
+        perform (work, work.next++, lock);
+    }
+}
+
+}
+}
@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_NODESTORE_READPOOL_H_INCLUDED
+#define BESSEL_NODESTORE_READPOOL_H_INCLUDED
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bessel {
+namespace NodeStore {
+
+/** A small pool of threads for issuing blocking reads concurrently.
+
+    A backend whose reads are synchronous (pread on a file, for instance)
+    uses this to keep several reads in flight for one batched fetch. The
+    calling thread works on its own batch too, so a pool with no threads
+    degenerates to a plain loop. The threads are started by the first
+    call to run that can use them.
+*/
+class ReadPool
+{
+public:
+    using Task = std::function <void (std::size_t)>;
+
+    explicit ReadPool (std::size_t threads);
+    ~ReadPool ();
+
+    ReadPool (ReadPool const&) = delete;
+    ReadPool& operator= (ReadPool const&) = delete;
+
+    /** Call task (i) for each i in [0, count), concurrently.
+
+        Returns when every call has returned. If any call throws, the
+        first exception is rethrown here.
+    */
+    void run (std::size_t count, Task const& task);
+
+private:
+    struct Work
+    {
+        Task const* task;
+        std::size_t count;
+        std::size_t next = 0;
+        std::size_t done = 0;
+        std::exception_ptr error;
+    };
+
+    void work ();
+    void perform (Work& work, std::size_t index,
+        std::unique_lock <std::mutex>& lock);
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable finished_;
+    std::deque <Work*> queue_;
+    bool stop_ = false;
+    std::size_t const size_;
+    std::vector <std::thread> threads_;
+};
+
+}
+}
+
+#endif
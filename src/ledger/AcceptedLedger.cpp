@@ -37,11 +37,11 @@ AcceptedLedger::AcceptedLedger (Ledger::ref ledger) : mLedger (ledger)
 {
     SHAMap& txSet = *ledger->peekTransactionMap ();
 
-    for (std::shared_ptr<SHAMapItem> item = txSet.peekFirstItem (); 
+    for (boost::intrusive_ptr<SHAMapItem const> item = txSet.peekFirstItem (); 
          item;
          item = txSet.peekNextItem (item->getTag ()))
     {
-        SerialIter sit (item->peekSerializer ());
+        SerialIter sit (item->slice ());
 
         insert (std::make_shared<AcceptedLedgerTx> (ledger, std::ref (sit)));
     }
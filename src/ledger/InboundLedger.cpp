@@ -22,6 +22,7 @@
 #include <common/misc/NetworkOPs.h>
 #include <common/base/Log.h>
 #include <common/core/JobQueue.h>
+#include <common/core/ParallelFor.h>
 #include <network/resource/Fees.h>
 #include <ledger/AccountStateSF.h>
 #include <ledger/InboundLedger.h>
@@ -55,6 +56,12 @@ enum
 
     // How many nodes to consider a fetch "small"
     ,fetchSmallNodes = 32
+
+    // Minimum number of received nodes worth giving to a decode helper job
+    ,decodeNodesPerHelper = 32
+
+    // Most helper jobs to use when decoding received nodes
+    ,decodeHelpersMax = 8
 };
 
 InboundLedger::InboundLedger (uint256 const& hash, std::uint32_t seq, fcReason reason, clock_type& clock)
@@ -836,7 +843,8 @@ bool InboundLedger::takeHeader (std::string const& data)
     Call with a lock
 */
 bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
-    const std::vector< Blob >& data, SHAMapAddNode& san)
+    const std::vector< Blob >& data, DecodedNodes const& decoded,
+    SHAMapAddNode& san)
 {
     if (!mHaveHeader)
     {
@@ -857,6 +865,7 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
 
     auto nodeIDit = nodeIDs.cbegin ();
     auto nodeDatait = data.begin ();
+    auto decodedit = decoded.begin ();
     TransactionStateSF tFilter;
 
     while (nodeIDit != nodeIDs.cend ())
@@ -870,13 +879,14 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
         else
         {
             san +=  mLedger->peekTransactionMap ()->addKnownNode (
-                *nodeIDit, *nodeDatait, &tFilter);
+                *nodeIDit, *decodedit, &tFilter);
             if (!san.isGood())
                 return false;
         }
 
         ++nodeIDit;
         ++nodeDatait;
+        ++decodedit;
     }
 
     if (!mLedger->peekTransactionMap ()->isSynching ())
@@ -898,7 +908,8 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
     Call with a lock
 */
 bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
-    const std::vector< Blob >& data, SHAMapAddNode& san)
+    const std::vector< Blob >& data, DecodedNodes const& decoded,
+    SHAMapAddNode& san)
 {
     if (m_journal.trace) 
         m_journal.trace << "got ASdata (" << nodeIDs.size () << ") acquiring ledger " << mHash;
@@ -927,6 +938,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
 
     auto nodeIDit = nodeIDs.cbegin ();
     auto nodeDatait = data.begin ();
+    auto decodedit = decoded.begin ();
     AccountStateSF tFilter;
 
     while (nodeIDit != nodeIDs.cend ())
@@ -945,7 +957,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
         else
         {
             san += mLedger->peekAccountStateMap ()->addKnownNode (
-                *nodeIDit, *nodeDatait, &tFilter);
+                *nodeIDit, *decodedit, &tFilter);
             if (!san.isGood ())
             {
                 if (m_journal.warning) 
@@ -957,6 +969,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
 
         ++nodeIDit;
         ++nodeDatait;
+        ++decodedit;
     }
 
     if (!mLedger->peekAccountStateMap ()->isSynching ())
@@ -1084,12 +1097,13 @@ bool InboundLedger::gotData (std::weak_ptr<Peer> peer,
 //
 //        TODO Change peer to Consumer
 //
-int InboundLedger::processData (std::shared_ptr<Peer> peer, protocol::TMLedgerData& packet)
+int InboundLedger::processData (std::shared_ptr<Peer> peer,
+    protocol::TMLedgerData& packet, DecodedNodes const& decoded)
 {
-    ScopedLockType sl (mLock);
-
     if (packet.type () == protocol::liBASE)
     {
+        ScopedLockType sl (mLock);
+
         if (packet.nodes_size () < 1)
         {
             if (m_journal.warning) 
@@ -1173,21 +1187,28 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer, protocol::TMLedgerDa
 
             nodeIDs.push_back (SHAMapNodeID (node.nodeid ().data (),
                 node.nodeid ().size ()));
-            nodeData.push_back (Blob (node.nodedata ().begin (),
-                node.nodedata ().end ()));
+
+            // Only a root node is attached from its raw form, every other
+            // node was already decoded and hashed by decodeNodes.
+            if (nodeIDs.back ().isRoot ())
+                nodeData.push_back (Blob (node.nodedata ().begin (),
+                    node.nodedata ().end ()));
+            else
+                nodeData.push_back (Blob ());
         }
 
         SHAMapAddNode ret;
+        ScopedLockType sl (mLock);
 
         if (packet.type () == protocol::liTX_NODE)
         {
-            takeTxNode (nodeIDs, nodeData, ret);
+            takeTxNode (nodeIDs, nodeData, decoded, ret);
             if (m_journal.debug) m_journal.debug <<
                 "Ledger TX node stats: " << ret.get();
         }
         else
         {
-            takeAsNode (nodeIDs, nodeData, ret);
+            takeAsNode (nodeIDs, nodeData, decoded, ret);
             if (m_journal.debug) m_journal.debug <<
                 "Ledger AS node stats: " << ret.get();
         }
@@ -1204,6 +1225,58 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer, protocol::TMLedgerDa
     return -1;
 }
 
+/** Decode and hash the tree nodes carried by received TMLedgerData.
+    This is the expensive part of ingesting node data and does not touch the
+    ledger, so it runs without the ledger lock, spread over JobQueue threads.
+*/
+std::vector<InboundLedger::DecodedNodes> InboundLedger::decodeNodes (
+    std::vector <PeerDataPairType> const& data)
+{
+    std::vector<DecodedNodes> decoded (data.size ());
+    std::vector<std::pair<std::size_t, int>> work;
+
+    for (std::size_t i = 0; i < data.size (); ++i)
+    {
+        protocol::TMLedgerData const& packet = *data[i].second;
+
+        if ((packet.type () != protocol::liTX_NODE) &&
+            (packet.type () != protocol::liAS_NODE))
+            continue;
+
+        decoded[i].resize (packet.nodes ().size ());
+
+        for (int j = 0; j < packet.nodes ().size (); ++j)
+        {
+            if (packet.nodes (j).has_nodedata ())
+                work.emplace_back (i, j);
+        }
+    }
+
+    std::size_t const helpers = std::min<std::size_t> (decodeHelpersMax,
+        work.size () / decodeNodesPerHelper);
+
+    parallelFor (getApp().getJobQueue (), jtLEDGER_DECODE, "decodeLedgerData",
+        work.size (), helpers,
+        [&data, &work, &decoded] (std::size_t index)
+        {
+            auto const& w = work[index];
+            std::string const& raw =
+                data[w.first].second->nodes (w.second).nodedata ();
+
+            try
+            {
+                decoded[w.first][w.second] = SHAMapTreeNode::make (
+                    Blob (raw.begin (), raw.end ()), 0, snfWIRE, uZero, false);
+            }
+            catch (std::exception const&)
+            {
+                // Leave the entry empty, it is reported as invalid on attach
+            }
+        });
+
+    return decoded;
+}
+
 /** Process pending TMLedgerData
     Query the 'best' peer
 */
@@ -1227,19 +1300,41 @@ void InboundLedger::runData ()
             data.swap(mReceivedData);
         }
 
+        auto const decoded = decodeNodes (data);
+        bool pipelined = false;
+
         // Select the peer that gives us the most nodes that are useful,
         // breaking ties in favor of the peer that responded first.
-        for (auto& entry : data)
+        for (std::size_t i = 0; i < data.size (); ++i)
         {
-            Peer::ptr peer = entry.first.lock();
+            Peer::ptr peer = data[i].first.lock();
             if (peer)
             {
-                int count = processData (peer, *(entry.second));
+                int count = processData (peer, *(data[i].second), decoded[i]);
                 if (count > chosenPeerCount)
                 {
                     chosenPeer = peer;
                     chosenPeerCount = count;
                 }
+
+                // Once part of a large batch is attached, request the next
+                // nodes so they are in flight while the rest is attached.
+                // Recently requested nodes are filtered out by trigger,
+                // except when aggressive, so don't pipeline then.
+                if (!pipelined && (count > 0) && ((i + 1) < data.size ()))
+                {
+                    bool aggressive;
+                    {
+                        ScopedLockType sl (mLock);
+                        aggressive = mAggressive;
+                    }
+
+                    if (!aggressive)
+                    {
+                        pipelined = true;
+                        trigger (peer);
+                    }
+                }
             }
         }
 
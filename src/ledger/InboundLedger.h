@@ -40,6 +40,10 @@ public:
     typedef std::shared_ptr <InboundLedger> pointer;
     typedef std::pair < std::weak_ptr<Peer>, std::shared_ptr<protocol::TMLedgerData> > PeerDataPairType;
 
+    // Tree nodes decoded from one TMLedgerData, in packet order.
+    // A null entry is a node that could not be decoded.
+    typedef std::vector < std::shared_ptr<SHAMapTreeNode> > DecodedNodes;
+
     // These are the reasons we might acquire a ledger
     enum fcReason
     {
@@ -125,11 +129,15 @@ private:
 
     std::weak_ptr <PeerSet> pmDowncast ();
 
-    int processData (std::shared_ptr<Peer> peer, protocol::TMLedgerData& data);
+    static std::vector<DecodedNodes> decodeNodes (
+        std::vector <PeerDataPairType> const& data);
+
+    int processData (std::shared_ptr<Peer> peer, protocol::TMLedgerData& data,
+                     DecodedNodes const& decoded);
 
     bool takeHeader (std::string const& data);
     bool takeTxNode (const std::vector<SHAMapNodeID>& IDs, const std::vector<Blob>& data,
-                     SHAMapAddNode&);
+                     DecodedNodes const& decoded, SHAMapAddNode&);
     bool takeTxRootNode (Blob const& data, SHAMapAddNode&);
 
     //  TODO Rename to receiveAccountStateNode
@@ -137,7 +145,7 @@ private:
     //             capitalize them correctly.
     //
     bool takeAsNode (const std::vector<SHAMapNodeID>& IDs, const std::vector<Blob>& data,
-                     SHAMapAddNode&);
+                     DecodedNodes const& decoded, SHAMapAddNode&);
     bool takeAsRootNode (Blob const& data, SHAMapAddNode&);
 
 private:
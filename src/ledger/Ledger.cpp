@@ -44,6 +44,7 @@
 #include <protocol/JsonFields.h>
 #include <protocol/HashPrefix.h>
 #include <transaction/tx/TransactionMaster.h>
+#include <transaction/tx/TxIndex.h>
 #include <boost/lexical_cast.hpp>
 
 namespace bessel {
@@ -226,6 +227,28 @@ Ledger::Ledger (std::string const& rawLedger, bool hasPrefix)
     initializeFees ();
 }
 
+/** Used for ledgers rebuilt from a binary snapshot */
+Ledger::Ledger (Blob const& rawLedger,
+                std::shared_ptr<SHAMap> const& txMap,
+                std::shared_ptr<SHAMap> const& stateMap)
+    : mClosed (true)
+    , mValidated (false)
+    , mValidHash (false)
+    , mAccepted (true)
+    , mImmutable (true)
+{
+    Serializer s (rawLedger);
+    setRaw (s, false);
+
+    // The header's hashes are kept; the caller checks them against the maps
+    mTransactionMap = txMap;
+    mAccountStateMap = stateMap;
+    mTransactionMap->setImmutable ();
+    mAccountStateMap->setImmutable ();
+
+    initializeFees ();
+}
+
 /** Used for ledgers loaded from JSON files */
 Ledger::Ledger (std::uint32_t ledgerSeq, std::uint32_t closeTime)
     : mTotCoins (0),
@@ -376,8 +399,9 @@ bool Ledger::hasAccount (BesselAddress const& accountID) const
 
 bool Ledger::addSLE (SLE const& sle)
 {
-    SHAMapItem item (sle.getIndex(), sle.getSerializer());
-    return mAccountStateMap->addItem(item, false, false);
+    return mAccountStateMap->addGiveItem (
+        make_shamapitem (sle.getIndex (), sle.getSerializer ().peekData ()),
+        false, false);
 }
 
 AccountState::pointer Ledger::getAccountState (BesselAddress const& accountID) const
@@ -426,7 +450,7 @@ AccountState::pointer Ledger::getAccountState1(const BesselAddress & accountID)
 bool Ledger::addTransaction (uint256 const& txID, const Serializer& txn)
 {
     // low-level - just add to table
-    auto item = std::make_shared<SHAMapItem> (txID, txn.peekData ());
+    auto item = make_shamapitem (txID, txn.peekData ());
 
     if (!mTransactionMap->addGiveItem (item, true, false))
     {
@@ -447,7 +471,7 @@ bool Ledger::addTransaction (
     Serializer s (txn.getDataLength () + md.getDataLength () + 16);
     s.addVL (txn.peekData ());
     s.addVL (md.peekData ());
-    auto item = std::make_shared<SHAMapItem> (txID, s.peekData ());
+    auto item = make_shamapitem (txID, s.peekData ());
 
     if (!mTransactionMap->addGiveItem (item, true, true))
     {
@@ -461,10 +485,12 @@ bool Ledger::addTransaction (
     return true;
 }
 
-Transaction::pointer Ledger::getTransaction (uint256 const& transID) const
+// Returns the transaction held by a ledger's transaction map
+static Transaction::pointer getTransactionFromMap (SHAMap const& map,
+    uint256 const& transID, TransStatus status, LedgerIndex ledgerSeq)
 {
     SHAMapTreeNode::TNType type;
-    std::shared_ptr<SHAMapItem> item = mTransactionMap->peekItem (transID, type);
+    boost::intrusive_ptr<SHAMapItem const> item = map.peekItem (transID, type);
 
     if (!item)
         return Transaction::pointer ();
@@ -476,15 +502,21 @@ Transaction::pointer Ledger::getTransaction (uint256 const& transID) const
 
     if (type == SHAMapTreeNode::tnTRANSACTION_NM)
     {
-        txn = Transaction::sharedTransaction (item->peekData (), Validate::YES);
+        txn = Transaction::sharedTransaction (item->getData (), Validate::YES);
     }
     else if (type == SHAMapTreeNode::tnTRANSACTION_MD)
     {
         Blob txnData;
-        int txnLength;
 
-        if (!item->peekSerializer ().getVL (txnData, 0, txnLength))
+        try
+        {
+            SerialIter sit (item->slice ());
+            txnData = sit.getVL ();
+        }
+        catch (std::exception const&)
+        {
             return Transaction::pointer ();
+        }
 
         txn = Transaction::sharedTransaction (txnData, Validate::NO);
     }
@@ -495,16 +527,34 @@ Transaction::pointer Ledger::getTransaction (uint256 const& transID) const
     }
 
     if (txn->getStatus () == NEW)
-        txn->setStatus (mClosed ? COMMITTED : INCLUDED, mLedgerSeq);
+        txn->setStatus (status, ledgerSeq);
 
     getApp().getMasterTransaction ().canonicalize (&txn);
 
     return txn;
 }
 
-STTx::pointer Ledger::getSTransaction (std::shared_ptr<SHAMapItem> const& item, SHAMapTreeNode::TNType type)
+Transaction::pointer Ledger::getTransaction (uint256 const& transID) const
+{
+    return getTransactionFromMap (*mTransactionMap, transID,
+        mClosed ? COMMITTED : INCLUDED, mLedgerSeq);
+}
+
+Transaction::pointer Ledger::loadTransaction (uint256 const& txMapHash,
+    LedgerIndex ledgerSeq, uint256 const& transID)
+{
+    SHAMap map (SHAMapType::TRANSACTION, txMapHash, getApp().family(),
+        deprecatedLogs().journal("SHAMap"));
+
+    if (!map.fetchRoot (txMapHash, nullptr))
+        return Transaction::pointer ();
+
+    return getTransactionFromMap (map, transID, COMMITTED, ledgerSeq);
+}
+
+STTx::pointer Ledger::getSTransaction (boost::intrusive_ptr<SHAMapItem const> const& item, SHAMapTreeNode::TNType type)
 {
-    SerialIter sit (item->peekSerializer ());
+    SerialIter sit (item->slice ());
 
     if (type == SHAMapTreeNode::tnTRANSACTION_NM)
         return std::make_shared<STTx> (sit);
@@ -519,11 +569,11 @@ STTx::pointer Ledger::getSTransaction (std::shared_ptr<SHAMapItem> const& item,
     return STTx::pointer ();
 }
 
-STTx::pointer Ledger::getSMTransaction (std::shared_ptr<SHAMapItem> const& item, 
+STTx::pointer Ledger::getSMTransaction (boost::intrusive_ptr<SHAMapItem const> const& item, 
                                         SHAMapTreeNode::TNType type,
                                         TransactionMetaSet::pointer& txMeta) const
 {
-    SerialIter sit (item->peekSerializer ());
+    SerialIter sit (item->slice ());
 
     if (type == SHAMapTreeNode::tnTRANSACTION_NM)
     {
@@ -550,7 +600,7 @@ bool Ledger::getTransaction (uint256 const& txID,
                             TransactionMetaSet::pointer& meta) const
 {
     SHAMapTreeNode::TNType type;
-    std::shared_ptr<SHAMapItem> item = mTransactionMap->peekItem (txID, type);
+    boost::intrusive_ptr<SHAMapItem const> item = mTransactionMap->peekItem (txID, type);
 
     if (!item)
         return false;
@@ -564,13 +614,13 @@ bool Ledger::getTransaction (uint256 const& txID,
         if (!txn)
         {
             txn = Transaction::sharedTransaction (
-                item->peekData (), Validate::YES);
+                item->getData (), Validate::YES);
         }
     }
     else if (type == SHAMapTreeNode::tnTRANSACTION_MD)
     {
         // in tree with metadata
-        SerialIter it (item->peekSerializer ());
+        SerialIter it (item->slice ());
         txn = getApp().getMasterTransaction ().fetch (txID, false);
 
         if (!txn)
@@ -597,7 +647,7 @@ bool Ledger::getTransactionMeta (
     uint256 const& txID, TransactionMetaSet::pointer& meta) const
 {
     SHAMapTreeNode::TNType type;
-    std::shared_ptr<SHAMapItem> item = mTransactionMap->peekItem (txID, type);
+    boost::intrusive_ptr<SHAMapItem const> item = mTransactionMap->peekItem (txID, type);
 
     if (!item)
         return false;
@@ -605,7 +655,7 @@ bool Ledger::getTransactionMeta (
     if (type != SHAMapTreeNode::tnTRANSACTION_MD)
         return false;
 
-    SerialIter it (item->peekSerializer ());
+    SerialIter it (item->slice ());
     it.getVL (); // skip transaction
     meta = std::make_shared<TransactionMetaSet> (txID, mLedgerSeq, it.getVL ());
 
@@ -615,7 +665,7 @@ bool Ledger::getTransactionMeta (
 bool Ledger::getMetaHex (uint256 const& transID, std::string& hex) const
 {
     SHAMapTreeNode::TNType type;
-    std::shared_ptr<SHAMapItem> item = mTransactionMap->peekItem (transID, type);
+    boost::intrusive_ptr<SHAMapItem const> item = mTransactionMap->peekItem (transID, type);
 
     if (!item)
         return false;
@@ -623,7 +673,7 @@ bool Ledger::getMetaHex (uint256 const& transID, std::string& hex) const
     if (type != SHAMapTreeNode::tnTRANSACTION_MD)
         return false;
 
-    SerialIter it (item->peekSerializer ());
+    SerialIter it (item->slice ());
     it.getVL (); // skip transaction
     hex = strHex (it.getVL ());
 
@@ -794,6 +844,9 @@ bool Ledger::saveValidatedLedger (bool current)
         tr.commit ();
     }
 
+    if (auto txIndex = getApp().getTxIndex ())
+        txIndex->insert (*aLedger);
+
     {
         auto db (getApp().getLedgerDB ().checkoutDb ());
 
@@ -1057,9 +1110,9 @@ Ledger::pointer Ledger::getLastFullLedger ()
             {
                 WriteLog (lsERROR, Ledger) << "Failed on ledger";
 
-                Json::Value p;
-                addJson (p, {*ledger, LedgerFill::full});
-                WriteLog (lsERROR, Ledger) << p;
+                std::string json;
+                outputJson ({*ledger, LedgerFill::full}, Json::stringOutput (json));
+                WriteLog (lsERROR, Ledger) << json;
             }
 
             assert (false);
@@ -1130,8 +1183,9 @@ LedgerStateParms Ledger::writeBack (LedgerStateParms parms, SLE::ref entry)
         create = true;
     }
 
-    auto item = std::make_shared<SHAMapItem> (entry->getIndex ());
-    entry->add (item->peekSerializer ());
+    Serializer s;
+    entry->add (s);
+    auto item = make_shamapitem (entry->getIndex (), s.peekData ());
 
     if (create)
     {
@@ -1157,19 +1211,30 @@ LedgerStateParms Ledger::writeBack (LedgerStateParms parms, SLE::ref entry)
 
 SLE::pointer Ledger::getSLE (uint256 const& uHash) const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekItem (uHash);
+    boost::intrusive_ptr<SHAMapItem const> node = mAccountStateMap->peekItem (uHash);
+
+    if (!node)
+        return SLE::pointer ();
+
+    return std::make_shared<SLE> (node->slice (), node->getTag ());
+}
+
+SLE::pointer Ledger::getSLE (uint256 const& uHash,
+    LedgerEntryAllocator<SLE> const& alloc) const
+{
+    boost::intrusive_ptr<SHAMapItem const> node = mAccountStateMap->peekItem (uHash);
 
     if (!node)
         return SLE::pointer ();
 
-    return std::make_shared<SLE> (node->peekSerializer (), node->getTag ());
+    return std::allocate_shared<SLE> (alloc, node->slice (), node->getTag ());
 }
 
 SLE::pointer Ledger::getSLEi (uint256 const& uId) const
 {
     uint256 hash;
 
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekItem (uId, hash);
+    boost::intrusive_ptr<SHAMapItem const> node = mAccountStateMap->peekItem (uId, hash);
 
     if (!node)
         return SLE::pointer ();
@@ -1178,7 +1243,7 @@ SLE::pointer Ledger::getSLEi (uint256 const& uId) const
 
     if (!ret)
     {
-        ret = std::make_shared<SLE> (node->peekSerializer (), node->getTag ());
+        ret = std::make_shared<SLE> (node->slice (), node->getTag ());
         ret->setImmutable ();
         getApp().getSLECache ().canonicalize (hash, ret);
     }
@@ -1299,9 +1364,9 @@ bool Ledger::visitAccountItems (
 }
 
 static void visitHelper (
-    std::function<void (SLE::ref)>& function, std::shared_ptr<SHAMapItem> const& item)
+    std::function<void (SLE::ref)>& function, boost::intrusive_ptr<SHAMapItem const> const& item)
 {
-    function (std::make_shared<SLE> (item->peekSerializer (), item->getTag ()));
+    function (std::make_shared<SLE> (item->slice (), item->getTag ()));
 }
 
 void Ledger::visitStateItems (std::function<void (SLE::ref)> function) const
@@ -1328,25 +1393,25 @@ void Ledger::visitStateItems (std::function<void (SLE::ref)> function) const
 
 uint256 Ledger::getFirstLedgerIndex () const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekFirstItem ();
+    boost::intrusive_ptr<SHAMapItem const> node = mAccountStateMap->peekFirstItem ();
     return node ? node->getTag () : uint256 ();
 }
 
 uint256 Ledger::getLastLedgerIndex () const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekLastItem ();
+    boost::intrusive_ptr<SHAMapItem const> node = mAccountStateMap->peekLastItem ();
     return node ? node->getTag () : uint256 ();
 }
 
 uint256 Ledger::getNextLedgerIndex (uint256 const& uHash) const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekNextItem (uHash);
+    boost::intrusive_ptr<SHAMapItem const> node = mAccountStateMap->peekNextItem (uHash);
     return node ? node->getTag () : uint256 ();
 }
 
 uint256 Ledger::getNextLedgerIndex (uint256 const& uHash, uint256 const& uEnd) const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekNextItem (uHash);
+    boost::intrusive_ptr<SHAMapItem const> node = mAccountStateMap->peekNextItem (uHash);
 
     if ((!node) || (node->getTag () > uEnd))
         return uint256 ();
@@ -1356,13 +1421,13 @@ uint256 Ledger::getNextLedgerIndex (uint256 const& uHash, uint256 const& uEnd) c
 
 uint256 Ledger::getPrevLedgerIndex (uint256 const& uHash) const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekPrevItem (uHash);
+    boost::intrusive_ptr<SHAMapItem const> node = mAccountStateMap->peekPrevItem (uHash);
     return node ? node->getTag () : uint256 ();
 }
 
 uint256 Ledger::getPrevLedgerIndex (uint256 const& uHash, uint256 const& uBegin) const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekNextItem (uHash);
+    boost::intrusive_ptr<SHAMapItem const> node = mAccountStateMap->peekNextItem (uHash);
 
     if ((!node) || (node->getTag () < uBegin))
         return uint256 ();
@@ -1383,7 +1448,7 @@ SLE::pointer Ledger::getASNodeI (uint256 const& nodeID, LedgerEntryType let) con
 SLE::pointer Ledger::getASNode (
     LedgerStateParms& parms, uint256 const& nodeID, LedgerEntryType let) const
 {
-    std::shared_ptr<SHAMapItem> account = mAccountStateMap->peekItem (nodeID);
+    boost::intrusive_ptr<SHAMapItem const> account = mAccountStateMap->peekItem (nodeID);
 
     if (!account)
     {
@@ -1401,7 +1466,7 @@ SLE::pointer Ledger::getASNode (
     }
 
     SLE::pointer sle =
-        std::make_shared<SLE> (account->peekSerializer (), nodeID);
+        std::make_shared<SLE> (account->slice (), nodeID);
 
     if (sle->getType () != let)
     {
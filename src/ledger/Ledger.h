@@ -29,6 +29,7 @@
 #include <protocol/STLedgerEntry.h>
 #include <protocol/Serializer.h>
 #include <protocol/Book.h>
+#include <ledger/LedgerEntryMap.h>
 
 namespace bessel {
 
@@ -130,6 +131,8 @@ public:
     Ledger (Blob const & rawLedger, bool hasPrefix);
     Ledger (std::string const& rawLedger, bool hasPrefix);
     Ledger (bool dummy, Ledger & previous); // ledger after this one
+    Ledger (Blob const& rawLedger, std::shared_ptr<SHAMap> const& txMap,
+            std::shared_ptr<SHAMap> const& stateMap); // rebuilt from a snapshot
     Ledger (Ledger & target, bool isMutable); // snapshot
 
     Ledger (Ledger const&) = delete;
@@ -268,6 +271,14 @@ public:
         return mTransactionMap->hasItem (TransID);
     }
     Transaction::pointer getTransaction (uint256 const& transID) const;
+
+    /** Look up a transaction in the closed ledger whose transaction map
+        has the given root, walking only the path to its leaf. The ledger
+        itself is not loaded.
+    */
+    static Transaction::pointer loadTransaction (uint256 const& txMapHash,
+        LedgerIndex ledgerSeq, uint256 const& transID);
+
     bool getTransaction (
         uint256 const& transID,
         Transaction::pointer & txn, TransactionMetaSet::pointer & txMeta) const;
@@ -276,9 +287,9 @@ public:
     bool getMetaHex (uint256 const& transID, std::string & hex) const;
 
     static STTx::pointer getSTransaction (
-        std::shared_ptr<SHAMapItem> const&, SHAMapTreeNode::TNType);
+        boost::intrusive_ptr<SHAMapItem const> const&, SHAMapTreeNode::TNType);
     STTx::pointer getSMTransaction (
-        std::shared_ptr<SHAMapItem> const&, SHAMapTreeNode::TNType,
+        boost::intrusive_ptr<SHAMapItem const> const&, SHAMapTreeNode::TNType,
         TransactionMetaSet::pointer & txMeta) const;
 
     // high-level functions
@@ -312,6 +323,8 @@ public:
 
     // next/prev function
     SLE::pointer getSLE (uint256 const& uHash) const; // SLE is mutable
+    SLE::pointer getSLE (uint256 const& uHash,
+        LedgerEntryAllocator<SLE> const& alloc) const; // SLE is mutable
     SLE::pointer getSLEi (uint256 const& uHash) const; // SLE is immutable
 
     //  NOTE These seem to let you walk the list of ledgers
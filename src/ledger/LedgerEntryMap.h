@@ -0,0 +1,328 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_APP_LEDGER_LEDGERENTRYMAP_H_INCLUDED
+#define BESSEL_APP_LEDGER_LEDGERENTRYMAP_H_INCLUDED
+
+#include <common/base/base_uint.h>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace bessel {
+
+/** Sorted vector with the subset of the std::map interface LedgerEntrySet uses.
+
+    A transaction touches a handful of ledger entries, so a contiguous,
+    sorted array beats a node-based tree: lookups are a short binary search
+    over adjacent keys and, because clear() keeps the capacity, a set reused
+    from one transaction to the next stops allocating altogether.
+
+    Iteration is in key order, exactly as with std::map, which keeps the
+    metadata built from it unchanged. Unlike std::map, inserting or erasing
+    invalidates iterators and references to other elements.
+*/
+template <class T>
+class LedgerEntryMap
+{
+public:
+    using key_type = uint256;
+    using mapped_type = T;
+    using value_type = std::pair <uint256, T>;
+
+private:
+    using container = std::vector <value_type>;
+
+    container items_;
+
+    struct KeyLess
+    {
+        bool operator() (value_type const& v, uint256 const& key) const
+        {
+            return v.first < key;
+        }
+
+        bool operator() (uint256 const& key, value_type const& v) const
+        {
+            return key < v.first;
+        }
+    };
+
+public:
+    using iterator = typename container::iterator;
+    using const_iterator = typename container::const_iterator;
+
+    bool empty () const
+    {
+        return items_.empty ();
+    }
+
+    std::size_t size () const
+    {
+        return items_.size ();
+    }
+
+    void reserve (std::size_t n)
+    {
+        items_.reserve (n);
+    }
+
+    /** Remove every element, keeping the storage for reuse. */
+    void clear ()
+    {
+        items_.clear ();
+    }
+
+    void swap (LedgerEntryMap& other)
+    {
+        items_.swap (other.items_);
+    }
+
+    iterator begin ()
+    {
+        return items_.begin ();
+    }
+
+    iterator end ()
+    {
+        return items_.end ();
+    }
+
+    const_iterator begin () const
+    {
+        return items_.begin ();
+    }
+
+    const_iterator end () const
+    {
+        return items_.end ();
+    }
+
+    const_iterator cbegin () const
+    {
+        return items_.cbegin ();
+    }
+
+    const_iterator cend () const
+    {
+        return items_.cend ();
+    }
+
+    iterator find (uint256 const& key)
+    {
+        auto const it = lower_bound (key);
+        return (it != items_.end () && it->first == key) ? it : items_.end ();
+    }
+
+    const_iterator find (uint256 const& key) const
+    {
+        auto const it = lower_bound (key);
+        return (it != items_.end () && it->first == key) ? it : items_.end ();
+    }
+
+    iterator lower_bound (uint256 const& key)
+    {
+        return std::lower_bound (items_.begin (), items_.end (), key, KeyLess ());
+    }
+
+    const_iterator lower_bound (uint256 const& key) const
+    {
+        return std::lower_bound (items_.begin (), items_.end (), key, KeyLess ());
+    }
+
+    iterator upper_bound (uint256 const& key)
+    {
+        return std::upper_bound (items_.begin (), items_.end (), key, KeyLess ());
+    }
+
+    const_iterator upper_bound (uint256 const& key) const
+    {
+        return std::upper_bound (items_.begin (), items_.end (), key, KeyLess ());
+    }
+
+    /** Insert an element if its key is not present yet. */
+    std::pair <iterator, bool> insert (value_type&& v)
+    {
+        auto it = lower_bound (v.first);
+
+        if (it != items_.end () && it->first == v.first)
+            return std::make_pair (it, false);
+
+        return std::make_pair (items_.insert (it, std::move (v)), true);
+    }
+
+    iterator erase (iterator it)
+    {
+        return items_.erase (it);
+    }
+
+    /** Lay the elements of another map over this one.
+
+        Keys present in both take the value from @a top, and keys whose
+        value in @a top satisfies @a erased are removed. This is a single
+        merge of the two sorted arrays.
+    */
+    template <class Erased>
+    void overlay (LedgerEntryMap const& top, Erased erased)
+    {
+        container merged;
+        merged.reserve (items_.size () + top.items_.size ());
+
+        auto a = items_.begin ();
+        auto b = top.items_.begin ();
+
+        while (a != items_.end () || b != top.items_.end ())
+        {
+            if (b == top.items_.end () ||
+                (a != items_.end () && a->first < b->first))
+            {
+                merged.push_back (std::move (*a));
+                ++a;
+                continue;
+            }
+
+            if (a != items_.end () && a->first == b->first)
+                ++a;
+
+            if (!erased (b->second))
+                merged.push_back (*b);
+
+            ++b;
+        }
+
+        items_.swap (merged);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** Bump allocator backing the ledger entries a LedgerEntrySet copies.
+
+    Memory is handed out from fixed size blocks and never returned
+    individually. Allocators hold a shared reference, so the arena lives
+    until the last entry carved from it is destroyed, however long that
+    entry outlives the transaction that created it.
+*/
+class LedgerEntryArena
+{
+public:
+    static std::size_t const blockSize = 16 * 1024;
+
+    LedgerEntryArena () = default;
+    LedgerEntryArena (LedgerEntryArena const&) = delete;
+    LedgerEntryArena& operator= (LedgerEntryArena const&) = delete;
+
+    void* allocate (std::size_t size, std::size_t align)
+    {
+        for (;;)
+        {
+            if (current_ < blocks_.size ())
+            {
+                auto& block = blocks_[current_];
+                auto const pad = (align - (used_ % align)) % align;
+
+                if (used_ + pad + size <= block.second)
+                {
+                    void* const p = block.first.get () + used_ + pad;
+                    used_ += pad + size;
+                    return p;
+                }
+
+                // Blocks kept by reset() are reused in order
+                ++current_;
+                used_ = 0;
+                continue;
+            }
+
+            auto const capacity = std::max (size + align, std::size_t (blockSize));
+            blocks_.emplace_back (
+                std::unique_ptr <char[]> (new char [capacity]), capacity);
+        }
+    }
+
+    /** Make every block available again. Only valid when nothing
+        allocated from the arena is still alive.
+    */
+    void reset ()
+    {
+        current_ = 0;
+        used_ = 0;
+    }
+
+private:
+    std::vector <std::pair <std::unique_ptr <char[]>, std::size_t>> blocks_;
+    std::size_t current_ = 0;
+    std::size_t used_ = 0;
+};
+
+/** Allocator that shares ownership of a LedgerEntryArena. */
+template <class T>
+class LedgerEntryAllocator
+{
+public:
+    using value_type = T;
+
+    explicit LedgerEntryAllocator (
+            std::shared_ptr <LedgerEntryArena> const& arena) noexcept
+        : arena_ (arena)
+    {
+    }
+
+    template <class U>
+    LedgerEntryAllocator (LedgerEntryAllocator <U> const& other) noexcept
+        : arena_ (other.arena ())
+    {
+    }
+
+    T* allocate (std::size_t n)
+    {
+        return static_cast <T*> (arena_->allocate (n * sizeof (T), alignof (T)));
+    }
+
+    void deallocate (T*, std::size_t) noexcept
+    {
+    }
+
+    std::shared_ptr <LedgerEntryArena> const& arena () const noexcept
+    {
+        return arena_;
+    }
+
+private:
+    std::shared_ptr <LedgerEntryArena> arena_;
+};
+
+template <class T, class U>
+bool operator== (LedgerEntryAllocator <T> const& a, LedgerEntryAllocator <U> const& b)
+{
+    return a.arena () == b.arena ();
+}
+
+template <class T, class U>
+bool operator!= (LedgerEntryAllocator <T> const& a, LedgerEntryAllocator <U> const& b)
+{
+    return !(a == b);
+}
+
+} // bessel
+
+#endif
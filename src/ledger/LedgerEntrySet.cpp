@@ -36,12 +36,18 @@ namespace bessel {
 //
 #define DIR_NODE_MAX        32
 
+// Checkpointing past this many layers collapses them into one, so that
+// lookups through a long series of passes stay cheap.
+static std::size_t const maxLayerDepth = 8;
+
 void LedgerEntrySet::init (Ledger::ref ledger, 
                            uint256 const& transactionID,
                            std::uint32_t ledgerID, 
                            TransactionEngineParams params)
 {
     mEntries.clear ();
+    mParent.reset ();
+    resetArena ();
     if (mDeferredCredits)
         mDeferredCredits->clear ();
 
@@ -54,6 +60,8 @@ void LedgerEntrySet::init (Ledger::ref ledger,
 void LedgerEntrySet::clear ()
 {
     mEntries.clear ();
+    mParent.reset ();
+    resetArena ();
     mSet.clear ();
 
     if (mDeferredCredits)
@@ -62,7 +70,13 @@ void LedgerEntrySet::clear ()
 
 LedgerEntrySet LedgerEntrySet::duplicate () const
 {
-    return LedgerEntrySet (mLedger, mEntries, mSet, mSeq + 1, mDeferredCredits);
+    return LedgerEntrySet (mLedger, mParent, mEntries, mSet, mSeq + 1, mDeferredCredits);
+}
+
+LedgerEntrySet LedgerEntrySet::checkpoint ()
+{
+    freeze ();
+    return *this;
 }
 
 void LedgerEntrySet::swapWith (LedgerEntrySet& e)
@@ -70,17 +84,183 @@ void LedgerEntrySet::swapWith (LedgerEntrySet& e)
     using std::swap;
     swap (mLedger, e.mLedger);
     mEntries.swap (e.mEntries);
+    swap (mParent, e.mParent);
+    swap (mArena, e.mArena);
     mSet.swap (e.mSet);
     swap (mParams, e.mParams);
     swap (mSeq, e.mSeq);
     swap (mDeferredCredits, e.mDeferredCredits);
 }
 
+LedgerEntryAllocator<SLE> LedgerEntrySet::getAllocator ()
+{
+    if (!mArena)
+        mArena = std::make_shared<LedgerEntryArena> ();
+
+    return LedgerEntryAllocator<SLE> (mArena);
+}
+
+// Between transactions, recycle the arena if no entry carved from it is
+// still referenced; otherwise leave it to its remaining owners.
+void LedgerEntrySet::resetArena ()
+{
+    if (mArena && mArena.use_count () == 1)
+        mArena->reset ();
+    else
+        mArena.reset ();
+}
+
+// Move the changes made so far into a new shared layer. The sequence number
+// moves on, so the frozen entries are copied before anything modifies them.
+void LedgerEntrySet::freeze ()
+{
+    if (mEntries.empty ())
+        return;
+
+    if (mParent && mParent->depth >= maxLayerDepth)
+        flatten ();
+
+    auto layer = std::make_shared<LedgerEntryLayer> ();
+    layer->entries.swap (mEntries);
+    layer->parent = mParent;
+    layer->depth = mParent ? mParent->depth + 1 : 1;
+
+    mParent = std::move (layer);
+    ++mSeq;
+}
+
+// Merge the layers and the changes over them back into a single set.
+void LedgerEntrySet::flatten () const
+{
+    if (!mParent)
+        return;
+
+    std::vector<LedgerEntryLayer const*> layers;
+
+    for (auto layer = mParent.get (); layer; layer = layer->parent.get ())
+        layers.push_back (layer);
+
+    auto const erased = [](LedgerEntrySetEntry const& entry)
+    {
+        return entry.mAction == taaNONE;
+    };
+
+    LedgerEntryMap<LedgerEntrySetEntry> entries;
+
+    for (auto it = layers.rbegin (); it != layers.rend (); ++it)
+        entries.overlay ((*it)->entries, erased);
+
+    entries.overlay (mEntries, erased);
+
+    mEntries.swap (entries);
+    mParent.reset ();
+}
+
+// Find the entry the set holds for an index, bringing it up from the layers
+// if only they have it. Erased entries are not found.
+LedgerEntryMap<LedgerEntrySetEntry>::iterator
+LedgerEntrySet::findEntry (uint256 const& index)
+{
+    auto it = mEntries.find (index);
+
+    if (it != mEntries.end ())
+        return (it->second.mAction == taaNONE) ? mEntries.end () : it;
+
+    auto const entry = peekLayers (index);
+
+    if (!entry)
+        return mEntries.end ();
+
+    return mEntries.insert (std::make_pair (index, *entry)).first;
+}
+
+LedgerEntrySetEntry const* LedgerEntrySet::peekEntry (uint256 const& index) const
+{
+    auto it = mEntries.find (index);
+
+    if (it != mEntries.end ())
+        return (it->second.mAction == taaNONE) ? nullptr : &it->second;
+
+    return peekLayers (index);
+}
+
+LedgerEntrySetEntry const* LedgerEntrySet::peekLayers (uint256 const& index) const
+{
+    for (auto layer = mParent.get (); layer; layer = layer->parent.get ())
+    {
+        auto it = layer->entries.find (index);
+
+        if (it != layer->entries.end ())
+            return (it->second.mAction == taaNONE) ? nullptr : &it->second;
+    }
+
+    return nullptr;
+}
+
+void LedgerEntrySet::insertEntry (uint256 const& index, LedgerEntrySetEntry const& entry)
+{
+    auto result = mEntries.insert (std::make_pair (index, entry));
+
+    if (!result.second)
+    {
+        // Only an erased entry may be replaced
+        assert (result.first->second.mAction == taaNONE);
+        result.first->second = entry;
+    }
+}
+
+void LedgerEntrySet::eraseEntry (LedgerEntryMap<LedgerEntrySetEntry>::iterator it)
+{
+    if (!peekLayers (it->first))
+    {
+        mEntries.erase (it);
+        return;
+    }
+
+    // Hide the entry the layers still hold
+    it->second.mEntry.reset ();
+    it->second.mAction = taaNONE;
+}
+
+// The first index after the given one that the set holds and does not delete.
+uint256 LedgerEntrySet::nextEntry (uint256 const& index) const
+{
+    uint256 next = index;
+
+    for (;;)
+    {
+        auto it = mEntries.upper_bound (next);
+        bool found = it != mEntries.end ();
+        uint256 candidate = found ? it->first : uint256 ();
+
+        for (auto layer = mParent.get (); layer; layer = layer->parent.get ())
+        {
+            auto lit = layer->entries.upper_bound (next);
+
+            if (lit != layer->entries.end () && (!found || lit->first < candidate))
+            {
+                candidate = lit->first;
+                found = true;
+            }
+        }
+
+        if (!found)
+            return uint256 ();
+
+        auto const entry = peekEntry (candidate);
+
+        if (entry && entry->mAction != taaDELETE)
+            return candidate;
+
+        next = candidate;
+    }
+}
+
 // Find an entry in the set.  If it has the wrong sequence number, copy it and update the sequence number.
 // This is basically: copy-on-read.
 SLE::pointer LedgerEntrySet::getEntry (uint256 const& index, LedgerEntryAction& action)
 {
-    auto it = mEntries.find (index);
+    auto it = findEntry (index);
 
     if (it == mEntries.end ())
     {
@@ -91,7 +271,8 @@ SLE::pointer LedgerEntrySet::getEntry (uint256 const& index, LedgerEntryAction&
     if (it->second.mSeq != mSeq)
     {
         assert (it->second.mSeq < mSeq);
-        it->second.mEntry = std::make_shared<STLedgerEntry> (*it->second.mEntry);
+        it->second.mEntry = std::allocate_shared<STLedgerEntry> (
+            getAllocator (), *it->second.mEntry);
         it->second.mSeq = mSeq;
     }
 
@@ -122,7 +303,9 @@ SLE::pointer LedgerEntrySet::entryCache (LedgerEntryType letType, uint256 const&
         if (!sleEntry)
         {
             assert (action != taaDELETE);
-            sleEntry = mImmutable ? mLedger->getSLEi (index) : mLedger->getSLE (index);
+            sleEntry = mImmutable
+                ? mLedger->getSLEi (index)
+                : mLedger->getSLE (index, getAllocator ());
 
             if (sleEntry)
                 entryCache (sleEntry);
@@ -140,11 +323,11 @@ void LedgerEntrySet::entryCache (SLE::ref sle)
 {
     assert (mLedger);
     assert (sle->isMutable () || mImmutable); // Don't put an immutable SLE in a mutable LES
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = findEntry (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
-        mEntries.insert (std::make_pair (sle->getIndex (), LedgerEntrySetEntry (sle, taaCACHED, mSeq)));
+        insertEntry (sle->getIndex (), LedgerEntrySetEntry (sle, taaCACHED, mSeq));
         return;
     }
 
@@ -166,11 +349,11 @@ void LedgerEntrySet::entryCreate (SLE::ref sle)
     assert (mLedger && !mImmutable);
     assert (sle->isMutable ());
 
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = findEntry (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
-        mEntries.insert (std::make_pair (sle->getIndex (), LedgerEntrySetEntry (sle, taaCREATE, mSeq)));
+        insertEntry (sle->getIndex (), LedgerEntrySetEntry (sle, taaCREATE, mSeq));
         return;
     }
 
@@ -204,11 +387,11 @@ void LedgerEntrySet::entryModify (SLE::ref sle)
 {
     assert (sle->isMutable () && !mImmutable);
     assert (mLedger);
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = findEntry (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
-        mEntries.insert (std::make_pair (sle->getIndex (), LedgerEntrySetEntry (sle, taaMODIFY, mSeq)));
+        insertEntry (sle->getIndex (), LedgerEntrySetEntry (sle, taaMODIFY, mSeq));
         return;
     }
 
@@ -240,13 +423,13 @@ void LedgerEntrySet::entryDelete (SLE::ref sle)
 {
     assert (sle->isMutable () && !mImmutable);
     assert (mLedger);
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = findEntry (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
         assert (false); // deleting an entry not cached?
 
-        mEntries.insert (std::make_pair (sle->getIndex (), LedgerEntrySetEntry (sle, taaDELETE, mSeq)));
+        insertEntry (sle->getIndex (), LedgerEntrySetEntry (sle, taaDELETE, mSeq));
 
         return;
     }
@@ -264,7 +447,7 @@ void LedgerEntrySet::entryDelete (SLE::ref sle)
         break;
 
     case taaCREATE:
-        mEntries.erase (it);
+        eraseEntry (it);
         break;
 
     case taaDELETE:
@@ -281,6 +464,8 @@ Json::Value LedgerEntrySet::getJson (int) const
 
     Json::Value nodes (Json::arrayValue);
 
+    flatten ();
+
     for (auto it = mEntries.begin (), end = mEntries.end (); it != end; ++it)
     {
         Json::Value entry (Json::objectValue);
@@ -351,7 +536,7 @@ Json::Value LedgerEntrySet::getJson (int) const
 SLE::pointer LedgerEntrySet::getForMod (uint256 const& node, Ledger::ref ledger,
                                         NodeToLedgerEntry& newMods)
 {
-    auto it = mEntries.find (node);
+    auto it = findEntry (node);
 
     if (it != mEntries.end ())
     {
@@ -367,7 +552,8 @@ SLE::pointer LedgerEntrySet::getForMod (uint256 const& node, Ledger::ref ledger,
 
         if (it->second.mSeq != mSeq)
         {
-            it->second.mEntry = std::make_shared<STLedgerEntry> (*it->second.mEntry);
+            it->second.mEntry = std::allocate_shared<STLedgerEntry> (
+            getAllocator (), *it->second.mEntry);
             it->second.mSeq = mSeq;
         }
 
@@ -383,7 +569,7 @@ SLE::pointer LedgerEntrySet::getForMod (uint256 const& node, Ledger::ref ledger,
         return me->second;
     }
 
-    SLE::pointer ret = ledger->getSLE (node);
+    SLE::pointer ret = ledger->getSLE (node, getAllocator ());
 
     if (ret)
         newMods.insert (std::make_pair (node, ret));
@@ -469,6 +655,8 @@ void LedgerEntrySet::calcRawMeta (Serializer& s, TER result, std::uint32_t index
     // Entries modified only as a result of building the transaction metadata
     NodeToLedgerEntry newMod;
 
+    flatten ();
+
     for (auto& it : mEntries)
     {
         auto type = &sfGeneric;
@@ -1014,26 +1202,25 @@ uint256 LedgerEntrySet::getNextLedgerIndex (uint256 const& uHash)
 {
     // find next node in ledger that isn't deleted by LES
     uint256 ledgerNext = uHash;
-    std::map<uint256, LedgerEntrySetEntry>::const_iterator it;
+    LedgerEntrySetEntry const* entry;
 
     do
     {
         ledgerNext = mLedger->getNextLedgerIndex (ledgerNext);
-        it  = mEntries.find (ledgerNext);
+        entry = peekEntry (ledgerNext);
     }
-    while ((it != mEntries.end ()) && (it->second.mAction == taaDELETE));
+    while (entry && (entry->mAction == taaDELETE));
 
     // find next node in LES that isn't deleted
-    for (it = mEntries.upper_bound (uHash); it != mEntries.end (); ++it)
-    {
-        // node found in LES, node found in ledger, return earliest
-        if (it->second.mAction != taaDELETE)
-            return (ledgerNext.isNonZero () && (ledgerNext < it->first)) ?
-                    ledgerNext : it->first;
-    }
+    uint256 const lesNext = nextEntry (uHash);
 
     // nothing next in LES, return next ledger node
-    return ledgerNext;
+    if (lesNext.isZero ())
+        return ledgerNext;
+
+    // node found in LES, node found in ledger, return earliest
+    return (ledgerNext.isNonZero () && (ledgerNext < lesNext)) ?
+            ledgerNext : lesNext;
 }
 
 uint256 LedgerEntrySet::getNextLedgerIndex (
@@ -23,6 +23,7 @@
 #include <boost/optional.hpp>
 #include <ledger/Ledger.h>
 #include <ledger/DeferredCredits.h>
+#include <ledger/LedgerEntryMap.h>
 #include <common/base/CountedObject.h>
 #include <protocol/STLedgerEntry.h>
 #include <common/misc/Zero.h>
@@ -89,6 +90,21 @@ public:
     }
 };
 
+/** A frozen level of a layered LedgerEntrySet.
+
+    Checkpointing a set moves the entries it holds into a layer that the
+    set and its copies share read-only, so taking a checkpoint or starting
+    a trial from one costs the size of the changes since the last layer
+    rather than the size of the whole set. An entry whose action is taaNONE
+    hides the entry with the same key in the layers below it.
+*/
+struct LedgerEntryLayer
+{
+    LedgerEntryMap<LedgerEntrySetEntry> entries;
+    std::shared_ptr<LedgerEntryLayer const> parent;
+    std::size_t depth;
+};
+
 /** An LES is a LedgerEntrySet.
 
     It's a view into a ledger used while a transaction is processing.
@@ -116,12 +132,16 @@ public:
     // Make a duplicate of this set.
     LedgerEntrySet duplicate () const;
 
+    // Freeze the changes made so far and return a set that shares them.
+    LedgerEntrySet checkpoint ();
+
     // Swap the contents of two sets
     void swapWith (LedgerEntrySet&);
 
     void invalidate ()
     {
         mLedger.reset ();
+        mParent.reset ();
         mDeferredCredits.reset ();
     }
 
@@ -224,35 +244,41 @@ public:
     void calcRawMeta (Serializer&, TER result, std::uint32_t index);
 
     // iterator functions
-    typedef std::map<uint256, LedgerEntrySetEntry>::iterator iterator;
-    typedef std::map<uint256, LedgerEntrySetEntry>::const_iterator const_iterator;
+    typedef LedgerEntryMap<LedgerEntrySetEntry>::iterator iterator;
+    typedef LedgerEntryMap<LedgerEntrySetEntry>::const_iterator const_iterator;
 
+    // Iterating collapses any layers into the set first
     bool empty () const
     {
+        flatten ();
         return mEntries.empty ();
     }
     const_iterator cbegin () const
     {
+        flatten ();
         return mEntries.cbegin ();
     }
     const_iterator cend () const
     {
+        flatten ();
         return mEntries.cend ();
     }
     const_iterator begin () const
     {
-        return mEntries.cbegin ();
+        return cbegin ();
     }
     const_iterator end () const
     {
-        return mEntries.cend ();
+        return cend ();
     }
     iterator begin ()
     {
+        flatten ();
         return mEntries.begin ();
     }
     iterator end ()
     {
+        flatten ();
         return mEntries.end ();
     }
 
@@ -276,7 +302,11 @@ public:
     Account AuthorizeAccountGet (Account const& account, Currency const& currency);
 private:
     Ledger::pointer mLedger;
-    std::map<uint256, LedgerEntrySetEntry>  mEntries; // cannot be unordered!
+    // Changes made since the last checkpoint, over the frozen layers
+    mutable LedgerEntryMap<LedgerEntrySetEntry> mEntries; // cannot be unordered!
+    mutable std::shared_ptr<LedgerEntryLayer const> mParent;
+    // Backs the entries this set copies or loads for modification
+    std::shared_ptr<LedgerEntryArena> mArena;
     // Defers credits made to accounts until later
     boost::optional<DeferredCredits> mDeferredCredits;
 
@@ -288,12 +318,26 @@ private:
     bool mImmutable;
 
     LedgerEntrySet (
-        Ledger::ref ledger, const std::map<uint256, LedgerEntrySetEntry>& e,
+        Ledger::ref ledger, std::shared_ptr<LedgerEntryLayer const> const& parent,
+        LedgerEntryMap<LedgerEntrySetEntry> const& e,
         const TransactionMetaSet & s, int m, boost::optional<DeferredCredits> const& ft) :
-        mLedger (ledger), mEntries (e), mDeferredCredits (ft), mSet (s), mParams (tapNONE),
-        mSeq (m), mImmutable (false)
+        mLedger (ledger), mEntries (e), mParent (parent), mDeferredCredits (ft), mSet (s),
+        mParams (tapNONE), mSeq (m), mImmutable (false)
     {}
 
+    LedgerEntryMap<LedgerEntrySetEntry>::iterator findEntry (uint256 const& index);
+    LedgerEntrySetEntry const* peekEntry (uint256 const& index) const;
+    LedgerEntrySetEntry const* peekLayers (uint256 const& index) const;
+    void insertEntry (uint256 const& index, LedgerEntrySetEntry const& entry);
+    void eraseEntry (LedgerEntryMap<LedgerEntrySetEntry>::iterator it);
+    uint256 nextEntry (uint256 const& index) const;
+
+    void freeze ();
+    void flatten () const;
+
+    LedgerEntryAllocator<SLE> getAllocator ();
+    void resetArena ();
+
     SLE::pointer getForMod (
         uint256 const& node, Ledger::ref ledger,
         NodeToLedgerEntry& newMods);
@@ -324,15 +324,15 @@ void LedgerHistory::handleMismatch (LedgerHash const& built, LedgerHash const& v
     std::vector <SHAMapItemInfo> builtTx, validTx;
     // Get built ledger hashes and metadata
     builtLedger->peekTransactionMap()->visitLeaves(
-        [&builtTx](std::shared_ptr<SHAMapItem> const& item)
+        [&builtTx](boost::intrusive_ptr<SHAMapItem const> const& item)
         {
-            builtTx.push_back({item->getTag(), item->peekData()});
+            builtTx.push_back({item->getTag(), item->getData()});
         });
     // Get valid ledger hashes and metadata
     validLedger->peekTransactionMap()->visitLeaves(
-        [&validTx](std::shared_ptr<SHAMapItem> const& item)
+        [&validTx](boost::intrusive_ptr<SHAMapItem const> const& item)
         {
-            validTx.push_back({item->getTag(), item->peekData()});
+            validTx.push_back({item->getTag(), item->getData()});
         });
 
     // Sort both by hash
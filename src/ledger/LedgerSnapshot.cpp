@@ -0,0 +1,386 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ledger/LedgerSnapshot.h>
+#include <main/Application.h>
+#include <common/base/Log.h>
+#include <common/core/JobQueue.h>
+#include <common/core/ParallelFor.h>
+#include <common/shamap/SHAMap.h>
+#include <protocol/Serializer.h>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace bessel {
+
+namespace {
+
+char const snapshotMagic[8] = { 'B', 'S', 'L', 'S', 'N', 'A', 'P', '1' };
+std::uint32_t const snapshotVersion = 1;
+
+// Leaves per chunk. A chunk is the unit of checksumming and of parallel
+// decoding when a snapshot is loaded.
+std::uint32_t const itemsPerChunk = 16384;
+
+// Upper bound on the number of helper jobs used to load a snapshot
+std::size_t const maxHelpers = 8;
+
+//------------------------------------------------------------------------------
+
+void
+writeBytes (std::ostream& out, void const* data, std::size_t size)
+{
+    out.write (static_cast<char const*> (data), size);
+}
+
+void
+writeChunk (std::ostream& out, std::uint32_t items, Serializer const& payload)
+{
+    Serializer s (8);
+    s.add32 (items);
+    s.add32 (payload.getDataLength ());
+    writeBytes (out, s.getDataPtr (), s.getDataLength ());
+
+    if (items != 0)
+    {
+        uint256 const checksum = payload.getSHA512Half ();
+        writeBytes (out, payload.getDataPtr (), payload.getDataLength ());
+        writeBytes (out, checksum.begin (), uint256::bytes);
+    }
+}
+
+void
+writeSection (std::ostream& out, SHAMap const& map,
+    SHAMapTreeNode::TNType type)
+{
+    unsigned char const t = static_cast<unsigned char> (type);
+    writeBytes (out, &t, 1);
+
+    Serializer payload;
+    std::uint32_t items = 0;
+
+    // Nodes are visited depth first in branch order, so leaves arrive
+    // sorted by key.
+    map.visitNodes ([&] (SHAMapTreeNode& node)
+    {
+        if (node.isInner ())
+            return false;
+
+        if (node.getType () != type)
+            throw std::runtime_error ("unexpected leaf type");
+
+        auto const& item = static_cast<SHAMapLeafNode&> (node).peekItem ();
+        payload.add256 (item->getTag ());
+        payload.add32 (item->size ());
+        payload.addRaw (item->slice ());
+
+        if (++items == itemsPerChunk)
+        {
+            writeChunk (out, items, payload);
+            payload.erase ();
+            items = 0;
+        }
+
+        return false;
+    });
+
+    if (items != 0)
+        writeChunk (out, items, payload);
+
+    // terminator
+    writeChunk (out, 0, Serializer ());
+}
+
+//------------------------------------------------------------------------------
+
+/** Bounds checked cursor over the mapped file. */
+class Cursor
+{
+public:
+    Cursor (unsigned char const* data, std::size_t size)
+        : p_ (data)
+        , remain_ (size)
+    {
+    }
+
+    unsigned char const*
+    take (std::size_t n)
+    {
+        if (remain_ < n)
+            throw std::runtime_error ("snapshot is truncated");
+
+        auto const p = p_;
+        p_ += n;
+        remain_ -= n;
+        return p;
+    }
+
+    std::uint8_t
+    get8 ()
+    {
+        return *take (1);
+    }
+
+    std::uint32_t
+    get32 ()
+    {
+        return SerialIter (take (4), 4).get32 ();
+    }
+
+    bool
+    empty () const
+    {
+        return remain_ == 0;
+    }
+
+private:
+    unsigned char const* p_;
+    std::size_t remain_;
+};
+
+struct Chunk
+{
+    unsigned char const* payload;
+    std::uint32_t size;
+    std::uint32_t items;
+    unsigned char const* checksum;
+    std::size_t first;              // index of the chunk's first item
+};
+
+// Decodes and verifies one chunk into its slot of the item vector
+void
+decodeChunk (Chunk const& chunk,
+    std::vector<boost::intrusive_ptr<SHAMapItem const>>& items)
+{
+    if (getSHA512Half (chunk.payload, chunk.size) !=
+            SerialIter (chunk.checksum, uint256::bytes).get256 ())
+        throw std::runtime_error ("chunk checksum mismatch");
+
+    SerialIter sit (chunk.payload, chunk.size);
+
+    for (std::uint32_t i = 0; i < chunk.items; ++i)
+    {
+        uint256 const key = sit.get256 ();
+        std::uint32_t const size = sit.get32 ();
+        items[chunk.first + i] = make_shamapitem (key, sit.getSlice (size));
+    }
+
+    if (!sit.empty ())
+        throw std::runtime_error ("chunk has trailing data");
+}
+
+// Reads one section and builds its map
+std::shared_ptr<SHAMap>
+readSection (Cursor& cursor, SHAMapType mapType, NodeObjectType objectType,
+    beast::Journal journal)
+{
+    auto const type = static_cast<SHAMapTreeNode::TNType> (cursor.get8 ());
+
+    if ((type != SHAMapTreeNode::tnTRANSACTION_NM) &&
+        (type != SHAMapTreeNode::tnTRANSACTION_MD) &&
+        (type != SHAMapTreeNode::tnACCOUNT_STATE))
+        throw std::runtime_error ("invalid leaf type");
+
+    // Locate the chunks without touching their payloads
+    std::vector<Chunk> chunks;
+    std::size_t total = 0;
+
+    while (true)
+    {
+        Chunk chunk;
+        chunk.items = cursor.get32 ();
+        chunk.size = cursor.get32 ();
+
+        if (chunk.items == 0)
+            break;
+
+        chunk.payload = cursor.take (chunk.size);
+        chunk.checksum = cursor.take (uint256::bytes);
+        chunk.first = total;
+        total += chunk.items;
+        chunks.push_back (chunk);
+    }
+
+    auto& jobQueue = getApp ().getJobQueue ();
+    std::vector<boost::intrusive_ptr<SHAMapItem const>> items (total);
+    std::atomic<bool> failed (false);
+
+    parallelFor (jobQueue, jtLEDGER_SNAPSHOT, "ledgerSnapshot",
+        chunks.size (), maxHelpers,
+        [&] (std::size_t i)
+        {
+            if (failed)
+                return;
+
+            try
+            {
+                decodeChunk (chunks[i], items);
+            }
+            catch (std::exception const& e)
+            {
+                if (journal.warning) journal.warning <<
+                    "Snapshot chunk " << i << ": " << e.what ();
+                failed = true;
+            }
+        });
+
+    if (failed)
+        throw std::runtime_error ("snapshot is corrupt");
+
+    auto map = std::make_shared<SHAMap> (mapType, getApp ().family (),
+        deprecatedLogs ().journal ("SHAMap"));
+
+    map->addSortedItems (items, type, objectType,
+        [&jobQueue] (std::function<void (int)> const& build)
+        {
+            parallelFor (jobQueue, jtLEDGER_SNAPSHOT, "ledgerSnapshot",
+                16, maxHelpers,
+                [&build] (std::size_t branch)
+                {
+                    build (static_cast<int> (branch));
+                });
+        });
+
+    if (journal.info) journal.info <<
+        "Snapshot: " << total << " items in " << chunks.size () << " chunks";
+
+    return map;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+
+bool
+writeLedgerSnapshot (Ledger& ledger, std::string const& path,
+    beast::Journal journal)
+{
+    if (!ledger.isClosed ())
+    {
+        if (journal.error) journal.error <<
+            "Snapshot: ledger " << ledger.getLedgerSeq () << " is not closed";
+        return false;
+    }
+
+    try
+    {
+        std::ofstream out (path.c_str (),
+            std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if (!out)
+            throw std::runtime_error ("unable to create file");
+
+        Serializer header;
+        ledger.addRaw (header);
+
+        Serializer prefix;
+        prefix.add32 (snapshotVersion);
+        prefix.add32 (header.getDataLength ());
+
+        writeBytes (out, snapshotMagic, sizeof (snapshotMagic));
+        writeBytes (out, prefix.getDataPtr (), prefix.getDataLength ());
+        writeBytes (out, header.getDataPtr (), header.getDataLength ());
+
+        writeSection (out, *ledger.peekTransactionMap (),
+            SHAMapTreeNode::tnTRANSACTION_MD);
+        writeSection (out, *ledger.peekAccountStateMap (),
+            SHAMapTreeNode::tnACCOUNT_STATE);
+
+        out.close ();
+
+        if (!out)
+            throw std::runtime_error ("write failed");
+    }
+    catch (std::exception const& e)
+    {
+        if (journal.error) journal.error <<
+            "Snapshot: unable to write " << path << ": " << e.what ();
+        return false;
+    }
+
+    if (journal.info) journal.info <<
+        "Snapshot: wrote ledger " << ledger.getLedgerSeq () << " to " << path;
+
+    return true;
+}
+
+Ledger::pointer
+readLedgerSnapshot (std::string const& path, beast::Journal journal)
+{
+    namespace bip = boost::interprocess;
+
+    try
+    {
+        bip::file_mapping file (path.c_str (), bip::read_only);
+        bip::mapped_region region (file, bip::read_only);
+
+        Cursor cursor (static_cast<unsigned char const*> (
+            region.get_address ()), region.get_size ());
+
+        if (std::memcmp (cursor.take (sizeof (snapshotMagic)),
+                snapshotMagic, sizeof (snapshotMagic)) != 0)
+            throw std::runtime_error ("not a ledger snapshot");
+
+        if (cursor.get32 () != snapshotVersion)
+            throw std::runtime_error ("unsupported snapshot version");
+
+        std::uint32_t const headerSize = cursor.get32 ();
+        auto const headerData = cursor.take (headerSize);
+        Blob const header (headerData, headerData + headerSize);
+
+        auto const txMap = readSection (cursor,
+            SHAMapType::TRANSACTION, hotTRANSACTION_NODE, journal);
+        auto const stateMap = readSection (cursor,
+            SHAMapType::STATE, hotACCOUNT_NODE, journal);
+
+        if (!cursor.empty ())
+            throw std::runtime_error ("snapshot has trailing data");
+
+        auto ledger = std::make_shared<Ledger> (header, txMap, stateMap);
+
+        if (ledger->getTransHash () != txMap->getHash ())
+            throw std::runtime_error ("transaction hash mismatch");
+
+        if (ledger->getAccountHash () != stateMap->getHash ())
+            throw std::runtime_error ("account hash mismatch");
+
+        if (journal.info) journal.info <<
+            "Snapshot: loaded ledger " << ledger->getLedgerSeq () <<
+            " (" << ledger->getHash () << ")";
+
+        return ledger;
+    }
+    catch (std::exception const& e)
+    {
+        if (journal.error) journal.error <<
+            "Snapshot: unable to load " << path << ": " << e.what ();
+    }
+
+    return Ledger::pointer ();
+}
+
+} // bessel
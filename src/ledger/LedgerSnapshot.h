@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_APP_LEDGER_LEDGERSNAPSHOT_H_INCLUDED
+#define BESSEL_APP_LEDGER_LEDGERSNAPSHOT_H_INCLUDED
+
+#include <ledger/Ledger.h>
+#include <beast/utility/Journal.h>
+#include <string>
+
+namespace bessel {
+
+/** Binary ledger snapshots.
+
+    A snapshot holds a ledger header followed by the leaves of the ledger's
+    transaction and state maps. Leaves are written in key order and grouped
+    into chunks, each protected by its own checksum. Loading a snapshot
+    rebuilds both maps in parallel and writes their nodes to the node store
+    in batches, which is far faster than parsing a JSON ledger dump.
+
+    File layout, all integers big-endian:
+
+        "BSLSNAP1"      magic
+        u32             format version
+        u32             header length
+        header          as produced by Ledger::addRaw
+        section         transaction map
+        section         state map
+
+    Each section is a u8 leaf node type followed by chunks and terminated by
+    a chunk holding no items. A chunk is:
+
+        u32             item count
+        u32             payload length
+        payload         [key (32)][data length (u32)][data] per item
+        checksum        SHA-512Half of the payload (32)
+*/
+
+/** Write a closed ledger to a snapshot file.
+    @return `true` if the snapshot was written completely.
+*/
+bool writeLedgerSnapshot (Ledger& ledger, std::string const& path,
+    beast::Journal journal);
+
+/** Rebuild a ledger from a snapshot file.
+    The maps are checked against the hashes in the ledger header.
+    @return The closed and accepted ledger, or `nullptr` on failure.
+*/
+Ledger::pointer readLedgerSnapshot (std::string const& path,
+    beast::Journal journal);
+
+} // bessel
+
+#endif
@@ -73,6 +73,15 @@ void addJson (Object&, LedgerFill const&);
 /** Return a new Json::Value representing the ledger with given options.*/
 Json::Value getJson (LedgerFill const&);
 
+/** Write the ledger with given options to an Output as it is visited.
+
+    No Json::Value is built for the ledger as a whole: each transaction and
+    state entry is rendered and written before the next one is read, so
+    memory use does not grow with the size of the ledger. Binary blobs are
+    hex encoded straight from the SHAMap items.
+*/
+void outputJson (LedgerFill const&, Json::Output const&);
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 // Implementations.
@@ -144,11 +153,11 @@ void fillJson (Object& json, LedgerFill const& fill)
                      if (bBinary)
                     {
                         auto&& obj = appendObject (txns);
-                        obj[jss::tx_blob] = strHex (item->peekData ());
+                        obj[jss::tx_blob] = strHex (item->slice ());
                     }
                     else
                     {
-                        SerialIter sit (item->peekSerializer ());
+                        SerialIter sit (item->slice ());
                         STTx txn (sit);
                         txns.append (txn.getJson (0));
                     }
@@ -157,18 +166,17 @@ void fillJson (Object& json, LedgerFill const& fill)
                 {
                     if (bBinary)
                     {
-                        SerialIter sit (item->peekSerializer ());
+                        SerialIter sit (item->slice ());
 
                         auto&& obj = appendObject (txns);
-                        obj[jss::tx_blob] = strHex (sit.getVL ());
-                        obj[jss::meta] = strHex (sit.getVL ());
+                        obj[jss::tx_blob] = strHex (sit.getVLSlice ());
+                        obj[jss::meta] = strHex (sit.getVLSlice ());
                     }
                     else
                     {
-                        SerialIter sit (item->peekSerializer ());
-                        Serializer sTxn (sit.getVL ());
+                        SerialIter sit (item->slice ());
 
-                        SerialIter tsit (sTxn);
+                        SerialIter tsit (sit.getVLSlice ());
                         STTx txn (tsit);
 
                         TransactionMetaSet meta (
@@ -203,11 +211,12 @@ void fillJson (Object& json, LedgerFill const& fill)
              if (bBinary)
              {
                  ledger.peekAccountStateMap()->visitLeaves (
-                     [&array] (std::shared_ptr<SHAMapItem> const& smi)
+                     [&array, &count] (boost::intrusive_ptr<SHAMapItem const> const& smi)
                      {
+                         count.yield();
                          auto&& obj = appendObject (array);
                          obj[jss::hash] = to_string(smi->getTag ());
-                         obj[jss::tx_blob] = strHex(smi->peekData ());
+                         obj[jss::tx_blob] = strHex(smi->slice ());
                      });
              }
              else
@@ -223,7 +232,7 @@ void fillJson (Object& json, LedgerFill const& fill)
         else
         {
             accountStateMap->visitLeaves(
-                [&array, &count] (std::shared_ptr<SHAMapItem> const& smi)
+                [&array, &count] (boost::intrusive_ptr<SHAMapItem const> const& smi)
                 {
                     count.yield();
                     array.append (to_string(smi->getTag ()));
@@ -248,6 +257,14 @@ Json::Value getJson (LedgerFill const& fill)
     return json;
 }
 
+inline
+void outputJson (LedgerFill const& fill, Json::Output const& output)
+{
+    Json::Writer writer (output);
+    Json::Object::Root root (writer);
+    fillJson (root, fill);
+}
+
 } // bessel
 
 #endif
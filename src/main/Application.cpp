@@ -23,6 +23,7 @@
 #include <beast/module/core/thread/DeadlineTimer.h>
 #include <boost/asio/signal_set.hpp>
 #include <fstream>
+#include <iterator>
 #include <cassert>
 #include <main/Application.h>
 #include <main/BasicApp.h>
@@ -39,6 +40,7 @@
 #include <ledger/AcceptedLedger.h>
 #include <ledger/InboundLedgers.h>
 #include <ledger/LedgerMaster.h>
+#include <ledger/LedgerSnapshot.h>
 #include <ledger/OrderBookDB.h>
 #include <common/misc/AmendmentTable.h>
 #include <common/misc/IHashRouter.h>
@@ -51,6 +53,7 @@
 #include <common/base/Sustain.h>
 #include <common/base/seconds_clock.h>
 #include <common/base/make_SSLContext.h>
+#include <common/json/FastReader.h>
 #include <common/json/json_reader.h>
 #include <common/json/to_string.h>
 #include <common/core/LoadFeeTrack.h>
@@ -62,11 +65,13 @@
 #include <network/overlay/make_Overlay.h>
 #include <transaction/tx/InboundTransactions.h>
 #include <transaction/tx/TransactionMaster.h>
+#include <transaction/tx/TxIndex.h>
 #include <services/net/SNTPClient.h>
 #include <services/rpc/Manager.h>
 #include <services/server/make_ServerHandler.h>
 #include <services/websocket/MakeServer.h>
 #include <protocol/STParsedJSON.h>
+#include <crypto/ECDSA.h>
 #include <crypto/RandomNumbers.h>
 #include <consensus/validators/make_Manager.h>
 #include <data/nodestore/backend/RocksDBQuickFactory.h>
@@ -249,6 +254,36 @@ private:
         }
     };
 
+    // Reports the decoded public key cache behind ECDSAVerify
+    class ecdsa_key_cache_stats
+    {
+    private:
+        beast::insight::Hook m_hook;
+        beast::insight::Gauge m_size;
+        beast::insight::Gauge m_hit_rate;
+
+    public:
+        explicit
+        ecdsa_key_cache_stats (beast::insight::Collector::ptr const& collector)
+            : m_size (collector->make_gauge ("ecdsa_key_cache", "size"))
+            , m_hit_rate (collector->make_gauge ("ecdsa_key_cache", "hit_rate"))
+        {
+            m_hook = collector->make_hook (
+                std::bind (&ecdsa_key_cache_stats::collect_metrics, this));
+        }
+
+    private:
+        void
+        collect_metrics ()
+        {
+            auto const stats = getECDSAKeyCacheStats ();
+            auto const total = stats.hits + stats.misses;
+
+            m_size.set (stats.size);
+            m_hit_rate.set (total ? (stats.hits * 100) / total : 0);
+        }
+    };
+
 public:
     Logs& m_logs;
     beast::Journal m_journal;
@@ -260,6 +295,7 @@ public:
     NodeStoreScheduler m_nodeStoreScheduler;
     std::unique_ptr <SHAMapStore> m_shaMapStore;
     std::unique_ptr <NodeStore::Database> m_nodeStore;
+    std::unique_ptr <TxIndex> m_txIndex;
 
     // These are not Stoppable-derived
     NodeCache m_tempNodeCache;
@@ -304,6 +340,7 @@ public:
     std::unique_ptr <ResolverAsio> m_resolver;
 
     io_latency_sampler m_io_latency_sampler;
+    ecdsa_key_cache_stats m_ecdsa_key_cache_stats;
 
     //--------------------------------------------------------------------------
 
@@ -334,6 +371,8 @@ public:
                 m_txMaster, getConfig()))
 
         , m_nodeStore (m_shaMapStore->makeDatabase ("NodeStore.main", 4))
+        , m_txIndex (make_TxIndex (getConfig (), m_nodeStoreScheduler,
+            m_logs.journal ("TxIndex")))
         , m_tempNodeCache ("NodeCache", 16384, 90, get_seconds_clock (),
             m_logs.journal("TaggedCache"))
 
@@ -386,7 +425,7 @@ public:
 
         , m_networkOPs (make_NetworkOPs (get_seconds_clock (),
             getConfig ().RUN_STANDALONE, getConfig ().NETWORK_QUORUM,
-            *m_jobQueue, *m_ledgerMaster, *m_jobQueue,
+            *m_jobQueue, *m_ledgerMaster, *m_jobQueue, *m_collectorManager,
             m_logs.journal("NetworkOPs")))
 
         //  NOTE LocalCredentials starts the deprecated UNL service
@@ -422,6 +461,8 @@ public:
 
         , m_io_latency_sampler (m_collectorManager->collector()->make_event ("ios_latency"),
             m_logs.journal("Application"), std::chrono::milliseconds (100), get_io_service())
+
+        , m_ecdsa_key_cache_stats (m_collectorManager->collector())
     {
         add (m_resourceManager.get ());
 
@@ -528,6 +569,11 @@ public:
         return *m_nodeStore;
     }
 
+    TxIndex* getTxIndex ()
+    {
+        return m_txIndex.get ();
+    }
+
     Application::MutexType& getMasterMutex ()
     {
         return m_masterMutex;
@@ -764,13 +810,15 @@ public:
         }
         else if (startUp == Config::LOAD ||
                  startUp == Config::LOAD_FILE ||
+                 startUp == Config::LOAD_SNAPSHOT ||
                  startUp == Config::REPLAY)
         {
             m_journal.info << "Loading specified Ledger";
 
             if (!loadOldLedger (getConfig ().START_LEDGER,
                                 startUp == Config::REPLAY,
-                                startUp == Config::LOAD_FILE))
+                                startUp == Config::LOAD_FILE,
+                                startUp == Config::LOAD_SNAPSHOT))
             {
                 exitWithCode(-1);
             }
@@ -1055,7 +1103,8 @@ public:
 private:
     void updateTables ();
     void startNewLedger ();
-    bool loadOldLedger (std::string const& ledgerID, bool replay, bool isFilename);
+    bool loadOldLedger (std::string const& ledgerID, bool replay, bool isFilename,
+                        bool isSnapshot);
 
     void onAnnounceAddress ();
 };
@@ -1093,13 +1142,18 @@ void ApplicationImp::startNewLedger ()
     }
 }
 
-bool ApplicationImp::loadOldLedger (std::string const& ledgerID, bool replay, bool isFileName)
+bool ApplicationImp::loadOldLedger (std::string const& ledgerID, bool replay,
+                                    bool isFileName, bool isSnapshot)
 {
     try
     {
         Ledger::pointer loadLedger, replayLedger;
 
-        if (isFileName)
+        if (isSnapshot)
+        {
+            loadLedger = readLedgerSnapshot (ledgerID, m_journal);
+        }
+        else if (isFileName)
         {
             std::ifstream ledgerFile (ledgerID.c_str (), std::ios::in);
             if (!ledgerFile)
@@ -1108,25 +1162,45 @@ bool ApplicationImp::loadOldLedger (std::string const& ledgerID, bool replay, bo
             }
             else
             {
-                 Json::Reader reader;
-                 Json::Value jLedger;
-                 if (!reader.parse (ledgerFile, jLedger)) 
+                 // Ledger dumps can be very large, so the entries are
+                 // converted from the parser's tape straight into
+                 // STObjects. Documents the fast reader declines (comments,
+                 // duplicate keys) are normalized through Json::Reader.
+                 std::string text (
+                     (std::istreambuf_iterator<char> (ledgerFile)),
+                     std::istreambuf_iterator<char> ());
+
+                 Json::FastReader document;
+                 bool parsed = document.parse (std::move (text));
+
+                 if (!parsed)
+                 {
+                     ledgerFile.clear ();
+                     ledgerFile.seekg (0);
+
+                     Json::Reader reader;
+                     Json::Value jLedger;
+                     if (reader.parse (ledgerFile, jLedger))
+                         parsed = document.parse (to_string (jLedger));
+                 }
+
+                 if (!parsed)
                  {
                      m_journal.fatal << "Unable to parse ledger JSON";
                  }
                  else
                  {
-                     std::reference_wrapper<Json::Value> ledger (jLedger);
+                     Json::TapeValue ledger (document.root ());
 
                      // accept a wrapped ledger
-                     if (ledger.get().isMember  ("result"))
+                     if (ledger.isMember  ("result"))
                      {
-                         ledger = ledger.get ()["result"];
+                         ledger = ledger["result"];
                      }
 
-                     if (ledger.get().isMember ("ledger")) 
+                     if (ledger.isMember ("ledger")) 
                      {
-                         ledger = ledger.get ()["ledger"];
+                         ledger = ledger["ledger"];
                      }
 
                      std::uint32_t seq = 1;
@@ -1135,37 +1209,37 @@ bool ApplicationImp::loadOldLedger (std::string const& ledgerID, bool replay, bo
                      bool closeTimeEstimated = false;
                      std::uint64_t totalCoins = 0;
 
-                     if (ledger.get ().isMember ("accountState"))
+                     if (ledger.isMember ("accountState"))
                      {
-                          if (ledger.get ().isMember (jss::ledger_index))
+                          if (ledger.isMember (jss::ledger_index))
                           {
-                              seq = ledger.get ()[jss::ledger_index].asUInt ();
+                              seq = ledger[jss::ledger_index].asUInt ();
                           }
 
-                          if (ledger.get ().isMember ("close_time"))
+                          if (ledger.isMember ("close_time"))
                           {
-                              closeTime = ledger.get ()["close_time"].asUInt ();
+                              closeTime = ledger["close_time"].asUInt ();
                           }
 
-                          if (ledger.get ().isMember ("close_time_resolution"))
+                          if (ledger.isMember ("close_time_resolution"))
                           {
-                              closeTimeResolution = ledger.get ()["close_time_resolution"].asUInt ();
+                              closeTimeResolution = ledger["close_time_resolution"].asUInt ();
                           }
 
-                          if (ledger.get().isMember ("close_time_estimated"))
+                          if (ledger.isMember ("close_time_estimated"))
                           {
-                              closeTimeEstimated = ledger.get ()["close_time_estimated"].asBool ();
+                              closeTimeEstimated = ledger["close_time_estimated"].asBool ();
                           }
 
-                          if (ledger.get ().isMember ("total_coins"))
+                          if (ledger.isMember ("total_coins"))
                           {
-                              totalCoins = boost::lexical_cast<std::uint64_t> (ledger.get ()["total_coins"].asString ());
+                              totalCoins = boost::lexical_cast<std::uint64_t> (ledger["total_coins"].asString ());
                           }
 
-                          ledger = ledger.get ()["accountState"];
+                          ledger = ledger["accountState"];
                      }
 
-                     if (!ledger.get ().isArray ())
+                     if (!ledger.isArray ())
                      {
                          m_journal.fatal << "State nodes must be an array";
                      }
@@ -1174,15 +1248,19 @@ bool ApplicationImp::loadOldLedger (std::string const& ledgerID, bool replay, bo
                          loadLedger = std::make_shared<Ledger> (seq, closeTime);
                          loadLedger->setTotalCoins(totalCoins);
 
-                         for (Json::UInt index = 0; index < ledger.get ().size (); ++index)
+                         for (Json::UInt index = 0; index < ledger.size (); ++index)
                          {
-                             Json::Value& entry = ledger.get ()[index];
+                             Json::TapeValue const entry = ledger[index];
 
                              uint256 uIndex;
                              uIndex.SetHex (entry[jss::index].asString ());
-                             entry.removeMember (jss::index);
 
-                             STParsedJSONObject stp ("sle", ledger.get ()[index]);
+                             STParsedJSONObject stp ("sle", entry);
+
+                             // The index is carried alongside the entry,
+                             // not inside it.
+                             if (stp.object)
+                                 stp.object->delField (sfIndex);
 
                              if (stp.object && (uIndex.isNonZero ()))
                              {
@@ -58,6 +58,7 @@ class Overlay;
 class PathRequests;
 class STLedgerEntry;
 class TransactionMaster;
+class TxIndex;
 class Validations;
 
 class DatabaseCon;
@@ -115,6 +116,9 @@ public:
     virtual PathRequests&           getPathRequests () = 0;
     virtual SHAMapStore&            getSHAMapStore () = 0;
 
+    /** The transaction lookup index, or `nullptr` if [tx_index] is unset. */
+    virtual TxIndex*                getTxIndex () = 0;
+
     virtual DatabaseCon& getTxnDB () = 0;
     virtual DatabaseCon& getLedgerDB () = 0;
 
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <main/ApplyBenchmark.h>
+#include <main/Application.h>
+#include <common/core/Config.h>
+#include <ledger/Ledger.h>
+#include <ledger/LedgerMaster.h>
+#include <protocol/BesselAddress.h>
+#include <protocol/STTx.h>
+#include <transaction/tx/TransactionEngine.h>
+#include <boost/format.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace bessel {
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+// Enough accounts that consecutive payments rarely touch the same entries
+int const accountCount = 500;
+
+struct BenchAccount
+{
+    BesselAddress publicKey;
+    std::uint32_t sequence;
+};
+
+BenchAccount makeAccount (std::string const& passphrase, std::uint32_t sequence)
+{
+    auto const seed = BesselAddress::createSeedGeneric (passphrase);
+    auto const generator = BesselAddress::createGeneratorPublic (seed);
+
+    BenchAccount account;
+    account.publicKey = BesselAddress::createAccountPublic (generator, 0);
+    account.sequence = sequence;
+    return account;
+}
+
+STTx makePayment (BenchAccount& from, BenchAccount const& to,
+    std::uint64_t drops, std::uint64_t fee)
+{
+    STTx txn (ttPAYMENT);
+    txn.setSourceAccount (from.publicKey);
+    txn.setSigningPubKey (from.publicKey);
+    txn.setFieldAccount (sfDestination, to.publicKey.getAccountID ());
+    txn.setFieldAmount (sfAmount, STAmount (drops));
+    txn.setTransactionFee (STAmount (fee));
+    txn.setSequence (from.sequence++);
+    return txn;
+}
+
+double micros (clock_type::duration d)
+{
+    return std::chrono::duration_cast <std::chrono::nanoseconds> (
+        d).count () / 1000.0;
+}
+
+} // namespace
+
+int runApplyBenchmark (int payments, std::ostream& out)
+{
+    if (payments <= 0)
+    {
+        out << "Invalid payment count " << payments << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Ledger::pointer closed = getApp().getLedgerMaster ().getClosedLedger ();
+
+    if (!closed)
+    {
+        out << "No closed ledger to start from" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto ledger = std::make_shared <Ledger> (true, *closed);
+    std::uint64_t const fee = getConfig ().FEE_DEFAULT;
+    std::uint64_t const funding = ledger->getReserve (0) * 10;
+
+    BenchAccount root = makeAccount ("masterpassphrase", 1);
+    std::vector <BenchAccount> accounts;
+    accounts.reserve (accountCount);
+
+    for (int i = 0; i < accountCount; ++i)
+        accounts.push_back (makeAccount ("applybench" + std::to_string (i), 1));
+
+    TransactionEngine engine (ledger);
+
+    // Fund the accounts; this is setup and not part of the measurement
+    for (auto const& account : accounts)
+    {
+        auto const txn = makePayment (root, account, funding, fee);
+        auto const result = engine.applyTransaction (txn, tapNO_CHECK_SIGN);
+
+        if (result.first != tesSUCCESS)
+        {
+            out << "Funding payment failed: " << transToken (result.first) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Build every transaction up front so only the apply is timed
+    std::vector <STTx> txns;
+    txns.reserve (payments);
+
+    for (int i = 0; i < payments; ++i)
+    {
+        auto& from = accounts[i % accountCount];
+        auto const& to = accounts[(i * 7 + 1) % accountCount];
+        txns.push_back (makePayment (from, to, 1000, fee));
+    }
+
+    int failed = 0;
+    auto const start = clock_type::now ();
+
+    for (auto const& txn : txns)
+    {
+        if (engine.applyTransaction (txn, tapNO_CHECK_SIGN).first != tesSUCCESS)
+            ++failed;
+    }
+
+    auto const elapsed = clock_type::now () - start;
+    auto const seconds = micros (elapsed) / 1000000.0;
+
+    out << boost::format ("%d payments between %d accounts\n")
+        % payments % accountCount;
+    out << boost::format ("apply: %.3f s, %.0f tx/s, %.2f us/tx, %d failed\n")
+        % seconds
+        % (seconds > 0 ? payments / seconds : 0.0)
+        % (micros (elapsed) / payments)
+        % failed;
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // bessel
@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_APP_MAIN_APPLYBENCHMARK_H_INCLUDED
+#define BESSEL_APP_MAIN_APPLYBENCHMARK_H_INCLUDED
+
+#include <ostream>
+
+namespace bessel {
+
+/** Transaction apply microbenchmark.
+
+    Funds a set of accounts from the root account of the current closed
+    ledger, then applies the given number of native payments between them
+    through a single TransactionEngine, the way a ledger is built during
+    consensus. Signatures are not checked, so the measurement covers the
+    transactors, the LedgerEntrySet and the ledger writes only.
+
+    Throughput and per-transaction apply time are written to the stream.
+    Nothing is written back to the ledger master.
+
+    The Application must have been set up with a fresh ledger.
+
+    @return EXIT_SUCCESS if every payment applied successfully.
+*/
+int runApplyBenchmark (int payments, std::ostream& out);
+
+} // bessel
+
+#endif
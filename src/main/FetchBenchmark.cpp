@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <main/FetchBenchmark.h>
+#include <common/base/BasicConfig.h>
+#include <common/base/Log.h>
+#include <data/nodestore/DummyScheduler.h>
+#include <data/nodestore/Manager.h>
+#include <protocol/Serializer.h>
+#include <beast/random/xor_shift_engine.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(BEAST_LINUX) || defined(BEAST_MAC) || defined(BEAST_BSD)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace bessel {
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+// Keys handed to each fetchBatch call
+std::size_t const batchSize = 256;
+
+// Write everything out and evict it from the page cache
+bool dropPageCache (boost::filesystem::path const& dir)
+{
+#if defined(POSIX_FADV_DONTNEED)
+    bool dropped = true;
+    for (auto const& entry : boost::filesystem::directory_iterator (dir))
+    {
+        if (!boost::filesystem::is_regular_file (entry.status ()))
+            continue;
+
+        int const fd = ::open (entry.path ().c_str (), O_RDONLY);
+        if (fd < 0)
+        {
+            dropped = false;
+            continue;
+        }
+
+        ::fsync (fd);
+        if (::posix_fadvise (fd, 0, 0, POSIX_FADV_DONTNEED) != 0)
+            dropped = false;
+        ::close (fd);
+    }
+    return dropped;
+#else
+    return false;
+#endif
+}
+
+double seconds (clock_type::duration d)
+{
+    return std::chrono::duration_cast <std::chrono::microseconds> (
+        d).count () / 1000000.0;
+}
+
+} // namespace
+
+int runFetchBenchmark (int objects, std::string const& config,
+    std::ostream& out)
+{
+    if (objects <= 0)
+    {
+        out << "Invalid object count " << objects << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto const dir = boost::filesystem::temp_directory_path () /
+        boost::filesystem::unique_path ("fetchbench-%%%%-%%%%");
+
+    Section params;
+    params.set ("type", "NuDB");
+
+    std::vector <std::string> pairs;
+    boost::split (pairs, config, boost::is_any_of (","));
+    params.append (pairs);
+    params.set ("path", dir.string ());
+
+    NodeStore::DummyScheduler scheduler;
+    auto const journal = deprecatedLogs ().journal ("NodeObject");
+    beast::xor_shift_engine gen (objects);
+    std::vector <uint256> hashes;
+    hashes.reserve (objects);
+
+    clock_type::duration insertElapsed;
+
+    {
+        auto backend = NodeStore::make_Backend (params, scheduler, journal);
+        auto const insertStart = clock_type::now ();
+        std::uniform_int_distribution <std::size_t> sizes (100, 1000);
+        NodeStore::Batch batch;
+        batch.reserve (batchSize);
+
+        for (int i = 0; i < objects; ++i)
+        {
+            Blob data (sizes (gen));
+            for (auto& byte : data)
+                byte = static_cast <unsigned char> (gen ());
+
+            auto const hash = getSHA512Half (data);
+            hashes.push_back (hash);
+            batch.push_back (NodeObject::createObject (
+                hotACCOUNT_NODE, std::move (data), hash));
+
+            if (batch.size () == batchSize)
+            {
+                backend->storeBatch (batch);
+                batch.clear ();
+            }
+        }
+
+        if (!batch.empty ())
+            backend->storeBatch (batch);
+        backend->flush ();
+        backend->close ();
+        insertElapsed = clock_type::now () - insertStart;
+    }
+
+    auto backend = NodeStore::make_Backend (params, scheduler, journal);
+    backend->setDeletePath ();
+
+    std::shuffle (hashes.begin (), hashes.end (), gen);
+    hashes.resize (std::min <std::size_t> (hashes.size (), 100000));
+
+    std::vector <void const*> keys;
+    keys.reserve (hashes.size ());
+    for (auto const& hash : hashes)
+        keys.push_back (hash.begin ());
+
+    if (!dropPageCache (dir))
+        out << "Warning: unable to drop the page cache, results are warm\n";
+
+    std::size_t serialFound = 0;
+    auto start = clock_type::now ();
+    for (auto const key : keys)
+    {
+        NodeObject::Ptr object;
+        if (backend->fetch (key, &object) == NodeStore::ok && object)
+            ++serialFound;
+    }
+    auto const serialElapsed = clock_type::now () - start;
+
+    dropPageCache (dir);
+
+    std::size_t batchFound = 0;
+    start = clock_type::now ();
+    for (std::size_t i = 0; i < keys.size (); i += batchSize)
+    {
+        auto const n = std::min (batchSize, keys.size () - i);
+        for (auto const& object : backend->fetchBatch (n, &keys[i]))
+            if (object)
+                ++batchFound;
+    }
+    auto const batchElapsed = clock_type::now () - start;
+
+    backend->close ();
+
+    auto const report = [&out, &keys] (char const* name,
+        std::size_t found, clock_type::duration elapsed)
+    {
+        auto const s = seconds (elapsed);
+        out << boost::format ("%-10s %8d found  %8.3f s %10.0f fetch/s\n")
+            % name % found % s % (s > 0 ? keys.size () / s : 0.0);
+    };
+
+    out << get<std::string> (params, "type") << ": " << objects <<
+        " objects, " << keys.size () << " cold lookups\n";
+    out << boost::format ("%-10s %8d stored %8.3f s %10.0f store/s\n")
+        % "storeBatch" % objects % seconds (insertElapsed)
+        % (seconds (insertElapsed) > 0 ? objects / seconds (insertElapsed) : 0.0);
+    report ("fetch", serialFound, serialElapsed);
+    report ("fetchBatch", batchFound, batchElapsed);
+
+    return (serialFound == keys.size () && batchFound == keys.size ())
+        ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // bessel
@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_APP_MAIN_FETCHBENCHMARK_H_INCLUDED
+#define BESSEL_APP_MAIN_FETCHBENCHMARK_H_INCLUDED
+
+#include <ostream>
+#include <string>
+
+namespace bessel {
+
+/** Node store fetch benchmark on a cold page cache.
+
+    Fills a scratch backend with the given number of random node objects,
+    reopens it, and then looks up a random sample of them twice: once with
+    one Backend::fetch per key and once with Backend::fetchBatch. The
+    operating system's cached pages for the database files are dropped
+    before each pass, so every lookup goes to the device. Insert and fetch
+    rates are written to the stream.
+
+    The backend is described by comma separated key=value pairs, as in
+    the [node_db] section; the type defaults to NuDB and the path is
+    always a scratch directory, deleted afterwards.
+
+    Needs no Application.
+
+    @return EXIT_SUCCESS if both passes found every object.
+*/
+int runFetchBenchmark (int objects, std::string const& config,
+    std::ostream& out);
+
+} // bessel
+
+#endif
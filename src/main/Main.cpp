@@ -21,11 +21,21 @@
 #include <beast/chrono/basic_seconds_clock.h>
 #include <beast/unit_test.h>
 #include <google/protobuf/stubs/common.h>
+#include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
 #include <cstdlib>
 #include <thread>
 #include <utility>
 #include <main/Application.h>
+#include <main/ApplyBenchmark.h>
+#include <main/FetchBenchmark.h>
+#include <main/NuDBTool.h>
+#include <main/PathBenchmark.h>
+#include <main/ReplayBenchmark.h>
+#include <main/TreeBenchmark.h>
+#include <main/TxIndexRebuild.h>
+#include <ledger/LedgerMaster.h>
+#include <ledger/LedgerSnapshot.h>
 #include <common/base/Log.h>
 #include <common/base/CheckLibraryVersions.h>
 #include <common/base/StringUtilities.h>
@@ -226,6 +236,122 @@ static int runUnitTests (std::string const& pattern,
     return EXIT_SUCCESS;
 }
 
+// Parse a ledger range of the form <first>[:<last>]
+static bool parseLedgerRange (std::string const& range,
+    std::uint32_t& firstSeq, std::uint32_t& lastSeq)
+{
+    try
+    {
+        auto const colon = range.find (':');
+        firstSeq = boost::lexical_cast <std::uint32_t> (range.substr (0, colon));
+        lastSeq = (colon == std::string::npos) ? firstSeq :
+            boost::lexical_cast <std::uint32_t> (range.substr (colon + 1));
+    }
+    catch (boost::bad_lexical_cast const&)
+    {
+        std::cerr << "Invalid ledger range '" << range << "'" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Keep the server off the network, without ledger history
+static void setStandalone ()
+{
+    getConfig ().RUN_STANDALONE = true;
+    getConfig ().LEDGER_HISTORY = 0;
+}
+
+// Creates the Application for a mode that only works on ledgers it loads
+// or builds itself, so it never talks to the network.
+static std::unique_ptr<Application> makeOfflineApplication ()
+{
+    setStandalone ();
+
+    std::unique_ptr<Application> app (make_Application (deprecatedLogs ()));
+    setupServer ();
+
+    return app;
+}
+
+static int doReplayBenchmark (std::string const& range)
+{
+    std::uint32_t firstSeq, lastSeq;
+
+    if (!parseLedgerRange (range, firstSeq, lastSeq))
+        return EXIT_FAILURE;
+
+    auto const app = makeOfflineApplication ();
+
+    return runReplayBenchmark (firstSeq, lastSeq, std::cout);
+}
+
+static int doTxIndexRebuild (std::string const& range)
+{
+    std::uint32_t firstSeq, lastSeq;
+
+    if (!parseLedgerRange (range, firstSeq, lastSeq))
+        return EXIT_FAILURE;
+
+    // Only stored ledgers are read
+    auto const app = makeOfflineApplication ();
+
+    return runTxIndexRebuild (firstSeq, lastSeq, std::cout);
+}
+
+static int doTreeBenchmark (int items)
+{
+    // The map goes to a scratch node store of its own; no Application needed
+    return runTreeBenchmark (items, std::cout);
+}
+
+static int doApplyBenchmark (int payments)
+{
+    // Payments are applied to a fresh genesis ledger
+    getConfig ().START_UP = Config::FRESH;
+
+    auto const app = makeOfflineApplication ();
+
+    return runApplyBenchmark (payments, std::cout);
+}
+
+static int doPathBenchmark (int payments)
+{
+    // The paths are built in a copy of a fresh genesis ledger
+    getConfig ().START_UP = Config::FRESH;
+
+    auto const app = makeOfflineApplication ();
+
+    return runPathBenchmark (payments, std::cout);
+}
+
+static int doExportSnapshot (std::string const& path)
+{
+    auto const startUp = getConfig ().START_UP;
+    if (startUp != Config::LOAD &&
+        startUp != Config::LOAD_FILE &&
+        startUp != Config::LOAD_SNAPSHOT)
+    {
+        std::cerr << "Specify the ledger to export with --ledger, --ledgerfile, "
+            "--snapshot or --load" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Only the loaded ledger is needed
+    auto const app = makeOfflineApplication ();
+
+    auto const ledger = getApp ().getLedgerMaster ().getClosedLedger ();
+    if (!ledger || !writeLedgerSnapshot (*ledger, path,
+            deprecatedLogs ().journal ("Ledger")))
+    {
+        std::cerr << "Unable to write snapshot " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
 //------------------------------------------------------------------------------
 
 int run (int argc, char** argv)
@@ -271,8 +397,20 @@ int run (int argc, char** argv)
     ("verbose,v"    , "Verbose logging.")
     ("load"         , "Load the current ledger from the local DB.")
     ("replay"       ,"Replay a ledger close.")
+    ("applybench"   , po::value <int> ()->implicit_value (20000), "Benchmark applying the given number of payments to a fresh ledger.")
+    ("fetchbench"   , po::value <int> ()->implicit_value (1000000), "Benchmark cold node store fetches, one at a time and batched.")
+    ("fetchbench-arg", po::value <std::string> ()->implicit_value (""), "Node store options for fetchbench, as key=value pairs separated by commas.")
+    ("pathbench"    , po::value <int> ()->implicit_value (2000), "Benchmark multi-hop, multi-path payments through the payment engine.")
+    ("replaybench"  , po::value<std::string> (), "Replay stored ledgers offline and report apply timings. Format: <first>[:<last>]")
+    ("treebench"    , po::value <int> ()->implicit_value (200000), "Benchmark concurrent lookups in a SHAMap of the given size.")
+    ("nudb-rekey"   , po::value<std::string> ()->implicit_value (""), "Rebuild the NuDB key file from its data file. Defaults to the [node_db] path.")
+    ("nudb-verify"  , po::value<std::string> ()->implicit_value (""), "Verify the NuDB key and data files in parallel. Defaults to the [node_db] path.")
+    ("nudb-arg"     , po::value<std::string> ()->implicit_value (""), "Options for nudb-rekey and nudb-verify, as key=value pairs separated by commas.")
+    ("txindex-rebuild", po::value<std::string> (), "Rebuild the [tx_index] transaction lookup index from stored ledgers. Format: <first>[:<last>]")
     ("ledger"       , po::value<std::string> (), "Load the specified ledger and start from .")
     ("ledgerfile"   , po::value<std::string> (), "Load the specified ledger file.")
+    ("snapshot"     , po::value<std::string> (), "Load the specified binary ledger snapshot.")
+    ("exportsnapshot", po::value<std::string> (), "Write the loaded ledger to a binary snapshot and exit. Use with --ledger, --ledgerfile, --snapshot or --load.")
     ("start"        , "Start from a fresh Ledger.")
     ("net"          , "Get the initial ledger from the network.")
     ("fg"           , "Run in the foreground.")
@@ -349,6 +487,15 @@ int run (int argc, char** argv)
         && !vm.count ("fg")
         && !vm.count ("standalone")
         && !vm.count ("shutdowntest")
+        && !vm.count ("replaybench")
+        && !vm.count ("treebench")
+        && !vm.count ("applybench")
+        && !vm.count ("pathbench")
+        && !vm.count ("fetchbench")
+        && !vm.count ("nudb-rekey")
+        && !vm.count ("nudb-verify")
+        && !vm.count ("txindex-rebuild")
+        && !vm.count ("exportsnapshot")
         && !vm.count ("unittest"))
     {
         std::string logMe = DoSustain (getConfig ().getDebugLogFile ().string ());
@@ -387,6 +534,18 @@ int run (int argc, char** argv)
         return runUnitTests (vm["unittest"].as<std::string>(), argument);
     }
 
+    if (vm.count ("fetchbench"))
+    {
+        std::string argument;
+
+        if (vm.count ("fetchbench-arg"))
+        {
+            argument = vm["fetchbench-arg"].as<std::string> ();
+        }
+
+        return runFetchBenchmark (vm["fetchbench"].as<int> (), argument, std::cout);
+    }
+
     if (!iResult)
     {
         auto configFile = vm.count ("conf") ? vm["conf"].as<std::string> () : std::string();
@@ -395,15 +554,33 @@ int run (int argc, char** argv)
         getConfig ().setup (configFile, bool (vm.count ("quiet")));
 
         if (vm.count ("standalone"))
-        {
-            getConfig ().RUN_STANDALONE = true;
-            getConfig ().LEDGER_HISTORY = 0;
-        }
+            setStandalone ();
 
         // Use any previously available entropy to stir the pool
         stir_entropy (getEntropyFile ().string ());
     }
 
+    if (!iResult && (vm.count ("nudb-rekey") || vm.count ("nudb-verify")))
+    {
+        std::string const operation = vm.count ("nudb-rekey") ? "rekey" : "verify";
+        auto path = vm["nudb-" + operation].as<std::string> ();
+
+        if (path.empty ())
+        {
+            path = get<std::string> (getConfig ().section (
+                ConfigSection::nodeDatabase ()), "path");
+        }
+
+        std::string argument;
+
+        if (vm.count ("nudb-arg"))
+        {
+            argument = vm["nudb-arg"].as<std::string> ();
+        }
+
+        return runNuDBTool (operation, path, argument, std::cout);
+    }
+
     if (vm.count ("start")) getConfig ().START_UP = Config::FRESH;
 
     // Handle a one-time import option
@@ -431,6 +608,12 @@ int run (int argc, char** argv)
 
         getConfig ().START_UP = Config::LOAD_FILE;
     }
+    else if (vm.count ("snapshot"))
+    {
+        getConfig ().START_LEDGER = vm["snapshot"].as<std::string> ();
+
+        getConfig ().START_UP = Config::LOAD_SNAPSHOT;
+    }
     else if (vm.count ("load"))
     {
         getConfig ().START_UP = Config::LOAD;
@@ -497,6 +680,36 @@ int run (int argc, char** argv)
         return runShutdownTests ();
     }
 
+    if (iResult == 0 && vm.count ("replaybench"))
+    {
+        return doReplayBenchmark (vm["replaybench"].as<std::string> ());
+    }
+
+    if (iResult == 0 && vm.count ("txindex-rebuild"))
+    {
+        return doTxIndexRebuild (vm["txindex-rebuild"].as<std::string> ());
+    }
+
+    if (iResult == 0 && vm.count ("treebench"))
+    {
+        return doTreeBenchmark (vm["treebench"].as<int> ());
+    }
+
+    if (iResult == 0 && vm.count ("applybench"))
+    {
+        return doApplyBenchmark (vm["applybench"].as<int> ());
+    }
+
+    if (iResult == 0 && vm.count ("pathbench"))
+    {
+        return doPathBenchmark (vm["pathbench"].as<int> ());
+    }
+
+    if (iResult == 0 && vm.count ("exportsnapshot"))
+    {
+        return doExportSnapshot (vm["exportsnapshot"].as<std::string> ());
+    }
+
     if (iResult == 0)
     {
         if (!vm.count ("parameters"))
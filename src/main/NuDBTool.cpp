@@ -0,0 +1,238 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <main/NuDBTool.h>
+#include <common/base/BasicConfig.h>
+#include <beast/hash/xxhasher.h>
+#include <beast/nudb.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bessel {
+
+namespace {
+
+// Must match the hasher of NuDBBackend
+typedef beast::xxhasher hasher;
+
+typedef std::chrono::steady_clock clock_type;
+
+double seconds (clock_type::duration d)
+{
+    return std::chrono::duration_cast <std::chrono::milliseconds> (
+        d).count () / 1000.0;
+}
+
+// Writes the fraction of work done, at most every few seconds
+class Progress
+{
+public:
+    Progress (std::string const& name, std::ostream& out)
+        : name_ (name)
+        , out_ (out)
+        , start_ (clock_type::now ())
+        , report_ (start_)
+    {
+    }
+
+    void operator() (std::size_t work, std::size_t total)
+    {
+        auto const now = clock_type::now ();
+        if (now - report_ < std::chrono::seconds (5) || total == 0)
+            return;
+        report_ = now;
+
+        auto const elapsed = seconds (now - start_);
+        auto const done = double (work) / total;
+        out_ << boost::format ("%s: %5.1f%% done, %.0f s elapsed")
+            % name_ % (done * 100) % elapsed;
+        if (done > 0)
+            out_ << boost::format (", about %.0f s left")
+                % (elapsed / done - elapsed);
+        out_ << std::endl;
+    }
+
+    double elapsed () const
+    {
+        return seconds (clock_type::now () - start_);
+    }
+
+private:
+    std::string const name_;
+    std::ostream& out_;
+    clock_type::time_point const start_;
+    clock_type::time_point report_;
+};
+
+void print (beast::nudb::verify_info const& info, std::ostream& out)
+{
+    out << boost::format (
+        "values:      %d (%d bytes)\n"
+        "keys:        %d in %d buckets of %d\n"
+        "block_size:  %d\n"
+        "load:        %.1f%% actual, %.1f%% target\n"
+        "spills:      %d used of %d (%d bytes used of %d)\n"
+        "avg_fetch:   %.3f\n"
+        "waste:       %.3f%%\n"
+        "overhead:    %.1f%%\n"
+        "key_file:    %d bytes\n"
+        "dat_file:    %d bytes\n")
+        % info.value_count % info.value_bytes
+        % info.key_count % info.buckets % info.capacity
+        % info.block_size
+        % (info.actual_load * 100) % (info.load_factor * 100)
+        % info.spill_count % info.spill_count_tot
+        % info.spill_bytes % info.spill_bytes_tot
+        % info.avg_fetch
+        % (info.waste * 100)
+        % (info.overhead * 100)
+        % info.key_file_size
+        % info.dat_file_size;
+
+    std::string hist;
+    for (auto const n : info.hist)
+        hist += (hist.empty () ? "" : ", ") + std::to_string (n);
+    out << "spill hist:  " << hist << std::endl;
+}
+
+int doVerify (std::string const& dp, std::string const& kp,
+    std::size_t bufferSize, std::size_t threads, std::ostream& out)
+{
+    Progress progress ("verify", out);
+    auto const info = beast::nudb::verify_parallel <hasher> (
+        dp, kp, bufferSize, threads, progress);
+    out << boost::format ("Verified in %.1f s using %d threads\n")
+        % progress.elapsed () % threads;
+    print (info, out);
+    return EXIT_SUCCESS;
+}
+
+int doRekey (std::string const& dp, std::string const& kp,
+    std::string const& lp, Section const& params,
+    std::size_t bufferSize, std::size_t threads, std::ostream& out)
+{
+    namespace fs = boost::filesystem;
+
+    if (fs::exists (lp))
+    {
+        out << "Log file " << lp << " exists. Open the database once "
+            "so it can recover, then try again." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto const blockSize = get <std::size_t> (params, "block_size",
+        beast::nudb::block_size (kp));
+    auto const loadFactor = get <float> (params, "load_factor", 0.5f);
+    auto const items = get <std::size_t> (params, "items", 0);
+
+    std::string const old = kp + ".old";
+    if (fs::exists (kp))
+    {
+        if (fs::exists (old))
+        {
+            out << "Remove or rename " << old << " first." << std::endl;
+            return EXIT_FAILURE;
+        }
+        fs::rename (kp, old);
+        out << "Existing key file kept as " << old << std::endl;
+    }
+
+    Progress progress ("rekey", out);
+    try
+    {
+        if (! beast::nudb::rekey <hasher> (dp, kp, lp, blockSize,
+            loadFactor, items, bufferSize, threads, progress))
+        {
+            out << "Unable to open " << dp << std::endl;
+            if (fs::exists (old))
+                fs::rename (old, kp);
+            return EXIT_FAILURE;
+        }
+    }
+    catch (std::exception const& e)
+    {
+        out << "Rekey failed: " << e.what () << std::endl;
+
+        // Remove the spill records written so far and
+        // put the previous key file back.
+        if (fs::exists (lp))
+            beast::nudb::recover <hasher, beast::nudb::identity> (
+                dp, kp, lp, bufferSize);
+        fs::remove (kp);
+        if (fs::exists (old))
+            fs::rename (old, kp);
+        return EXIT_FAILURE;
+    }
+
+    out << boost::format ("Rebuilt %s in %.1f s using %d threads\n")
+        % kp % progress.elapsed () % threads;
+    return doVerify (dp, kp, bufferSize, threads, out);
+}
+
+} // namespace
+
+int runNuDBTool (std::string const& operation, std::string const& path,
+    std::string const& options, std::ostream& out)
+{
+    if (path.empty ())
+    {
+        out << "No NuDB path given and none in [node_db]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Section params;
+    std::vector <std::string> pairs;
+    boost::split (pairs, options, boost::is_any_of (","));
+    params.append (pairs);
+
+    auto const threads = std::max <std::size_t> (1, get <std::size_t> (
+        params, "threads", std::thread::hardware_concurrency ()));
+    auto const bufferSize = std::max <std::size_t> (1, get <std::size_t> (
+        params, "buffer", 256)) * 1024 * 1024;
+
+    auto const folder = boost::filesystem::path (path);
+    auto const dp = (folder / "nudb.dat").string ();
+    auto const kp = (folder / "nudb.key").string ();
+    auto const lp = (folder / "nudb.log").string ();
+
+    try
+    {
+        if (operation == "rekey")
+            return doRekey (dp, kp, lp, params, bufferSize, threads, out);
+        if (operation == "verify")
+            return doVerify (dp, kp, bufferSize, threads, out);
+        out << "Unknown NuDB operation " << operation << std::endl;
+    }
+    catch (std::exception const& e)
+    {
+        out << operation << " failed: " << e.what () << std::endl;
+    }
+    return EXIT_FAILURE;
+}
+
+} // bessel
@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BESSEL_APP_MAIN_NUDBTOOL_H_INCLUDED
+#define BESSEL_APP_MAIN_NUDBTOOL_H_INCLUDED
+
+#include <ostream>
+#include <string>
+
+namespace bessel {
+
+/** Offline maintenance of a NuDB node store.
+
+    The database is the nudb.dat, nudb.key and nudb.log files in the
+    given directory, which is the path from the [node_db] section. The
+    server must not be running against it.
+
+    "rekey" builds a new key file from the data file. Any existing key
+    file is kept as nudb.key.old. "verify" checks the key and data files
+    against each other and writes the database statistics.
+
+    Options are comma separated key=value pairs:
+        threads=<n>         Worker threads, default one per core
+        buffer=<mb>         Memory for key file buckets, default 256
+        block_size=<bytes>  Key file block size for rekey
+        load_factor=<f>     Target bucket fill for rekey, default 0.5
+        items=<n>           Expected records for rekey, default counted
+
+    Progress is written to the stream while the operation runs.
+
+    Needs no Application.
+
+    @return EXIT_SUCCESS if the operation completed.
+*/
+int runNuDBTool (std::string const& operation, std::string const& path,
+    std::string const& options, std::ostream& out);
+
+} // bessel
+
+#endif
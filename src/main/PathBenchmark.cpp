@@ -0,0 +1,232 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <main/PathBenchmark.h>
+#include <main/Application.h>
+#include <ledger/Ledger.h>
+#include <ledger/LedgerEntrySet.h>
+#include <ledger/LedgerMaster.h>
+#include <protocol/BesselAddress.h>
+#include <protocol/Indexes.h>
+#include <protocol/STPathSet.h>
+#include <protocol/Serializer.h>
+#include <transaction/paths/BesselCalc.h>
+#include <boost/format.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace bessel {
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+// As many paths as a payment may carry, each with a few accounts to ripple
+// through between the source and the destination
+int const pathCount = 6;
+int const hopCount = 4;
+
+Account makeAccount (std::string const& passphrase)
+{
+    auto const seed = BesselAddress::createSeedGeneric (passphrase);
+    auto const generator = BesselAddress::createGeneratorPublic (seed);
+    return BesselAddress::createAccountPublic (generator, 0).getAccountID ();
+}
+
+SLE::pointer makeAccountRoot (Account const& account, std::uint64_t drops)
+{
+    auto sle = std::make_shared<SLE> (
+        ltACCOUNT_ROOT, getAccountRootIndex (account));
+    sle->setFieldAccount (sfAccount, account);
+    sle->setFieldAmount (sfBalance, STAmount (drops));
+    sle->setFieldU32 (sfSequence, 1);
+    return sle;
+}
+
+// A trust line on which the holder accepts up to limit of the issuer's IOUs
+SLE::pointer makeTrustLine (Account const& issuer, Account const& holder,
+    Currency const& currency, int limit)
+{
+    bool const holderHigh = issuer < holder;
+    Account const& low = holderHigh ? issuer : holder;
+    Account const& high = holderHigh ? holder : issuer;
+
+    auto sle = std::make_shared<SLE> (
+        ltBESSEL_STATE, getBesselStateIndex (low, high, currency));
+    sle->setFieldAmount (sfBalance, STAmount ({currency, noAccount ()}));
+    sle->setFieldAmount (sfLowLimit,
+        STAmount ({currency, low}, holderHigh ? 0 : limit));
+    sle->setFieldAmount (sfHighLimit,
+        STAmount ({currency, high}, holderHigh ? limit : 0));
+    return sle;
+}
+
+// Digest of every entry the set would write, in order
+uint256 digest (LedgerEntrySet& les)
+{
+    Serializer s;
+
+    for (auto const& item : les)
+    {
+        s.add256 (item.first);
+        s.add8 (static_cast<unsigned char> (item.second.mAction));
+        item.second.mEntry->add (s);
+    }
+
+    return s.getSHA512Half ();
+}
+
+double micros (clock_type::duration d)
+{
+    return std::chrono::duration_cast <std::chrono::nanoseconds> (
+        d).count () / 1000.0;
+}
+
+} // namespace
+
+int runPathBenchmark (int payments, std::ostream& out)
+{
+    if (payments <= 0)
+    {
+        out << "Invalid payment count " << payments << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Ledger::pointer closed = getApp().getLedgerMaster ().getClosedLedger ();
+
+    if (!closed)
+    {
+        out << "No closed ledger to start from" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto ledger = std::make_shared <Ledger> (true, *closed);
+    std::uint64_t const funding = ledger->getReserve (2) * 10;
+    Currency const currency = to_currency ("USD");
+
+    Account const source = makeAccount ("pathbench.source");
+    Account const destination = makeAccount ("pathbench.destination");
+
+    ledger->writeBack (lepCREATE, makeAccountRoot (source, funding));
+    ledger->writeBack (lepCREATE, makeAccountRoot (destination, funding));
+
+    // Each path has less room than the last, so a payment drains them one
+    // pass at a time
+    STPathSet paths;
+    int capacity = 0;
+
+    for (int p = 0; p < pathCount; ++p)
+    {
+        int const limit = 1000 * (pathCount - p);
+        Account previous = source;
+        STPath path;
+
+        for (int h = 0; h < hopCount; ++h)
+        {
+            Account const hop = makeAccount (
+                "pathbench." + std::to_string (p) + "." + std::to_string (h));
+
+            ledger->writeBack (lepCREATE, makeAccountRoot (hop, funding));
+            ledger->writeBack (lepCREATE,
+                makeTrustLine (previous, hop, currency, limit));
+
+            path.emplace_back (hop, xrpCurrency (), xrpAccount ());
+            previous = hop;
+        }
+
+        ledger->writeBack (lepCREATE,
+            makeTrustLine (previous, destination, currency, limit));
+
+        paths.push_back (path);
+        capacity += limit;
+    }
+
+    // Leave part of the last path unused
+    STAmount const deliver ({currency, destination}, capacity - 500);
+    STAmount const maxSpend ({currency, source}, capacity);
+
+    path::BesselCalc::Input input;
+    input.defaultPathsAllowed = false;
+    input.isLedgerOpen = false;
+
+    auto const pay = [&](LedgerEntrySet& les) -> path::BesselCalc::Output
+    {
+        ScopedDeferCredits g (les);
+        return path::BesselCalc::besselCalculate (
+            les, maxSpend, deliver, destination, source, paths, &input);
+    };
+
+    out << boost::format ("%d payments over %d paths of %d hops\n")
+        % payments % pathCount % (hopCount + 1);
+
+    bool ok = true;
+    uint256 serialState;
+
+    for (bool const parallel : {false, true})
+    {
+        input.parallelPaths = parallel;
+
+        // One untimed payment provides the amounts and the state to report
+        LedgerEntrySet first (ledger, tapNONE);
+        auto const expected = pay (first);
+        auto const state = digest (first);
+
+        int failed = 0;
+        auto const start = clock_type::now ();
+
+        for (int i = 0; i < payments; ++i)
+        {
+            LedgerEntrySet les (ledger, tapNONE);
+
+            if (pay (les).result () != tesSUCCESS)
+                ++failed;
+        }
+
+        auto const elapsed = clock_type::now () - start;
+        auto const seconds = micros (elapsed) / 1000000.0;
+
+        out << boost::format ("%s: %.3f s, %.2f us/payment, %d failed\n")
+            % (parallel ? "parallel" : "serial")
+            % seconds
+            % (micros (elapsed) / payments)
+            % failed;
+        out << boost::format ("%s: delivered %s for %s, state %s\n")
+            % transToken (expected.result ())
+            % expected.actualAmountOut.getFullText ()
+            % expected.actualAmountIn.getFullText ()
+            % to_string (state);
+
+        if (!parallel)
+            serialState = state;
+        else if (state != serialState)
+            out << "Parallel evaluation changed the result" << std::endl;
+
+        ok = ok && failed == 0 && expected.result () == tesSUCCESS &&
+            state == serialState;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // bessel
@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_APP_MAIN_PATHBENCHMARK_H_INCLUDED
+#define BESSEL_APP_MAIN_PATHBENCHMARK_H_INCLUDED
+
+#include <ostream>
+
+namespace bessel {
+
+/** Payment engine microbenchmark.
+
+    Builds a fan of parallel multi-hop trust line paths between two
+    accounts in a copy of the current closed ledger, then runs the given
+    number of cross-currency payments through BesselCalc, each in a fresh
+    LedgerEntrySet. The amount needs every path, so each payment takes
+    several passes and tries every remaining path on each one.
+
+    The payments are run once with the paths of each pass evaluated one
+    after another and once with them evaluated concurrently. Time per
+    payment is written to the stream, together with the amounts delivered
+    and a digest of the resulting ledger entries, so that the two modes and
+    runs of different builds can be checked for identical results.
+
+    The Application must have been set up with a fresh ledger.
+
+    @return EXIT_SUCCESS if every payment succeeded and both modes agree.
+*/
+int runPathBenchmark (int payments, std::ostream& out);
+
+} // bessel
+
+#endif
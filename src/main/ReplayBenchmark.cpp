@@ -0,0 +1,277 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <main/ReplayBenchmark.h>
+#include <main/Application.h>
+#include <common/base/Log.h>
+#include <common/base/seconds_clock.h>
+#include <common/shamap/Family.h>
+#include <common/shamap/SHAMapMissingNode.h>
+#include <data/nodestore/Database.h>
+#include <ledger/InboundLedger.h>
+#include <ledger/Ledger.h>
+#include <protocol/TxFormats.h>
+#include <transaction/tx/TransactionEngine.h>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+namespace bessel {
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+struct TypeStats
+{
+    std::uint64_t count = 0;
+    std::uint64_t failed = 0;
+    clock_type::duration elapsed = clock_type::duration::zero ();
+};
+
+struct CacheCounters
+{
+    std::uint64_t sleHits;
+    std::uint64_t sleMisses;
+    std::uint64_t storeFetches;
+    std::uint64_t storeHits;
+
+    static CacheCounters sample ()
+    {
+        CacheCounters c;
+        c.sleHits = getApp().getSLECache ().getHits ();
+        c.sleMisses = getApp().getSLECache ().getMisses ();
+        c.storeFetches = getApp().getNodeStore ().getFetchTotalCount ();
+        c.storeHits = getApp().getNodeStore ().getFetchHitCount ();
+        return c;
+    }
+};
+
+double percent (std::uint64_t part, std::uint64_t total)
+{
+    return (total == 0) ? 0.0 : (100.0 * part) / total;
+}
+
+double millis (clock_type::duration d)
+{
+    return std::chrono::duration_cast <std::chrono::microseconds> (
+        d).count () / 1000.0;
+}
+
+std::string typeName (TxType type)
+{
+    auto const item = TxFormats::getInstance ().findByType (type);
+    return item ? item->getName () : std::to_string (type);
+}
+
+Ledger::pointer loadLedger (uint256 const& hash)
+{
+    Ledger::pointer ledger = Ledger::loadByHash (hash);
+
+    if (!ledger)
+    {
+        // Try to build the ledger from the node store
+        auto il = std::make_shared <InboundLedger> (hash, 0,
+            InboundLedger::fcGENERIC, get_seconds_clock ());
+        if (il->checkLocal ())
+            ledger = il->getLedger ();
+    }
+
+    return ledger;
+}
+
+// The transactions of a stored ledger in the order they were applied
+std::vector <STTx::pointer> getOrderedTransactions (Ledger const& ledger)
+{
+    std::vector <std::pair <std::uint32_t, STTx::pointer>> ordered;
+    auto const& txMap = ledger.peekTransactionMap ();
+    SHAMapTreeNode::TNType type;
+
+    for (auto item = txMap->peekFirstItem (type); item;
+         item = txMap->peekNextItem (item->getTag (), type))
+    {
+        TransactionMetaSet::pointer meta;
+        STTx::pointer txn = ledger.getSMTransaction (item, type, meta);
+
+        if (!txn || !meta)
+            throw std::runtime_error ("transaction without metadata");
+
+        ordered.emplace_back (meta->getIndex (), txn);
+    }
+
+    std::sort (ordered.begin (), ordered.end (),
+        [] (std::pair <std::uint32_t, STTx::pointer> const& a,
+            std::pair <std::uint32_t, STTx::pointer> const& b)
+        {
+            return a.first < b.first;
+        });
+
+    std::vector <STTx::pointer> result;
+    result.reserve (ordered.size ());
+    for (auto& entry : ordered)
+        result.push_back (std::move (entry.second));
+    return result;
+}
+
+} // namespace
+
+int runReplayBenchmark (std::uint32_t firstSeq, std::uint32_t lastSeq,
+    std::ostream& out)
+{
+    if (firstSeq < 2 || lastSeq < firstSeq)
+    {
+        out << "Invalid ledger range " << firstSeq << "-" << lastSeq << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::map <TxType, TypeStats> typeStats;
+    clock_type::duration totalElapsed = clock_type::duration::zero ();
+    std::uint64_t totalTxns = 0;
+    std::uint32_t mismatches = 0;
+
+    try
+    {
+        Ledger::pointer stored = Ledger::loadByIndex (firstSeq);
+        Ledger::pointer parent = stored ? loadLedger (stored->getParentHash ()) : Ledger::pointer ();
+
+        if (!parent)
+        {
+            out << "Unable to load the parent of ledger " << firstSeq << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        out << boost::format ("%8s %6s %10s %9s %8s %8s %9s %8s  %s\n")
+            % "ledger" % "txns" % "apply ms" % "sle get" % "sle hit" %
+                "tree hit" % "ns fetch" % "ns hit" % "result";
+
+        // Stop at the end of the body: seq <= lastSeq always holds when
+        // lastSeq is the largest sequence number
+        for (std::uint32_t seq = firstSeq; ; ++seq)
+        {
+            if (!stored)
+                stored = loadLedger (Ledger::getHashByIndex (seq));
+
+            if (!stored || (stored->getParentHash () != parent->getHash ()))
+            {
+                out << "Ledger " << seq << " is missing or not a child of "
+                    << parent->getLedgerSeq () << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            // Decoding the stored transactions is not part of the measurement
+            auto const txns = getOrderedTransactions (*stored);
+
+            auto ledger = std::make_shared <Ledger> (false, *parent);
+            ledger->setCloseTime (stored->getCloseTimeNC ());
+
+            getApp().family ().treecache ().clearStats ();
+            auto const before = CacheCounters::sample ();
+            clock_type::duration elapsed = clock_type::duration::zero ();
+
+            {
+                TransactionEngine engine (ledger);
+
+                for (auto const& txn : txns)
+                {
+                    auto const start = clock_type::now ();
+                    auto const result = engine.applyTransaction (
+                        *txn, tapNO_CHECK_SIGN);
+                    auto const took = clock_type::now () - start;
+
+                    auto& stats = typeStats[txn->getTxnType ()];
+                    ++stats.count;
+                    stats.elapsed += took;
+                    if (!result.second)
+                        ++stats.failed;
+
+                    elapsed += took;
+                }
+            }
+
+            auto const after = CacheCounters::sample ();
+            float const treeHitRate = getApp().family ().treecache ().getHitRate ();
+
+            ledger->updateSkipList ();
+            ledger->setClosed ();
+            ledger->setAccepted (stored->getCloseTimeNC (),
+                stored->getCloseResolution (), stored->getCloseAgree ());
+
+            bool const match =
+                ledger->getAccountHash () == stored->getAccountHash ();
+            if (!match)
+                ++mismatches;
+
+            auto const sleHits = after.sleHits - before.sleHits;
+            auto const sleFetches = sleHits + (after.sleMisses - before.sleMisses);
+            auto const storeFetches = after.storeFetches - before.storeFetches;
+
+            out << boost::format ("%8u %6u %10.3f %9u %7.1f%% %7.1f%% %9u %7.1f%%  %s\n")
+                % seq % txns.size () % millis (elapsed) % sleFetches %
+                    percent (sleHits, sleFetches) % treeHitRate % storeFetches %
+                    percent (after.storeHits - before.storeHits, storeFetches) %
+                    (match ? "ok" : "ACCOUNT HASH MISMATCH");
+
+            totalElapsed += elapsed;
+            totalTxns += txns.size ();
+
+            parent = stored;
+            stored.reset ();
+
+            if (seq == lastSeq)
+                break;
+        }
+    }
+    catch (SHAMapMissingNode const& e)
+    {
+        out << "Missing node while replaying: " << e << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (std::exception const& e)
+    {
+        out << "Replay failed: " << e.what () << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    out << "\n" << boost::format ("%-24s %8s %8s %12s %10s\n")
+        % "transaction type" % "count" % "failed" % "total ms" % "avg us";
+
+    for (auto const& entry : typeStats)
+    {
+        auto const& stats = entry.second;
+        out << boost::format ("%-24s %8u %8u %12.3f %10.1f\n")
+            % typeName (entry.first) % stats.count % stats.failed %
+                millis (stats.elapsed) %
+                (1000.0 * millis (stats.elapsed) / std::max <std::uint64_t> (stats.count, 1));
+    }
+
+    out << "\n" << (lastSeq - firstSeq + 1) << " ledgers, " << totalTxns
+        << " transactions applied in " << millis (totalElapsed) << " ms";
+    if (mismatches != 0)
+        out << ", " << mismatches << " account hash mismatches";
+    out << std::endl;
+
+    return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // bessel
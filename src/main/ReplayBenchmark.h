@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_APP_MAIN_REPLAYBENCHMARK_H_INCLUDED
+#define BESSEL_APP_MAIN_REPLAYBENCHMARK_H_INCLUDED
+
+#include <cstdint>
+#include <ostream>
+
+namespace bessel {
+
+/** Offline ledger replay benchmark.
+
+    Loads the parent of the first ledger in [firstSeq, lastSeq] from the
+    local databases and node store, then rebuilds every ledger of the range
+    by applying its stored transactions (in their original metadata order)
+    through TransactionEngine. Each rebuilt ledger is checked against the
+    stored account hash. Nothing is written back and no network or
+    consensus activity takes place.
+
+    Per ledger and per transaction type apply times are written to the
+    stream along with SLE fetch counts and cache hit rates.
+
+    The Application must have been set up before calling this.
+
+    @return EXIT_SUCCESS if every ledger reproduced its stored account hash.
+*/
+int runReplayBenchmark (std::uint32_t firstSeq, std::uint32_t lastSeq,
+    std::ostream& out);
+
+} // bessel
+
+#endif
@@ -0,0 +1,383 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <main/TreeBenchmark.h>
+#include <common/base/BasicConfig.h>
+#include <common/base/Log.h>
+#include <common/base/seconds_clock.h>
+#include <common/shamap/Family.h>
+#include <common/shamap/SHAMap.h>
+#include <common/shamap/SHAMapMissingNode.h>
+#include <data/nodestore/DummyScheduler.h>
+#include <data/nodestore/Manager.h>
+#include <protocol/Serializer.h>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace bessel {
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+// Lookups done by each thread in a warm pass
+int const warmLookups = 1000000;
+
+// Full passes over the leaves when timing iteration
+int const iterationPasses = 5;
+
+double seconds (clock_type::duration d)
+{
+    return std::chrono::duration_cast <std::chrono::microseconds> (
+        d).count () / 1000000.0;
+}
+
+/** A scratch directory that is removed with everything in it. */
+class ScratchDirectory
+{
+private:
+    boost::filesystem::path path_;
+
+public:
+    ScratchDirectory (ScratchDirectory const&) = delete;
+    ScratchDirectory& operator= (ScratchDirectory const&) = delete;
+
+    ScratchDirectory ()
+        : path_ (boost::filesystem::temp_directory_path () /
+            boost::filesystem::unique_path ("treebench-%%%%-%%%%"))
+    {
+    }
+
+    ~ScratchDirectory ()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all (path_, ec);
+    }
+
+    boost::filesystem::path const&
+    path () const
+    {
+        return path_;
+    }
+};
+
+/** The node store and caches the benchmark maps live in.
+
+    The nodes go to a NuDB database of their own so that the configured
+    node store is never written to.
+*/
+class BenchmarkFamily : public shamap::Family
+{
+private:
+    NodeStore::DummyScheduler scheduler_;
+    std::unique_ptr <NodeStore::Database> db_;
+    TreeNodeCache treecache_;
+    FullBelowCache fullbelow_;
+
+public:
+    BenchmarkFamily (BenchmarkFamily const&) = delete;
+    BenchmarkFamily& operator= (BenchmarkFamily const&) = delete;
+
+    BenchmarkFamily (boost::filesystem::path const& path,
+            beast::Journal journal)
+        : treecache_ ("TreeNodeCache", 65536, 60, get_seconds_clock (),
+            deprecatedLogs ().journal ("TaggedCache"))
+        , fullbelow_ ("full_below", get_seconds_clock ())
+    {
+        Section params;
+        params.set ("type", "NuDB");
+        params.set ("path", path.string ());
+
+        db_ = NodeStore::Manager::instance ().make_Database (
+            "NodeStore.treebench", scheduler_, journal, 0, params);
+    }
+
+    FullBelowCache&
+    fullbelow () override
+    {
+        return fullbelow_;
+    }
+
+    FullBelowCache const&
+    fullbelow () const override
+    {
+        return fullbelow_;
+    }
+
+    TreeNodeCache&
+    treecache () override
+    {
+        return treecache_;
+    }
+
+    TreeNodeCache const&
+    treecache () const override
+    {
+        return treecache_;
+    }
+
+    NodeStore::Database&
+    db () override
+    {
+        return *db_;
+    }
+
+    NodeStore::Database const&
+    db () const override
+    {
+        return *db_;
+    }
+
+    void
+    missing_node (std::uint32_t) override
+    {
+    }
+};
+
+std::shared_ptr<SHAMap> loadMap (shamap::Family& family, uint256 const& hash,
+    beast::Journal journal)
+{
+    auto map = std::make_shared<SHAMap> (SHAMapType::STATE, hash,
+        family, journal);
+
+    if (!map->fetchRoot (hash, nullptr))
+        return std::shared_ptr<SHAMap> ();
+
+    map->setImmutable ();
+    return map;
+}
+
+/** Look up keys on a number of threads at once.
+
+    Thread i starts at a different offset into the keys so that the threads
+    are not all walking the same path at the same moment.
+
+    @return the elapsed time, or a negative duration if a lookup failed.
+*/
+clock_type::duration lookup (SHAMap const& map,
+    std::vector<uint256> const& keys, int threads, int perThread)
+{
+    std::atomic<bool> failed (false);
+    std::atomic<int> ready (0);
+    std::atomic<bool> go (false);
+    std::vector<std::thread> workers;
+    workers.reserve (threads);
+
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back ([&, t] ()
+        {
+            std::size_t i = (keys.size () / threads) * t;
+
+            ++ready;
+            while (!go.load ())
+                std::this_thread::yield ();
+
+            try
+            {
+                for (int n = 0; n < perThread; ++n)
+                {
+                    if (!map.hasItem (keys[i]))
+                        failed = true;
+
+                    if (++i == keys.size ())
+                        i = 0;
+                }
+            }
+            catch (SHAMapMissingNode const&)
+            {
+                failed = true;
+            }
+        });
+    }
+
+    while (ready.load () != threads)
+        std::this_thread::yield ();
+
+    auto const start = clock_type::now ();
+    go = true;
+
+    for (auto& w : workers)
+        w.join ();
+
+    auto const elapsed = clock_type::now () - start;
+    return failed ? clock_type::duration (-1) : elapsed;
+}
+
+/** Time visitLeaves over a map that is already in memory.
+
+    Also reports the heap used by the items themselves: each is a single
+    block holding the header and the payload.
+*/
+void iterate (SHAMap const& map, std::ostream& out)
+{
+    std::size_t items = 0;
+    std::size_t payload = 0;
+
+    // The first pass loads the tree
+    map.visitLeaves ([&] (boost::intrusive_ptr<SHAMapItem const> const& item)
+    {
+        ++items;
+        payload += item->size ();
+    });
+
+    if (items == 0)
+        return;
+
+    std::size_t checksum = 0;
+    auto const start = clock_type::now ();
+
+    for (int pass = 0; pass < iterationPasses; ++pass)
+    {
+        map.visitLeaves ([&] (boost::intrusive_ptr<SHAMapItem const> const& item)
+        {
+            // Touch the payload so it has to be brought into cache
+            checksum += static_cast<std::uint8_t const*> (item->data ())[0];
+        });
+    }
+
+    double const elapsed = seconds (clock_type::now () - start);
+    double const visited = 1.0 * items * iterationPasses;
+
+    out << boost::format ("item size: %d byte header, %.1f byte average payload, "
+        "%.1f bytes per item\n")
+        % sizeof (SHAMapItem)
+        % (1.0 * payload / items)
+        % (sizeof (SHAMapItem) + 1.0 * payload / items);
+    out << boost::format ("iteration: %.0f items/s, %.1f MB/s of payload "
+        "(checksum %d)\n\n")
+        % (visited / elapsed)
+        % (payload * iterationPasses / elapsed / 1e6)
+        % (checksum & 0xff);
+}
+
+} // namespace
+
+int runTreeBenchmark (int items, std::ostream& out)
+{
+    auto journal = deprecatedLogs ().journal ("TreeBenchmark");
+
+    if (items <= 0)
+    {
+        out << "Invalid item count " << items << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ScratchDirectory const scratch;
+    BenchmarkFamily family (scratch.path (),
+        deprecatedLogs ().journal ("NodeObject"));
+
+    // Build and store the map
+    std::vector<uint256> keys;
+    keys.reserve (items);
+    uint256 hash;
+    {
+        std::mt19937 gen (items);
+        std::uniform_int_distribution<int> size (48, 160);
+        std::uniform_int_distribution<int> byte (0, 255);
+        SHAMap map (SHAMapType::STATE, family, journal);
+
+        for (int i = 0; i < items; ++i)
+        {
+            keys.push_back (getSHA512Half (&i, sizeof (i)));
+
+            Blob data (size (gen));
+            for (auto& b : data)
+                b = static_cast<unsigned char> (byte (gen));
+
+            map.addGiveItem (make_shamapitem (keys.back (), data),
+                false, false);
+        }
+
+        map.flushDirty (hotACCOUNT_NODE, 1);
+        hash = map.getHash ();
+    }
+
+    std::shuffle (keys.begin (), keys.end (), std::mt19937 (items + 1));
+
+    unsigned const cores = std::max (1u, std::thread::hardware_concurrency ());
+    std::vector<int> threadCounts;
+    for (unsigned t = 1; t < cores; t *= 2)
+        threadCounts.push_back (t);
+    threadCounts.push_back (cores);
+
+    out << items << " items, root " << hash << "\n\n";
+
+    {
+        auto map = loadMap (family, hash, journal);
+
+        if (!map)
+        {
+            out << "Unable to load the map root" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        iterate (*map, out);
+    }
+
+    out << boost::format ("%7s %14s %14s %9s\n")
+        % "threads" % "cold items/s" % "warm items/s" % "speedup";
+
+    double warmBase = 0;
+    for (int threads : threadCounts)
+    {
+        // Drop cached nodes so the cold pass has to load and hook them up
+        family.treecache ().clear ();
+        auto map = loadMap (family, hash, journal);
+
+        if (!map)
+        {
+            out << "Unable to load the map root" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        int const coldPerThread = (items + threads - 1) / threads;
+        auto const cold = lookup (*map, keys, threads, coldPerThread);
+        auto const warm = lookup (*map, keys, threads, warmLookups);
+
+        if ((cold.count () < 0) || (warm.count () < 0))
+        {
+            out << "Lookup failed with " << threads << " threads" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        double const coldRate = (1.0 * coldPerThread * threads) / seconds (cold);
+        double const warmRate = (1.0 * warmLookups * threads) / seconds (warm);
+
+        if (threads == 1)
+            warmBase = warmRate;
+
+        out << boost::format ("%7d %14.0f %14.0f %8.2fx\n")
+            % threads % coldRate % warmRate % (warmRate / warmBase);
+    }
+
+    out.flush ();
+    return EXIT_SUCCESS;
+}
+
+} // bessel
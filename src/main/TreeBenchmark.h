@@ -0,0 +1,45 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_APP_MAIN_TREEBENCHMARK_H_INCLUDED
+#define BESSEL_APP_MAIN_TREEBENCHMARK_H_INCLUDED
+
+#include <ostream>
+
+namespace bessel {
+
+/** Multi-threaded SHAMap traversal benchmark.
+
+    Builds a state map of the given number of random items and writes it
+    to a NuDB node store in a scratch directory, which is removed when the
+    benchmark finishes; the configured node store is not used. It then reports the memory used per item and the
+    rate at which visitLeaves walks the items. Finally it looks items up
+    from one shared, immutable copy of the map with an increasing number
+    of threads. Each thread count is
+    measured twice: cold, starting from just the root so that threads race
+    to load and hook up the same nodes, and warm, with the whole tree in
+    memory. Lookup rates and the speedup over a single thread are written
+    to the stream.
+*/
+int runTreeBenchmark (int items, std::ostream& out);
+
+} // bessel
+
+#endif
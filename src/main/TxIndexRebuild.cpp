@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <main/TxIndexRebuild.h>
+#include <main/Application.h>
+#include <common/shamap/SHAMapMissingNode.h>
+#include <ledger/AcceptedLedger.h>
+#include <ledger/Ledger.h>
+#include <transaction/tx/TxIndex.h>
+#include <cstdlib>
+
+namespace bessel {
+
+int runTxIndexRebuild (std::uint32_t firstSeq, std::uint32_t lastSeq,
+    std::ostream& out)
+{
+    if (firstSeq < 2 || lastSeq < firstSeq)
+    {
+        out << "Invalid ledger range " << firstSeq << "-" << lastSeq << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TxIndex* const txIndex = getApp().getTxIndex ();
+
+    if (!txIndex)
+    {
+        out << "No [tx_index] section is configured" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::uint32_t missing = 0;
+    std::uint64_t txns = 0;
+
+    // Stop at the end of the body: seq <= lastSeq always holds when
+    // lastSeq is the largest sequence number
+    for (std::uint32_t seq = firstSeq; ; ++seq)
+    {
+        try
+        {
+            Ledger::pointer ledger = Ledger::loadByIndex (seq);
+
+            if (ledger)
+            {
+                auto const accepted = AcceptedLedger::makeAcceptedLedger (ledger);
+                txIndex->insert (*accepted);
+                txns += accepted->getMap ().size ();
+            }
+            else
+            {
+                out << "Ledger " << seq << " is not stored" << std::endl;
+                ++missing;
+            }
+        }
+        catch (SHAMapMissingNode const& e)
+        {
+            out << "Ledger " << seq << " is incomplete: " << e << std::endl;
+            ++missing;
+        }
+
+        if ((seq - firstSeq + 1) % 10000 == 0)
+            out << "Indexed through ledger " << seq << std::endl;
+
+        if (seq == lastSeq)
+            break;
+    }
+
+    out << "Indexed " << txns << " transactions from "
+        << (lastSeq - firstSeq + 1 - missing) << " ledgers";
+    if (missing != 0)
+        out << ", " << missing << " ledgers skipped";
+    out << std::endl;
+
+    return (missing == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // bessel
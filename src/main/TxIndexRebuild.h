@@ -0,0 +1,45 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_APP_MAIN_TXINDEXREBUILD_H_INCLUDED
+#define BESSEL_APP_MAIN_TXINDEXREBUILD_H_INCLUDED
+
+#include <cstdint>
+#include <ostream>
+
+namespace bessel {
+
+/** Offline rebuild of the transaction lookup index.
+
+    Loads every ledger in [firstSeq, lastSeq] from the local databases and
+    node store and records the location of each of its transactions in the
+    index configured by [tx_index]. Ledgers that cannot be loaded are
+    reported and skipped. No network or consensus activity takes place.
+
+    The Application must have been set up before calling this.
+
+    @return EXIT_SUCCESS if every ledger of the range was indexed.
+*/
+int runTxIndexRebuild (std::uint32_t firstSeq, std::uint32_t lastSeq,
+    std::ostream& out);
+
+} // bessel
+
+#endif
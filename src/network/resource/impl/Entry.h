@@ -24,6 +24,7 @@
 #include <common/base/DecayingSample.h>
 #include <network/resource/impl/Key.h>
 #include <network/resource/impl/Tuning.h>
+#include <atomic>
 #include <cassert>
 #include <boost/intrusive/list.hpp>
 
@@ -34,6 +35,10 @@ typedef beast::abstract_clock <std::chrono::steady_clock> clock_type;
 
 // An entry in the table
 //  DEPRECATED using boost::intrusive list
+//
+// The balance, the remote contribution, the warning time and the reference
+// count are atomics so the charge path never takes the Logic lock. The key,
+// the list hook and whenExpires are only touched with the lock held.
 struct Entry 
     : public boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>
 {
@@ -72,32 +77,32 @@ struct Entry
     }
 
     // Balance including remote contributions
-    int balance (clock_type::time_point const now)
+    int balance (clock_type::time_point const now) const
     {
-        return local_balance.value (now) + remote_balance;
+        return local_balance.value (now) + remote_balance.load ();
     }
 
     // Add a charge and return normalized balance
     // including contributions from imports.
     int add (int charge, clock_type::time_point const now)
     {
-        return local_balance.add (charge, now) + remote_balance;
+        return local_balance.add (charge, now) + remote_balance.load ();
     }
 
     // Back pointer to the map key (bit of a hack here)
     Key const* key;
 
     // Number of Consumer references
-    int refcount;
+    std::atomic <int> refcount;
 
     // Exponentially decaying balance of resource consumption
-    DecayingSample <decayWindowSeconds, clock_type> local_balance;
+    AtomicDecayingSample <decayWindowSeconds, clock_type> local_balance;
 
     // Normalized balance contribution from imports
-    int remote_balance;
+    std::atomic <int> remote_balance;
 
     // Time of the last warning
-    clock_type::rep lastWarningTime;
+    std::atomic <clock_type::rep> lastWarningTime;
 
     // For inactive entries, time after which this entry will be erased
     clock_type::rep whenExpires;
@@ -132,8 +132,7 @@ public:
 
             entry = &result.first->second;
             entry->key = &result.first->first;
-            ++entry->refcount;
-            if (entry->refcount == 1)
+            if (++entry->refcount == 1)
             {
                 if (! result.second)
                 {
@@ -165,8 +164,7 @@ public:
 
             entry = &result.first->second;
             entry->key = &result.first->first;
-            ++entry->refcount;
-            if (entry->refcount == 1)
+            if (++entry->refcount == 1)
             {
                 if (! result.second)
                     state->inactive.erase (
@@ -193,8 +191,7 @@ public:
 
             entry = &result.first->second;
             entry->key = &result.first->first;
-            ++entry->refcount;
-            if (entry->refcount == 1)
+            if (++entry->refcount == 1)
             {
                 if (! result.second)
                     state->inactive.erase (
@@ -224,8 +221,7 @@ public:
 
             entry = &result.first->second;
             entry->key = &result.first->first;
-            ++entry->refcount;
-            if (entry->refcount == 1)
+            if (++entry->refcount == 1)
             {
                 if (! result.second)
                     state->inactive.erase (
@@ -255,11 +251,11 @@ public:
         for (auto& inboundEntry : state->inbound)
         {
             int localBalance = inboundEntry.local_balance.value (now);
-            if ((localBalance + inboundEntry.remote_balance) >= threshold)
+            if ((localBalance + inboundEntry.remote_balance.load ()) >= threshold)
             {
                 Json::Value& entry = (ret[inboundEntry.to_string()] = Json::objectValue);
                 entry[jss::local] = localBalance;
-                entry[jss::remote] = inboundEntry.remote_balance;
+                entry[jss::remote] = inboundEntry.remote_balance.load ();
                 entry[jss::type] = "outbound";
             }
 
@@ -267,11 +263,11 @@ public:
         for (auto& outboundEntry : state->outbound)
         {
             int localBalance = outboundEntry.local_balance.value (now);
-            if ((localBalance + outboundEntry.remote_balance) >= threshold)
+            if ((localBalance + outboundEntry.remote_balance.load ()) >= threshold)
             {
                 Json::Value& entry = (ret[outboundEntry.to_string()] = Json::objectValue);
                 entry[jss::local] = localBalance;
-                entry[jss::remote] = outboundEntry.remote_balance;
+                entry[jss::remote] = outboundEntry.remote_balance.load ();
                 entry[jss::type] = "outbound";
             }
 
@@ -279,11 +275,11 @@ public:
         for (auto& adminEntry : state->admin)
         {
             int localBalance = adminEntry.local_balance.value (now);
-            if ((localBalance + adminEntry.remote_balance) >= threshold)
+            if ((localBalance + adminEntry.remote_balance.load ()) >= threshold)
             {
                 Json::Value& entry = (ret[adminEntry.to_string()] = Json::objectValue);
                 entry[jss::local] = localBalance;
-                entry[jss::remote] = adminEntry.remote_balance;
+                entry[jss::remote] = adminEntry.remote_balance.load ();
                 entry[jss::type] = "admin";
             }
 
@@ -441,11 +437,6 @@ public:
         return Disposition::ok;
     }
 
-    void acquire (Entry& entry, SharedState::Access& state)
-    {
-        ++entry.refcount;
-    }
-
     void release (Entry& entry, SharedState::Access& state)
     {
         if (--entry.refcount == 0)
@@ -483,97 +474,72 @@ public:
         state->table.erase (iter);
     }
 
-    Disposition charge (Entry& entry, Charge const& fee, SharedState::Access& state)
-    {
-        clock_type::time_point const now (m_clock.now());
-        int const balance (entry.add (fee.cost(), now));
-
-        m_journal.trace << "Charging " << entry << " for " << fee;
+    //--------------------------------------------------------------------------
+    //
+    // The functions below run for every request a consumer makes. They work
+    // on the Entry's atomics and do not take the lock; only a release of
+    // the last reference, which moves the entry to the inactive list, does.
+    //
 
-        return disposition (balance);
+    // The caller already holds a reference, so the count cannot be zero
+    void acquire (Entry& entry)
+    {
+        ++entry.refcount;
     }
 
-    bool warn (Entry& entry, SharedState::Access& state)
+    void release (Entry& entry)
     {
-        bool notify (false);
-        clock_type::rep const elapsed (m_clock.elapsed());
-        if (entry.balance (m_clock.now()) >= warningThreshold &&
-            elapsed != entry.lastWarningTime)
+        int count (entry.refcount.load ());
+
+        while (count > 1)
         {
-            charge (entry, feeWarning, state);
-            notify = true;
-            entry.lastWarningTime = elapsed;
+            if (entry.refcount.compare_exchange_weak (count, count - 1))
+                return;
         }
 
-        if (notify)
-            m_journal.info << "Load warning: " << entry;
-
-        if (notify)
-            ++m_stats.warn;
+        SharedState::Access state (m_state);
 
-        return notify;
+        release (entry, state);
     }
 
-    bool disconnect (Entry& entry, SharedState::Access& state)
+    Disposition charge (Entry& entry, Charge const& fee)
     {
-        bool drop (false);
         clock_type::time_point const now (m_clock.now());
-        int const balance (entry.balance (now));
-        if (balance >= dropThreshold)
-        {
-            m_journal.warning <<
-                "Consumer entry " << entry <<
-                " dropped with balance " << balance <<
-                " at or above drop threshold " << dropThreshold;
-
-            // Adding feeDrop at this point keeps the dropped connection
-            // from re-connecting for at least a little while after it is
-            // dropped.
-            charge (entry, feeDrop, state);
-
-            ++m_stats.drop;
+        int const balance (entry.add (fee.cost(), now));
 
-            drop = true;
-        }
+        m_journal.trace << "Charging " << entry << " for " << fee;
 
-        return drop;
+        return disposition (balance);
     }
 
-    int balance (Entry& entry, SharedState::Access& state)
+    bool warn (Entry& entry)
     {
-        return entry.balance (m_clock.now());
-    }
-
-    //--------------------------------------------------------------------------
+        if (entry.admin())
+            return false;
 
-    void acquire (Entry& entry)
-    {
-        SharedState::Access state (m_state);
-        acquire (entry, state);
-    }
+        clock_type::rep const elapsed (m_clock.elapsed());
 
-    void release (Entry& entry)
-    {
-        SharedState::Access state (m_state);
+        if (entry.balance (m_clock.now()) < warningThreshold)
+            return false;
 
-        release (entry, state);
-    }
+        // At most one warning per entry per second, even when several
+        // threads see the balance cross the threshold together.
+        clock_type::rep last (entry.lastWarningTime.load ());
 
-    Disposition charge (Entry& entry, Charge const& fee)
-    {
-        SharedState::Access state (m_state);
+        do
+        {
+            if (last == elapsed)
+                return false;
+        }
+        while (! entry.lastWarningTime.compare_exchange_weak (last, elapsed));
 
-        return charge (entry, fee, state);
-    }
+        charge (entry, feeWarning);
 
-    bool warn (Entry& entry)
-    {
-        if (entry.admin())
-            return false;
+        m_journal.info << "Load warning: " << entry;
 
-        SharedState::Access state (m_state);
+        ++m_stats.warn;
 
-        return warn (entry, state);
+        return true;
     }
 
     bool disconnect (Entry& entry)
@@ -581,16 +547,30 @@ public:
         if (entry.admin())
             return false;
 
-        SharedState::Access state (m_state);
+        clock_type::time_point const now (m_clock.now());
+        int const balance (entry.balance (now));
+
+        if (balance < dropThreshold)
+            return false;
+
+        m_journal.warning <<
+            "Consumer entry " << entry <<
+            " dropped with balance " << balance <<
+            " at or above drop threshold " << dropThreshold;
+
+        // Adding feeDrop at this point keeps the dropped connection
+        // from re-connecting for at least a little while after it is
+        // dropped.
+        charge (entry, feeDrop);
 
-        return disconnect (entry, state);
+        ++m_stats.drop;
+
+        return true;
     }
 
     int balance (Entry& entry)
     {
-        SharedState::Access state (m_state);
-
-        return balance (entry, state);
+        return entry.balance (m_clock.now());
     }
 
     //--------------------------------------------------------------------------
@@ -603,13 +583,13 @@ public:
         {
             beast::PropertyStream::Map item (items);
             if (entry.refcount != 0)
-                item ["count"] = entry.refcount;
+                item ["count"] = entry.refcount.load ();
 
             item ["name"] = entry.to_string();
             item ["balance"] = entry.balance(now);
 
             if (entry.remote_balance != 0)
-                item ["remote_balance"] = entry.remote_balance;
+                item ["remote_balance"] = entry.remote_balance.load ();
         }
     }
 
@@ -38,6 +38,7 @@ public:
 public:
     STLedgerEntry (const Serializer & s, uint256 const& index);
     STLedgerEntry (SerialIter & sit, uint256 const& index);
+    STLedgerEntry (Slice const& data, uint256 const& index);
     STLedgerEntry (LedgerEntryType type, uint256 const& index);
     STLedgerEntry (const STObject & object, uint256 const& index);
 
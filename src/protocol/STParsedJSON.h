@@ -21,6 +21,7 @@
 #define BESSEL_PROTOCOL_STPARSEDJSON_H_INCLUDED
 
 #include <protocol/STArray.h>
+#include <common/json/FastReader.h>
 #include <boost/optional.hpp>
 
 namespace bessel {
@@ -40,6 +41,11 @@ public:
     */
     STParsedJSONObject (std::string const& name, Json::Value const& json);
 
+    /** Parses directly from a Json::FastReader tape, without building a
+        Json::Value. Results and errors are the same as for Json::Value.
+    */
+    STParsedJSONObject (std::string const& name, Json::TapeValue const& json);
+
     STParsedJSONObject () = delete;
     STParsedJSONObject (STParsedJSONObject const&) = delete;
     STParsedJSONObject& operator= (STParsedJSONObject const&) = delete;
@@ -67,6 +73,9 @@ public:
     */
     STParsedJSONArray (std::string const& name, Json::Value const& json);
 
+    /** Parses directly from a Json::FastReader tape. */
+    STParsedJSONArray (std::string const& name, Json::TapeValue const& json);
+
     STParsedJSONArray () = delete;
     STParsedJSONArray (STParsedJSONArray const&) = delete;
     STParsedJSONArray& operator= (STParsedJSONArray const&) = delete;
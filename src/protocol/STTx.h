@@ -26,6 +26,7 @@
 #include <boost/logic/tribool.hpp>
 #include <common/base/Log.h>
 #include <set>
+#include <vector>
 
 namespace bessel {
 
@@ -191,6 +192,18 @@ public:
 
     bool checkSign () const;
 
+    /** Check the signatures of a group of transactions.
+
+        Transactions whose signatures are all Ed25519, with canonical
+        keys and R values that have no small order component, are
+        verified together in one batch. The others go through
+        checkSign(), so the verdict is always the one checkSign() would
+        give. On
+        return every transaction's signature state is known, so later
+        calls to checkSign() are free.
+    */
+    static void checkSigns (std::vector<pointer> const& txns);
+
     bool isKnownGood () const
     {
         return (sig_state_ == true);
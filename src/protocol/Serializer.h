@@ -23,6 +23,7 @@
 #include <protocol/SField.h>
 #include <common/base/base_uint.h>
 #include <common/base/Buffer.h>
+#include <common/base/Slice.h>
 #include <cassert>
 #include <cstdint>
 #include <iomanip>
@@ -49,6 +50,11 @@ public:
     {
         ;
     }
+    // Takes over the vector, including its capacity
+    Serializer (Blob&& data) : mData (std::move (data))
+    {
+        ;
+    }
     Serializer (std::string const& data) : mData (data.data (), (data.data ()) + data.size ())
     {
         ;
@@ -76,6 +82,13 @@ public:
         return mData.data();
     }
 
+    // The serialized bytes, in place. Valid until the next modification.
+    Slice
+    slice() const noexcept
+    {
+        return Slice (mData.data(), mData.size());
+    }
+
     // assemble functions
     int add8 (unsigned char byte);
     int add16 (std::uint16_t);
@@ -102,6 +115,7 @@ public:
     }
 
     int addRaw (Blob const& vector);
+    int addRaw (Slice const& slice);
     int addRaw (const void* ptr, int len);
     int addRaw (const Serializer& s);
     int addZeros (size_t uBytes);
@@ -182,6 +196,9 @@ public:
     {
         return getPrefixHash (prefix, reinterpret_cast<const unsigned char*> (strData.data ()), strData.size ());
     }
+    // Hash of prefix, data and suffix, without assembling them in a buffer
+    static uint256 getPrefixHash (std::uint32_t prefix, Slice const& data,
+        uint256 const& suffix);
 
     // totality functions
     Blob const& peekData () const
@@ -308,6 +325,28 @@ private:
 
 //------------------------------------------------------------------------------
 
+/** A Serializer whose buffer comes from a per-thread pool.
+
+    Use it for short-lived serializations which are hashed, copied into a
+    message or parsed and then dropped: the buffer, with its capacity, is
+    returned to the pool on destruction instead of being freed, so the
+    next serialization on the same thread does not allocate. Data moved
+    out through modData() simply leaves an empty buffer behind.
+*/
+class PooledSerializer : public Serializer
+{
+public:
+    explicit
+    PooledSerializer (std::size_t reserve = 256);
+
+    PooledSerializer (PooledSerializer const&) = delete;
+    PooledSerializer& operator= (PooledSerializer const&) = delete;
+
+    ~PooledSerializer ();
+};
+
+//------------------------------------------------------------------------------
+
 // DEPRECATED
 // Transitional adapter to new serialization interfaces
 class SerialIter
@@ -326,6 +365,12 @@ public:
     {
     }
 
+    explicit
+    SerialIter (Slice const& slice) noexcept
+        : SerialIter(slice.data(), slice.size())
+    {
+    }
+
     template <class T,
         typename std::enable_if<std::is_integral<T>::value &&
             sizeof(T) == 1>::type* = nullptr>
@@ -398,10 +443,18 @@ public:
     Blob
     getRaw (int size);
 
+    // The next bytes, in place. They stay valid as long as the source does.
+    Slice
+    getSlice (std::size_t bytes);
+
     //  DEPRECATED Returns a copy
     Blob
     getVL();
 
+    // The next variable length field, in place.
+    Slice
+    getVLSlice();
+
     Buffer
     getVLBuffer();
 
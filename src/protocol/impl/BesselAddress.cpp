@@ -29,6 +29,7 @@
 #include <protocol/BesselAddress.h>
 #include <protocol/Serializer.h>
 #include <protocol/BesselPublicKey.h>
+#include <crypto/Ed25519.h>
 #include <crypto/ed25519-donna/ed25519.h>
 #include <openssl/ripemd.h>
 #include <openssl/pem.h>
@@ -37,27 +38,6 @@
 
 namespace bessel {
 
-static
-bool isCanonicalEd25519Signature (std::uint8_t const* signature)
-{
-    using std::uint8_t;
-
-    // Big-endian `l`, the Ed25519 subgroup order
-    char const* const order = "\x10\x00\x00\x00\x00\x00\x00\x00"
-                              "\x00\x00\x00\x00\x00\x00\x00\x00"
-                              "\x14\xDE\xF9\xDE\xA2\xF7\x9C\xD6"
-                              "\x58\x12\x63\x1A\x5C\xF5\xD3\xED";
-
-    uint8_t const* const l = reinterpret_cast<uint8_t const*> (order);
-
-    // Take the second half of signature and byte-reverse it to big-endian.
-    uint8_t const* S_le = signature + 32;
-    uint8_t S[32];
-    std::reverse_copy (S_le, S_le + 32, S);
-
-    return std::lexicographical_compare (S, S + 32, l, l + 32);
-}
-
 // <-- seed
 static
 uint128 PassPhraseToKey (std::string const& passPhrase)
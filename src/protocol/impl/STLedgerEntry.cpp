@@ -46,6 +46,15 @@ STLedgerEntry::STLedgerEntry (
     setSLEType ();
 }
 
+STLedgerEntry::STLedgerEntry (
+    Slice const& data, uint256 const& index)
+    : STObject (sfLedgerEntry), mIndex (index), mMutable (true)
+{
+    SerialIter sit (data);
+    set (sit);
+    setSLEType ();
+}
+
 STLedgerEntry::STLedgerEntry (
     const STObject & object, uint256 const& index)
     : STObject (object), mIndex(index),  mMutable (true)
@@ -356,7 +356,7 @@ bool STObject::isEquivalent (const STBase& t) const
 
 uint256 STObject::getHash (std::uint32_t prefix) const
 {
-    Serializer s;
+    PooledSerializer s;
     s.add32 (prefix);
     add (s, true);
     return s.getSHA512Half ();
@@ -364,7 +364,7 @@ uint256 STObject::getHash (std::uint32_t prefix) const
 
 uint256 STObject::getSigningHash (std::uint32_t prefix) const
 {
-    Serializer s;
+    PooledSerializer s;
     s.add32 (prefix);
     add (s, false);
     return s.getSHA512Half ();
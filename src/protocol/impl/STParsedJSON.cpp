@@ -138,13 +138,30 @@ static Json::Value singleton_expected (std::string const& object,
 }
 
 
+// amountFromJson works on a Json::Value; amounts are small, so a tape
+// value is converted just for that call.
+static Json::Value const& asJsonValue (Json::Value const& value)
+{
+    return value;
+}
+
+static Json::Value asJsonValue (Json::TapeValue const& value)
+{
+    return value.toValue ();
+}
+
+// The parsers below are templates on the JSON representation so that a
+// document held in a Json::FastReader tape is converted straight into an
+// STObject, with the same checks and diagnostics as a Json::Value.
+
 // This function is used by parseObject to parse any JSON type that doesn't
 // recurse.  Everything represented here is a leaf-type.
+template <class JsonValue>
 static boost::optional<detail::STVar> parseLeaf (
     std::string const& json_name,
     std::string const& fieldName,
     SField const* name,
-    Json::Value const& value,
+    JsonValue const& value,
     Json::Value& error)
 {
     boost::optional <detail::STVar> ret;
@@ -432,7 +449,8 @@ static boost::optional<detail::STVar> parseLeaf (
     case STI_AMOUNT:
         try
         {
-            ret = detail::make_stvar <STAmount> (amountFromJson (field, value));
+            ret = detail::make_stvar <STAmount> (
+                amountFromJson (field, asJsonValue (value)));
         }
         catch (...)
         {
@@ -501,7 +519,7 @@ static boost::optional<detail::STVar> parseLeaf (
                     // each element in this path has some combination of
                     // account, currency, or issuer
 
-                    Json::Value pathEl = value[i][j];
+                    JsonValue const pathEl = value[i][j];
 
                     if (!pathEl.isObject ())
                     {
@@ -509,9 +527,9 @@ static boost::optional<detail::STVar> parseLeaf (
                         return ret;
                     }
 
-                    Json::Value const& account  = pathEl["account"];
-                    Json::Value const& currency = pathEl["currency"];
-                    Json::Value const& issuer   = pathEl["issuer"];
+                    JsonValue const& account  = pathEl["account"];
+                    JsonValue const& currency = pathEl["currency"];
+                    JsonValue const& issuer   = pathEl["issuer"];
                     bool hasCurrency            = false;
                     Account uAccount, uIssuer;
                     Currency uCurrency;
@@ -659,18 +677,20 @@ static boost::optional<detail::STVar> parseLeaf (
 static const int maxDepth = 64;
 
 // Forward declaration since parseObject() and parseArray() call each other.
+template <class JsonValue>
 static boost::optional <detail::STVar> parseArray (
     std::string const& json_name,
-    Json::Value const& json,
+    JsonValue const& json,
     SField const& inName,
     int depth,
     Json::Value& error);
 
 
 
+template <class JsonValue>
 static boost::optional <STObject> parseObject (
     std::string const& json_name,
-    Json::Value const& json,
+    JsonValue const& json,
     SField const& inName,
     int depth,
     Json::Value& error)
@@ -691,7 +711,7 @@ static boost::optional <STObject> parseObject (
 
     for (auto const& fieldName : json.getMemberNames ())
     {
-        Json::Value const& value = json [fieldName];
+        JsonValue const& value = json [fieldName];
 
         auto const& field = SField::getField (fieldName);
 
@@ -768,9 +788,10 @@ static boost::optional <STObject> parseObject (
     return std::move (data);
 }
 
+template <class JsonValue>
 static boost::optional <detail::STVar> parseArray (
     std::string const& json_name,
-    Json::Value const& json,
+    JsonValue const& json,
     SField const& inName,
     int depth,
     Json::Value& error)
@@ -814,7 +835,7 @@ static boost::optional <detail::STVar> parseArray (
                 return boost::none;
             }
 
-            Json::Value const objectFields (json[i][objectName]);
+            JsonValue const objectFields (json[i][objectName]);
 
             std::stringstream ss;
             ss << json_name << "." <<
@@ -853,24 +874,46 @@ STParsedJSONObject::STParsedJSONObject (
     object = std::move (parseObject (name, json, sfGeneric, 0, error));
 }
 
+STParsedJSONObject::STParsedJSONObject (
+    std::string const& name,
+    Json::TapeValue const& json)
+{
+    using namespace STParsedJSONDetail;
+    object = std::move (parseObject (name, json, sfGeneric, 0, error));
+}
+
 //------------------------------------------------------------------------------
 
-STParsedJSONArray::STParsedJSONArray (
+template <class JsonValue>
+static boost::optional <STArray> parseTopArray (
     std::string const& name,
-    Json::Value const& json)
+    JsonValue const& json,
+    Json::Value& error)
 {
     using namespace STParsedJSONDetail;
     auto arr = parseArray (name, json, sfGeneric, 0, error);
     if (!arr)
-        array = boost::none;
-    else
-    {
-        auto p = dynamic_cast <STArray*> (&arr->get());
-        if (p == nullptr)
-            array = boost::none;
-        else
-            array = std::move (*p);
-    }
+        return boost::none;
+
+    auto p = dynamic_cast <STArray*> (&arr->get());
+    if (p == nullptr)
+        return boost::none;
+
+    return std::move (*p);
+}
+
+STParsedJSONArray::STParsedJSONArray (
+    std::string const& name,
+    Json::Value const& json)
+{
+    array = parseTopArray (name, json, error);
+}
+
+STParsedJSONArray::STParsedJSONArray (
+    std::string const& name,
+    Json::TapeValue const& json)
+{
+    array = parseTopArray (name, json, error);
 }
 
 
@@ -28,8 +28,12 @@
 #include <common/base/StringUtilities.h>
 #include <common/json/to_string.h>
 #include <boost/format.hpp>
+#include <algorithm>
 #include <array>
 #include <protocol/BesselAddress.h>
+#include <crypto/Ed25519.h>
+#include <deque>
+#include <map>
 
 namespace bessel {
 
@@ -199,7 +203,7 @@ static Blob getSigningData (STTx const& that)
     Serializer s;
     s.add32 (HashPrefix::txSign);
     that.add (s, false);
-    return s.getData();
+    return std::move (s.modData ());
 }
 
 uint256
@@ -315,6 +319,124 @@ bool STTx::checkSign() const
     return static_cast<bool> (sig_state_);
 }
 
+namespace detail {
+
+// A signature that can take part in an Ed25519 batch. The batch only
+// reaches the same verdict as checkSign when S is canonical and both the
+// key and R are canonical encodings of points with no small order
+// component, so anything else is checked on its own. Keys recur across a
+// set, so their check is remembered in `keys`.
+static bool isBatchableEd25519 (Blob const& key, Blob const& sig,
+    std::map<Blob, bool>& keys)
+{
+    if (key.size () != 33 || key[0] != 0xED || sig.size () != 64)
+        return false;
+
+    if (! isCanonicalEd25519Signature (sig.data ()))
+        return false;
+
+    auto iter = keys.find (key);
+
+    if (iter == keys.end ())
+    {
+        iter = keys.emplace (key,
+            isCanonicalTorsionFreeEd25519Point (key.data () + 1)).first;
+    }
+
+    return iter->second && isCanonicalTorsionFreeEd25519Point (sig.data ());
+}
+
+} // detail
+
+void STTx::checkSigns (std::vector<pointer> const& txns)
+{
+    struct Pending
+    {
+        STTx const* txn;
+        std::size_t first;
+        std::size_t count;
+    };
+
+    Ed25519BatchVerifier batch;
+    std::vector<Pending> pending;
+    std::map<Blob, bool> keys;
+
+    // The verifier does not copy, so keep every buffer it points into
+    // alive, at a stable address, until verify() is done.
+    std::deque<Blob> buffers;
+
+    for (auto const& txn : txns)
+    {
+        if (! boost::indeterminate (txn->sig_state_))
+            continue;
+
+        try
+        {
+            std::vector<std::pair<Blob, Blob>> sigs;
+            sigs.emplace_back (txn->getFieldVL (sfSigningPubKey),
+                txn->getFieldVL (sfTxnSignature));
+
+            if (txn->getTxnType () == ttOPERATION)
+            {
+                for (STObject const& tSign : txn->getFieldArray (sfSigns))
+                {
+                    sigs.emplace_back (tSign.getFieldVL (sfSigningPubKey),
+                        tSign.getFieldVL (sfTxnSignature));
+                }
+            }
+
+            bool const batchable = std::all_of (sigs.begin (), sigs.end (),
+                [&keys](std::pair<Blob, Blob> const& s)
+                {
+                    return detail::isBatchableEd25519 (
+                        s.first, s.second, keys);
+                });
+
+            if (! batchable)
+            {
+                txn->checkSign ();
+                continue;
+            }
+
+            buffers.push_back (getSigningData (*txn));
+            Blob const& message = buffers.back ();
+
+            Pending p { txn.get (), batch.size (), sigs.size () };
+
+            for (auto& s : sigs)
+            {
+                buffers.push_back (std::move (s.first));
+                std::uint8_t const* key = buffers.back ().data () + 1;
+                buffers.push_back (std::move (s.second));
+                std::uint8_t const* sig = buffers.back ().data ();
+
+                batch.add (message.data (), message.size (), key, sig);
+            }
+
+            pending.push_back (p);
+        }
+        catch (...)
+        {
+            txn->setBad ();
+        }
+    }
+
+    if (pending.empty ())
+        return;
+
+    batch.verify ();
+
+    for (auto const& p : pending)
+    {
+        bool good = true;
+
+        for (std::size_t i = p.first; good && i != p.first + p.count; ++i)
+            good = batch.valid (i);
+
+        p.txn->sig_state_ = good;
+    }
+}
+
 void STTx::setSigningPubKey (BesselAddress const& naSignPubKey)
 {
     setFieldVL (sfSigningPubKey, naSignPubKey.getAccountPublic ());
@@ -22,6 +22,8 @@
 #include <protocol/Serializer.h>
 #include <openssl/ripemd.h>
 #include <openssl/pem.h>
+#include <boost/thread/tss.hpp>
+#include <vector>
 
 namespace bessel {
 
@@ -93,6 +95,13 @@ int Serializer::addRaw (Blob const& vector)
     return ret;
 }
 
+int Serializer::addRaw (Slice const& slice)
+{
+    int ret = mData.size ();
+    mData.insert (mData.end (), slice.data (), slice.data () + slice.size ());
+    return ret;
+}
+
 int Serializer::addRaw (const Serializer& s)
 {
     int ret = mData.size ();
@@ -319,6 +328,26 @@ uint256 Serializer::getPrefixHash (std::uint32_t prefix, const unsigned char* da
     return j[0];
 }
 
+uint256 Serializer::getPrefixHash (std::uint32_t prefix, Slice const& data,
+    uint256 const& suffix)
+{
+    unsigned char be_prefix[4];
+    be_prefix[0] = static_cast<unsigned char> (prefix >> 24);
+    be_prefix[1] = static_cast<unsigned char> ((prefix >> 16) & 0xff);
+    be_prefix[2] = static_cast<unsigned char> ((prefix >> 8) & 0xff);
+    be_prefix[3] = static_cast<unsigned char> (prefix & 0xff);
+
+    uint256 j[2];
+    SHA512_CTX ctx;
+    SHA512_Init (&ctx);
+    SHA512_Update (&ctx, &be_prefix[0], 4);
+    SHA512_Update (&ctx, data.data (), data.size ());
+    SHA512_Update (&ctx, suffix.begin (), suffix.size ());
+    SHA512_Final (reinterpret_cast<unsigned char*> (&j[0]), &ctx);
+
+    return j[0];
+}
+
 int Serializer::addVL (Blob const& vector)
 {
     int ret = addEncoded (vector.size ());
@@ -637,6 +666,19 @@ SerialIter::getRaw (int size)
     return getRawHelper<Blob> (size);
 }
 
+Slice
+SerialIter::getSlice (std::size_t bytes)
+{
+    if (remain_ < bytes)
+        throw std::runtime_error(
+            "invalid SerialIter getSlice");
+    Slice result (p_, bytes);
+    p_ += bytes;
+    used_ += bytes;
+    remain_ -= bytes;
+    return result;
+}
+
 int SerialIter::getVLDataLength ()
 {
     int b1 = get8();
@@ -668,6 +710,12 @@ SerialIter::getVL()
     return getRaw(getVLDataLength ());
 }
 
+Slice
+SerialIter::getVLSlice()
+{
+    return getSlice (getVLDataLength ());
+}
+
 Buffer
 SerialIter::getVLBuffer()
 {
@@ -687,4 +735,64 @@ getSHA512Half (void const* data, int len)
     return j[0];
 }
 
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Buffers kept per thread, and the largest one worth keeping
+std::size_t const poolBuffers = 8;
+std::size_t const poolBufferCapacity = 64 * 1024;
+
+boost::thread_specific_ptr<std::vector<Blob>> bufferPool;
+
+Blob acquireBuffer (std::size_t reserve)
+{
+    Blob buffer;
+
+    if (auto pool = bufferPool.get ())
+    {
+        if (!pool->empty ())
+        {
+            buffer = std::move (pool->back ());
+            pool->pop_back ();
+        }
+    }
+
+    buffer.reserve (reserve);
+    return buffer;
+}
+
+void releaseBuffer (Blob& buffer)
+{
+    if (buffer.capacity () == 0 || buffer.capacity () > poolBufferCapacity)
+        return;
+
+    auto pool = bufferPool.get ();
+
+    if (!pool)
+    {
+        pool = new std::vector<Blob>;
+        pool->reserve (poolBuffers);
+        bufferPool.reset (pool);
+    }
+
+    if (pool->size () < poolBuffers)
+    {
+        buffer.clear ();
+        pool->push_back (std::move (buffer));
+    }
+}
+
+}
+
+PooledSerializer::PooledSerializer (std::size_t reserve)
+    : Serializer (acquireBuffer (reserve))
+{
+}
+
+PooledSerializer::~PooledSerializer ()
+{
+    releaseBuffer (modData ());
+}
+
 } // bessel
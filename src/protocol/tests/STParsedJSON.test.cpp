@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <protocol/STParsedJSON.h>
+#include <common/json/FastReader.h>
+#include <common/json/json_reader.h>
+#include <common/json/to_string.h>
+#include <beast/unit_test/suite.h>
+#include <string>
+
+namespace bessel {
+
+class STParsedJSON_test : public beast::unit_test::suite
+{
+public:
+    // Parses a tx_json through Json::Value and through the FastReader
+    // tape, and checks that both give the same object or the same error.
+    void
+    check (std::string const& txJson, bool valid)
+    {
+        Json::Value value;
+        Json::FastReader reader;
+
+        expect (Json::Reader ().parse (txJson, value), txJson);
+        expect (reader.parse (txJson), txJson);
+
+        STParsedJSONObject const dom ("tx_json", value);
+        STParsedJSONObject const tape ("tx_json", reader.root ());
+
+        expect (bool (dom.object) == valid, txJson);
+        expect (bool (tape.object) == valid, txJson);
+
+        if (dom.object && tape.object)
+        {
+            expect (*dom.object == *tape.object, txJson);
+            expect (to_string (dom.object->getJson (0)) ==
+                to_string (tape.object->getJson (0)), txJson);
+        }
+        else
+        {
+            expect (to_string (dom.error) == to_string (tape.error),
+                to_string (dom.error) + " != " + to_string (tape.error));
+        }
+    }
+
+    void
+    testValid ()
+    {
+        testcase ("valid");
+
+        check (
+            "{\"TransactionType\":\"Payment\","
+            "\"Account\":\"bHb9CJAWyB4bj91VRWn96DkukG4bwdtyTh\","
+            "\"Destination\":\"bHb9CJAWyB4bj91VRWn96DkukG4bwdtyTh\","
+            "\"Amount\":\"1000\",\"Fee\":\"10\",\"Sequence\":7,\"Flags\":0,"
+            "\"Memos\":[{\"Memo\":{\"MemoType\":\"74657374\",\"MemoData\":\"00FF\"}}]}",
+            true);
+    }
+
+    void
+    testMalformed ()
+    {
+        testcase ("malformed");
+
+        char const* const documents[] = {
+            "{\"Fee\":null}",
+            "{\"Fee\":{\"currency\":\"USD\"}}",
+            "{\"NotAField\":1}",
+            "{\"TransactionType\":\"NoSuchType\"}",
+            "{\"TransactionType\":7}",
+            "{\"Sequence\":\"seven\"}",
+            "{\"Sequence\":-1}",
+            "{\"Sequence\":4294967296}",
+            "{\"Flags\":1.5}",
+            "{\"Account\":12}",
+            "{\"Account\":\"not an account\"}",
+            "{\"SigningPubKey\":\"XYZ\"}",
+            "{\"Memos\":{}}",
+            "{\"Memos\":[1]}",
+            "{\"Memos\":[{\"Memo\":1}]}",
+            "{\"Memos\":[{\"Memo\":{\"MemoType\":\"zz\"}}]}",
+            "{\"Memos\":[{\"Memo\":{},\"Other\":{}}]}",
+            "{\"Paths\":\"x\"}",
+            "{\"Paths\":[[1]]}",
+            "{\"Paths\":[[{\"account\":1}]]}",
+            "{\"Paths\":[[{\"currency\":\"USD\",\"issuer\":\"nobody\"}]]}",
+        };
+
+        for (auto const document : documents)
+            check (document, false);
+    }
+
+    void
+    run ()
+    {
+        testValid ();
+        testMalformed ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(STParsedJSON,protocol,bessel);
+
+} // bessel
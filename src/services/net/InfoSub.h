@@ -25,6 +25,7 @@
 #include <protocol/BesselAddress.h>
 #include <protocol/Book.h>
 #include <network/resource/Consumer.h>
+#include <services/websocket/Broadcast.h>
 #include <beast/threads/Stoppable.h>
 #include <mutex>
 
@@ -116,6 +117,16 @@ public:
     // virtual so that a derived class can optimize this case
     virtual void send (Json::Value const& jvObj, std::string const& sObj, bool broadcast);
 
+    /** Send an object published to many subscribers.
+        A derived class may use the frame the broadcast prepared.
+    */
+    virtual void send (websocket::Broadcast const& broadcast);
+
+    /** Returns the state of the client's outbound queue, or null if
+        messages have never had to wait for it.
+    */
+    virtual Json::Value getSendQueue ();
+
     std::uint64_t getSeq ();
 
     void onSendEmpty ();
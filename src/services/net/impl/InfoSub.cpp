@@ -78,6 +78,16 @@ void InfoSub::send (
     send (jvObj, broadcast);
 }
 
+void InfoSub::send (websocket::Broadcast const& broadcast)
+{
+    send (broadcast.json (), broadcast.text (), true);
+}
+
+Json::Value InfoSub::getSendQueue ()
+{
+    return Json::Value ();
+}
+
 std::uint64_t InfoSub::getSeq ()
 {
     return mSeq;
@@ -21,6 +21,7 @@
 #define BESSEL_RPC_CONTEXT_H_INCLUDED
 
 #include <common/core/Config.h>
+#include <common/json/FastReader.h>
 #include <services/net/InfoSub.h>
 #include <services/rpc/Yield.h>
 #include <services/server/Role.h>
@@ -42,6 +43,10 @@ struct Context
     InfoSub::pointer infoSub;
     RPC::Yield yield;
     NodeStore::ScopedMetrics metrics;
+
+    // The tx_json of the request as the client sent it, when the request
+    // was parsed by Json::FastReader; null otherwise.
+    Json::TapeValue txJson;
 };
 
 } // RPC
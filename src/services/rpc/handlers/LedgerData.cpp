@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <services/rpc/handlers/LedgerData.h>
+#include <services/rpc/Context.h>
+#include <services/rpc/impl/LookupLedger.h>
+#include <services/rpc/impl/Tuning.h>
+#include <protocol/ErrorCodes.h>
+#include <algorithm>
+
+namespace bessel {
+namespace RPC {
+
+LedgerDataHandler::LedgerDataHandler (Context& context)
+    : context_ (context)
+{
+}
+
+Status LedgerDataHandler::check ()
+{
+    auto const& params = context_.params;
+
+    if (params.isMember (jss::binary))
+    {
+        if (!params[jss::binary].isBool ())
+            return {rpcINVALID_PARAMS, expected_field_message (
+                jss::binary, "boolean")};
+        binary_ = params[jss::binary].asBool ();
+    }
+
+    unsigned int const maxLimit = binary_
+        ? Tuning::maxBinaryStatePerRequest
+        : Tuning::maxStatePerRequest;
+
+    limit_ = Tuning::defaultStatePerRequest;
+    if (params.isMember (jss::limit))
+    {
+        auto const& jvLimit = params[jss::limit];
+        if (!jvLimit.isIntegral ())
+            return {rpcINVALID_PARAMS, expected_field_message (
+                jss::limit, "unsigned integer")};
+
+        limit_ = jvLimit.isUInt () ? jvLimit.asUInt () :
+            std::max (0, jvLimit.asInt ());
+
+        if (context_.role != Role::ADMIN)
+            limit_ = std::max (Tuning::minStatePerRequest,
+                std::min (limit_, maxLimit));
+        else
+            limit_ = std::max (1u, limit_);
+    }
+
+    if (params.isMember (jss::marker))
+    {
+        auto const& jvMarker = params[jss::marker];
+        std::string const strMarker = jvMarker.isString ()
+            ? jvMarker.asString () : std::string ();
+        uint256 marker;
+        if (strMarker.size () != 2 * marker.size () ||
+            !marker.SetHexExact (strMarker.c_str ()))
+            return {rpcINVALID_PARAMS, invalid_field_message (jss::marker)};
+        marker_ = marker;
+    }
+
+    if (auto status = lookupLedger (
+            params, ledger_, context_.netOps, header_))
+        return status;
+
+    if (!ledger_->peekAccountStateMap ())
+        return rpcLGR_NOT_FOUND;
+
+    return Status::OK;
+}
+
+} // RPC
+} // bessel
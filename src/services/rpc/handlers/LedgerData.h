@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BESSEL_RPC_HANDLERS_LEDGERDATA_H_INCLUDED
+#define BESSEL_RPC_HANDLERS_LEDGERDATA_H_INCLUDED
+
+#include <ledger/Ledger.h>
+#include <common/base/StringUtilities.h>
+#include <common/json/Object.h>
+#include <protocol/JsonFields.h>
+#include <services/rpc/Status.h>
+#include <services/rpc/impl/Handler.h>
+#include <services/server/Role.h>
+#include <boost/optional.hpp>
+
+namespace bessel {
+namespace RPC {
+
+struct Context;
+
+/** Pages through the state map of a ledger.
+
+    {
+      ledger_hash : <ledger>
+      ledger_index : <ledger_index>
+      marker : <key>      // resume after this key, from a previous page
+      limit : <integer>   // entries per page
+      binary : <bool>     // serialized entries instead of JSON
+    }
+
+    The response carries "marker" while there are entries left. Pass the
+    ledger_hash of the first page with it, so every page comes from the
+    same state map. Entries are written one at a time, so the response
+    streams with the O(1) writer.
+*/
+class LedgerDataHandler
+{
+public:
+    explicit LedgerDataHandler (Context&);
+
+    Status check ();
+
+    template <class Object>
+    void writeResult (Object&);
+
+    static char const* const name ()
+    {
+        return "ledger_data";
+    }
+
+    static Role role ()
+    {
+        return Role::USER;
+    }
+
+    static Condition condition ()
+    {
+        return NEEDS_NETWORK_CONNECTION;
+    }
+
+private:
+    Context& context_;
+    Ledger::pointer ledger_;
+    Json::Value header_;
+    boost::optional<uint256> marker_;
+    unsigned int limit_ = 0;
+    bool binary_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation.
+
+template <class Object>
+void LedgerDataHandler::writeResult (Object& value)
+{
+    Json::copyFrom (value, header_);
+
+    auto const& stateMap = ledger_->peekAccountStateMap ();
+
+    auto item = marker_
+        ? stateMap->peekNextItem (*marker_)
+        : stateMap->peekFirstItem ();
+
+    {
+        auto&& state = Json::setArray (value, jss::state);
+
+        for (unsigned int count = 0; item && count < limit_; ++count)
+        {
+            if (binary_)
+            {
+                auto&& entry = Json::appendObject (state);
+                entry[jss::index] = to_string (item->getTag ());
+                entry[jss::data] = strHex (item->slice ());
+            }
+            else
+            {
+                STLedgerEntry sle (item->slice (), item->getTag ());
+                state.append (sle.getJson (0));
+            }
+
+            marker_ = item->getTag ();
+            item = stateMap->peekNextItem (*marker_);
+        }
+    }
+
+    // The last key written is where the next page starts
+    if (item && marker_)
+        value[jss::marker] = to_string (*marker_);
+}
+
+} // RPC
+} // bessel
+
+#endif
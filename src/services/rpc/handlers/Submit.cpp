@@ -57,7 +57,8 @@ Json::Value doSubmit (RPC::Context& context)
                 && context.params[jss::fail_hard].asBool ();
     
        return RPC::transactionSign (
-            context.params, true, bFailHard, context.netOps, context.role);
+            context.params, true, bFailHard, context.netOps, context.role,
+            context.txJson);
     }
 
     Json::Value jvResult;
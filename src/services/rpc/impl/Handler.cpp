@@ -21,6 +21,7 @@
 #include <services/rpc/impl/Handler.h>
 #include <services/rpc/handlers/Handlers.h>
 #include <services/rpc/handlers/Ledger.h>
+#include <services/rpc/handlers/LedgerData.h>
 #include <services/rpc/handlers/Version.h>
 
 namespace bessel {
@@ -68,6 +69,7 @@ class HandlerTable {
 
         // This is where the new-style handlers are added.
         addHandler<LedgerHandler>();
+        addHandler<LedgerDataHandler>();
         addHandler<VersionHandler>();
     }
 
@@ -272,7 +272,8 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
       @param result   A JSON object for injecting error results, if any
       @param admin    `true` if this is called by an administrative endpoint.
   */
-  static void autofill_fee(
+  // Returns true if a fee was filled in.
+  static bool autofill_fee(
       Json::Value& request,
       RPCDetail::LedgerFacade& ledgerFacade,
       Json::Value& result,
@@ -280,7 +281,7 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
   {
       Json::Value& tx(request[jss::tx_json]);
       if (tx.isMember(jss::Fee))
-          return;
+          return false;
 
       std::uint32_t count = 1; 
       if (request[jss::tx_json].isMember(jss::Operations))
@@ -299,7 +300,7 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
           {
               RPC::inject_error(rpcHIGH_FEE, RPC::expected_field_message(
                   jss::fee_mult_max, "a number"), result);
-              return;
+              return false;
           }
       }
 
@@ -317,10 +318,11 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
               "Fee of " << fee <<
               " exceeds the requested tx limit of " << limit;
           RPC::inject_error(rpcHIGH_FEE, ss.str(), result);
-          return;
+          return false;
       }
 
       tx[jss::Fee] = static_cast<int>(fee) * count;
+      return true;
   }
 
   static Json::Value signPayment(
@@ -329,6 +331,7 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
       BesselAddress const& raSrcAddressID,
       RPCDetail::LedgerFacade& ledgerFacade,
       Role role,
+      bool& modified,
       int const& index = 0)
   {
       boost::format  error = boost::format("tx_json[%d].%s");
@@ -406,7 +409,10 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
                   << to_string(spsPaths.getJson(0));
 
               if (!spsPaths.empty())
+              {
                   tx_json[jss::Paths] = spsPaths.getJson(0);
+                  modified = true;
+              }
           }
       }
       return Json::Value();
@@ -514,12 +520,15 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
           std::string const sType = op[jss::TransactionType].asString();
           if ("Payment" == sType)
           {
+              // Operations are always signed from the Json::Value
+              bool modified = true;
               auto e = signPayment(
                   params,
                   op,
                   raSrcAddressID,
                   src_LedgerFacade,
                   role,
+                  modified,
                   index);
               if (contains_error(e))
                   return e;
@@ -635,7 +644,8 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
       bool bSubmit,
       bool bFailHard,
       RPCDetail::LedgerFacade& ledgerFacade,
-      Role role)
+      Role role,
+      Json::TapeValue const& txJson)
   {
       Json::Value jvResult;
 
@@ -699,7 +709,12 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
           }
       }
 
-      autofill_fee(params, ledgerFacade, jvResult, role == Role::ADMIN);
+      // Set whenever tx_json is written, so the transaction is only built
+      // from the request tape while tx_json is still what the client sent.
+      bool modified = false;
+
+      if (autofill_fee(params, ledgerFacade, jvResult, role == Role::ADMIN))
+          modified = true;
       if (RPC::contains_error(jvResult))
           return jvResult;
 
@@ -767,6 +782,7 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
       }*/
         if ("Operation" == sType)
 	       {
+		        modified = true;
 		        auto e = signOperation(params,
 			          tx_json, 
 			          ledgerFacade, 
@@ -784,21 +800,29 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
                   tx_json,
                   raSrcAddressID,
                   ledgerFacade,
-                  role);
+                  role,
+                  modified);
               if (contains_error(e))
                   return e;
           }       
       
 
       if (!tx_json.isMember(jss::Sequence))
+      {
           tx_json[jss::Sequence] = ledgerFacade.getSeq();
+          modified = true;
+      }
       if (!tx_json.isMember(jss::Timestamp))
       {
           tx_json[jss::Timestamp] = getApp().getOPs().getNetworkTimeNC();
+          modified = true;
       }
 
       if (!tx_json.isMember(jss::Flags))
+      {
           tx_json[jss::Flags] = tfFullyCanonicalSig;
+          modified = true;
+      }
 
       if (verify)
       {
@@ -825,16 +849,22 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
           }
       }
 
-      STParsedJSONObject parsed(std::string(jss::tx_json), tx_json);
-      if (!parsed.object)
+      // Unless something above wrote to tx_json, the transaction is built
+      // straight from the request tape.
+      bool const asReceived = txJson.isObject() && !modified;
+
+      auto const parsed = asReceived
+          ? std::make_unique<STParsedJSONObject>(std::string(jss::tx_json), txJson)
+          : std::make_unique<STParsedJSONObject>(std::string(jss::tx_json), tx_json);
+      if (!parsed->object)
       {
-          jvResult[jss::error] = parsed.error[jss::error];
-          jvResult[jss::error_code] = parsed.error[jss::error_code];
-          jvResult[jss::error_message] = parsed.error[jss::error_message];
+          jvResult[jss::error] = parsed->error[jss::error];
+          jvResult[jss::error_code] = parsed->error[jss::error_code];
+          jvResult[jss::error_message] = parsed->error[jss::error_message];
           return jvResult;
       }
 
-      parsed.object->setFieldVL(
+      parsed->object->setFieldVL(
           sfSigningPubKey,
           keypair.publicKey.getAccountPublic());
 
@@ -842,7 +872,7 @@ NetworkOPs& LedgerFacade::getNetworkOPs() const
 
       try
       {
-          stpTrans = std::make_shared<STTx>(std::move(*parsed.object));
+          stpTrans = std::make_shared<STTx>(std::move(*parsed->object));
       }
       catch (std::exception&)
       {
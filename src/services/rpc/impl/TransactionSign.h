@@ -20,6 +20,7 @@
 #ifndef BESSEL_RPC_TRANSACTIONSIGN_H_INCLUDED
 #define BESSEL_RPC_TRANSACTIONSIGN_H_INCLUDED
 #include <services/server/Role.h>
+#include <common/json/FastReader.h>
 #include <common/misc/NetworkOPs.h>
 
 namespace bessel {
@@ -118,22 +119,30 @@ namespace bessel {
             bool const verify,
             Role role);
 
+        /** Sign and optionally submit the tx_json of a request.
+
+            @param txJson The tx_json as the client sent it, from the
+                          request's Json::FastReader tape, if there is one.
+        */
         Json::Value transactionSign(
             Json::Value params,
             bool bSubmit,
             bool bFailHard,
             RPCDetail::LedgerFacade& ledgerFacade,
-            Role role);
+            Role role,
+            Json::TapeValue const& txJson = Json::TapeValue());
 
         inline Json::Value transactionSign(
             Json::Value params,
             bool bSubmit,
             bool bFailHard,
             NetworkOPs& netOPs,
-            Role role)
+            Role role,
+            Json::TapeValue const& txJson = Json::TapeValue())
         {
             RPCDetail::LedgerFacade ledgerFacade(netOPs);
-            return transactionSign(params, bSubmit, bFailHard, ledgerFacade, role);
+            return transactionSign(params, bSubmit, bFailHard, ledgerFacade,
+                role, txJson);
         }
 
     } // RPC
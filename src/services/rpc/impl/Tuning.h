@@ -72,6 +72,26 @@ static unsigned int const minOffersPerRequest (10);
 */
 static unsigned int const maxOffersPerRequest (400);
 
+/** Default state entries returned per request from the
+    ledger_data command when no limit param is specified.
+*/
+static unsigned int const defaultStatePerRequest (256);
+
+/** Minimum state entries returned per request from the
+    ledger_data command. Specified in the limit param.
+*/
+static unsigned int const minStatePerRequest (16);
+
+/** Maximum state entries returned per request from the
+    ledger_data command as JSON. Specified in the limit param.
+*/
+static unsigned int const maxStatePerRequest (2048);
+
+/** Maximum state entries returned per request from the
+    ledger_data command as binary. Specified in the limit param.
+*/
+static unsigned int const maxBinaryStatePerRequest (16384);
+
 static int const defaultAutoFillFeeMultiplier (10);
 static int const maxPathfindsInProgress (2);
 static int const maxPathfindJobCount (50);
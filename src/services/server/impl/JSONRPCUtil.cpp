@@ -25,6 +25,7 @@
 #include <protocol/BuildInfo.h>
 #include <protocol/SystemParameters.h>
 #include <boost/algorithm/string.hpp>
+#include <cstdio>
 
 namespace bessel {
 
@@ -47,6 +48,19 @@ std::string getHTTPHeaderTimestamp ()
     return std::string (buffer);
 }
 
+static void HTTPStatusLine (int nStatus, Json::Output const& output)
+{
+    switch (nStatus)
+    {
+    case 200: output ("HTTP/1.1 200 OK\r\n"); break;
+    case 400: output ("HTTP/1.1 400 Bad Request\r\n"); break;
+    case 403: output ("HTTP/1.1 403 Forbidden\r\n"); break;
+    case 404: output ("HTTP/1.1 404 Not Found\r\n"); break;
+    case 500: output ("HTTP/1.1 500 Internal Server Error\r\n"); break;
+    case 503: output ("HTTP/1.1 503 Service Unavailable\r\n"); break;
+    }
+}
+
 void HTTPReply (
     int nStatus, std::string const& content, Json::Output const& output)
 {
@@ -88,15 +102,7 @@ void HTTPReply (
         return;
     }
 
-    switch (nStatus)
-    {
-    case 200: output ("HTTP/1.1 200 OK\r\n"); break;
-    case 400: output ("HTTP/1.1 400 Bad Request\r\n"); break;
-    case 403: output ("HTTP/1.1 403 Forbidden\r\n"); break;
-    case 404: output ("HTTP/1.1 404 Not Found\r\n"); break;
-    case 500: output ("HTTP/1.1 500 Internal Server Error\r\n"); break;
-    }
-
+    HTTPStatusLine (nStatus, output);
     output (getHTTPHeaderTimestamp ());
 
     output ("Connection: Keep-Alive\r\n"
@@ -118,4 +124,36 @@ void HTTPReply (
     output ("\r\n");
 }
 
+void HTTPChunkedReplyHeader (int nStatus, Json::Output const& output)
+{
+    HTTPStatusLine (nStatus, output);
+    output (getHTTPHeaderTimestamp ());
+
+    output ("Connection: Keep-Alive\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "Content-Type: application/json; charset=UTF-8\r\n");
+
+    output ("Server: " + systemName () + "-json-rpc/");
+    output (BuildInfo::getFullVersionString ());
+    output ("\r\n"
+            "\r\n");
+}
+
+void HTTPChunk (std::string const& content, Json::Output const& output)
+{
+    if (content.empty ())
+        return;
+
+    char size[24];
+    snprintf (size, sizeof (size), "%zx\r\n", content.size ());
+    output (size);
+    output (content);
+    output ("\r\n");
+}
+
+void HTTPLastChunk (Json::Output const& output)
+{
+    output ("0\r\n\r\n");
+}
+
 } // bessel
@@ -27,6 +27,19 @@ namespace bessel {
 
 void HTTPReply (int nStatus, std::string const& strMsg, Json::Output const&);
 
+/** Writes the head of a reply whose body follows in chunks.
+    Used when the body is sent while it is still being built.
+*/
+void HTTPChunkedReplyHeader (int nStatus, Json::Output const&);
+
+/** Writes one chunk of a chunked reply body. Empty content writes nothing,
+    since an empty chunk would end the body.
+*/
+void HTTPChunk (std::string const& content, Json::Output const&);
+
+/** Ends a chunked reply body. */
+void HTTPLastChunk (Json::Output const&);
+
 } // bessel
 
 #endif
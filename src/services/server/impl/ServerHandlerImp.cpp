@@ -19,9 +19,11 @@
 
 #include <BeastConfig.h>
 #include <main/Application.h>
+#include <common/json/FastReader.h>
 #include <common/json/json_reader.h>
 #include <common/json/json_value.h>
 #include <common/json/to_string.h>
+#include <common/json/Writer.h>
 #include <network/resource/Manager.h>
 #include <network/resource/Fees.h>
 #include <common/base/Log.h>
@@ -40,6 +42,7 @@
 #include <boost/optional.hpp>
 #include <boost/regex.hpp>
 #include <algorithm>
+#include <mutex>
 #include <stdexcept>
 #include <common/misc/Utility.h>
 #include <common/misc/std_rfc2616.h>
@@ -178,8 +181,115 @@ void runCoroutine (RPC::Coroutine coroutine, JobQueue& jobQueue)
         });
 }
 
+// The most calls a single JSON-RPC batch may carry
+std::size_t const maxBatchSize = 250;
+
+// The most calls of one batch that may be on the job queue at once
+std::size_t const maxBatchJobs = 4;
+
+// Returns `true` if the body is a JSON-RPC batch, that is, an array
+bool isBatchRequest (std::string const& body)
+{
+    auto const first = body.find_first_not_of (" \t\r\n");
+    return first != std::string::npos && body[first] == '[';
+}
+
 } // namespace
 
+// A batch whose calls are running on the job queue.
+//
+// The reply is sent with chunked encoding. Each call's reply is written
+// to the session as soon as every reply before it is in, so the client
+// gets the array in request order while later calls are still running.
+// Only the replies that finished ahead of their turn are held here.
+struct ServerHandlerImp::BatchState
+{
+    std::shared_ptr<HTTP::Session> session;
+    std::unique_ptr<Json::FastReader> reader;
+    Json::Value calls;
+    Json::TapeValue tape;
+    std::chrono::high_resolution_clock::time_point const start;
+
+    std::mutex mutex;
+    std::vector<Json::Value> replies;
+    std::vector<bool> done;
+    std::size_t dispatched;
+    std::size_t next;
+    std::size_t remaining;
+    std::size_t size;
+    std::string chunk;
+    Json::Writer writer;
+
+    BatchState (std::shared_ptr<HTTP::Session> const& s,
+            std::unique_ptr<Json::FastReader>&& r, Json::Value&& c,
+            Json::TapeValue const& t)
+        : session (s)
+        , reader (std::move (r))
+        , calls (std::move (c))
+        , tape (t)
+        , start (std::chrono::high_resolution_clock::now ())
+        , replies (calls.size ())
+        , done (calls.size (), false)
+        , dispatched (0)
+        , next (0)
+        , remaining (calls.size ())
+        , size (0)
+        , writer ([this] (boost::string_ref const& b)
+            {
+                chunk.append (b.data (), b.size ());
+            })
+    {
+        writer.startRoot (Json::Writer::array);
+    }
+
+    // Returns `true` and the index of the next call to run, if any is left
+    bool dispatch (std::size_t& index)
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+
+        if (dispatched == calls.size ())
+            return false;
+
+        index = dispatched++;
+        return true;
+    }
+
+    // Returns `true` if this was the last reply outstanding
+    bool complete (std::size_t index, Json::Value&& reply)
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+
+        replies[index] = std::move (reply);
+        done[index] = true;
+
+        for (; next < done.size () && done[next]; ++next)
+        {
+            writer.rawAppend ();
+            writer.output (replies[next]);
+            replies[next] = Json::Value ();
+        }
+
+        bool const last = (--remaining == 0);
+
+        if (last)
+        {
+            writer.finishAll ();
+            chunk += '\n';
+        }
+
+        // Written under the lock so that chunks go out in order
+        auto const output = makeOutput (*session);
+        size += chunk.size ();
+        HTTPChunk (chunk, output);
+        chunk.clear ();
+
+        if (last)
+            HTTPLastChunk (output);
+
+        return last;
+    }
+};
+
 void
 ServerHandlerImp::onRequest (HTTP::Session& session)
 {
@@ -243,12 +353,39 @@ ServerHandlerImp::processSession (std::shared_ptr<HTTP::Session> const& session,
     boost::asio::ip::tcp::endpoint end;
     end.address(session->remoteAddress().address());
     end.port(0);
-    processRequest (
-        session->port(),
-        to_string (session->body()),
-        end,
-        output,
-        yield);
+
+    auto const request = to_string (session->body());
+
+    if (isBatchRequest (request))
+    {
+        // The reader holds the tape the calls are read from, so it lives
+        // as long as the batch.
+        auto reader = std::make_unique<Json::FastReader> ();
+        Json::Value batch;
+        Json::TapeValue tape;
+
+        if ((request.size () <= 1000000) &&
+            Json::parse (*reader, request, batch, tape, jss::tx_json) &&
+            batch.size () > 0 &&
+            batch.size () <= maxBatchSize)
+        {
+            // The batch completes the session once its last call is done
+            processBatch (std::make_shared<BatchState> (session,
+                std::move (reader), std::move (batch), tape), end);
+            return;
+        }
+
+        HTTPReply (400, "Unable to parse batch request", output);
+    }
+    else
+    {
+        processRequest (
+            session->port(),
+            request,
+            end,
+            output,
+            yield);
+    }
 
     if (session->request().keep_alive())
         session->complete();
@@ -256,27 +393,36 @@ ServerHandlerImp::processSession (std::shared_ptr<HTTP::Session> const& session,
         session->close (true);
 }
 
-void
-ServerHandlerImp::processRequest (
-    HTTP::Port const& port,
-    std::string const& request,
-    boost::asio::ip::tcp::endpoint const& remoteIPAddress,
-    Output output,
-    Yield yield)
+// Marks the result of a call as a success or an error. On an error the
+// request is reported as received.
+static void
+finishResult (Json::Value& result, Json::Value const& params)
 {
-    Json::Value jsonRPC;
+    if (result.isMember (jss::error))
     {
-        Json::Reader reader;
-        if ((request.size () > 1000000) ||
-            ! reader.parse (request, jsonRPC) ||
-            jsonRPC.isNull () ||
-            ! jsonRPC.isObject ())
-        {
-            HTTPReply (400, "Unable to parse request", output);
-            return;
-        }
+        result[jss::status] = jss::error;
+        result[jss::request] = params;
+
+        WriteLog (lsDEBUG, RPCErr) <<
+            "rpcError: " << result [jss::error] <<
+            ": " << result [jss::error_message];
+    }
+    else
+    {
+        result[jss::status]  = jss::success;
     }
+}
 
+void
+ServerHandlerImp::processCall (
+    HTTP::Port const& port,
+    Json::Value const& jsonRPC,
+    Json::TapeValue const& tape,
+    boost::asio::ip::tcp::endpoint const& remoteIPAddress,
+    Yield yield,
+    std::function <void (int, std::string const&)> const& reject,
+    std::function <void (RPC::Context&)> const& execute)
+{
     // Parse id now so errors from here on will have the id
     //
     //  NOTE Except that "id" isn't included in the following errors.
@@ -286,12 +432,12 @@ ServerHandlerImp::processRequest (
     Json::Value const& method = jsonRPC ["method"];
 
     if (method.isNull ()) {
-        HTTPReply (400, "Null method", output);
+        reject (400, "Null method");
         return;
     }
 
     if (!method.isString ()) {
-        HTTPReply (400, "method is not string", output);
+        reject (400, "method is not string");
         return;
     }
 
@@ -321,14 +467,14 @@ ServerHandlerImp::processRequest (
 
     if (usage.disconnect ())
     {
-        HTTPReply (503, "Server is overloaded", output);
+        reject (503, "Server is overloaded");
         return;
     }
 
     std::string strMethod = method.asString ();
     if (strMethod.empty())
     {
-        HTTPReply (400, "method is empty", output);
+        reject (400, "method is empty");
         return;
     }
 
@@ -345,7 +491,7 @@ ServerHandlerImp::processRequest (
 
     else if (!params.isArray () || params.size() != 1)
     {
-        HTTPReply (400, "params unparseable", output);
+        reject (400, "params unparseable");
         return;
     }
     else
@@ -353,7 +499,7 @@ ServerHandlerImp::processRequest (
         params = std::move (params[0u]);
         if (!params.isObject())
         {
-            HTTPReply (400, "params unparseable", output);
+            reject (400, "params unparseable");
             return;
         }
     }
@@ -365,7 +511,7 @@ ServerHandlerImp::processRequest (
         //  TODO Needs implementing
         // FIXME Needs implementing
         // XXX This needs rate limiting to prevent brute forcing password.
-        HTTPReply (403, "Forbidden", output);
+        reject (403, "Forbidden");
         return;
     }
 
@@ -382,39 +528,10 @@ ServerHandlerImp::processRequest (
 
     auto const start (std::chrono::high_resolution_clock::now ());
     RPC::Context context {params, loadType, m_networkOPs, role, nullptr, yield};
+    context.txJson = tape[jss::params][0u][jss::tx_json];
     //RPC::RPCInfo::updateCmd(context.params,true);
-    
-    std::string response;
-
-    if (setup_.yieldStrategy.streaming == RPC::YieldStrategy::Streaming::yes)
-    {
-        executeRPC (context, response, setup_.yieldStrategy);
-    }
-    else
-    {
-        Json::Value result;
-        RPC::doCommand (context, result, setup_.yieldStrategy);
-	//RPC::RPCInfo::updateError(context.params,result,true);
-        // Always report "status".  On an error report the request as received.
-        if (result.isMember (jss::error))
-        {
-            //WriteLog (lsWARNING, RPCErr) <<"----RPC---error\n "<<result;
-            result[jss::status] = jss::error;
-            result[jss::request] = params;
-    
-            WriteLog (lsDEBUG, RPCErr) <<
-                "rpcError: " << result [jss::error] <<
-                ": " << result [jss::error_message];
-        }
-        else
-        {
-            result[jss::status]  = jss::success;
-        }
 
-        Json::Value reply (Json::objectValue);
-        reply[jss::result] = std::move (result);
-        response = to_string (reply);
-    }
+    execute (context);
 
     rpc_time_.notify (static_cast <beast::insight::Event::value_type> (
                                         std::chrono::duration_cast <std::chrono::milliseconds> (
@@ -423,10 +540,65 @@ ServerHandlerImp::processRequest (
     ++rpc_requests_;
 
     rpc_io_.notify (static_cast <beast::insight::Event::value_type> (context.metrics.fetches));
+
+    usage.charge (loadType);
+}
+
+void
+ServerHandlerImp::processRequest (
+    HTTP::Port const& port,
+    std::string const& request,
+    boost::asio::ip::tcp::endpoint const& remoteIPAddress,
+    Output output,
+    Yield yield)
+{
+    Json::FastReader reader;
+    Json::Value jsonRPC;
+    Json::TapeValue tape;
+
+    if ((request.size () > 1000000) ||
+        ! Json::parse (reader, request, jsonRPC, tape, jss::tx_json) ||
+        jsonRPC.isNull () ||
+        ! jsonRPC.isObject ())
+    {
+        HTTPReply (400, "Unable to parse request", output);
+        return;
+    }
+
+    bool rejected = false;
+    std::string response;
+
+    processCall (port, jsonRPC, tape, remoteIPAddress, yield,
+        [&] (int status, std::string const& message)
+        {
+            HTTPReply (status, message, output);
+            rejected = true;
+        },
+        [&] (RPC::Context& context)
+        {
+            if (setup_.yieldStrategy.streaming == RPC::YieldStrategy::Streaming::yes)
+            {
+                executeRPC (context, response, setup_.yieldStrategy);
+                return;
+            }
+
+            Json::Value result;
+            RPC::doCommand (context, result, setup_.yieldStrategy);
+            //RPC::RPCInfo::updateError(context.params,result,true);
+            // Always report "status".  On an error report the request as received.
+            finishResult (result, context.params);
+
+            Json::Value reply (Json::objectValue);
+            reply[jss::result] = std::move (result);
+            response = to_string (reply);
+        });
+
+    if (rejected)
+        return;
+
     rpc_size_.notify (static_cast <beast::insight::Event::value_type> (response.size ()));
 
     response += '\n';
-    usage.charge (loadType);
 
     if (m_journal.debug.active())
     {
@@ -442,6 +614,129 @@ ServerHandlerImp::processRequest (
 
 //------------------------------------------------------------------------------
 
+void
+ServerHandlerImp::processBatch (
+    std::shared_ptr<BatchState> const& state,
+    boost::asio::ip::tcp::endpoint const& remoteIPAddress)
+{
+    m_journal.debug << "Batch of " << state->calls.size () << " calls";
+
+    // Turn away an overloaded client before any of its calls are queued.
+    // Each call is still charged to its own consumer as it runs.
+    auto const role = requestRole (Role::GUEST, state->session->port (),
+        Json::objectValue, remoteIPAddress);
+
+    Resource::Consumer usage = (role == Role::ADMIN) ?
+        m_resourceManager.newAdminEndpoint (
+            convert_endpoint_to_string (remoteIPAddress)) :
+        m_resourceManager.newInboundEndpoint (remoteIPAddress);
+
+    if (usage.disconnect ())
+    {
+        HTTPReply (503, "Server is overloaded", makeOutput (*state->session));
+
+        if (state->session->request().keep_alive())
+            state->session->complete();
+        else
+            state->session->close (true);
+
+        return;
+    }
+
+    HTTPChunkedReplyHeader (200, makeOutput (*state->session));
+
+    // A batch keeps only a few calls on the job queue at a time, so one
+    // client can't crowd out everyone else's requests. Each finished call
+    // queues the next one.
+    for (std::size_t i = 0; i < maxBatchJobs; ++i)
+    {
+        if (! processBatchNext (state, remoteIPAddress))
+            break;
+    }
+}
+
+bool
+ServerHandlerImp::processBatchNext (
+    std::shared_ptr<BatchState> const& state,
+    boost::asio::ip::tcp::endpoint const& remoteIPAddress)
+{
+    std::size_t i;
+
+    if (! state->dispatch (i))
+        return false;
+
+    m_jobQueue.addJob (
+        jtCLIENT, "RPC-Batch",
+        [this, state, i, remoteIPAddress] (Job&)
+        {
+            auto reply = processBatchElement (state->session->port (),
+                state->calls[Json::UInt (i)], state->tape[Json::UInt (i)],
+                remoteIPAddress);
+
+            if (! state->complete (i, std::move (reply)))
+            {
+                processBatchNext (state, remoteIPAddress);
+                return;
+            }
+
+            rpc_size_.notify (static_cast <beast::insight::Event::value_type> (
+                state->size));
+
+            if (state->session->request().keep_alive())
+                state->session->complete();
+            else
+                state->session->close (true);
+        });
+
+    return true;
+}
+
+// Runs one call of a batch. Problems that would fail a lone request with
+// an HTTP error are reported in this call's reply instead, so the rest of
+// the batch still runs.
+Json::Value
+ServerHandlerImp::processBatchElement (
+    HTTP::Port const& port,
+    Json::Value const& jsonRPC,
+    Json::TapeValue const& tape,
+    boost::asio::ip::tcp::endpoint const& remoteIPAddress)
+{
+    Json::Value reply (Json::objectValue);
+
+    if (! jsonRPC.isObject ())
+    {
+        Json::Value result = RPC::make_error (rpcINVALID_PARAMS, "call is not an object");
+        result[jss::status] = jss::error;
+        reply[jss::result] = std::move (result);
+        return reply;
+    }
+
+    if (jsonRPC.isMember (jss::id))
+        reply[jss::id] = jsonRPC[jss::id];
+
+    processCall (port, jsonRPC, tape, remoteIPAddress, RPC::Yield{},
+        [&] (int status, std::string const& message)
+        {
+            auto const code = (status == 503) ? rpcSLOW_DOWN :
+                (status == 403) ? rpcFORBIDDEN : rpcINVALID_PARAMS;
+
+            Json::Value result = RPC::make_error (code, message);
+            result[jss::status] = jss::error;
+            reply[jss::result] = std::move (result);
+        },
+        [&] (RPC::Context& context)
+        {
+            Json::Value result;
+            RPC::doCommand (context, result, setup_.yieldStrategy);
+            finishResult (result, context.params);
+            reply[jss::result] = std::move (result);
+        });
+
+    return reply;
+}
+
+//------------------------------------------------------------------------------
+
 // Returns `true` if the HTTP request is a Websockets Upgrade
 // http://en.wikipedia.org/wiki/HTTP/1.1_Upgrade_header#Use_with_WebSockets
 bool
@@ -29,6 +29,7 @@
 #include <services/rpc/handlers/RPCInfo.h>
 #include <main/CollectorManager.h>
 #include <boost/asio.hpp>
+#include <functional>
 #include <common/misc/sslbundle.h>
 
 namespace bessel {
@@ -64,6 +65,8 @@ private:
     using Output = Json::Output;
     using Yield  = RPC::Yield;
 
+    struct BatchState;
+
     void
     setup (Setup const& setup, beast::Journal journal) override;
 
@@ -116,6 +119,19 @@ private:
     void
     processSession (std::shared_ptr<HTTP::Session> const&, Yield const&);
 
+    // Validates one JSON-RPC call and, if it may run, passes its context
+    // to `execute`, then records the call metrics and charges the caller.
+    // Problems that keep the call from running go to `reject` as an HTTP
+    // status and message, and nothing is charged.
+    void
+    processCall (HTTP::Port const& port,
+                 Json::Value const& jsonRPC,
+                 Json::TapeValue const& tape,
+                 boost::asio::ip::tcp::endpoint const& remoteIPAddress,
+                 Yield yield,
+                 std::function <void (int, std::string const&)> const& reject,
+                 std::function <void (RPC::Context&)> const& execute);
+
     void
     processRequest (HTTP::Port const& port, 
                     std::string const& request,
@@ -123,6 +139,22 @@ private:
                     Output,
                     Yield);
 
+    void
+    processBatch (std::shared_ptr<BatchState> const& state,
+                  boost::asio::ip::tcp::endpoint const& remoteIPAddress);
+
+    // Queues the next call of the batch that hasn't been started.
+    // Returns `false` if every call has been started already.
+    bool
+    processBatchNext (std::shared_ptr<BatchState> const& state,
+                      boost::asio::ip::tcp::endpoint const& remoteIPAddress);
+
+    Json::Value
+    processBatchElement (HTTP::Port const& port,
+                         Json::Value const& jsonRPC,
+                         Json::TapeValue const& tape,
+                         boost::asio::ip::tcp::endpoint const& remoteIPAddress);
+
     //
     // PropertyStream
     //
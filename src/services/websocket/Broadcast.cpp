@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <services/websocket/Broadcast.h>
+#include <services/websocket/Deflate.h>
+#include <common/json/to_string.h>
+#include <protocol/JsonFields.h>
+#include <chrono>
+
+namespace bessel {
+namespace websocket {
+
+namespace {
+
+// Compression is tracked per stream, named by the object's type
+std::string streamName (Json::Value const& jvObj)
+{
+    return jvObj.isMember (jss::type)
+        ? jvObj[jss::type].asString () : "unknown";
+}
+
+} // namespace
+
+Broadcast::Broadcast (Json::Value const& jvObj, DeflateStats& stats)
+    : json_ (jvObj)
+    , text_ (to_string (jvObj))
+    , stats_ (stats)
+    , sends_ (0)
+{
+}
+
+Broadcast::~Broadcast ()
+{
+    if (sends_ != 0)
+        stats_.sent (streamName (json_), sends_);
+}
+
+Broadcast::Frame const* Broadcast::frame (int deflateWindowBits) const
+{
+    if (text_.size () < minDeflateSize ||
+        !canDeflate (text_.size (), deflateWindowBits))
+        return nullptr;
+
+    std::call_once (deflated_, [this] ()
+    {
+        auto const start = std::chrono::steady_clock::now ();
+        auto payload = Deflater::local ().compress (text_);
+        auto const elapsed = std::chrono::duration_cast <
+            std::chrono::microseconds> (
+                std::chrono::steady_clock::now () - start);
+
+        stats_.compressed (streamName (json_), text_.size (),
+            payload.size (), elapsed);
+        frame_ = makeFrame (std::move (payload));
+    });
+
+    ++sends_;
+    return frame_.get ();
+}
+
+} // websocket
+} // bessel
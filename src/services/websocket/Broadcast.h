@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BESSEL_WEBSOCKET_BROADCAST_H_INCLUDED
+#define BESSEL_WEBSOCKET_BROADCAST_H_INCLUDED
+
+#include <common/json/json_value.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace bessel {
+namespace websocket {
+
+class DeflateStats;
+
+/** An object published to many subscribers, prepared at the publish site.
+
+    The object is serialized once when the broadcast is made. The first
+    subscriber that can take it compressed causes it to be deflated, once,
+    into a frame that every such subscriber is then sent unchanged.
+*/
+class Broadcast
+{
+public:
+    /** A compressed frame, defined by the websocket implementation. */
+    struct Frame;
+
+    Broadcast (Json::Value const& jvObj, DeflateStats& stats);
+    ~Broadcast ();
+
+    Broadcast (Broadcast const&) = delete;
+    Broadcast& operator= (Broadcast const&) = delete;
+
+    Json::Value const&
+    json () const
+    {
+        return json_;
+    }
+
+    std::string const&
+    text () const
+    {
+        return text_;
+    }
+
+    /** Returns the compressed frame for a client, or nullptr if the
+        client must be sent the text instead.
+
+        @param deflateWindowBits The permessage-deflate window the client
+                                 accepts, 0 if none.
+    */
+    Frame const* frame (int deflateWindowBits) const;
+
+private:
+    // Defined by the websocket implementation
+    static std::shared_ptr <Frame const> makeFrame (std::string&& payload);
+
+    Json::Value const& json_;
+    std::string const text_;
+    DeflateStats& stats_;
+
+    mutable std::once_flag deflated_;
+    mutable std::shared_ptr <Frame const> frame_;
+    mutable std::atomic <std::size_t> sends_;
+};
+
+} // websocket
+} // bessel
+
+#endif
@@ -25,6 +25,7 @@
 #include <services/websocket/Logger.h>
 
 #include <websocketpp/config/core.hpp>
+#include <websocketpp/extensions/permessage_deflate/enabled.hpp>
 #include <websocketpp/server.hpp>
 #include <websocketpp/transport/asio/endpoint.hpp>
 
@@ -66,6 +67,13 @@ struct Config04 : ConfigBase04 {
 
     typedef websocketpp::transport::asio::endpoint<transport_config>
         transport_type;
+
+    /// Negotiates permessage-deflate and inflates client messages. Our
+    /// outgoing messages are compressed by HandlerImpl, see Deflate.h.
+    struct permessage_deflate_config {};
+
+    typedef websocketpp::extensions::permessage_deflate::enabled
+        <permessage_deflate_config> permessage_deflate_type;
 };
 
 } // websocket
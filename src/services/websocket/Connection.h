@@ -25,6 +25,7 @@
 #include <common/base/CountedObject.h>
 #include <common/base/Log.h>
 #include <common/core/Config.h>
+#include <common/json/FastReader.h>
 #include <common/json/to_string.h>
 #include <network/resource/Fees.h>
 #include <network/resource/Manager.h>
@@ -37,6 +38,7 @@
 #include <services/server/Port.h>
 #include <services/rpc/RPCHandler.h>
 #include <services/server/Role.h>
+#include <services/websocket/SendQueue.h>
 #include <services/websocket/WebSocket.h>
 #include <boost/asio.hpp>
 #include <memory>
@@ -81,6 +83,19 @@ public:
 
     void send (Json::Value const& jvObj, bool broadcast);
 
+    void send (Json::Value const& jvObj, std::string const& sObj,
+        bool broadcast);
+
+    void send (Broadcast const& broadcast) override;
+
+    Json::Value getSendQueue () override;
+
+    /** The permessage-deflate window the client accepts, 0 if none. */
+    int deflateWindowBits () const
+    {
+        return m_deflateWindowBits;
+    }
+
     void disconnect ();
 
     static void handle_disconnect(weak_connection_ptr c);
@@ -89,17 +104,24 @@ public:
 
     void pingTimer (typename WebSocket::ErrorCode const& e);
 
+    void drainTimer (typename WebSocket::ErrorCode const& e);
+
     void onPong (std::string const&);
     void rcvMessage (message_ptr const&, bool& msgRejected, bool& runQueue);
     message_ptr getMessage ();
     bool checkMessage ();
     void returnMessage (message_ptr const&);
-    Json::Value invokeCommand (Json::Value& jvRequest);
+    Json::Value invokeCommand (Json::Value& jvRequest,
+        Json::TapeValue const& txJson = Json::TapeValue ());
 
     // Generically implemented per version.
     void setPingTimer ();
+    void setDrainTimer ();
 
 private:
+    void enqueue (connection_ptr const& ptr, message_ptr const& msg,
+        Json::Value const& jvObj);
+
     HTTP::Port const& m_port;
     Resource::Manager& m_resourceManager;
     Resource::Consumer m_usage;
@@ -110,6 +132,13 @@ private:
     NetworkOPs& m_netOPs;
     boost::asio::io_service& m_io_service;
     boost::asio::deadline_timer m_pingTimer;
+    int const m_deflateWindowBits;
+
+    // Messages waiting until websocketpp has room for them
+    std::mutex m_sendQueueMutex;
+    SendQueue <message_ptr> m_sendQueue;
+    bool m_sendQueueDraining = false;
+    bool m_sendQueueClosed = false;
 
     bool m_sentPing = false;
     bool m_receiveQueueRunning = false;
@@ -136,6 +165,8 @@ ConnectionImpl <WebSocket>::ConnectionImpl (
         , m_netOPs (getApp ().getOPs ())
         , m_io_service (io_service)
         , m_pingTimer (io_service)
+        , m_deflateWindowBits (WebSocket::deflateWindowBits (*cpConnection))
+        , m_sendQueue (handler.sendQueueSetup ())
         , m_handler (handler)
         , m_connection (cpConnection)
 {
@@ -232,7 +263,8 @@ void ConnectionImpl <WebSocket>::returnMessage (message_ptr const& ptr)
 }
 
 template <class WebSocket>
-Json::Value ConnectionImpl <WebSocket>::invokeCommand (Json::Value& jvRequest)
+Json::Value ConnectionImpl <WebSocket>::invokeCommand (Json::Value& jvRequest,
+    Json::TapeValue const& txJson)
 {
     if (getConsumer().disconnect ())
     {
@@ -278,6 +310,7 @@ Json::Value ConnectionImpl <WebSocket>::invokeCommand (Json::Value& jvRequest)
                               m_netOPs,
                               role,
                               std::dynamic_pointer_cast<InfoSub> (this->shared_from_this ())};
+        context.txJson = txJson;
 
         RPC::doCommand (context, jvResult[jss::result]);
        // RPC::RPCInfo::update(context.params,false,jvResult[jss::result]); //
@@ -329,6 +362,12 @@ void ConnectionImpl <WebSocket>::preDestroy ()
         ScopedLockType sl (this->m_receiveQueueMutex);
         this->m_isDead = true;
     }
+
+    {
+        ScopedLockType sl (this->m_sendQueueMutex);
+        this->m_sendQueueClosed = true;
+        this->m_sendQueue.clear ();
+    }
 }
 
 // Implement overridden functions from base class:
@@ -339,8 +378,149 @@ void ConnectionImpl <WebSocket>::send (Json::Value const& jvObj, bool broadcast)
 
     connection_ptr ptr = m_connection.lock ();
 
-    if (ptr)
-        m_handler.send (ptr, jvObj, broadcast);
+    if (!ptr)
+        return;
+
+    try
+    {
+        enqueue (ptr, m_handler.makeMessage (
+            to_string (jvObj), broadcast, m_deflateWindowBits), jvObj);
+    }
+    catch (...)
+    {
+        WebSocket::closeTooSlowClient (*ptr, handler_type::crTooSlow);
+    }
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::send (
+    Json::Value const& jvObj, std::string const& sObj, bool broadcast)
+{
+    connection_ptr ptr = m_connection.lock ();
+
+    if (!ptr)
+        return;
+
+    try
+    {
+        enqueue (ptr, m_handler.makeMessage (
+            sObj, broadcast, m_deflateWindowBits), jvObj);
+    }
+    catch (...)
+    {
+        WebSocket::closeTooSlowClient (*ptr, handler_type::crTooSlow);
+    }
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::send (Broadcast const& broadcast)
+{
+    connection_ptr ptr = m_connection.lock ();
+
+    if (!ptr)
+        return;
+
+    try
+    {
+        enqueue (ptr, m_handler.makeBroadcast (
+            broadcast, m_deflateWindowBits), broadcast.json ());
+    }
+    catch (...)
+    {
+        WebSocket::closeTooSlowClient (*ptr, handler_type::crTooSlow);
+    }
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::enqueue (
+    connection_ptr const& ptr, message_ptr const& msg, Json::Value const& jvObj)
+{
+    auto const& setup = m_handler.sendQueueSetup ();
+    Json::Value overflow;
+    bool drain = false;
+
+    {
+        ScopedLockType sl (m_sendQueueMutex);
+
+        if (m_sendQueueClosed)
+            return;
+
+        // Messages go straight to websocketpp while the client keeps up.
+        // Sending under the lock keeps them in order with the queue.
+        if (m_sendQueue.empty () &&
+            WebSocket::bufferedAmount (*ptr) < setup.highWater)
+        {
+            m_handler.send (ptr, msg);
+            return;
+        }
+
+        auto const policy = setup.policy (jvObj);
+        auto const result = m_sendQueue.push (
+            msg, msg->get_payload ().size (), policy,
+            policy == SendPolicy::coalesce
+                ? SendQueueSetup::coalesceKey (jvObj) : std::string ());
+
+        if (result == SendQueue <message_ptr>::Result::overflow)
+        {
+            overflow = m_sendQueue.getJson ();
+            overflow[jss::ip] = m_remoteAddress.address ().to_string ();
+            m_sendQueue.clear ();
+            m_sendQueueClosed = true;
+        }
+        else if (!m_sendQueueDraining)
+        {
+            m_sendQueueDraining = true;
+            drain = true;
+        }
+    }
+
+    if (!overflow.isNull ())
+        m_handler.sendQueueOverflow (ptr, overflow);
+    else if (drain)
+        setDrainTimer ();
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::drainTimer (
+    typename WebSocket::ErrorCode const& e)
+{
+    connection_ptr ptr = m_connection.lock ();
+    bool again = false;
+
+    {
+        ScopedLockType sl (m_sendQueueMutex);
+
+        if (e || !ptr || m_sendQueueClosed)
+        {
+            m_sendQueue.clear ();
+            m_sendQueueDraining = false;
+            return;
+        }
+
+        auto const highWater = m_handler.sendQueueSetup ().highWater;
+        while (!m_sendQueue.empty () &&
+               WebSocket::bufferedAmount (*ptr) < highWater)
+            m_handler.send (ptr, m_sendQueue.pop ());
+
+        again = !m_sendQueue.empty ();
+        m_sendQueueDraining = again;
+    }
+
+    if (again)
+        setDrainTimer ();
+}
+
+template <class WebSocket>
+Json::Value ConnectionImpl <WebSocket>::getSendQueue ()
+{
+    ScopedLockType sl (m_sendQueueMutex);
+
+    if (!m_sendQueue.used ())
+        return Json::Value ();
+
+    Json::Value ret = m_sendQueue.getJson ();
+    ret[jss::ip] = m_remoteAddress.address ().to_string ();
+    return ret;
 }
 
 template <class WebSocket>
@@ -0,0 +1,256 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <services/websocket/Deflate.h>
+#include <common/base/Log.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <boost/thread/tss.hpp>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace bessel {
+namespace websocket {
+
+namespace {
+
+// RFC 7692 section 7.2.1: the sender removes the tail
+// of the final empty block produced by a sync flush.
+char const flushTail[] = { 0x00, 0x00, char (0xff), char (0xff) };
+
+boost::thread_specific_ptr<Deflater> localDeflater;
+
+// How often the per stream totals are logged
+std::chrono::minutes const reportInterval (5);
+
+} // namespace
+
+Deflater::Deflater ()
+{
+    stream_.zalloc = Z_NULL;
+    stream_.zfree = Z_NULL;
+    stream_.opaque = Z_NULL;
+
+    // A negative window produces raw deflate data with no zlib header
+    if (deflateInit2 (&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+            -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::runtime_error ("websocket: deflateInit2 failed");
+}
+
+Deflater::~Deflater ()
+{
+    deflateEnd (&stream_);
+}
+
+std::string Deflater::compress (std::string const& payload)
+{
+    // Forget the previous message so nothing refers back to it
+    deflateReset (&stream_);
+
+    std::string out;
+    out.resize (deflateBound (&stream_, payload.size ()) + 16);
+
+    stream_.next_in = reinterpret_cast <Bytef*> (
+        const_cast <char*> (payload.data ()));
+    stream_.avail_in = static_cast <uInt> (payload.size ());
+
+    std::size_t used = 0;
+    for (;;)
+    {
+        stream_.next_out = reinterpret_cast <Bytef*> (&out[used]);
+        stream_.avail_out = static_cast <uInt> (out.size () - used);
+
+        if (deflate (&stream_, Z_SYNC_FLUSH) == Z_STREAM_ERROR)
+            throw std::runtime_error ("websocket: deflate failed");
+
+        used = out.size () - stream_.avail_out;
+        if (stream_.avail_out != 0)
+            break;
+
+        out.resize (out.size () * 2);
+    }
+
+    out.resize (used);
+    if (out.size () >= sizeof (flushTail) &&
+        out.compare (out.size () - sizeof (flushTail), sizeof (flushTail),
+            flushTail, sizeof (flushTail)) == 0)
+    {
+        out.resize (out.size () - sizeof (flushTail));
+    }
+    return out;
+}
+
+Deflater& Deflater::local ()
+{
+    auto deflater = localDeflater.get ();
+    if (!deflater)
+    {
+        deflater = new Deflater;
+        localDeflater.reset (deflater);
+    }
+    return *deflater;
+}
+
+std::string makeFrameHeader (std::size_t size, bool compressed)
+{
+    std::string header;
+    header.reserve (10);
+
+    // FIN, RSV1 when compressed, text opcode
+    header.push_back (char (0x81 | (compressed ? 0x40 : 0)));
+
+    if (size < 126)
+    {
+        header.push_back (char (size));
+    }
+    else if (size <= 0xffff)
+    {
+        header.push_back (char (126));
+        header.push_back (char (size >> 8));
+        header.push_back (char (size));
+    }
+    else
+    {
+        header.push_back (char (127));
+        for (int shift = 56; shift >= 0; shift -= 8)
+            header.push_back (char (std::uint64_t (size) >> shift));
+    }
+    return header;
+}
+
+int deflateWindowBits (std::string const& extensions)
+{
+    std::vector <std::string> offers;
+    boost::split (offers, extensions, boost::is_any_of (","));
+
+    for (auto const& offer : offers)
+    {
+        std::vector <std::string> params;
+        boost::split (params, offer, boost::is_any_of (";"));
+
+        if (boost::trim_copy (params[0]) != "permessage-deflate")
+            continue;
+
+        int bits = MAX_WBITS;
+        for (std::size_t i = 1; i < params.size (); ++i)
+        {
+            auto param = boost::trim_copy (params[i]);
+            auto const eq = param.find ('=');
+            if (eq == std::string::npos ||
+                boost::trim_copy (param.substr (0, eq)) !=
+                    "server_max_window_bits")
+                continue;
+
+            try
+            {
+                bits = std::stoi (boost::trim_copy_if (
+                    param.substr (eq + 1), boost::is_any_of (" \"")));
+            }
+            catch (std::exception const&)
+            {
+                return 0;
+            }
+        }
+        return (bits >= 8 && bits <= MAX_WBITS) ? bits : 0;
+    }
+    return 0;
+}
+
+bool canDeflate (std::size_t size, int windowBits)
+{
+    if (windowBits <= 0)
+        return false;
+    return windowBits >= MAX_WBITS ||
+        size <= (std::size_t (1) << windowBits);
+}
+
+//------------------------------------------------------------------------------
+
+DeflateStats::DeflateStats (beast::insight::Group::ptr const& group)
+    : group_ (group)
+    , lastReport_ (std::chrono::steady_clock::now ())
+{
+}
+
+DeflateStats::Stream& DeflateStats::get (std::string const& stream)
+{
+    auto iter = streams_.find (stream);
+    if (iter == streams_.end ())
+    {
+        iter = streams_.emplace (stream, Stream ()).first;
+        auto& s = iter->second;
+        s.bytesIn = group_->make_counter (stream, "bytes_in");
+        s.bytesOut = group_->make_counter (stream, "bytes_out");
+        s.micros = group_->make_counter (stream, "micros");
+        s.sends = group_->make_counter (stream, "sends");
+    }
+    return iter->second;
+}
+
+void DeflateStats::compressed (std::string const& stream,
+    std::size_t bytesIn, std::size_t bytesOut,
+    std::chrono::microseconds elapsed)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto& s = get (stream);
+    s.bytesIn += bytesIn;
+    s.bytesOut += bytesOut;
+    s.micros += elapsed.count ();
+
+    ++s.messages;
+    s.totalIn += bytesIn;
+    s.totalOut += bytesOut;
+    s.totalMicros += elapsed.count ();
+
+    auto const now = std::chrono::steady_clock::now ();
+    if (now - lastReport_ >= reportInterval)
+    {
+        lastReport_ = now;
+        report ();
+    }
+}
+
+void DeflateStats::sent (std::string const& stream, std::size_t copies)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto& s = get (stream);
+    s.sends += copies;
+    s.totalSends += copies;
+}
+
+void DeflateStats::report ()
+{
+    for (auto const& entry : streams_)
+    {
+        auto const& s = entry.second;
+        if (s.messages == 0 || s.totalIn == 0)
+            continue;
+
+        WriteLog (lsINFO, WebSocket) << boost::format (
+            "deflate %s: %d messages, %d sends, ratio %.3f, %.1f us/message")
+            % entry.first % s.messages % s.totalSends
+            % (double (s.totalOut) / s.totalIn)
+            % (double (s.totalMicros) / s.messages);
+    }
+}
+
+} // websocket
+} // bessel
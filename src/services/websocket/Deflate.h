@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BESSEL_WEBSOCKET_DEFLATE_H_INCLUDED
+#define BESSEL_WEBSOCKET_DEFLATE_H_INCLUDED
+
+#include <beast/insight/Counter.h>
+#include <beast/insight/Group.h>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <zlib.h>
+
+namespace bessel {
+namespace websocket {
+
+/** Messages shorter than this are not worth compressing. */
+std::size_t const minDeflateSize = 128;
+
+/** Compresses messages for the permessage-deflate extension (RFC 7692).
+
+    Each message is compressed on its own, with no reference to earlier
+    messages, so the output is valid for every client that negotiated
+    the extension whatever context takeover it agreed to.
+*/
+class Deflater
+{
+public:
+    Deflater ();
+    ~Deflater ();
+
+    Deflater (Deflater const&) = delete;
+    Deflater& operator= (Deflater const&) = delete;
+
+    /** Returns the compressed payload of a message. */
+    std::string compress (std::string const& payload);
+
+    /** Returns the deflater belonging to the calling thread. */
+    static Deflater& local ();
+
+private:
+    z_stream stream_;
+};
+
+/** Returns the header of a server frame holding one whole text message.
+
+    Server frames are unmasked, so a header and payload can be written
+    unchanged to any number of clients. If `compressed` is set the
+    payload must come from Deflater::compress.
+*/
+std::string makeFrameHeader (std::size_t size, bool compressed);
+
+/** Returns the largest LZ77 window, in bits, the client will accept from
+    us, or 0 if the handshake response did not agree to permessage-deflate.
+
+    @param extensions The Sec-WebSocket-Extensions response header.
+*/
+int deflateWindowBits (std::string const& extensions);
+
+/** Returns true if a message of this size may be sent compressed to a
+    client with the given window.
+
+    Messages are compressed independently, so no match reaches further
+    back than the message length.
+*/
+bool canDeflate (std::size_t size, int windowBits);
+
+/** Tracks compression of broadcast messages per stream.
+
+    The stream is the "type" field of the published object. Totals are
+    exported through insight and written to the log periodically.
+    Each broadcast is recorded once, not once per subscriber.
+*/
+class DeflateStats
+{
+public:
+    explicit DeflateStats (beast::insight::Group::ptr const& group);
+
+    /** Record one compressed broadcast. */
+    void compressed (std::string const& stream, std::size_t bytesIn,
+        std::size_t bytesOut, std::chrono::microseconds elapsed);
+
+    /** Record copies of a compressed broadcast sent to subscribers. */
+    void sent (std::string const& stream, std::size_t copies);
+
+private:
+    struct Stream
+    {
+        beast::insight::Counter bytesIn;
+        beast::insight::Counter bytesOut;
+        beast::insight::Counter micros;
+        beast::insight::Counter sends;
+
+        std::size_t messages = 0;
+        std::size_t totalIn = 0;
+        std::size_t totalOut = 0;
+        std::size_t totalMicros = 0;
+        std::size_t totalSends = 0;
+    };
+
+    Stream& get (std::string const& stream);
+    void report ();
+
+    std::mutex mutex_;
+    beast::insight::Group::ptr group_;
+    std::map <std::string, Stream> streams_;
+    std::chrono::steady_clock::time_point lastReport_;
+};
+
+} // websocket
+} // bessel
+
+#endif
@@ -23,13 +23,16 @@
 #include <main/Application.h>
 #include <main/CollectorManager.h>
 #include <common/core/JobQueue.h>
-#include <common/json/json_reader.h>
+#include <common/json/FastReader.h>
 #include <protocol/JsonFields.h>
 #include <services/server/Port.h>
 #include <services/websocket/Connection.h>
+#include <services/websocket/Deflate.h>
+#include <services/websocket/SendQueue.h>
 #include <services/websocket/WebSocket.h>
 #include <services/rpc/handlers/RPCInfo.h>
 #include <services/websocket/WebSocket04.h>
+#include <chrono>
 #include <memory>
 #include <boost/asio.hpp>
 #include <common/misc/Utility.h>
@@ -72,9 +75,12 @@ private:
     beast::insight::Event rpc_io_;
     beast::insight::Event rpc_size_;
     beast::insight::Event rpc_time_;
+    beast::insight::Counter send_queue_overflows_;
 
     ServerDescription desc_;
 
+    SendQueueSetup const sendQueueSetup_;
+
 protected:
     //  TODO Make this private.
     std::mutex mLock;
@@ -84,13 +90,18 @@ protected:
     MapType mMap;
 
 public:
-    HandlerImpl (ServerDescription const& desc) : desc_ (desc)
+    HandlerImpl (ServerDescription const& desc)
+        : desc_ (desc)
+        , sendQueueSetup_ (setup_SendQueue (
+            desc_.config.section (desc_.port.name), desc_.journal))
     {
         auto const& group (desc_.collectorManager.group ("rpc"));
         rpc_requests_ = group->make_counter ("requests");
         rpc_io_ = group->make_event ("io");
         rpc_size_ = group->make_event ("size");
         rpc_time_ = group->make_event ("time");
+        send_queue_overflows_ = desc_.collectorManager.group (
+            "ws_send_queue")->make_counter ("overflows");
     }
 
     HandlerImpl(HandlerImpl const&) = delete;
@@ -107,12 +118,18 @@ public:
         return ! port ().admin_ip.empty ();
     };
 
+    SendQueueSetup const&
+    sendQueueSetup () const
+    {
+        return sendQueueSetup_;
+    }
+
+    /** Send a message made by makeMessage or makeBroadcast. */
     void send (connection_ptr const& cpClient, message_ptr const& mpMessage)
     {
         try
         {
-            cpClient->send (
-                mpMessage->get_payload (), mpMessage->get_opcode ());
+            WebSocket::sendFrame (*cpClient, mpMessage);
         }
         catch (...)
         {
@@ -120,27 +137,58 @@ public:
         }
     }
 
-    void send (connection_ptr const& cpClient, 
-               std::string const& strMessage,
-               bool broadcast)
+    /** Close a client whose send queue is over its limits. */
+    void sendQueueOverflow (connection_ptr const& cpClient,
+                            Json::Value const& queue)
     {
+        ++send_queue_overflows_;
+
+        WriteLog (lsWARNING, HandlerLog)
+                << "Ws:: Send queue full, disconnecting: " << queue;
+
         try
         {
-            WriteLog (broadcast ? lsTRACE : lsDEBUG, HandlerLog)
-                    << "Ws:: Sending '" << strMessage << "'";
-
-            cpClient->send (strMessage);
+            WebSocket::closeTooSlowClient (*cpClient, crTooSlow);
         }
         catch (...)
         {
-            WebSocket::closeTooSlowClient (*cpClient, crTooSlow);
         }
     }
 
-    void send (connection_ptr const& cpClient, Json::Value const& jvObj,
-               bool broadcast)
+    /** Frame a message for one client. */
+    message_ptr makeMessage (std::string const& strMessage,
+                             bool broadcast,
+                             int deflateWindowBits)
+    {
+        WriteLog (broadcast ? lsTRACE : lsDEBUG, HandlerLog)
+                << "Ws:: Sending '" << strMessage << "'";
+
+        // Every message is framed here, so websocketpp never
+        // compresses with its own per connection context.
+        if (deflateWindowBits != 0 &&
+            strMessage.size () >= minDeflateSize &&
+            canDeflate (strMessage.size (), deflateWindowBits))
+            return WebSocket::makeFrame (
+                Deflater::local ().compress (strMessage), true);
+
+        return WebSocket::makeFrame (std::string (strMessage), false);
+    }
+
+    /** Frame a published object. Subscribers that negotiated
+        permessage-deflate are sent the frame the broadcast compressed.
+    */
+    message_ptr makeBroadcast (Broadcast const& broadcast,
+                               int deflateWindowBits)
     {
-        send (cpClient, to_string (jvObj), broadcast);
+        auto const frame = broadcast.frame (deflateWindowBits);
+
+        if (!frame)
+            return makeMessage (broadcast.text (), true, deflateWindowBits);
+
+        WriteLog (lsTRACE, HandlerLog)
+                << "Ws:: Sending '" << broadcast.text () << "'";
+
+        return frame->message;
     }
 
     void pingTimer (connection_ptr const& cpClient)
@@ -381,7 +429,8 @@ public:
                      const wsc_ptr& conn, const message_ptr& mpMessage)
     {
         Json::Value     jvRequest;
-        Json::Reader    jrReader;
+        Json::FastReader jrReader;
+        Json::TapeValue jtRequest;
 
         try
         {
@@ -402,9 +451,10 @@ public:
             jvResult[jss::error]   = "wsTextRequired";
             // We only accept text messages.
 
-            send (cpClient, jvResult, false);
+            conn->send (jvResult, false);
         }
-        else if (!jrReader.parse (mpMessage->get_payload (), jvRequest) ||
+        else if (!Json::parse (jrReader, mpMessage->get_payload (),
+                     jvRequest, jtRequest, jss::tx_json) ||
                  jvRequest.isNull () || !jvRequest.isObject ())
         {
             Json::Value jvResult (Json::objectValue);
@@ -413,7 +463,7 @@ public:
             jvResult[jss::error]   = "jsonInvalid";    // Received invalid json.
             jvResult[jss::value]   = mpMessage->get_payload ();
 
-            send (cpClient, jvResult, false);
+            conn->send (jvResult, false);
         }
         else
         {
@@ -427,7 +477,8 @@ public:
             RPC::RPCInfo::updateCmd(jvRequest,false);
 
             auto const start (std::chrono::high_resolution_clock::now ());
-            Json::Value const jvObj (conn->invokeCommand (jvRequest));
+            Json::Value const jvObj (conn->invokeCommand (
+                jvRequest, jtRequest[jss::tx_json]));
             RPC::RPCInfo::updateError(jvRequest,jvObj,false);
             std::string const buffer (to_string (jvObj));
 
@@ -440,7 +491,7 @@ public:
             rpc_size_.notify (static_cast <beast::insight::Event::value_type>
                              (buffer.size ()));
 
-            send (cpClient, buffer, false);
+            conn->send (jvObj, buffer, false);
         }
 
         return true;
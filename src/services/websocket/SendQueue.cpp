@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <services/websocket/SendQueue.h>
+#include <common/base/BasicConfig.h>
+#include <protocol/JsonFields.h>
+#include <algorithm>
+
+namespace bessel {
+namespace websocket {
+
+namespace {
+
+void
+setPolicy (SendPolicy& policy, Section const& section,
+    std::string const& name, beast::Journal journal)
+{
+    auto const result = section.find (name);
+    if (! result.second)
+        return;
+
+    if (result.first == "drop_oldest")
+        policy = SendPolicy::dropOldest;
+    else if (result.first == "coalesce")
+        policy = SendPolicy::coalesce;
+    else if (result.first == "disconnect")
+        policy = SendPolicy::disconnect;
+    else
+        journal.warning << "Invalid value '" << result.first <<
+            "' for key '" << name << "' in [" << section.name() <<
+            "], using " << to_string (policy);
+}
+
+} // anonymous namespace
+
+SendPolicy
+SendQueueSetup::policy (Json::Value const& jvObj) const
+{
+    if (! jvObj.isMember (jss::type))
+        return SendPolicy::disconnect;
+
+    std::string const type = jvObj[jss::type].asString ();
+
+    if (type == "serverStatus")
+        return server;
+    if (type == "ledgerClosed")
+        return ledger;
+    if (type == "transaction")
+        return account;
+    return SendPolicy::disconnect;
+}
+
+std::string
+SendQueueSetup::coalesceKey (Json::Value const& jvObj)
+{
+    std::string const type = jvObj.isMember (jss::type)
+        ? jvObj[jss::type].asString () : std::string ();
+
+    // A transaction is published when proposed and again when
+    // validated, and once per stream the client subscribes to.
+    if (type == "transaction")
+    {
+        if (jvObj.isMember (jss::transaction) &&
+                jvObj[jss::transaction].isMember (jss::hash))
+            return type + ":" + jvObj[jss::transaction][jss::hash].asString ();
+        return std::string ();
+    }
+
+    // Each server and ledger update supersedes the previous one
+    return type;
+}
+
+SendQueueSetup
+setup_SendQueue (Section const& section, beast::Journal journal)
+{
+    SendQueueSetup setup;
+    set (setup.maxMessages, "send_queue_messages", section);
+    set (setup.maxBytes, "send_queue_bytes", section);
+    setPolicy (setup.server, section, "send_queue_server", journal);
+    setPolicy (setup.ledger, section, "send_queue_ledger", journal);
+    setPolicy (setup.account, section, "send_queue_account", journal);
+    setup.highWater = std::min (setup.highWater, setup.maxBytes);
+    return setup;
+}
+
+char const*
+to_string (SendPolicy policy)
+{
+    switch (policy)
+    {
+    case SendPolicy::dropOldest: return "drop_oldest";
+    case SendPolicy::coalesce:   return "coalesce";
+    case SendPolicy::disconnect: break;
+    }
+    return "disconnect";
+}
+
+} // websocket
+} // bessel
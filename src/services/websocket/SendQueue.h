@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BESSEL_WEBSOCKET_SENDQUEUE_H_INCLUDED
+#define BESSEL_WEBSOCKET_SENDQUEUE_H_INCLUDED
+
+#include <common/json/json_value.h>
+#include <beast/utility/Journal.h>
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <string>
+
+namespace bessel {
+
+class Section;
+
+namespace websocket {
+
+/** What to do with a stream's messages when a client falls behind. */
+enum class SendPolicy
+{
+    // Discard the oldest queued messages of the stream to make room.
+    dropOldest,
+
+    // Replace a queued message with a newer one carrying the same key.
+    coalesce,
+
+    // Close the connection when the queue is full.
+    disconnect
+};
+
+/** Limits and policies for the outbound queue of each websocket client.
+
+    Read from the websocket port section:
+
+        send_queue_messages = 1000
+        send_queue_bytes = 16777216
+        send_queue_server = drop_oldest
+        send_queue_ledger = drop_oldest
+        send_queue_account = coalesce
+
+    The account policy covers both the transactions and accounts streams.
+    Responses and every other stream always use disconnect.
+*/
+struct SendQueueSetup
+{
+    std::size_t maxMessages = 1000;
+    std::size_t maxBytes = 16 * 1024 * 1024;
+
+    // Bytes we let websocketpp hold before messages wait in our queue
+    std::size_t highWater = 256 * 1024;
+
+    // How often a waiting queue is moved along to websocketpp
+    int drainMilliseconds = 50;
+
+    SendPolicy server = SendPolicy::dropOldest;
+    SendPolicy ledger = SendPolicy::dropOldest;
+    SendPolicy account = SendPolicy::coalesce;
+
+    /** Returns the policy for a published object or response. */
+    SendPolicy policy (Json::Value const& jvObj) const;
+
+    /** Returns the key under which a message may be coalesced. */
+    static std::string coalesceKey (Json::Value const& jvObj);
+};
+
+SendQueueSetup
+setup_SendQueue (Section const& section, beast::Journal journal);
+
+char const*
+to_string (SendPolicy policy);
+
+//------------------------------------------------------------------------------
+
+/** Messages waiting for a slow websocket client.
+
+    Not thread safe, callers must serialize access.
+*/
+template <class MessagePtr>
+class SendQueue
+{
+public:
+    enum class Result
+    {
+        queued,
+        coalesced,
+        overflow
+    };
+
+    explicit SendQueue (SendQueueSetup const& setup)
+        : setup_ (setup)
+    {
+    }
+
+    bool empty () const
+    {
+        return queue_.empty ();
+    }
+
+    std::size_t size () const
+    {
+        return queue_.size ();
+    }
+
+    std::size_t bytes () const
+    {
+        return bytes_;
+    }
+
+    /** Returns true if a message ever had to wait in the queue. */
+    bool used () const
+    {
+        return peakMessages_ != 0;
+    }
+
+    /** Add a message, applying the stream policies if the queue is full.
+
+        @return overflow if the queue is still over its limits, in which
+                case the caller should disconnect the client.
+    */
+    Result push (MessagePtr const& msg, std::size_t size,
+        SendPolicy policy, std::string key);
+
+    /** Remove and return the oldest message. */
+    MessagePtr pop ();
+
+    /** Discard every queued message. */
+    void clear ();
+
+    Json::Value getJson () const;
+
+private:
+    struct Entry
+    {
+        MessagePtr msg;
+        std::size_t size;
+        SendPolicy policy;
+        std::string key;
+    };
+
+    bool full () const
+    {
+        return queue_.size () > setup_.maxMessages ||
+            bytes_ > setup_.maxBytes;
+    }
+
+    SendQueueSetup const& setup_;
+    std::deque <Entry> queue_;
+    std::size_t bytes_ = 0;
+    std::size_t peakMessages_ = 0;
+    std::size_t peakBytes_ = 0;
+    std::size_t sent_ = 0;
+    std::size_t dropped_ = 0;
+    std::size_t coalesced_ = 0;
+};
+
+template <class MessagePtr>
+typename SendQueue<MessagePtr>::Result
+SendQueue<MessagePtr>::push (MessagePtr const& msg, std::size_t size,
+    SendPolicy policy, std::string key)
+{
+    Result result = Result::queued;
+
+    auto iter = queue_.end ();
+    if (policy == SendPolicy::coalesce && ! key.empty ())
+        iter = std::find_if (queue_.begin (), queue_.end (),
+            [&key](Entry const& e)
+            {
+                return e.policy == SendPolicy::coalesce && e.key == key;
+            });
+
+    if (iter != queue_.end ())
+    {
+        // The client only needs the latest copy, in the original place
+        bytes_ = bytes_ - iter->size + size;
+        iter->msg = msg;
+        iter->size = size;
+        ++coalesced_;
+        result = Result::coalesced;
+    }
+    else
+    {
+        queue_.push_back ({msg, size, policy, std::move (key)});
+        bytes_ += size;
+    }
+
+    peakMessages_ = std::max (peakMessages_, queue_.size ());
+    peakBytes_ = std::max (peakBytes_, bytes_);
+
+    while (full ())
+    {
+        auto victim = std::find_if (queue_.begin (), queue_.end (),
+            [](Entry const& e)
+            {
+                return e.policy == SendPolicy::dropOldest;
+            });
+
+        if (victim == queue_.end ())
+            return Result::overflow;
+
+        bytes_ -= victim->size;
+        queue_.erase (victim);
+        ++dropped_;
+    }
+
+    return result;
+}
+
+template <class MessagePtr>
+MessagePtr
+SendQueue<MessagePtr>::pop ()
+{
+    MessagePtr msg = std::move (queue_.front ().msg);
+    bytes_ -= queue_.front ().size;
+    queue_.pop_front ();
+    ++sent_;
+    return msg;
+}
+
+template <class MessagePtr>
+void
+SendQueue<MessagePtr>::clear ()
+{
+    queue_.clear ();
+    bytes_ = 0;
+}
+
+template <class MessagePtr>
+Json::Value
+SendQueue<MessagePtr>::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+    ret["messages"] = static_cast <Json::UInt> (queue_.size ());
+    ret["bytes"] = static_cast <Json::UInt> (bytes_);
+    ret["peak_messages"] = static_cast <Json::UInt> (peakMessages_);
+    ret["peak_bytes"] = static_cast <Json::UInt> (peakBytes_);
+    ret["sent_from_queue"] = static_cast <Json::UInt> (sent_);
+    ret["dropped"] = static_cast <Json::UInt> (dropped_);
+    ret["coalesced"] = static_cast <Json::UInt> (coalesced_);
+    return ret;
+}
+
+} // websocket
+} // bessel
+
+#endif
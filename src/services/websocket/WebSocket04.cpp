@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <services/websocket/WebSocket04.h>
+#include <services/websocket/Deflate.h>
 #include <services/websocket/Handler.h>
 #include <services/websocket/Server.h>
 #include <boost/make_shared.hpp>
@@ -125,11 +126,60 @@ void ConnectionImpl <WebSocket04>::setPingTimer ()
     }
 }
 
+template <>
+void ConnectionImpl <WebSocket04>::setDrainTimer ()
+{
+    if (auto con = m_connection.lock ())
+    {
+        con->set_timer (
+            m_handler.sendQueueSetup ().drainMilliseconds,
+            std::bind (&ConnectionImpl<WebSocket04>::drainTimer, shared_from_this(),
+                                std::placeholders::_1));
+    }
+}
+
 boost::asio::io_service::strand& WebSocket04::getStrand (Connection& con)
 {
     return *con.get_strand();
 }
 
+int WebSocket04::deflateWindowBits (Connection& con)
+{
+    return websocket::deflateWindowBits (
+        con.get_response_header ("Sec-WebSocket-Extensions"));
+}
+
+WebSocket04::MessagePtr WebSocket04::makeFrame (
+    std::string&& payload, bool compressed)
+{
+    // Not owned by any connection, so it is never recycled
+    auto msg = std::make_shared <Message> (
+        Message::con_msg_man_ptr (), websocketpp::frame::opcode::text, 0);
+    msg->set_header (makeFrameHeader (payload.size (), compressed));
+    msg->set_payload (std::move (payload));
+    msg->set_compressed (compressed);
+    msg->set_prepared (true);
+    return msg;
+}
+
+std::shared_ptr <Broadcast::Frame const> Broadcast::makeFrame (
+    std::string&& payload)
+{
+    auto frame = std::make_shared <Frame> ();
+    frame->message = WebSocket04::makeFrame (std::move (payload), true);
+    return std::move (frame);
+}
+
+void WebSocket04::sendFrame (Connection& con, MessagePtr const& msg)
+{
+    con.send (msg);
+}
+
+std::size_t WebSocket04::bufferedAmount (Connection& con)
+{
+    return con.get_buffered_amount ();
+}
+
 template <>
 void Server <WebSocket04>::listen()
 {
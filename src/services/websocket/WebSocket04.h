@@ -20,6 +20,7 @@
 #ifndef BESSELD_BESSEL_WEBSOCKET_WEBSOCKET04_H
 #define BESSELD_BESSEL_WEBSOCKET_WEBSOCKET04_H
 
+#include <services/websocket/Broadcast.h>
 #include <services/websocket/Config04.h>
 #include <services/websocket/WebSocket.h>
 #include <boost/make_shared.hpp>
@@ -99,6 +100,29 @@ struct WebSocket04
     /** Get the ASIO strand that this connection lives on. */
     static
     boost::asio::io_service::strand& getStrand (Connection&);
+
+    /** Return the permessage-deflate window the client accepted from us,
+        or 0 if the extension was not negotiated. */
+    static
+    int deflateWindowBits (Connection&);
+
+    /** Make a text message that is written out exactly as given. */
+    static
+    MessagePtr makeFrame (std::string&& payload, bool compressed);
+
+    /** Queue a message made by makeFrame. */
+    static
+    void sendFrame (Connection&, MessagePtr const&);
+
+    /** Return the number of bytes websocketpp has yet to write. */
+    static
+    std::size_t bufferedAmount (Connection&);
+};
+
+/** A broadcast compressed once and queued unchanged to every client. */
+struct Broadcast::Frame
+{
+    WebSocket04::MessagePtr message;
 };
 
 } // websocket
@@ -21,7 +21,10 @@
 #include <transaction/paths/Tuning.h>
 #include <transaction/paths/BesselCalc.h>
 #include <transaction/paths/cursor/PathCursor.h>
+#include <main/Application.h>
 #include <common/base/Log.h>
+#include <common/core/ParallelFor.h>
+#include <thread>
 
 namespace bessel {
 namespace path {
@@ -206,14 +209,20 @@ TER BesselCalc::besselCalculate ()
     while (resultCode == temUNCERTAIN)
     {
         int iBest = -1;
-        LedgerEntrySet lesCheckpoint = mActiveLedger;
+        LedgerEntrySet lesCheckpoint = mActiveLedger.checkpoint ();
         int iDry = 0;
 
         // True, if ever computed multi-quality.
         bool multiQuality = false;
 
+        // Paths evaluated ahead, if the pass runs them concurrently.
+        std::vector<PathTrial> trials;
+
+        if (inputFlags.parallelPaths)
+            evaluatePaths (lesCheckpoint, trials);
+
         // Find the best path.
-        for (auto pathState : pathStateList_)
+        for (auto& pathState : pathStateList_)
         {
             if (pathState->quality())
                 // Only do active paths.
@@ -221,12 +230,30 @@ TER BesselCalc::besselCalculate ()
                 // If computing the only non-dry path, compute multi-quality.
                 multiQuality = ((pathStateList_.size () - iDry) == 1);
 
-                // Update to current amount processed.
-                pathState->reset (actualAmountIn_, actualAmountOut_);
+                PathTrial* trial = trials.empty () ?
+                    nullptr : &trials[pathState->index ()];
 
-                // Error if done, output met.
-                PathCursor pc(*this, *pathState, multiQuality);
-                pc.nextIncrement (lesCheckpoint);
+                if (trial && trial->pathState && !multiQuality)
+                {
+                    // Take the increment computed ahead, as if computed here.
+                    if (trial->exception)
+                        std::rethrow_exception (trial->exception);
+
+                    pathState = trial->pathState;
+                    mActiveLedger.swapWith (trial->ledger);
+                    permanentlyUnfundedOffers_.insert (
+                        trial->unfundedOffers.begin (),
+                        trial->unfundedOffers.end ());
+                }
+                else
+                {
+                    // Update to current amount processed.
+                    pathState->reset (actualAmountIn_, actualAmountOut_);
+
+                    // Error if done, output met.
+                    PathCursor pc(*this, *pathState, multiQuality);
+                    pc.nextIncrement (lesCheckpoint);
+                }
 
                 // Compute increment.
                 WriteLog (lsDEBUG, BesselCalc)
@@ -435,5 +462,62 @@ TER BesselCalc::besselCalculate ()
     return resultCode;
 }
 
+void BesselCalc::evaluatePaths (
+    LedgerEntrySet const& lesCheckpoint, std::vector<PathTrial>& trials)
+{
+    std::vector<std::size_t> active;
+
+    for (auto const& pathState : pathStateList_)
+    {
+        if (pathState->quality ())
+            active.push_back (pathState->index ());
+    }
+
+    // With a single active path there is nothing to overlap.
+    if (active.size () < 2)
+        return;
+
+    trials.resize (pathStateList_.size ());
+
+    // Each path is evaluated as the serial loop does it while other paths
+    // are still active, without multi-quality. A path left alone by the
+    // others drying up during the pass is evaluated again in the loop.
+    parallelFor (getApp().getJobQueue (), jtPATH_EVAL, "evaluatePaths",
+        active.size (), std::thread::hardware_concurrency (),
+        [&](std::size_t i)
+        {
+            auto& trial = trials[active[i]];
+
+            try
+            {
+                trial.pathState = std::make_shared<PathState> (
+                    *pathStateList_[active[i]]);
+                trial.pathState->reset (actualAmountIn_, actualAmountOut_);
+
+                // The cursor works through a calculation of its own, so no
+                // state is shared between the paths.
+                BesselCalc calc (
+                    trial.ledger,
+                    saMaxAmountReq_,
+                    saDstAmountReq_,
+                    uDstAccountID_,
+                    uSrcAccountID_,
+                    spsPaths_);
+                calc.inputFlags = inputFlags;
+                calc.mumSource_ = mumSource_;
+                calc.permanentlyUnfundedOffers_ = permanentlyUnfundedOffers_;
+
+                PathCursor pc (calc, *trial.pathState, false);
+                pc.nextIncrement (lesCheckpoint);
+
+                trial.unfundedOffers.swap (calc.permanentlyUnfundedOffers_);
+            }
+            catch (...)
+            {
+                trial.exception = std::current_exception ();
+            }
+        });
+}
+
 } // path
 } // bessel
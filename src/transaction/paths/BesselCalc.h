@@ -24,6 +24,8 @@
 #include <transaction/paths/PathState.h>
 #include <protocol/STAmount.h>
 #include <protocol/TER.h>
+#include <exception>
+#include <vector>
 
 namespace bessel {
 namespace path {
@@ -43,6 +45,12 @@ public:
         bool limitQuality = false;
         bool deleteUnfundedOffers = false;
         bool isLedgerOpen = true;
+
+        // Evaluate the paths of each pass concurrently on JobQueue threads.
+        // The best path is chosen exactly as the serial loop chooses it.
+        // Meant for previews such as path_find, not for applying
+        // transactions.
+        bool parallelPaths = false;
     };
     struct Output
     {
@@ -134,6 +142,21 @@ private:
     /** Compute liquidity through these path sets. */
     TER besselCalculate ();
 
+    /** A path evaluated ahead of the selection of a pass' best path. */
+    struct PathTrial
+    {
+        PathState::Ptr pathState;
+        LedgerEntrySet ledger;
+        OfferSet unfundedOffers;
+        std::exception_ptr exception;
+    };
+
+    /** Evaluate the active paths of a pass concurrently, each on a copy
+        of its state and against its own ledger entry set.
+    */
+    void evaluatePaths (LedgerEntrySet const& lesCheckpoint,
+        std::vector<PathTrial>& trials);
+
     /** Add a single PathState.  Returns true on success.*/
     bool addPathState(STPath const&, TER&);
 
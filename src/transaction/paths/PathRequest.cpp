@@ -517,13 +517,18 @@ Json::Value PathRequest::doUpdate (BesselLineCache::ref cache, bool fast)
 
             m_journal.debug << iIdentifier << " Paths found, calling besselCalc";
 
+            // Only a preview, so the paths may be evaluated concurrently
+            path::BesselCalc::Input rcInput;
+            rcInput.parallelPaths = true;
+
             auto rc = path::BesselCalc::besselCalculate (
                 lesSandbox,
                 saMaxAmount,
                 saDstAmount,
                 raDstAccount.getAccountID (),
                 raSrcAccount.getAccountID (),
-                spsPaths);
+                spsPaths,
+                &rcInput);
 
             if (!fullLiquidityPath.empty () && (rc.result () == terNO_LINE || rc.result () == tecPATH_PARTIAL))
             {
@@ -537,7 +542,8 @@ Json::Value PathRequest::doUpdate (BesselLineCache::ref cache, bool fast)
                     saDstAmount,
                     raDstAccount.getAccountID (),
                     raSrcAccount.getAccountID (),
-                    spsPaths);
+                    spsPaths,
+                    &rcInput);
 
                 if (rc.result () != tesSUCCESS)
                 {
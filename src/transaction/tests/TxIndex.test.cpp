@@ -0,0 +1,228 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <transaction/tx/TxIndex.h>
+#include <transaction/tx/Transaction.h>
+#include <data/nodestore/DummyScheduler.h>
+#include <data/nodestore/Manager.h>
+#include <protocol/Serializer.h>
+#include <beast/unit_test/suite.h>
+#include <string>
+
+namespace bessel {
+
+class TxIndex_test : public beast::unit_test::suite
+{
+public:
+    // Each index gets its own Memory backend, and a raw handle to it for
+    // storing entries TxIndex would never write.
+    std::unique_ptr <TxIndex>
+    makeIndex (std::string const& name, NodeStore::Backend*& backend)
+    {
+        Section params;
+        params.set ("type", "Memory");
+        params.set ("path", "TxIndex_test." + name);
+
+        auto b = NodeStore::Manager::instance ().make_Backend (
+            params, scheduler_, beast::Journal ());
+        backend = b.get ();
+        return std::make_unique <TxIndex> (std::move (b), beast::Journal ());
+    }
+
+    static
+    uint256
+    txID (int i)
+    {
+        return getSHA512Half (&i, sizeof (i));
+    }
+
+    static
+    Transaction::pointer
+    makeTransaction ()
+    {
+        std::string reason;
+        return std::make_shared <Transaction> (
+            std::make_shared <STTx> (ttPAYMENT), Validate::NO, reason);
+    }
+
+    void
+    testRoundTrip ()
+    {
+        testcase ("round trip");
+
+        NodeStore::Backend* backend;
+        auto index = makeIndex ("roundtrip", backend);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            TxIndex::Location location;
+            location.ledgerSeq = 1000 + i / 10;
+            location.txnSeq = i % 10;
+            location.txMap = txID (-1 - i / 10);
+            index->insert (txID (i), location);
+        }
+
+        bool ok = true;
+        for (int i = 0; i < 100; ++i)
+        {
+            auto const location = index->fetch (txID (i));
+            ok = ok && location &&
+                location->ledgerSeq == LedgerIndex (1000 + i / 10) &&
+                location->txnSeq == std::uint32_t (i % 10) &&
+                location->txMap == txID (-1 - i / 10);
+        }
+        expect (ok, "Every location reads back as written");
+
+        // A transaction that was never indexed
+        expect (!index->fetch (txID (100)), "A miss returns no location");
+    }
+
+    void
+    testMalformed ()
+    {
+        testcase ("malformed");
+
+        NodeStore::Backend* backend;
+        auto index = makeIndex ("malformed", backend);
+
+        auto store = [backend] (uint256 const& id, Blob data)
+        {
+            backend->store (NodeObject::createObject (
+                hotUNKNOWN, std::move (data), id));
+        };
+
+        store (txID (1), Blob (7, 1));
+        store (txID (2), Blob (9, 1));
+        store (txID (3), Blob (8, 0));
+        store (txID (4), Blob (41, 1));
+
+        expect (!index->fetch (txID (1)), "A short entry is ignored");
+        expect (!index->fetch (txID (2)), "A long entry is ignored");
+        expect (!index->fetch (txID (3)), "An entry naming ledger 0 is ignored");
+        expect (!index->fetch (txID (4)), "An overlong entry is ignored");
+    }
+
+    void
+    testOldEntry ()
+    {
+        testcase ("old entry");
+
+        NodeStore::Backend* backend;
+        auto index = makeIndex ("oldentry", backend);
+
+        // Written before the transaction map root was recorded
+        Serializer s (8);
+        s.add32 (3000);
+        s.add32 (7);
+        backend->store (NodeObject::createObject (
+            hotUNKNOWN, std::move (s.modData ()), txID (1)));
+
+        auto const location = index->fetch (txID (1));
+        expect (location && location->ledgerSeq == 3000 &&
+            location->txnSeq == 7 && location->txMap.isZero (),
+            "An entry without a root still reads back");
+    }
+
+    void
+    testLoad ()
+    {
+        testcase ("load");
+
+        NodeStore::Backend* backend;
+        auto index = makeIndex ("load", backend);
+
+        TxIndex::Location location;
+        location.ledgerSeq = 2000;
+        location.txnSeq = 3;
+        location.txMap = txID (-1);
+        index->insert (txID (1), location);
+
+        auto const fromDatabase = makeTransaction ();
+        auto const fromLedger = makeTransaction ();
+
+        int databaseLoads = 0;
+        auto database = [&] () -> Transaction::pointer
+        {
+            ++databaseLoads;
+            return fromDatabase;
+        };
+
+        // The index names ledger 2000, which no longer holds the transaction
+        LedgerIndex asked = 0;
+        uint256 askedMap;
+        auto tr = Transaction::load (txID (1), index.get (),
+            [&] (LedgerIndex seq, uint256 const& txMap) -> Transaction::pointer
+            {
+                asked = seq;
+                askedMap = txMap;
+                return nullptr;
+            },
+            database);
+        expect (asked == 2000 && askedMap == txID (-1),
+            "The named ledger is asked, by its transaction map");
+        expect (tr == fromDatabase && databaseLoads == 1,
+            "A ledger without the transaction falls back to SQL");
+
+        // The named ledger holds it
+        tr = Transaction::load (txID (1), index.get (),
+            [&] (LedgerIndex, uint256 const&)
+            {
+                return fromLedger;
+            },
+            database);
+        expect (tr == fromLedger && databaseLoads == 1,
+            "A ledger holding the transaction is used");
+        expect (tr->getStatus () == COMMITTED && tr->getLedger () == 2000,
+            "The transaction is committed in the named ledger");
+
+        // Not indexed, or no index at all
+        asked = 0;
+        auto const anyLedger = [&] (LedgerIndex seq, uint256 const&)
+            -> Transaction::pointer
+        {
+            asked = seq;
+            return fromLedger;
+        };
+
+        tr = Transaction::load (txID (2), index.get (), anyLedger, database);
+        expect (tr == fromDatabase && asked == 0 && databaseLoads == 2,
+            "An unindexed transaction is loaded from SQL");
+
+        tr = Transaction::load (txID (1), nullptr, anyLedger, database);
+        expect (tr == fromDatabase && asked == 0 && databaseLoads == 3,
+            "Without an index the transaction is loaded from SQL");
+    }
+
+    void
+    run ()
+    {
+        testRoundTrip ();
+        testMalformed ();
+        testOldEntry ();
+        testLoad ();
+    }
+
+private:
+    NodeStore::DummyScheduler scheduler_;
+};
+
+BEAST_DEFINE_TESTSUITE(TxIndex,transaction,bessel);
+
+} // bessel
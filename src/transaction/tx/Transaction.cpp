@@ -24,6 +24,7 @@
 #include <ledger/LedgerMaster.h>
 #include <main/Application.h>
 #include <protocol/JsonFields.h>
+#include <transaction/tx/TxIndex.h>
 #include <boost/optional.hpp>
 
 namespace bessel {
@@ -64,8 +65,7 @@ namespace bessel {
     {
         try
         {
-            Serializer s(vucTransaction);
-            SerialIter sit(s);
+            SerialIter sit(vucTransaction);
             std::string reason;
 
             return std::make_shared<Transaction>(std::make_shared<STTx>(sit),
@@ -146,7 +146,9 @@ namespace bessel {
         return tr;
     }
 
-    Transaction::pointer Transaction::load(uint256 const& id)
+    namespace {
+
+    Transaction::pointer loadFromDatabase(uint256 const& id)
     {
         std::string sql = "SELECT LedgerSeq,Status,RawTxn "
             "FROM Transactions WHERE TransID='";
@@ -174,6 +176,51 @@ namespace bessel {
             ledgerSeq, status, rawTxn, Validate::YES);
     }
 
+    } // namespace
+
+    Transaction::pointer Transaction::load(uint256 const& id)
+    {
+        return load(id, getApp().getTxIndex(),
+            [&id](LedgerIndex ledgerSeq, uint256 const& txMap) -> pointer
+            {
+                // Walking the transaction map from its root touches only
+                // the nodes on the path to the transaction. Loading a cold
+                // ledger by sequence would cost a SQL query first.
+                if (txMap.isNonZero())
+                    return Ledger::loadTransaction(txMap, ledgerSeq, id);
+
+                auto ledger = getApp().getLedgerMaster().
+                    getLedgerBySeq(ledgerSeq);
+                return ledger ? ledger->getTransaction(id) : pointer();
+            },
+            [&id]() -> pointer
+            {
+                return loadFromDatabase(id);
+            });
+    }
+
+    Transaction::pointer Transaction::load(uint256 const& id, TxIndex* txIndex,
+        std::function<pointer (LedgerIndex)> const& fromLedger,
+        std::function<pointer ()> const& fromDatabase)
+    {
+        // The index can name a ledger the transaction is no longer in, so
+        // only a ledger that still holds it is believed; otherwise fall
+        // back to the transaction database.
+        if (txIndex)
+        {
+            if (auto location = txIndex->fetch(id))
+            {
+                if (auto tr = fromLedger(location->ledgerSeq, location->txMap))
+                {
+                    tr->setStatus(COMMITTED, location->ledgerSeq);
+                    return tr;
+                }
+            }
+        }
+
+        return fromDatabase();
+    }
+
     // options 1 to include the date of the transaction
     Json::Value Transaction::getJson(int options, bool binary) const
     {
@@ -27,6 +27,7 @@
 #include <services/rpc/Context.h>
 #include <protocol/JsonFields.h>
 #include <transaction/tx/TransactionMeta.h>
+#include <functional>
 
 namespace bessel {
 
@@ -37,6 +38,7 @@ namespace bessel {
 //
 
 class Database;
+class TxIndex;
 
     enum TransStatus
     {
@@ -138,6 +140,21 @@ class Database;
 
         static Transaction::pointer load(uint256 const& id);
 
+        /** Load a transaction through the index, if there is one, and
+            otherwise from the transaction database.
+
+            @param fromLedger Returns the transaction from the ledger with
+                              the given sequence and transaction map root,
+                              or nullptr if that ledger is unavailable or
+                              does not hold it. The root is zero when the
+                              index entry does not record it.
+            @param fromDatabase Loads the transaction from the transaction
+                                database.
+        */
+        static Transaction::pointer load(uint256 const& id, TxIndex* txIndex,
+            std::function<pointer (LedgerIndex, uint256 const&)> const& fromLedger,
+            std::function<pointer ()> const& fromDatabase);
+
         STArray const& getTxs()
         {
             return mTransaction->getFieldArray(sfOperations);
@@ -59,7 +59,7 @@ Transaction::pointer TransactionMaster::fetch (uint256 const& txnID, bool checkD
     return txn;
 }
 
-STTx::pointer TransactionMaster::fetch (std::shared_ptr<SHAMapItem> const& item,
+STTx::pointer TransactionMaster::fetch (boost::intrusive_ptr<SHAMapItem const> const& item,
         SHAMapTreeNode::TNType type,
         bool checkDisk, std::uint32_t uCommitLedger)
 {
@@ -71,15 +71,14 @@ STTx::pointer TransactionMaster::fetch (std::shared_ptr<SHAMapItem> const& item,
 
         if (type == SHAMapTreeNode::tnTRANSACTION_NM)
         {
-            SerialIter sit (item->peekSerializer ());
+            SerialIter sit (item->slice ());
             txn = std::make_shared<STTx> (std::ref (sit));
         }
         else if (type == SHAMapTreeNode::tnTRANSACTION_MD)
         {
-            Serializer s;
-            int length;
-            item->peekSerializer ().getVL (s.modData (), 0, length);
-            SerialIter sit (s);
+            SerialIter it (item->slice ());
+            Blob const txnData = it.getVL ();
+            SerialIter sit (txnData);
 
             txn = std::make_shared<STTx> (std::ref (sit));
         }
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <transaction/tx/TxIndex.h>
+#include <common/core/ConfigSections.h>
+#include <data/nodestore/Manager.h>
+#include <ledger/AcceptedLedger.h>
+#include <protocol/Serializer.h>
+#include <beast/cxx14/memory.h> // <memory>
+
+namespace bessel {
+
+namespace {
+
+// An entry is the ledger sequence, the transaction's index in it and the
+// root of the ledger's transaction map. Older entries lack the root.
+std::size_t const entryBytes = 40;
+std::size_t const oldEntryBytes = 8;
+
+NodeObject::Ptr makeEntry (uint256 const& txID, LedgerIndex ledgerSeq,
+    std::uint32_t txnSeq, uint256 const& txMap)
+{
+    Serializer s (entryBytes);
+    s.add32 (ledgerSeq);
+    s.add32 (txnSeq);
+    s.add256 (txMap);
+
+    return NodeObject::createObject (hotUNKNOWN, std::move (s.modData ()), txID);
+}
+
+} // namespace
+
+TxIndex::TxIndex (std::unique_ptr <NodeStore::Backend> backend,
+        beast::Journal journal)
+    : backend_ (std::move (backend))
+    , journal_ (journal)
+{
+}
+
+TxIndex::~TxIndex ()
+{
+    backend_->close ();
+}
+
+void TxIndex::insert (AcceptedLedger const& ledger)
+{
+    LedgerIndex const ledgerSeq = ledger.getLedger ()->getLedgerSeq ();
+    uint256 const& txMap = ledger.getLedger ()->getTransHash ();
+
+    NodeStore::Batch batch;
+    batch.reserve (ledger.getMap ().size ());
+
+    for (auto const& item : ledger.getMap ())
+    {
+        batch.push_back (makeEntry (item.second->getTransactionID (),
+            ledgerSeq, item.second->getTxnSeq (), txMap));
+    }
+
+    if (!batch.empty ())
+        backend_->storeBatch (batch);
+}
+
+void TxIndex::insert (uint256 const& txID, Location const& location)
+{
+    backend_->store (makeEntry (txID, location.ledgerSeq, location.txnSeq,
+        location.txMap));
+}
+
+boost::optional <TxIndex::Location> TxIndex::fetch (uint256 const& txID)
+{
+    NodeObject::Ptr object;
+    NodeStore::Status const status = backend_->fetch (txID.begin (), &object);
+
+    if (status != NodeStore::ok || !object)
+    {
+        if (status != NodeStore::notFound)
+            journal_.warning << "Unable to fetch " << txID << ": " << status;
+        return boost::none;
+    }
+
+    SerialIter sit (object->getData ());
+    std::size_t const size = sit.getBytesLeft ();
+    if (size != entryBytes && size != oldEntryBytes)
+    {
+        journal_.warning << "Malformed entry for " << txID;
+        return boost::none;
+    }
+
+    Location location;
+    location.ledgerSeq = sit.get32 ();
+    location.txnSeq = sit.get32 ();
+    if (size == entryBytes)
+        location.txMap = sit.get256 ();
+
+    // No transaction is applied in a ledger before the first
+    if (location.ledgerSeq == 0)
+    {
+        journal_.warning << "Malformed entry for " << txID;
+        return boost::none;
+    }
+
+    return location;
+}
+
+//------------------------------------------------------------------------------
+
+std::unique_ptr <TxIndex>
+make_TxIndex (BasicConfig const& config,
+    NodeStore::Scheduler& scheduler, beast::Journal journal)
+{
+    if (!config.exists (SECTION_TX_INDEX))
+        return nullptr;
+
+    return std::make_unique <TxIndex> (NodeStore::Manager::instance ().make_Backend (
+        config.section (SECTION_TX_INDEX), scheduler, journal), journal);
+}
+
+} // bessel
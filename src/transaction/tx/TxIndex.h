@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+//*
+    This file is part of Bessel Chain Project: https://github.com/Besselfoundation/bessel-core
+    Copyright (c) 2018 BESSEL.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BESSEL_APP_TX_TXINDEX_H_INCLUDED
+#define BESSEL_APP_TX_TXINDEX_H_INCLUDED
+
+#include <common/base/base_uint.h>
+#include <common/base/BasicConfig.h>
+#include <data/nodestore/Backend.h>
+#include <data/nodestore/Scheduler.h>
+#include <protocol/Protocol.h>
+#include <beast/utility/Journal.h>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <memory>
+
+namespace bessel {
+
+class AcceptedLedger;
+
+/** Persistent map from a transaction ID to where it was applied.
+
+    The index lives in a key value store of its own, opened through the
+    NodeStore factories from the optional [tx_index] section, which takes
+    the same 'type' and 'path' keys as [node_db]. Each validated ledger adds
+    its transactions as it is saved, so a lookup by ID no longer has to go
+    through the transaction database. An entry also keeps the root of the
+    ledger's transaction map, so the transaction can be read straight from
+    the node store without loading the ledger.
+
+    Backends such as NuDB never overwrite a key, so an entry can name a
+    ledger the transaction was later moved out of. Callers must check that
+    the ledger really holds the transaction before trusting a location.
+*/
+class TxIndex
+{
+public:
+    struct Location
+    {
+        LedgerIndex ledgerSeq;
+        std::uint32_t txnSeq;
+
+        // The root hash of the ledger's transaction map. Zero for entries
+        // written before the root was recorded.
+        uint256 txMap;
+    };
+
+    TxIndex (std::unique_ptr <NodeStore::Backend> backend,
+        beast::Journal journal);
+
+    ~TxIndex ();
+
+    TxIndex (TxIndex const&) = delete;
+    TxIndex& operator= (TxIndex const&) = delete;
+
+    /** Record the location of every transaction in an accepted ledger. */
+    void insert (AcceptedLedger const& ledger);
+
+    /** Record the location of one transaction. */
+    void insert (uint256 const& txID, Location const& location);
+
+    /** Return where a transaction was applied, if it is indexed.
+        Entries that do not decode to a location are treated as absent.
+    */
+    boost::optional <Location> fetch (uint256 const& txID);
+
+private:
+    std::unique_ptr <NodeStore::Backend> backend_;
+    beast::Journal journal_;
+};
+
+/** Open the transaction index described by the [tx_index] section.
+
+    @return `nullptr` if the section is absent, which disables the index.
+*/
+std::unique_ptr <TxIndex>
+make_TxIndex (BasicConfig const& config,
+    NodeStore::Scheduler& scheduler, beast::Journal journal);
+
+} // bessel
+
+#endif